@@ -5,6 +5,7 @@
 #include <bench/bench.h>
 
 #include <crypto/sha256.h>
+#include <crypto/x11.h>
 #include <stacktraces.h>
 #include <util/strencodings.h>
 #include <util/system.h>
@@ -59,6 +60,8 @@ int main(int argc, char** argv)
     args.output_csv = argsman.GetArg("-output_csv", "");
     args.output_json = argsman.GetArg("-output_json", "");
 
+    X11AutoDetect();
+
     benchmark::BenchRunner::RunAll(args);
 
     return EXIT_SUCCESS;
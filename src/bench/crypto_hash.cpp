@@ -12,7 +12,9 @@
 #include <crypto/sha3.h>
 #include <crypto/sha512.h>
 #include <crypto/siphash.h>
+#include <crypto/x11.h>
 #include <hash.h>
+#include <primitives/block.h>
 #include <random.h>
 #include <uint256.h>
 
@@ -196,6 +198,35 @@ static void HASH_X11_2048b_single(benchmark::Bench& bench)
     });
 }
 
+static void HASH_X11_0080b_4way(benchmark::Bench& bench)
+{
+    uint8_t hash[4 * 32];
+    std::vector<uint8_t> in(4 * 80,0);
+    bench.batch(4).unit("hash").minEpochIterations(2500).run([&] {
+        X11_4way(hash, in.data(), 80);
+    });
+}
+
+/* Hash a full HEADERS message */
+
+static void HASH_X11_Headers_2000(benchmark::Bench& bench)
+{
+    FastRandomContext rng(true);
+    std::vector<CBlockHeader> headers(2000);
+    for (auto& header : headers) {
+        header.nVersion = 0x20000000;
+        header.hashPrevBlock = rng.rand256();
+        header.hashMerkleRoot = rng.rand256();
+        header.nTime = rng.rand32();
+        header.nBits = 0x1e0ffff0;
+        header.nNonce = rng.rand32();
+    }
+    std::vector<uint256> hashes;
+    bench.batch(headers.size()).unit("header").run([&] {
+        hashes = GetBlockHeaderHashes(headers);
+    });
+}
+
 /* Hash 32 bytes via SHA and SipHash */
 
 static void HASH_SHA256_32b(benchmark::Bench& bench)
@@ -313,6 +344,8 @@ BENCHMARK(HASH_X11_0128b_single);
 BENCHMARK(HASH_X11_0512b_single);
 BENCHMARK(HASH_X11_1024b_single);
 BENCHMARK(HASH_X11_2048b_single);
+BENCHMARK(HASH_X11_0080b_4way);
+BENCHMARK(HASH_X11_Headers_2000);
 
 BENCHMARK(HASH_SHA256_32b);
 BENCHMARK(HASH_SipHash_32b);
@@ -673,6 +673,19 @@ std::future<CBLSSignature> CBLSWorker::AsyncAggregateSigs(Span<CBLSSignature> si
     return std::move(p.second);
 }
 
+std::future<std::optional<CBLSSecretKey>> CBLSWorker::AsyncDecryptContributionShare(const std::shared_ptr<CBLSIESMultiRecipientObjects<CBLSSecretKey>>& encryptedContributions,
+                                                                                size_t idx, const CBLSSecretKey& sk, int nVersion)
+{
+    auto f = [encryptedContributions, idx, sk, nVersion](int threadId) -> std::optional<CBLSSecretKey> {
+        CBLSSecretKey skContribution;
+        if (!encryptedContributions->Decrypt(idx, sk, skContribution, nVersion)) {
+            return std::nullopt;
+        }
+        return skContribution;
+    };
+    return workerPool.push(f);
+}
+
 CBLSPublicKey CBLSWorker::BuildPubKeyShare(const BLSVerificationVectorPtr& vvec, const CBLSId& id)
 {
     CBLSPublicKey pkShare;
@@ -6,11 +6,13 @@
 #define DASH_CRYPTO_BLS_WORKER_H
 
 #include <bls/bls.h>
+#include <bls/bls_ies.h>
 
 #include <ctpl_stl.h>
 
 #include <future>
 #include <mutex>
+#include <optional>
 #include <utility>
 
 // Low level BLS/DKG stuff. All very compute intensive and optimized for parallelization
@@ -111,6 +113,10 @@ public:
 
     std::future<bool> AsyncVerifyContributionShare(const CBLSId& forId, const BLSVerificationVectorPtr& vvec, const CBLSSecretKey& skContribution);
 
+    // Decrypts the secret key share for recipient idx from an encrypted contribution. Returns std::nullopt if decryption fails
+    std::future<std::optional<CBLSSecretKey>> AsyncDecryptContributionShare(const std::shared_ptr<CBLSIESMultiRecipientObjects<CBLSSecretKey>>& encryptedContributions,
+                                                                            size_t idx, const CBLSSecretKey& sk, int nVersion);
+
     // Simple verification of vectors. Checks x.IsValid() for every entry and checks for duplicate entries
     static bool VerifyVerificationVector(Span<CBLSPublicKey> vvec);
     static bool VerifyVerificationVectors(Span<BLSVerificationVectorPtr> vvecs);
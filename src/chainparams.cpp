@@ -885,11 +885,13 @@ public:
         m_assumeutxo_data = MapAssumeutxo{
             {
                 110,
-                {AssumeutxoHash{uint256S("0x9b2a277a3e3b979f1a539d57e949495d7f8247312dbc32bce6619128c192b44b")}, 110},
+                {AssumeutxoHash{uint256S("0x9b2a277a3e3b979f1a539d57e949495d7f8247312dbc32bce6619128c192b44b")}, 110,
+                 uint256S("0xd0cbd795f796401858c3f7dc27db343abeb344144c6703df536275e51563eb2e")},
             },
             {
                 210,
-                {AssumeutxoHash{uint256S("0xd4c97d32882583b057efc3dce673e44204851435e6ffcef20346e69cddc7c91e")}, 210},
+                {AssumeutxoHash{uint256S("0xd4c97d32882583b057efc3dce673e44204851435e6ffcef20346e69cddc7c91e")}, 210,
+                 uint256S("0xb8caf213ad6744f432662c07d9937aaf1f926b97a29cfbe03a9fa9b6b59ad284")},
             },
         };
 
@@ -48,6 +48,10 @@ struct AssumeutxoData {
     //! We need to hardcode the value here because this is computed cumulatively using block data,
     //! which we do not necessarily have at the time of snapshot load.
     const unsigned int nChainTx;
+
+    //! The expected hash of the EvoDB contents bundled with the snapshot, which are not covered by
+    //! hash_serialized. Snapshots are refused if it is null.
+    const uint256 evodb_hash{};
 };
 
 using MapAssumeutxo = std::map<int, const AssumeutxoData>;
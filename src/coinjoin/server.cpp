@@ -12,6 +12,7 @@
 #include <masternode/sync.h>
 #include <net.h>
 #include <netmessagemaker.h>
+#include <scheduler.h>
 #include <script/interpreter.h>
 #include <shutdown.h>
 #include <streams.h>
@@ -19,13 +20,116 @@
 #include <util/moneystr.h>
 #include <util/ranges.h>
 #include <util/system.h>
+#include <util/thread.h>
 #include <validation.h>
 #include <version.h>
 
 #include <univalue.h>
 
+#include <utility>
+
 constexpr static CAmount DEFAULT_MAX_RAW_TX_FEE{COIN / 10};
 
+CCoinJoinServer::CCoinJoinServer(CChainState& chainstate, CConnman& _connman, CTxMemPool& mempool, const CMasternodeSync& mn_sync) :
+    m_chainstate(chainstate),
+    connman(_connman),
+    mempool(mempool),
+    m_mn_sync(mn_sync),
+    fUnitTest(false)
+{}
+
+CCoinJoinServer::~CCoinJoinServer()
+{
+    Stop();
+}
+
+void CCoinJoinServer::Start()
+{
+    if (!fMasternodeMode || scheduler != nullptr) return;
+
+    scheduler = std::make_unique<CScheduler>();
+    scheduler_thread = std::make_unique<std::thread>(std::thread(util::TraceThread, "cj-schdlr", [&] { scheduler->serviceQueue(); }));
+    // sessions schedule their own timers, this only takes care of the network queues and finished sessions
+    scheduler->scheduleEvery([&]() { DoMaintenance(); }, std::chrono::seconds{5});
+}
+
+void CCoinJoinServer::Stop()
+{
+    if (scheduler_thread == nullptr) return;
+
+    scheduler->stop();
+    scheduler_thread->join();
+    scheduler_thread.reset();
+}
+
+void CCoinJoinServer::ScheduleCheck(const std::shared_ptr<CCoinJoinServerSession>& session, std::chrono::milliseconds delay)
+{
+    if (scheduler == nullptr) {
+        // no timers without the scheduler, but still advance the session right away if asked to
+        if (delay.count() == 0) session->Check();
+        return;
+    }
+    scheduler->scheduleFromNow([weak_session = std::weak_ptr<CCoinJoinServerSession>(session)]() {
+        if (auto session = weak_session.lock()) {
+            session->Check();
+        }
+    }, delay);
+}
+
+void CCoinJoinServer::OnSessionFinished(bool fSuccess, const std::optional<CCoinJoinQueue>& dsq)
+{
+    ++(fSuccess ? nSessionsCompleted : nSessionsFailed);
+    if (!dsq) return;
+    // the queues of the other sessions stay until they finish as well, even if they look the same
+    LOCK(cs_vecqueue);
+    if (const auto it = ranges::find_if(vecCoinJoinQueue, [&dsq](const auto& q) { return q == *dsq; }); it != vecCoinJoinQueue.end()) {
+        vecCoinJoinQueue.erase(it);
+    }
+}
+
+bool CCoinJoinServer::HasOpenOwnQueue() const
+{
+    const auto mnOutpoint = WITH_LOCK(activeMasternodeInfoCs, return activeMasternodeInfo.outpoint);
+    const size_t nOwnQueues = WITH_LOCK(cs_vecqueue, return ranges::count_if(vecCoinJoinQueue, [&mnOutpoint](const auto& q) {
+        return q.masternodeOutpoint == mnOutpoint;
+    }));
+    if (nOwnQueues == 0) return false;
+
+    // Queues of sessions started at the same time can't be told apart, so count them instead of matching them
+    LOCK(cs_sessions);
+    size_t nSessionQueues{0};
+    for (const auto& session : vecSessions) {
+        if (!session->GetQueue()) continue;
+        if (session->IsOpen()) return true;
+        ++nSessionQueues;
+    }
+    // our own queues without a session never go away on their own
+    return nOwnQueues > nSessionQueues;
+}
+
+std::shared_ptr<CCoinJoinServerSession> CCoinJoinServer::GetPeerSession(NodeId nodeid) const
+{
+    LOCK(cs_sessions);
+    const auto it = mapPeerSessions.find(nodeid);
+    if (it == mapPeerSessions.end() || it->second->IsFinished()) return nullptr;
+    return it->second;
+}
+
+void CCoinJoinServer::CleanupSessions()
+{
+    LOCK(cs_sessions);
+    vecSessions.erase(std::remove_if(vecSessions.begin(), vecSessions.end(), [](const auto& session) {
+        return session->IsFinished();
+    }), vecSessions.end());
+    for (auto it = mapPeerSessions.begin(); it != mapPeerSessions.end();) {
+        if (it->second->IsFinished()) {
+            it = mapPeerSessions.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
 PeerMsgRet CCoinJoinServer::ProcessMessage(CNode& peer, std::string_view msg_type, CDataStream& vRecv)
 {
     if (!fMasternodeMode) return {};
@@ -38,17 +142,61 @@ PeerMsgRet CCoinJoinServer::ProcessMessage(CNode& peer, std::string_view msg_typ
     } else if (msg_type == NetMsgType::DSVIN) {
         ProcessDSVIN(peer, vRecv);
     } else if (msg_type == NetMsgType::DSSIGNFINALTX) {
-        ProcessDSSIGNFINALTX(vRecv);
+        ProcessDSSIGNFINALTX(peer, vRecv);
     }
     return {};
 }
 
-void CCoinJoinServer::ProcessDSACCEPT(CNode& peer, CDataStream& vRecv)
+bool CCoinJoinServer::SelectSession(NodeId nodeid, std::shared_ptr<CCoinJoinServerSession>& sessionRet, PoolMessage& nMessageIDRet) const
 {
-    if (IsSessionReady()) {
+    // peers stay in the session they joined, everyone else can only join the session which is still gathering participants
+    sessionRet = GetPeerSession(nodeid);
+    if (sessionRet != nullptr) {
+        if (sessionRet->IsOpen()) return true;
         // too many users in this session already, reject new ones
         LogPrint(BCLog::COINJOIN, "DSACCEPT -- queue is already full!\n");
-        PushStatus(peer, STATUS_REJECTED, ERR_QUEUE_FULL);
+        nMessageIDRet = ERR_QUEUE_FULL;
+        return false;
+    }
+
+    LOCK(cs_sessions);
+    const auto it = ranges::find_if(vecSessions, [](const auto& s) { return s->IsOpen(); });
+    if (it != vecSessions.end()) {
+        sessionRet = *it;
+        return true;
+    }
+    if (ranges::count_if(vecSessions, [](const auto& s) { return !s->IsFinished(); }) >= COINJOIN_SERVER_MAX_SESSIONS) {
+        LogPrint(BCLog::COINJOIN, "DSACCEPT -- already hosting %d sessions!\n", COINJOIN_SERVER_MAX_SESSIONS);
+        nMessageIDRet = ERR_QUEUE_FULL;
+        return false;
+    }
+    return true;
+}
+
+bool CCoinJoinServer::JoinSession(NodeId nodeid, std::shared_ptr<CCoinJoinServerSession>& session, const CCoinJoinAccept& dsa, PoolMessage& nMessageIDRet)
+{
+    if (session == nullptr) {
+        auto new_session = std::make_shared<CCoinJoinServerSession>(*this, GetTime());
+        if (!new_session->CreateNewSession(dsa, nMessageIDRet)) return false;
+        session = new_session;
+        WITH_LOCK(cs_sessions, vecSessions.push_back(session));
+    } else if (!session->AddUserToExistingSession(dsa, nMessageIDRet)) {
+        return false;
+    }
+    WITH_LOCK(cs_sessions, mapPeerSessions[nodeid] = session);
+    return true;
+}
+
+void CCoinJoinServer::ProcessDSACCEPT(CNode& peer, CDataStream& vRecv)
+{
+    std::shared_ptr<CCoinJoinServerSession> session;
+    PoolMessage nMessageID = MSG_NOERR;
+    if (!SelectSession(peer.GetId(), session, nMessageID)) {
+        if (session != nullptr) {
+            session->PushStatus(peer, STATUS_REJECTED, nMessageID);
+        } else {
+            PushStatus(peer, STATUS_REJECTED, nMessageID);
+        }
         return;
     }
 
@@ -64,20 +212,12 @@ void CCoinJoinServer::ProcessDSACCEPT(CNode& peer, CDataStream& vRecv)
         return;
     }
 
-    if (vecSessionCollaterals.empty()) {
-        {
-            TRY_LOCK(cs_vecqueue, lockRecv);
-            if (!lockRecv) return;
-
-            auto mnOutpoint = WITH_LOCK(activeMasternodeInfoCs, return activeMasternodeInfo.outpoint);
-
-            if (ranges::any_of(vecCoinJoinQueue,
-                               [&mnOutpoint](const auto& q){return q.masternodeOutpoint == mnOutpoint;})) {
-                // refuse to create another queue this often
-                LogPrint(BCLog::COINJOIN, "DSACCEPT -- last dsq is still in queue, refuse to mix\n");
-                PushStatus(peer, STATUS_REJECTED, ERR_RECENT);
-                return;
-            }
+    if (session == nullptr) {
+        if (HasOpenOwnQueue()) {
+            // refuse to create another queue this often
+            LogPrint(BCLog::COINJOIN, "DSACCEPT -- last dsq is still in queue, refuse to mix\n");
+            PushStatus(peer, STATUS_REJECTED, ERR_RECENT);
+            return;
         }
 
         int64_t nLastDsq = mmetaman->GetMetaInfo(dmn->proTxHash)->GetLastDsq();
@@ -93,17 +233,17 @@ void CCoinJoinServer::ProcessDSACCEPT(CNode& peer, CDataStream& vRecv)
         }
     }
 
-    PoolMessage nMessageID = MSG_NOERR;
-
-    bool fResult = nSessionID == 0 ? CreateNewSession(dsa, nMessageID)
-            : AddUserToExistingSession(dsa, nMessageID);
-    if (fResult) {
+    if (JoinSession(peer.GetId(), session, dsa, nMessageID)) {
         LogPrint(BCLog::COINJOIN, "DSACCEPT -- is compatible, please submit!\n");
-        PushStatus(peer, STATUS_ACCEPTED, nMessageID);
+        session->PushStatus(peer, STATUS_ACCEPTED, nMessageID);
         return;
     } else {
         LogPrint(BCLog::COINJOIN, "DSACCEPT -- not compatible with existing transactions!\n");
-        PushStatus(peer, STATUS_REJECTED, nMessageID);
+        if (session != nullptr) {
+            session->PushStatus(peer, STATUS_REJECTED, nMessageID);
+        } else {
+            PushStatus(peer, STATUS_REJECTED, nMessageID);
+        }
         return;
     }
 }
@@ -182,8 +322,8 @@ PeerMsgRet CCoinJoinServer::ProcessDSQUEUE(const CNode& peer, CDataStream& vRecv
 
 void CCoinJoinServer::ProcessDSVIN(CNode& peer, CDataStream& vRecv)
 {
-    //do we have enough users in the current session?
-    if (!IsSessionReady()) {
+    auto session = GetPeerSession(peer.GetId());
+    if (session == nullptr) {
         LogPrint(BCLog::COINJOIN, "DSVIN -- session not complete!\n");
         PushStatus(peer, STATUS_REJECTED, ERR_SESSION);
         return;
@@ -192,11 +332,101 @@ void CCoinJoinServer::ProcessDSVIN(CNode& peer, CDataStream& vRecv)
     CCoinJoinEntry entry;
     vRecv >> entry;
 
+    entry.addr = peer.addr;
+    session->ProcessDSVIN(peer, entry);
+}
+
+void CCoinJoinServer::ProcessDSSIGNFINALTX(CNode& peer, CDataStream& vRecv)
+{
+    std::vector<CTxIn> vecTxIn;
+    vRecv >> vecTxIn;
+
+    LogPrint(BCLog::COINJOIN, "DSSIGNFINALTX -- vecTxIn.size() %s\n", vecTxIn.size());
+
+    auto session = GetPeerSession(peer.GetId());
+    if (session == nullptr) {
+        LogPrint(BCLog::COINJOIN, "DSSIGNFINALTX -- peer=%d is not in any session\n", peer.GetId());
+        return;
+    }
+    session->ProcessDSSIGNFINALTX(vecTxIn);
+}
+
+void CCoinJoinServer::ConsumeCollateral(const CTransactionRef& txref) const
+{
+    LOCK(cs_main);
+    TxValidationState validationState;
+    if (!AcceptToMemoryPool(m_chainstate, mempool, validationState, txref, false /* bypass_limits */, 0 /* nAbsurdFee */)) {
+        LogPrint(BCLog::COINJOIN, "%s -- AcceptToMemoryPool failed\n", __func__);
+    } else {
+        connman.RelayTransaction(*txref);
+        LogPrint(BCLog::COINJOIN, "%s -- Collateral was consumed\n", __func__);
+    }
+}
+
+void CCoinJoinServer::PushStatus(CNode& peer, PoolStatusUpdate nStatusUpdate, PoolMessage nMessageID) const
+{
+    // not related to any session
+    CCoinJoinStatusUpdate psssup(0, POOL_STATE_IDLE, 0, nStatusUpdate, nMessageID);
+    connman.PushMessage(&peer, CNetMsgMaker(peer.GetSendVersion()).Make(NetMsgType::DSSTATUSUPDATE, psssup));
+}
+
+void CCoinJoinServer::DoMaintenance()
+{
+    if (!fMasternodeMode) return; // only run on masternodes
+    if (!m_mn_sync.IsBlockchainSynced()) return;
+    if (ShutdownRequested()) return;
+
+    CheckQueue();
+
+    // session timers normally take care of this already, this is only a fallback in case a timer got lost
+    for (const auto& session : WITH_LOCK(cs_sessions, return vecSessions)) {
+        if (session->GetTimeUntilTimeout() == 0) {
+            session->Check();
+        }
+    }
+
+    CleanupSessions();
+}
+
+void CCoinJoinServer::GetJsonInfo(UniValue& obj) const
+{
+    LOCK(cs_sessions);
+    UniValue sessions(UniValue::VARR);
+    for (const auto& session : vecSessions) {
+        if (session->IsFinished()) continue;
+        UniValue sessionObj;
+        session->GetJsonInfo(sessionObj);
+        sessions.push_back(sessionObj);
+    }
+    // report the most recent session on the top level, it's the one new participants join
+    const UniValue* current = sessions.empty() ? nullptr : &sessions[sessions.size() - 1];
+
+    obj.clear();
+    obj.setObject();
+    obj.pushKV("queue_size",    GetQueueSize());
+    obj.pushKV("denomination",  current ? find_value(*current, "denomination") : ValueFromAmount(0));
+    obj.pushKV("state",         current ? find_value(*current, "state").get_str() : "IDLE");
+    obj.pushKV("entries_count", current ? find_value(*current, "entries_count").get_int() : 0);
+    obj.pushKV("sessions_completed", nSessionsCompleted.load());
+    obj.pushKV("sessions_failed", nSessionsFailed.load());
+    obj.pushKV("sessions", sessions);
+}
+
+void CCoinJoinServerSession::ProcessDSVIN(CNode& peer, const CCoinJoinEntry& entry)
+{
+    LOCK(cs_session);
+
+    //do we have enough users in the current session?
+    if (!IsSessionReady()) {
+        LogPrint(BCLog::COINJOIN, "DSVIN -- session not complete!\n");
+        PushStatus(peer, STATUS_REJECTED, ERR_SESSION);
+        return;
+    }
+
     LogPrint(BCLog::COINJOIN, "DSVIN -- txCollateral %s", entry.txCollateral->ToString()); /* Continued */
 
     PoolMessage nMessageID = MSG_NOERR;
 
-    entry.addr = peer.addr;
     if (AddEntry(entry, nMessageID)) {
         PushStatus(peer, STATUS_ACCEPTED, nMessageID);
         CheckPool();
@@ -207,59 +437,71 @@ void CCoinJoinServer::ProcessDSVIN(CNode& peer, CDataStream& vRecv)
     }
 }
 
-void CCoinJoinServer::ProcessDSSIGNFINALTX(CDataStream& vRecv)
+void CCoinJoinServerSession::ProcessDSSIGNFINALTX(const std::vector<CTxIn>& vecTxIn)
 {
-    std::vector<CTxIn> vecTxIn;
-    vRecv >> vecTxIn;
-
-    LogPrint(BCLog::COINJOIN, "DSSIGNFINALTX -- vecTxIn.size() %s\n", vecTxIn.size());
+    {
+        LOCK(cs_session);
 
-    int nTxInIndex = 0;
-    int nTxInsCount = (int)vecTxIn.size();
+        int nTxInIndex = 0;
+        int nTxInsCount = (int)vecTxIn.size();
 
-    for (const auto& txin : vecTxIn) {
-        nTxInIndex++;
-        if (!AddScriptSig(txin)) {
-            LogPrint(BCLog::COINJOIN, "DSSIGNFINALTX -- AddScriptSig() failed at %d/%d, session: %d\n", nTxInIndex, nTxInsCount, nSessionID);
-            LOCK(cs_coinjoin);
-            RelayStatus(STATUS_REJECTED);
-            return;
+        for (const auto& txin : vecTxIn) {
+            nTxInIndex++;
+            if (!AddScriptSig(txin)) {
+                LogPrint(BCLog::COINJOIN, "DSSIGNFINALTX -- AddScriptSig() failed at %d/%d, session: %d\n", nTxInIndex, nTxInsCount, nSessionID);
+                LOCK(cs_coinjoin);
+                RelayStatus(STATUS_REJECTED);
+                return;
+            }
+            LogPrint(BCLog::COINJOIN, "DSSIGNFINALTX -- AddScriptSig() %d/%d success\n", nTxInIndex, nTxInsCount);
         }
-        LogPrint(BCLog::COINJOIN, "DSSIGNFINALTX -- AddScriptSig() %d/%d success\n", nTxInIndex, nTxInsCount);
     }
-    // all is good
-    CheckPool();
+    // all is good, the final transaction is committed on the scheduler thread once everyone signed
+    if (nState == POOL_STATE_SIGNING && IsSignaturesComplete()) {
+        m_server.ScheduleCheck(shared_from_this(), std::chrono::milliseconds{0});
+    }
 }
 
-void CCoinJoinServer::SetNull()
+void CCoinJoinServerSession::Finish(bool fSuccess)
 {
     AssertLockHeld(cs_coinjoin);
-    // MN side
-    vecSessionCollaterals.clear();
+    if (fFinished.exchange(true)) return;
 
+    LogPrint(BCLog::COINJOIN, "CCoinJoinServerSession::%s -- nSessionID: %d %s after %d seconds\n",
+        __func__, nSessionID, fSuccess ? "completed" : "failed", GetTime() - nTimeCreated);
     CCoinJoinBaseSession::SetNull();
-    CCoinJoinBaseManager::SetNull();
+    m_server.OnSessionFinished(fSuccess, std::exchange(m_dsq, std::nullopt));
+}
+
+void CCoinJoinServerSession::Check()
+{
+    LOCK(cs_session);
+    if (fFinished) return;
+
+    CheckForCompleteQueue();
+    CheckPool();
+    CheckTimeout();
 }
 
 //
 // Check the mixing progress and send client updates if a Masternode
 //
-void CCoinJoinServer::CheckPool()
+void CCoinJoinServerSession::CheckPool()
 {
     if (!fMasternodeMode) return;
 
-    if (int entries = GetEntriesCount(); entries != 0) LogPrint(BCLog::COINJOIN, "CCoinJoinServer::CheckPool -- entries count %lu\n", entries);
+    if (int entries = GetEntriesCount(); entries != 0) LogPrint(BCLog::COINJOIN, "CCoinJoinServerSession::CheckPool -- entries count %lu\n", entries);
 
     // If we have an entry for each collateral, then create final tx
     if (nState == POOL_STATE_ACCEPTING_ENTRIES && size_t(GetEntriesCount()) == vecSessionCollaterals.size()) {
-        LogPrint(BCLog::COINJOIN, "CCoinJoinServer::CheckPool -- FINALIZE TRANSACTIONS\n");
+        LogPrint(BCLog::COINJOIN, "CCoinJoinServerSession::CheckPool -- FINALIZE TRANSACTIONS\n");
         CreateFinalTransaction();
         return;
     }
 
     // Check for Time Out
     // If we timed out while accepting entries, then if we have more than minimum, create final tx
-    if (nState == POOL_STATE_ACCEPTING_ENTRIES && CCoinJoinServer::HasTimedOut()
+    if (nState == POOL_STATE_ACCEPTING_ENTRIES && HasTimedOut()
             && GetEntriesCount() >= CoinJoin::GetMinPoolParticipants()) {
         // Punish misbehaving participants
         ChargeFees();
@@ -270,16 +512,16 @@ void CCoinJoinServer::CheckPool()
 
     // If we have all the signatures, try to compile the transaction
     if (nState == POOL_STATE_SIGNING && IsSignaturesComplete()) {
-        LogPrint(BCLog::COINJOIN, "CCoinJoinServer::CheckPool -- SIGNING\n");
+        LogPrint(BCLog::COINJOIN, "CCoinJoinServerSession::CheckPool -- SIGNING\n");
         CommitFinalTransaction();
         return;
     }
 }
 
-void CCoinJoinServer::CreateFinalTransaction()
+void CCoinJoinServerSession::CreateFinalTransaction()
 {
     AssertLockNotHeld(cs_coinjoin);
-    LogPrint(BCLog::COINJOIN, "CCoinJoinServer::CreateFinalTransaction -- FINALIZE TRANSACTIONS\n");
+    LogPrint(BCLog::COINJOIN, "CCoinJoinServerSession::CreateFinalTransaction -- FINALIZE TRANSACTIONS\n");
 
     LOCK(cs_coinjoin);
 
@@ -299,14 +541,14 @@ void CCoinJoinServer::CreateFinalTransaction()
     sort(txNew.vout.begin(), txNew.vout.end(), CompareOutputBIP69());
 
     finalMutableTransaction = txNew;
-    LogPrint(BCLog::COINJOIN, "CCoinJoinServer::CreateFinalTransaction -- finalMutableTransaction=%s", txNew.ToString()); /* Continued */
+    LogPrint(BCLog::COINJOIN, "CCoinJoinServerSession::CreateFinalTransaction -- finalMutableTransaction=%s", txNew.ToString()); /* Continued */
 
     // request signatures from clients
     SetState(POOL_STATE_SIGNING);
     RelayFinalTransaction(CTransaction(finalMutableTransaction));
 }
 
-void CCoinJoinServer::CommitFinalTransaction()
+void CCoinJoinServerSession::CommitFinalTransaction()
 {
     AssertLockNotHeld(cs_coinjoin);
     if (!fMasternodeMode) return; // check and relay final tx only on masternode
@@ -314,23 +556,23 @@ void CCoinJoinServer::CommitFinalTransaction()
     CTransactionRef finalTransaction = WITH_LOCK(cs_coinjoin, return MakeTransactionRef(finalMutableTransaction));
     uint256 hashTx = finalTransaction->GetHash();
 
-    LogPrint(BCLog::COINJOIN, "CCoinJoinServer::CommitFinalTransaction -- finalTransaction=%s", finalTransaction->ToString()); /* Continued */
+    LogPrint(BCLog::COINJOIN, "CCoinJoinServerSession::CommitFinalTransaction -- finalTransaction=%s", finalTransaction->ToString()); /* Continued */
 
     {
         // See if the transaction is valid
         TRY_LOCK(cs_main, lockMain);
         TxValidationState validationState;
-        mempool.PrioritiseTransaction(hashTx, 0.1 * COIN);
-        if (!lockMain || !AcceptToMemoryPool(m_chainstate, mempool, validationState, finalTransaction, false /* bypass_limits */, DEFAULT_MAX_RAW_TX_FEE /* nAbsurdFee */)) {
-            LogPrint(BCLog::COINJOIN, "CCoinJoinServer::CommitFinalTransaction -- AcceptToMemoryPool() error: Transaction not valid\n");
-            WITH_LOCK(cs_coinjoin, SetNull());
+        m_server.mempool.PrioritiseTransaction(hashTx, 0.1 * COIN);
+        if (!lockMain || !AcceptToMemoryPool(m_server.m_chainstate, m_server.mempool, validationState, finalTransaction, false /* bypass_limits */, DEFAULT_MAX_RAW_TX_FEE /* nAbsurdFee */)) {
+            LogPrint(BCLog::COINJOIN, "CCoinJoinServerSession::CommitFinalTransaction -- AcceptToMemoryPool() error: Transaction not valid\n");
             // not much we can do in this case, just notify clients
             RelayCompletedTransaction(ERR_INVALID_TX);
+            WITH_LOCK(cs_coinjoin, Finish(false));
             return;
         }
     }
 
-    LogPrint(BCLog::COINJOIN, "CCoinJoinServer::CommitFinalTransaction -- CREATING DSTX\n");
+    LogPrint(BCLog::COINJOIN, "CCoinJoinServerSession::CommitFinalTransaction -- CREATING DSTX\n");
 
     // create and sign masternode dstx transaction
     if (!::dstxManager->GetDSTX(hashTx)) {
@@ -342,10 +584,10 @@ void CCoinJoinServer::CommitFinalTransaction()
         ::dstxManager->AddDSTX(dstxNew);
     }
 
-    LogPrint(BCLog::COINJOIN, "CCoinJoinServer::CommitFinalTransaction -- TRANSMITTING DSTX\n");
+    LogPrint(BCLog::COINJOIN, "CCoinJoinServerSession::CommitFinalTransaction -- TRANSMITTING DSTX\n");
 
     CInv inv(MSG_DSTX, hashTx);
-    connman.RelayInv(inv);
+    m_server.connman.RelayInv(inv);
 
     // Tell the clients it was successful
     RelayCompletedTransaction(MSG_SUCCESS);
@@ -354,8 +596,8 @@ void CCoinJoinServer::CommitFinalTransaction()
     ChargeRandomFees();
 
     // Reset
-    LogPrint(BCLog::COINJOIN, "CCoinJoinServer::CommitFinalTransaction -- COMPLETED -- RESETTING\n");
-    WITH_LOCK(cs_coinjoin, SetNull());
+    LogPrint(BCLog::COINJOIN, "CCoinJoinServerSession::CommitFinalTransaction -- COMPLETED -- RESETTING\n");
+    WITH_LOCK(cs_coinjoin, Finish(true));
 }
 
 //
@@ -370,7 +612,7 @@ void CCoinJoinServer::CommitFinalTransaction()
 // transaction for the client to be able to enter the pool. This transaction is kept by the Masternode
 // until the transaction is either complete or fails.
 //
-void CCoinJoinServer::ChargeFees() const
+void CCoinJoinServerSession::ChargeFees() const
 {
     AssertLockNotHeld(cs_coinjoin);
     if (!fMasternodeMode) return;
@@ -389,7 +631,7 @@ void CCoinJoinServer::ChargeFees() const
 
             // This queue entry didn't send us the promised transaction
             if (!fFound) {
-                LogPrint(BCLog::COINJOIN, "CCoinJoinServer::ChargeFees -- found uncooperative node (didn't send transaction), found offence\n");
+                LogPrint(BCLog::COINJOIN, "CCoinJoinServerSession::ChargeFees -- found uncooperative node (didn't send transaction), found offence\n");
                 vecOffendersCollaterals.push_back(txCollateral);
             }
         }
@@ -401,7 +643,7 @@ void CCoinJoinServer::ChargeFees() const
         for (const auto& entry : vecEntries) {
             for (const auto& txdsin : entry.vecTxDSIn) {
                 if (!txdsin.fHasSig) {
-                    LogPrint(BCLog::COINJOIN, "CCoinJoinServer::ChargeFees -- found uncooperative node (didn't sign), found offence\n");
+                    LogPrint(BCLog::COINJOIN, "CCoinJoinServerSession::ChargeFees -- found uncooperative node (didn't sign), found offence\n");
                     vecOffendersCollaterals.push_back(entry.txCollateral);
                 }
             }
@@ -421,9 +663,9 @@ void CCoinJoinServer::ChargeFees() const
     Shuffle(vecOffendersCollaterals.begin(), vecOffendersCollaterals.end(), FastRandomContext());
 
     if (nState == POOL_STATE_ACCEPTING_ENTRIES || nState == POOL_STATE_SIGNING) {
-        LogPrint(BCLog::COINJOIN, "CCoinJoinServer::ChargeFees -- found uncooperative node (didn't %s transaction), charging fees: %s", /* Continued */
+        LogPrint(BCLog::COINJOIN, "CCoinJoinServerSession::ChargeFees -- found uncooperative node (didn't %s transaction), charging fees: %s", /* Continued */
             (nState == POOL_STATE_SIGNING) ? "sign" : "send", vecOffendersCollaterals[0]->ToString());
-        ConsumeCollateral(vecOffendersCollaterals[0]);
+        m_server.ConsumeCollateral(vecOffendersCollaterals[0]);
     }
 }
 
@@ -439,30 +681,18 @@ void CCoinJoinServer::ChargeFees() const
     stop these kinds of attacks 1 in 10 successful transactions are charged. This
     adds up to a cost of 0.001DRK per transaction on average.
 */
-void CCoinJoinServer::ChargeRandomFees() const
+void CCoinJoinServerSession::ChargeRandomFees() const
 {
     if (!fMasternodeMode) return;
 
     for (const auto& txCollateral : vecSessionCollaterals) {
         if (GetRandInt(100) > 10) return;
-        LogPrint(BCLog::COINJOIN, "CCoinJoinServer::ChargeRandomFees -- charging random fees, txCollateral=%s", txCollateral->ToString()); /* Continued */
-        ConsumeCollateral(txCollateral);
+        LogPrint(BCLog::COINJOIN, "CCoinJoinServerSession::ChargeRandomFees -- charging random fees, txCollateral=%s", txCollateral->ToString()); /* Continued */
+        m_server.ConsumeCollateral(txCollateral);
     }
 }
 
-void CCoinJoinServer::ConsumeCollateral(const CTransactionRef& txref) const
-{
-    LOCK(cs_main);
-    TxValidationState validationState;
-    if (!AcceptToMemoryPool(m_chainstate, mempool, validationState, txref, false /* bypass_limits */, 0 /* nAbsurdFee */)) {
-        LogPrint(BCLog::COINJOIN, "%s -- AcceptToMemoryPool failed\n", __func__);
-    } else {
-        connman.RelayTransaction(*txref);
-        LogPrint(BCLog::COINJOIN, "%s -- Collateral was consumed\n", __func__);
-    }
-}
-
-bool CCoinJoinServer::HasTimedOut() const
+bool CCoinJoinServerSession::HasTimedOut() const
 {
     if (!fMasternodeMode) return false;
 
@@ -473,22 +703,26 @@ bool CCoinJoinServer::HasTimedOut() const
     return GetTime() - nTimeLastSuccessfulStep >= nTimeout;
 }
 
+int64_t CCoinJoinServerSession::GetTimeUntilTimeout() const
+{
+    int nTimeout = (nState == POOL_STATE_SIGNING) ? COINJOIN_SIGNING_TIMEOUT : COINJOIN_QUEUE_TIMEOUT;
+    return std::max<int64_t>(0, nTimeLastSuccessfulStep + nTimeout - GetTime());
+}
+
 //
 // Check for extraneous timeout
 //
-void CCoinJoinServer::CheckTimeout()
+void CCoinJoinServerSession::CheckTimeout()
 {
     if (!fMasternodeMode) return;
 
-    CheckQueue();
-
     // Too early to do anything
-    if (!CCoinJoinServer::HasTimedOut()) return;
+    if (!HasTimedOut()) return;
 
-    LogPrint(BCLog::COINJOIN, "CCoinJoinServer::CheckTimeout -- %s timed out -- resetting\n",
+    LogPrint(BCLog::COINJOIN, "CCoinJoinServerSession::CheckTimeout -- %s timed out -- resetting\n",
         (nState == POOL_STATE_SIGNING) ? "Signing" : "Session");
     ChargeFees();
-    WITH_LOCK(cs_coinjoin, SetNull());
+    WITH_LOCK(cs_coinjoin, Finish(false));
 }
 
 /*
@@ -496,7 +730,7 @@ void CCoinJoinServer::CheckTimeout()
     After receiving multiple dsa messages, the queue will switch to "accepting entries"
     which is the active state right before merging the transaction
 */
-void CCoinJoinServer::CheckForCompleteQueue()
+void CCoinJoinServerSession::CheckForCompleteQueue()
 {
     if (!fMasternodeMode) return;
 
@@ -507,15 +741,15 @@ void CCoinJoinServer::CheckForCompleteQueue()
                             WITH_LOCK(activeMasternodeInfoCs, return activeMasternodeInfo.outpoint),
                             WITH_LOCK(activeMasternodeInfoCs, return activeMasternodeInfo.proTxHash),
                             GetAdjustedTime(), true);
-        LogPrint(BCLog::COINJOIN, "CCoinJoinServer::CheckForCompleteQueue -- queue is ready, signing and relaying (%s) " /* Continued */
+        LogPrint(BCLog::COINJOIN, "CCoinJoinServerSession::CheckForCompleteQueue -- queue is ready, signing and relaying (%s) " /* Continued */
                                      "with %d participants\n", dsq.ToString(), vecSessionCollaterals.size());
         dsq.Sign();
-        dsq.Relay(connman);
+        dsq.Relay(m_server.connman);
     }
 }
 
 // Check to make sure a given input matches an input in the pool and its scriptSig is valid
-bool CCoinJoinServer::IsInputScriptSigValid(const CTxIn& txin) const
+bool CCoinJoinServerSession::IsInputScriptSigValid(const CTxIn& txin) const
 {
     AssertLockHeld(cs_coinjoin);
     CMutableTransaction txNew;
@@ -544,58 +778,58 @@ bool CCoinJoinServer::IsInputScriptSigValid(const CTxIn& txin) const
     }
     if (nTxInIndex >= 0) { //might have to do this one input at a time?
         txNew.vin[nTxInIndex].scriptSig = txin.scriptSig;
-        LogPrint(BCLog::COINJOIN, "CCoinJoinServer::IsInputScriptSigValid -- verifying scriptSig %s\n", ScriptToAsmStr(txin.scriptSig).substr(0, 24));
+        LogPrint(BCLog::COINJOIN, "CCoinJoinServerSession::IsInputScriptSigValid -- verifying scriptSig %s\n", ScriptToAsmStr(txin.scriptSig).substr(0, 24));
         // TODO we're using amount=0 here but we should use the correct amount. This works because Dash ignores the amount while signing/verifying (only used in Bitcoin/Segwit)
         if (!VerifyScript(txNew.vin[nTxInIndex].scriptSig, sigPubKey, SCRIPT_VERIFY_P2SH | SCRIPT_VERIFY_STRICTENC, MutableTransactionSignatureChecker(&txNew, nTxInIndex, 0))) {
-            LogPrint(BCLog::COINJOIN, "CCoinJoinServer::IsInputScriptSigValid -- VerifyScript() failed on input %d\n", nTxInIndex);
+            LogPrint(BCLog::COINJOIN, "CCoinJoinServerSession::IsInputScriptSigValid -- VerifyScript() failed on input %d\n", nTxInIndex);
             return false;
         }
     } else {
-        LogPrint(BCLog::COINJOIN, "CCoinJoinServer::IsInputScriptSigValid -- Failed to find matching input in pool, %s\n", txin.ToString());
+        LogPrint(BCLog::COINJOIN, "CCoinJoinServerSession::IsInputScriptSigValid -- Failed to find matching input in pool, %s\n", txin.ToString());
         return false;
     }
 
-    LogPrint(BCLog::COINJOIN, "CCoinJoinServer::IsInputScriptSigValid -- Successfully validated input and scriptSig\n");
+    LogPrint(BCLog::COINJOIN, "CCoinJoinServerSession::IsInputScriptSigValid -- Successfully validated input and scriptSig\n");
     return true;
 }
 
 //
 // Add a client's transaction inputs/outputs to the pool
 //
-bool CCoinJoinServer::AddEntry(const CCoinJoinEntry& entry, PoolMessage& nMessageIDRet)
+bool CCoinJoinServerSession::AddEntry(const CCoinJoinEntry& entry, PoolMessage& nMessageIDRet)
 {
     AssertLockNotHeld(cs_coinjoin);
     if (!fMasternodeMode) return false;
 
     if (size_t(GetEntriesCount()) >= vecSessionCollaterals.size()) {
-        LogPrint(BCLog::COINJOIN, "CCoinJoinServer::%s -- ERROR: entries is full!\n", __func__);
+        LogPrint(BCLog::COINJOIN, "CCoinJoinServerSession::%s -- ERROR: entries is full!\n", __func__);
         nMessageIDRet = ERR_ENTRIES_FULL;
         return false;
     }
 
-    if (!CoinJoin::IsCollateralValid(mempool, *entry.txCollateral)) {
-        LogPrint(BCLog::COINJOIN, "CCoinJoinServer::%s -- ERROR: collateral not valid!\n", __func__);
+    if (!CoinJoin::IsCollateralValid(m_server.mempool, *entry.txCollateral)) {
+        LogPrint(BCLog::COINJOIN, "CCoinJoinServerSession::%s -- ERROR: collateral not valid!\n", __func__);
         nMessageIDRet = ERR_INVALID_COLLATERAL;
         return false;
     }
 
     if (entry.vecTxDSIn.size() > COINJOIN_ENTRY_MAX_SIZE) {
-        LogPrint(BCLog::COINJOIN, "CCoinJoinServer::%s -- ERROR: too many inputs! %d/%d\n", __func__, entry.vecTxDSIn.size(), COINJOIN_ENTRY_MAX_SIZE);
+        LogPrint(BCLog::COINJOIN, "CCoinJoinServerSession::%s -- ERROR: too many inputs! %d/%d\n", __func__, entry.vecTxDSIn.size(), COINJOIN_ENTRY_MAX_SIZE);
         nMessageIDRet = ERR_MAXIMUM;
-        ConsumeCollateral(entry.txCollateral);
+        m_server.ConsumeCollateral(entry.txCollateral);
         return false;
     }
 
     std::vector<CTxIn> vin;
     for (const auto& txin : entry.vecTxDSIn) {
-        LogPrint(BCLog::COINJOIN, "CCoinJoinServer::%s -- txin=%s\n", __func__, txin.ToString());
+        LogPrint(BCLog::COINJOIN, "CCoinJoinServerSession::%s -- txin=%s\n", __func__, txin.ToString());
         LOCK(cs_coinjoin);
         for (const auto& inner_entry : vecEntries) {
             if (ranges::any_of(inner_entry.vecTxDSIn,
                             [&txin](const auto& txdsin){
                                     return txdsin.prevout == txin.prevout;
                             })) {
-                LogPrint(BCLog::COINJOIN, "CCoinJoinServer::%s -- ERROR: already have this txin in entries\n", __func__);
+                LogPrint(BCLog::COINJOIN, "CCoinJoinServerSession::%s -- ERROR: already have this txin in entries\n", __func__);
                 nMessageIDRet = ERR_ALREADY_HAVE;
                 // Two peers sent the same input? Can't really say who is the malicious one here,
                 // could be that someone is picking someone else's inputs randomly trying to force
@@ -607,62 +841,62 @@ bool CCoinJoinServer::AddEntry(const CCoinJoinEntry& entry, PoolMessage& nMessag
     }
 
     bool fConsumeCollateral{false};
-    if (!IsValidInOuts(mempool, vin, entry.vecTxOut, nMessageIDRet, &fConsumeCollateral)) {
-        LogPrint(BCLog::COINJOIN, "CCoinJoinServer::%s -- ERROR! IsValidInOuts() failed: %s\n", __func__, CoinJoin::GetMessageByID(nMessageIDRet).translated);
+    if (!IsValidInOuts(m_server.mempool, vin, entry.vecTxOut, nMessageIDRet, &fConsumeCollateral)) {
+        LogPrint(BCLog::COINJOIN, "CCoinJoinServerSession::%s -- ERROR! IsValidInOuts() failed: %s\n", __func__, CoinJoin::GetMessageByID(nMessageIDRet).translated);
         if (fConsumeCollateral) {
-            ConsumeCollateral(entry.txCollateral);
+            m_server.ConsumeCollateral(entry.txCollateral);
         }
         return false;
     }
 
     WITH_LOCK(cs_coinjoin, vecEntries.push_back(entry));
 
-    LogPrint(BCLog::COINJOIN, "CCoinJoinServer::%s -- adding entry %d of %d required\n", __func__, GetEntriesCount(), CoinJoin::GetMaxPoolParticipants());
+    LogPrint(BCLog::COINJOIN, "CCoinJoinServerSession::%s -- adding entry %d of %d required\n", __func__, GetEntriesCount(), CoinJoin::GetMaxPoolParticipants());
     nMessageIDRet = MSG_ENTRIES_ADDED;
 
     return true;
 }
 
-bool CCoinJoinServer::AddScriptSig(const CTxIn& txinNew)
+bool CCoinJoinServerSession::AddScriptSig(const CTxIn& txinNew)
 {
     AssertLockNotHeld(cs_coinjoin);
-    LogPrint(BCLog::COINJOIN, "CCoinJoinServer::AddScriptSig -- scriptSig=%s\n", ScriptToAsmStr(txinNew.scriptSig).substr(0, 24));
+    LogPrint(BCLog::COINJOIN, "CCoinJoinServerSession::AddScriptSig -- scriptSig=%s\n", ScriptToAsmStr(txinNew.scriptSig).substr(0, 24));
 
     LOCK(cs_coinjoin);
     for (const auto& entry : vecEntries) {
         if (ranges::any_of(entry.vecTxDSIn,
                         [&txinNew](const auto& txdsin){ return txdsin.scriptSig == txinNew.scriptSig; })){
-            LogPrint(BCLog::COINJOIN, "CCoinJoinServer::AddScriptSig -- already exists\n");
+            LogPrint(BCLog::COINJOIN, "CCoinJoinServerSession::AddScriptSig -- already exists\n");
             return false;
         }
     }
 
     if (!IsInputScriptSigValid(txinNew)) {
-        LogPrint(BCLog::COINJOIN, "CCoinJoinServer::AddScriptSig -- Invalid scriptSig\n");
+        LogPrint(BCLog::COINJOIN, "CCoinJoinServerSession::AddScriptSig -- Invalid scriptSig\n");
         return false;
     }
 
-    LogPrint(BCLog::COINJOIN, "CCoinJoinServer::AddScriptSig -- scriptSig=%s new\n", ScriptToAsmStr(txinNew.scriptSig).substr(0, 24));
+    LogPrint(BCLog::COINJOIN, "CCoinJoinServerSession::AddScriptSig -- scriptSig=%s new\n", ScriptToAsmStr(txinNew.scriptSig).substr(0, 24));
 
     for (auto& txin : finalMutableTransaction.vin) {
         if (txin.prevout == txinNew.prevout && txin.nSequence == txinNew.nSequence) {
             txin.scriptSig = txinNew.scriptSig;
-            LogPrint(BCLog::COINJOIN, "CCoinJoinServer::AddScriptSig -- adding to finalMutableTransaction, scriptSig=%s\n", ScriptToAsmStr(txinNew.scriptSig).substr(0, 24));
+            LogPrint(BCLog::COINJOIN, "CCoinJoinServerSession::AddScriptSig -- adding to finalMutableTransaction, scriptSig=%s\n", ScriptToAsmStr(txinNew.scriptSig).substr(0, 24));
         }
     }
     for (auto& entry : vecEntries) {
         if (entry.AddScriptSig(txinNew)) {
-            LogPrint(BCLog::COINJOIN, "CCoinJoinServer::AddScriptSig -- adding to entries, scriptSig=%s\n", ScriptToAsmStr(txinNew.scriptSig).substr(0, 24));
+            LogPrint(BCLog::COINJOIN, "CCoinJoinServerSession::AddScriptSig -- adding to entries, scriptSig=%s\n", ScriptToAsmStr(txinNew.scriptSig).substr(0, 24));
             return true;
         }
     }
 
-    LogPrint(BCLog::COINJOIN, "CCoinJoinServer::AddScriptSig -- Couldn't set sig!\n");
+    LogPrint(BCLog::COINJOIN, "CCoinJoinServerSession::AddScriptSig -- Couldn't set sig!\n");
     return false;
 }
 
 // Check to make sure everything is signed
-bool CCoinJoinServer::IsSignaturesComplete() const
+bool CCoinJoinServerSession::IsSignaturesComplete() const
 {
     AssertLockNotHeld(cs_coinjoin);
     LOCK(cs_coinjoin);
@@ -672,20 +906,20 @@ bool CCoinJoinServer::IsSignaturesComplete() const
     });
 }
 
-bool CCoinJoinServer::IsAcceptableDSA(const CCoinJoinAccept& dsa, PoolMessage& nMessageIDRet) const
+bool CCoinJoinServerSession::IsAcceptableDSA(const CCoinJoinAccept& dsa, PoolMessage& nMessageIDRet) const
 {
     if (!fMasternodeMode) return false;
 
     // is denom even something legit?
     if (!CoinJoin::IsValidDenomination(dsa.nDenom)) {
-        LogPrint(BCLog::COINJOIN, "CCoinJoinServer::%s -- denom not valid!\n", __func__);
+        LogPrint(BCLog::COINJOIN, "CCoinJoinServerSession::%s -- denom not valid!\n", __func__);
         nMessageIDRet = ERR_DENOM;
         return false;
     }
 
     // check collateral
-    if (!fUnitTest && !CoinJoin::IsCollateralValid(mempool, CTransaction(dsa.txCollateral))) {
-        LogPrint(BCLog::COINJOIN, "CCoinJoinServer::%s -- collateral not valid!\n", __func__);
+    if (!m_server.fUnitTest && !CoinJoin::IsCollateralValid(m_server.mempool, CTransaction(dsa.txCollateral))) {
+        LogPrint(BCLog::COINJOIN, "CCoinJoinServerSession::%s -- collateral not valid!\n", __func__);
         nMessageIDRet = ERR_INVALID_COLLATERAL;
         return false;
     }
@@ -693,14 +927,15 @@ bool CCoinJoinServer::IsAcceptableDSA(const CCoinJoinAccept& dsa, PoolMessage& n
     return true;
 }
 
-bool CCoinJoinServer::CreateNewSession(const CCoinJoinAccept& dsa, PoolMessage& nMessageIDRet)
+bool CCoinJoinServerSession::CreateNewSession(const CCoinJoinAccept& dsa, PoolMessage& nMessageIDRet)
 {
+    LOCK(cs_session);
     if (!fMasternodeMode || nSessionID != 0) return false;
 
     // new session can only be started in idle mode
     if (nState != POOL_STATE_IDLE) {
         nMessageIDRet = ERR_MODE;
-        LogPrint(BCLog::COINJOIN, "CCoinJoinServer::CreateNewSession -- incompatible mode: nState=%d\n", nState);
+        LogPrint(BCLog::COINJOIN, "CCoinJoinServerSession::CreateNewSession -- incompatible mode: nState=%d\n", nState);
         return false;
     }
 
@@ -715,28 +950,30 @@ bool CCoinJoinServer::CreateNewSession(const CCoinJoinAccept& dsa, PoolMessage&
 
     SetState(POOL_STATE_QUEUE);
 
-    if (!fUnitTest) {
-        //broadcast that I'm accepting entries, only if it's the first entry through
-        CCoinJoinQueue dsq(nSessionDenom,
-                            WITH_LOCK(activeMasternodeInfoCs, return activeMasternodeInfo.outpoint),
-                            WITH_LOCK(activeMasternodeInfoCs, return activeMasternodeInfo.proTxHash),
-                            GetAdjustedTime(), false);
-        LogPrint(BCLog::COINJOIN, "CCoinJoinServer::CreateNewSession -- signing and relaying new queue: %s\n", dsq.ToString());
-        dsq.Sign();
-        dsq.Relay(connman);
-        LOCK(cs_vecqueue);
-        vecCoinJoinQueue.push_back(dsq);
+    //broadcast that I'm accepting entries, only if it's the first entry through
+    CCoinJoinQueue dsq(nSessionDenom,
+                        WITH_LOCK(activeMasternodeInfoCs, return activeMasternodeInfo.outpoint),
+                        WITH_LOCK(activeMasternodeInfoCs, return activeMasternodeInfo.proTxHash),
+                        GetAdjustedTime(), false);
+    LogPrint(BCLog::COINJOIN, "CCoinJoinServerSession::CreateNewSession -- signing and relaying new queue: %s\n", dsq.ToString());
+    dsq.Sign();
+    if (!m_server.fUnitTest) {
+        dsq.Relay(m_server.connman);
     }
+    WITH_LOCK(cs_coinjoin, m_dsq = dsq);
+    WITH_LOCK(m_server.cs_vecqueue, m_server.vecCoinJoinQueue.push_back(dsq));
 
     vecSessionCollaterals.push_back(MakeTransactionRef(dsa.txCollateral));
-    LogPrint(BCLog::COINJOIN, "CCoinJoinServer::CreateNewSession -- new session created, nSessionID: %d  nSessionDenom: %d (%s)  vecSessionCollaterals.size(): %d  CoinJoin::GetMaxPoolParticipants(): %d\n",
+    nParticipants = vecSessionCollaterals.size();
+    LogPrint(BCLog::COINJOIN, "CCoinJoinServerSession::CreateNewSession -- new session created, nSessionID: %d  nSessionDenom: %d (%s)  vecSessionCollaterals.size(): %d  CoinJoin::GetMaxPoolParticipants(): %d\n",
         nSessionID, nSessionDenom, CoinJoin::DenominationToString(nSessionDenom), vecSessionCollaterals.size(), CoinJoin::GetMaxPoolParticipants());
 
     return true;
 }
 
-bool CCoinJoinServer::AddUserToExistingSession(const CCoinJoinAccept& dsa, PoolMessage& nMessageIDRet)
+bool CCoinJoinServerSession::AddUserToExistingSession(const CCoinJoinAccept& dsa, PoolMessage& nMessageIDRet)
 {
+    LOCK(cs_session);
     if (!fMasternodeMode || nSessionID == 0 || IsSessionReady()) return false;
 
     if (!IsAcceptableDSA(dsa, nMessageIDRet)) {
@@ -746,12 +983,12 @@ bool CCoinJoinServer::AddUserToExistingSession(const CCoinJoinAccept& dsa, PoolM
     // we only add new users to an existing session when we are in queue mode
     if (nState != POOL_STATE_QUEUE) {
         nMessageIDRet = ERR_MODE;
-        LogPrint(BCLog::COINJOIN, "CCoinJoinServer::AddUserToExistingSession -- incompatible mode: nState=%d\n", nState);
+        LogPrint(BCLog::COINJOIN, "CCoinJoinServerSession::AddUserToExistingSession -- incompatible mode: nState=%d\n", nState);
         return false;
     }
 
     if (dsa.nDenom != nSessionDenom) {
-        LogPrint(BCLog::COINJOIN, "CCoinJoinServer::AddUserToExistingSession -- incompatible denom %d (%s) != nSessionDenom %d (%s)\n",
+        LogPrint(BCLog::COINJOIN, "CCoinJoinServerSession::AddUserToExistingSession -- incompatible denom %d (%s) != nSessionDenom %d (%s)\n",
             dsa.nDenom, CoinJoin::DenominationToString(dsa.nDenom), nSessionDenom, CoinJoin::DenominationToString(nSessionDenom));
         nMessageIDRet = ERR_DENOM;
         return false;
@@ -761,21 +998,27 @@ bool CCoinJoinServer::AddUserToExistingSession(const CCoinJoinAccept& dsa, PoolM
 
     nMessageIDRet = MSG_NOERR;
     vecSessionCollaterals.push_back(MakeTransactionRef(dsa.txCollateral));
+    nParticipants = vecSessionCollaterals.size();
 
-    LogPrint(BCLog::COINJOIN, "CCoinJoinServer::AddUserToExistingSession -- new user accepted, nSessionID: %d  nSessionDenom: %d (%s)  vecSessionCollaterals.size(): %d  CoinJoin::GetMaxPoolParticipants(): %d\n",
+    LogPrint(BCLog::COINJOIN, "CCoinJoinServerSession::AddUserToExistingSession -- new user accepted, nSessionID: %d  nSessionDenom: %d (%s)  vecSessionCollaterals.size(): %d  CoinJoin::GetMaxPoolParticipants(): %d\n",
         nSessionID, nSessionDenom, CoinJoin::DenominationToString(nSessionDenom), vecSessionCollaterals.size(), CoinJoin::GetMaxPoolParticipants());
 
+    // the session may be complete now, don't wait for its timer
+    if (IsSessionReady()) {
+        CheckForCompleteQueue();
+    }
+
     return true;
 }
 
 // Returns true if either max size has been reached or if the mix timed out and min size was reached
-bool CCoinJoinServer::IsSessionReady() const
+bool CCoinJoinServerSession::IsSessionReady() const
 {
     if (nState == POOL_STATE_QUEUE) {
-        if ((int)vecSessionCollaterals.size() >= CoinJoin::GetMaxPoolParticipants()) {
+        if (nParticipants >= CoinJoin::GetMaxPoolParticipants()) {
             return true;
         }
-        if (CCoinJoinServer::HasTimedOut() && (int)vecSessionCollaterals.size() >= CoinJoin::GetMinPoolParticipants()) {
+        if (HasTimedOut() && nParticipants >= CoinJoin::GetMinPoolParticipants()) {
             return true;
         }
     }
@@ -785,17 +1028,17 @@ bool CCoinJoinServer::IsSessionReady() const
     return false;
 }
 
-void CCoinJoinServer::RelayFinalTransaction(const CTransaction& txFinal)
+void CCoinJoinServerSession::RelayFinalTransaction(const CTransaction& txFinal)
 {
     AssertLockHeld(cs_coinjoin);
-    LogPrint(BCLog::COINJOIN, "CCoinJoinServer::%s -- nSessionID: %d  nSessionDenom: %d (%s)\n",
+    LogPrint(BCLog::COINJOIN, "CCoinJoinServerSession::%s -- nSessionID: %d  nSessionDenom: %d (%s)\n",
         __func__, nSessionID, nSessionDenom, CoinJoin::DenominationToString(nSessionDenom));
 
     // final mixing tx with empty signatures should be relayed to mixing participants only
     for (const auto& entry : vecEntries) {
-        bool fOk = connman.ForNode(entry.addr, [&txFinal, this](CNode* pnode) {
+        bool fOk = m_server.connman.ForNode(entry.addr, [&txFinal, this](CNode* pnode) {
             CNetMsgMaker msgMaker(pnode->GetSendVersion());
-            connman.PushMessage(pnode, msgMaker.Make(NetMsgType::DSFINALTX, nSessionID.load(), txFinal));
+            m_server.connman.PushMessage(pnode, msgMaker.Make(NetMsgType::DSFINALTX, nSessionID.load(), txFinal));
             return true;
         });
         if (!fOk) {
@@ -806,20 +1049,20 @@ void CCoinJoinServer::RelayFinalTransaction(const CTransaction& txFinal)
     }
 }
 
-void CCoinJoinServer::PushStatus(CNode& peer, PoolStatusUpdate nStatusUpdate, PoolMessage nMessageID) const
+void CCoinJoinServerSession::PushStatus(CNode& peer, PoolStatusUpdate nStatusUpdate, PoolMessage nMessageID) const
 {
     CCoinJoinStatusUpdate psssup(nSessionID, nState, 0, nStatusUpdate, nMessageID);
-    connman.PushMessage(&peer, CNetMsgMaker(peer.GetSendVersion()).Make(NetMsgType::DSSTATUSUPDATE, psssup));
+    m_server.connman.PushMessage(&peer, CNetMsgMaker(peer.GetSendVersion()).Make(NetMsgType::DSSTATUSUPDATE, psssup));
 }
 
-void CCoinJoinServer::RelayStatus(PoolStatusUpdate nStatusUpdate, PoolMessage nMessageID)
+void CCoinJoinServerSession::RelayStatus(PoolStatusUpdate nStatusUpdate, PoolMessage nMessageID)
 {
     AssertLockHeld(cs_coinjoin);
     unsigned int nDisconnected{};
     // status updates should be relayed to mixing participants only
     for (const auto& entry : vecEntries) {
         // make sure everyone is still connected
-        bool fOk = connman.ForNode(entry.addr, [&nStatusUpdate, &nMessageID, this](CNode* pnode) {
+        bool fOk = m_server.connman.ForNode(entry.addr, [&nStatusUpdate, &nMessageID, this](CNode* pnode) {
             PushStatus(*pnode, nStatusUpdate, nMessageID);
             return true;
         });
@@ -831,12 +1074,12 @@ void CCoinJoinServer::RelayStatus(PoolStatusUpdate nStatusUpdate, PoolMessage nM
     if (nDisconnected == 0) return; // all is clear
 
     // something went wrong
-    LogPrint(BCLog::COINJOIN, "CCoinJoinServer::%s -- can't continue, %llu client(s) disconnected, nSessionID: %d  nSessionDenom: %d (%s)\n",
+    LogPrint(BCLog::COINJOIN, "CCoinJoinServerSession::%s -- can't continue, %llu client(s) disconnected, nSessionID: %d  nSessionDenom: %d (%s)\n",
         __func__, nDisconnected, nSessionID, nSessionDenom, CoinJoin::DenominationToString(nSessionDenom));
 
     // notify everyone else that this session should be terminated
     for (const auto& entry : vecEntries) {
-        connman.ForNode(entry.addr, [this](CNode* pnode) {
+        m_server.connman.ForNode(entry.addr, [this](CNode* pnode) {
             PushStatus(*pnode, STATUS_REJECTED, MSG_NOERR);
             return true;
         });
@@ -845,22 +1088,22 @@ void CCoinJoinServer::RelayStatus(PoolStatusUpdate nStatusUpdate, PoolMessage nM
     if (nDisconnected == vecEntries.size()) {
         // all clients disconnected, there is probably some issues with our own connection
         // do not charge any fees, just reset the pool
-        SetNull();
+        Finish(false);
     }
 }
 
-void CCoinJoinServer::RelayCompletedTransaction(PoolMessage nMessageID)
+void CCoinJoinServerSession::RelayCompletedTransaction(PoolMessage nMessageID)
 {
     AssertLockNotHeld(cs_coinjoin);
-    LogPrint(BCLog::COINJOIN, "CCoinJoinServer::%s -- nSessionID: %d  nSessionDenom: %d (%s)\n",
+    LogPrint(BCLog::COINJOIN, "CCoinJoinServerSession::%s -- nSessionID: %d  nSessionDenom: %d (%s)\n",
         __func__, nSessionID, nSessionDenom, CoinJoin::DenominationToString(nSessionDenom));
 
     // final mixing tx with empty signatures should be relayed to mixing participants only
     LOCK(cs_coinjoin);
     for (const auto& entry : vecEntries) {
-        bool fOk = connman.ForNode(entry.addr, [&nMessageID, this](CNode* pnode) {
+        bool fOk = m_server.connman.ForNode(entry.addr, [&nMessageID, this](CNode* pnode) {
             CNetMsgMaker msgMaker(pnode->GetSendVersion());
-            connman.PushMessage(pnode, msgMaker.Make(NetMsgType::DSCOMPLETE, nSessionID.load(), nMessageID));
+            m_server.connman.PushMessage(pnode, msgMaker.Make(NetMsgType::DSCOMPLETE, nSessionID.load(), nMessageID));
             return true;
         });
         if (!fOk) {
@@ -871,37 +1114,32 @@ void CCoinJoinServer::RelayCompletedTransaction(PoolMessage nMessageID)
     }
 }
 
-void CCoinJoinServer::SetState(PoolState nStateNew)
+void CCoinJoinServerSession::SetState(PoolState nStateNew)
 {
     if (!fMasternodeMode) return;
 
     if (nStateNew == POOL_STATE_ERROR) {
-        LogPrint(BCLog::COINJOIN, "CCoinJoinServer::SetState -- Can't set state to ERROR as a Masternode. \n");
+        LogPrint(BCLog::COINJOIN, "CCoinJoinServerSession::SetState -- Can't set state to ERROR as a Masternode. \n");
         return;
     }
 
-    LogPrint(BCLog::COINJOIN, "CCoinJoinServer::SetState -- nState: %d, nStateNew: %d\n", nState, nStateNew);
+    LogPrint(BCLog::COINJOIN, "CCoinJoinServerSession::SetState -- nState: %d, nStateNew: %d\n", nState, nStateNew);
     nTimeLastSuccessfulStep = GetTime();
     nState = nStateNew;
-}
-
-void CCoinJoinServer::DoMaintenance()
-{
-    if (!fMasternodeMode) return; // only run on masternodes
-    if (!m_mn_sync.IsBlockchainSynced()) return;
-    if (ShutdownRequested()) return;
 
-    CheckForCompleteQueue();
-    CheckPool();
-    CheckTimeout();
+    // check back once the new step times out
+    m_server.ScheduleCheck(shared_from_this(), std::chrono::seconds{GetTimeUntilTimeout()});
 }
 
-void CCoinJoinServer::GetJsonInfo(UniValue& obj) const
+void CCoinJoinServerSession::GetJsonInfo(UniValue& obj) const
 {
+    LOCK(cs_session);
     obj.clear();
     obj.setObject();
-    obj.pushKV("queue_size",    GetQueueSize());
+    obj.pushKV("session_id",    nSessionID.load());
     obj.pushKV("denomination",  ValueFromAmount(CoinJoin::DenominationToAmount(nSessionDenom)));
     obj.pushKV("state",         GetStateString());
+    obj.pushKV("participants",  GetParticipantsCount());
     obj.pushKV("entries_count", GetEntriesCount());
+    obj.pushKV("age",           GetTime() - nTimeCreated);
 }
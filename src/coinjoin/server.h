@@ -9,29 +9,49 @@
 
 #include <net_types.h>
 
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <optional>
+#include <thread>
+
 class CChainState;
 class CCoinJoinServer;
+class CConnman;
 class CDataStream;
+class CMasternodeSync;
 class CNode;
+class CScheduler;
 class CTxMemPool;
 
 class UniValue;
 
-/** Used to keep track of current status of mixing pool
+using NodeId = int64_t;
+
+/** Maximum number of mixing sessions a masternode hosts at the same time */
+static constexpr int COINJOIN_SERVER_MAX_SESSIONS = 4;
+
+/** A single mixing session hosted by this masternode, sessions are never reused once they finished
  */
-class CCoinJoinServer : public CCoinJoinBaseSession, public CCoinJoinBaseManager
+class CCoinJoinServerSession : public CCoinJoinBaseSession, public std::enable_shared_from_this<CCoinJoinServerSession>
 {
 private:
-    CChainState& m_chainstate;
-    CConnman& connman;
-    CTxMemPool& mempool;
-    const CMasternodeSync& m_mn_sync;
+    CCoinJoinServer& m_server;
+
+    // Serializes all state transitions of this session, they are triggered both by
+    // messages of the participants and by the timers of the server
+    mutable Mutex cs_session;
 
     // Mixing uses collateral transactions to trust parties entering the pool
     // to behave honestly. If they don't it takes their money.
     std::vector<CTransactionRef> vecSessionCollaterals;
 
-    bool fUnitTest;
+    const int64_t nTimeCreated;
+    std::atomic<int> nParticipants{0};
+    // The queue this session announced to find participants, it's forgotten once the session finishes
+    std::optional<CCoinJoinQueue> m_dsq GUARDED_BY(cs_coinjoin);
+    std::atomic<bool> fFinished{false};
 
     /// Add a clients entry to the pool
     bool AddEntry(const CCoinJoinEntry& entry, PoolMessage& nMessageIDRet) LOCKS_EXCLUDED(cs_coinjoin);
@@ -42,19 +62,15 @@ private:
     void ChargeFees() const LOCKS_EXCLUDED(cs_coinjoin);
     /// Rarely charge fees to pay miners
     void ChargeRandomFees() const;
-    /// Consume collateral in cases when peer misbehaved
-    void ConsumeCollateral(const CTransactionRef& txref) const;
 
     /// Check for process
-    void CheckPool();
+    void CheckPool() EXCLUSIVE_LOCKS_REQUIRED(cs_session);
 
     void CreateFinalTransaction() LOCKS_EXCLUDED(cs_coinjoin);
-    void CommitFinalTransaction() LOCKS_EXCLUDED(cs_coinjoin);
+    void CommitFinalTransaction() EXCLUSIVE_LOCKS_REQUIRED(cs_session) LOCKS_EXCLUDED(cs_coinjoin);
 
     /// Is this nDenom and txCollateral acceptable?
     bool IsAcceptableDSA(const CCoinJoinAccept& dsa, PoolMessage& nMessageIDRet) const;
-    bool CreateNewSession(const CCoinJoinAccept& dsa, PoolMessage& nMessageIDRet) LOCKS_EXCLUDED(cs_vecqueue);
-    bool AddUserToExistingSession(const CCoinJoinAccept& dsa, PoolMessage& nMessageIDRet);
     /// Do we have enough users to take entries?
     bool IsSessionReady() const;
 
@@ -68,32 +84,105 @@ private:
 
     /// Relay mixing Messages
     void RelayFinalTransaction(const CTransaction& txFinal) EXCLUSIVE_LOCKS_REQUIRED(cs_coinjoin);
-    void PushStatus(CNode& peer, PoolStatusUpdate nStatusUpdate, PoolMessage nMessageID) const;
     void RelayStatus(PoolStatusUpdate nStatusUpdate, PoolMessage nMessageID = MSG_NOERR) EXCLUSIVE_LOCKS_REQUIRED(cs_coinjoin);
     void RelayCompletedTransaction(PoolMessage nMessageID) LOCKS_EXCLUDED(cs_coinjoin);
 
-    void ProcessDSACCEPT(CNode& peer, CDataStream& vRecv) LOCKS_EXCLUDED(cs_vecqueue);
+    bool HasTimedOut() const;
+    void CheckTimeout() EXCLUSIVE_LOCKS_REQUIRED(cs_session);
+    void CheckForCompleteQueue();
+
+    /// Ends the session, the server drops it on its next maintenance
+    void Finish(bool fSuccess) EXCLUSIVE_LOCKS_REQUIRED(cs_coinjoin);
+
+public:
+    CCoinJoinServerSession(CCoinJoinServer& server, int64_t nTime) : m_server(server), nTimeCreated(nTime) {}
+
+    bool CreateNewSession(const CCoinJoinAccept& dsa, PoolMessage& nMessageIDRet) LOCKS_EXCLUDED(cs_session);
+    bool AddUserToExistingSession(const CCoinJoinAccept& dsa, PoolMessage& nMessageIDRet) LOCKS_EXCLUDED(cs_session);
+
+    void ProcessDSVIN(CNode& peer, const CCoinJoinEntry& entry) LOCKS_EXCLUDED(cs_session);
+    void ProcessDSSIGNFINALTX(const std::vector<CTxIn>& vecTxIn) LOCKS_EXCLUDED(cs_session);
+
+    void PushStatus(CNode& peer, PoolStatusUpdate nStatusUpdate, PoolMessage nMessageID) const;
+
+    /// Advance the session if it's ready for its next step and end it if it timed out
+    void Check() LOCKS_EXCLUDED(cs_session);
+    /// Seconds until the current step of the session times out
+    int64_t GetTimeUntilTimeout() const;
+
+    bool IsOpen() const { return !fFinished && nState == POOL_STATE_QUEUE && !IsSessionReady(); }
+    bool IsFinished() const { return fFinished; }
+    int GetParticipantsCount() const { return nParticipants; }
+    /// The queue this session announced, if it didn't finish yet
+    std::optional<CCoinJoinQueue> GetQueue() const LOCKS_EXCLUDED(cs_coinjoin) { LOCK(cs_coinjoin); return m_dsq; }
+
+    void GetJsonInfo(UniValue& obj) const LOCKS_EXCLUDED(cs_session);
+};
+
+/** Hosts the mixing sessions of this masternode and routes the messages of their participants
+ */
+class CCoinJoinServer : public CCoinJoinBaseManager
+{
+private:
+    friend class CCoinJoinServerSession;
+
+    CChainState& m_chainstate;
+    CConnman& connman;
+    CTxMemPool& mempool;
+    const CMasternodeSync& m_mn_sync;
+
+    mutable Mutex cs_sessions;
+    std::vector<std::shared_ptr<CCoinJoinServerSession>> vecSessions GUARDED_BY(cs_sessions);
+    std::map<NodeId, std::shared_ptr<CCoinJoinServerSession>> mapPeerSessions GUARDED_BY(cs_sessions);
+
+    std::atomic<uint64_t> nSessionsCompleted{0};
+    std::atomic<uint64_t> nSessionsFailed{0};
+
+    // Runs the session timers and commits the final transactions, so that neither happens on the message handler thread
+    std::unique_ptr<CScheduler> scheduler;
+    std::unique_ptr<std::thread> scheduler_thread;
+
+    /// Consume collateral in cases when peer misbehaved
+    void ConsumeCollateral(const CTransactionRef& txref) const;
+
+    /// Schedule a check of the session after the given delay, only immediate checks run without the scheduler
+    void ScheduleCheck(const std::shared_ptr<CCoinJoinServerSession>& session, std::chrono::milliseconds delay);
+
+    void PushStatus(CNode& peer, PoolStatusUpdate nStatusUpdate, PoolMessage nMessageID) const;
+
+    void ProcessDSACCEPT(CNode& peer, CDataStream& vRecv) LOCKS_EXCLUDED(cs_vecqueue, cs_sessions);
     PeerMsgRet ProcessDSQUEUE(const CNode& peer, CDataStream& vRecv) LOCKS_EXCLUDED(cs_vecqueue);
-    void ProcessDSVIN(CNode& peer, CDataStream& vRecv) LOCKS_EXCLUDED(cs_coinjoin);
-    void ProcessDSSIGNFINALTX(CDataStream& vRecv) LOCKS_EXCLUDED(cs_coinjoin);
+    void ProcessDSVIN(CNode& peer, CDataStream& vRecv) LOCKS_EXCLUDED(cs_sessions);
+    void ProcessDSSIGNFINALTX(CNode& peer, CDataStream& vRecv) LOCKS_EXCLUDED(cs_sessions);
+
+protected:
+    bool fUnitTest;
 
-    void SetNull() EXCLUSIVE_LOCKS_REQUIRED(cs_coinjoin);
+    /// Forget the queue of the session, other masternodes' queues stay to keep rate limiting them
+    void OnSessionFinished(bool fSuccess, const std::optional<CCoinJoinQueue>& dsq) LOCKS_EXCLUDED(cs_vecqueue);
+    /// Whether a queue of this masternode is still gathering participants, the queues of sessions which moved on
+    /// to entries and signing don't hold back new sessions
+    bool HasOpenOwnQueue() const LOCKS_EXCLUDED(cs_vecqueue, cs_sessions);
+
+    /// Pick the session a DSACCEPT of the peer is meant for, sessionRet is left empty if a new session should be started
+    bool SelectSession(NodeId nodeid, std::shared_ptr<CCoinJoinServerSession>& sessionRet, PoolMessage& nMessageIDRet) const LOCKS_EXCLUDED(cs_sessions);
+    /// Add the peer to the session or start a new one, further messages of the peer are routed to it
+    bool JoinSession(NodeId nodeid, std::shared_ptr<CCoinJoinServerSession>& session, const CCoinJoinAccept& dsa, PoolMessage& nMessageIDRet) LOCKS_EXCLUDED(cs_sessions);
+
+    /// The session the peer participates in, if any
+    std::shared_ptr<CCoinJoinServerSession> GetPeerSession(NodeId nodeid) const LOCKS_EXCLUDED(cs_sessions);
+    /// Drop finished sessions and forget about their participants
+    void CleanupSessions() LOCKS_EXCLUDED(cs_sessions);
+    size_t GetSessionsCount() const LOCKS_EXCLUDED(cs_sessions) { LOCK(cs_sessions); return vecSessions.size(); }
 
 public:
-    explicit CCoinJoinServer(CChainState& chainstate, CConnman& _connman, CTxMemPool& mempool, const CMasternodeSync& mn_sync) :
-        m_chainstate(chainstate),
-        connman(_connman),
-        mempool(mempool),
-        m_mn_sync(mn_sync),
-        vecSessionCollaterals(),
-        fUnitTest(false)
-    {}
+    explicit CCoinJoinServer(CChainState& chainstate, CConnman& _connman, CTxMemPool& mempool, const CMasternodeSync& mn_sync);
+    ~CCoinJoinServer();
 
-    PeerMsgRet ProcessMessage(CNode& pfrom, std::string_view msg_type, CDataStream& vRecv);
+    void Start();
+    void Stop();
 
-    bool HasTimedOut() const;
-    void CheckTimeout();
-    void CheckForCompleteQueue();
+    PeerMsgRet ProcessMessage(CNode& pfrom, std::string_view msg_type, CDataStream& vRecv);
 
     void DoMaintenance();
 
@@ -7,8 +7,11 @@
 #include <consensus/consensus.h>
 #include <logging.h>
 #include <random.h>
+#include <util/metrics.h>
 #include <version.h>
 
+#include <mutex>
+
 bool CCoinsView::GetCoin(const COutPoint &outpoint, Coin &coin) const { return false; }
 uint256 CCoinsView::GetBestBlock() const { return uint256(); }
 std::vector<uint256> CCoinsView::GetHeadBlocks() const { return std::vector<uint256>(); }
@@ -259,6 +262,15 @@ void CCoinsViewCache::ReallocateCache()
     ::new (&cacheCoins) CCoinsMap();
 }
 
+void CCoinsViewCache::ForEachDirtyCoin(const std::function<void(const COutPoint&, const Coin&)>& func) const
+{
+    for (const auto& [outpoint, entry] : cacheCoins) {
+        if (entry.flags & CCoinsCacheEntry::DIRTY) {
+            func(outpoint, entry.coin);
+        }
+    }
+}
+
 static const size_t MAX_OUTPUTS_PER_BLOCK = MaxBlockSize() /  ::GetSerializeSize(CTxOut(), PROTOCOL_VERSION);
 
 const Coin& AccessByTxid(const CCoinsViewCache& view, const uint256& txid)
@@ -272,6 +284,143 @@ const Coin& AccessByTxid(const CCoinsViewCache& view, const uint256& txid)
     return coinEmpty;
 }
 
+CCoinsReadCache::Shard& CCoinsReadCache::GetShard(const COutPoint& outpoint) const
+{
+    return m_shards[m_shard_hasher(outpoint) % SHARDS];
+}
+
+void CCoinsReadCache::Clear()
+{
+    for (auto& shard : m_shards) {
+        LOCK(shard.cs);
+        shard.coins.clear();
+        shard.clean_count = 0;
+        shard.cached_coins_usage = 0;
+    }
+}
+
+void CCoinsReadCache::AddChanges(const CCoinsViewCache& view)
+{
+    view.ForEachDirtyCoin([this](const COutPoint& outpoint, const Coin& coin) {
+        auto& shard = GetShard(outpoint);
+        LOCK(shard.cs);
+        auto [it, inserted] = shard.coins.try_emplace(outpoint);
+        if (!inserted) {
+            if (!it->second.dirty) --shard.clean_count;
+            shard.cached_coins_usage -= it->second.coin.DynamicMemoryUsage();
+        }
+        it->second = Entry{coin, true};
+        shard.cached_coins_usage += coin.DynamicMemoryUsage();
+    });
+}
+
+void CCoinsReadCache::Reset()
+{
+    std::unique_lock lock(m_mutex);
+    m_base = nullptr;
+    m_best_block.SetNull();
+    m_best_height = -1;
+    Clear();
+}
+
+void CCoinsReadCache::Reset(CCoinsView& base, const CCoinsViewCache& tip, int best_height)
+{
+    std::unique_lock lock(m_mutex);
+    m_base = &base;
+    m_best_block = tip.GetBestBlock();
+    m_best_height = best_height;
+    Clear();
+    AddChanges(tip);
+}
+
+void CCoinsReadCache::ApplyChanges(const CCoinsViewCache& view, int best_height)
+{
+    std::unique_lock lock(m_mutex);
+    if (m_base == nullptr) return;
+    AddChanges(view);
+    m_best_block = view.GetBestBlock();
+    m_best_height = best_height;
+}
+
+bool CCoinsReadCache::IsReady() const
+{
+    std::shared_lock lock(m_mutex);
+    return m_base != nullptr;
+}
+
+size_t CCoinsReadCache::DynamicMemoryUsage() const
+{
+    size_t ret{0};
+    for (auto& shard : m_shards) {
+        LOCK(shard.cs);
+        // empty shards hold nothing a flush would free
+        if (shard.coins.empty()) continue;
+        ret += memusage::DynamicUsage(shard.coins) + shard.cached_coins_usage;
+    }
+    return ret;
+}
+
+Coin CCoinsReadCache::Lookup(const COutPoint& outpoint) const
+{
+    static metrics::Counter& hits = metrics::GetCounter("coins.read_cache.hits");
+    static metrics::Counter& misses = metrics::GetCounter("coins.read_cache.misses");
+
+    auto& shard = GetShard(outpoint);
+    {
+        LOCK(shard.cs);
+        if (const auto it = shard.coins.find(outpoint); it != shard.coins.end()) {
+            hits.Inc();
+            return it->second.coin;
+        }
+    }
+
+    // Nothing can change the database while the caller holds m_mutex, so what is read here can be cached. Spent
+    // (i.e. missing) coins are cached as well, lookups of coins which don't exist are common for CoinJoin.
+    misses.Inc();
+    Coin coin;
+    if (!m_base->GetCoin(outpoint, coin)) coin.Clear();
+
+    LOCK(shard.cs);
+    if (shard.clean_count >= MAX_CLEAN_COINS_PER_SHARD) {
+        for (auto it = shard.coins.begin(); it != shard.coins.end();) {
+            if (it->second.dirty) {
+                ++it;
+                continue;
+            }
+            shard.cached_coins_usage -= it->second.coin.DynamicMemoryUsage();
+            it = shard.coins.erase(it);
+        }
+        shard.clean_count = 0;
+    }
+    if (shard.coins.try_emplace(outpoint, Entry{coin, false}).second) {
+        ++shard.clean_count;
+        shard.cached_coins_usage += coin.DynamicMemoryUsage();
+    }
+    return coin;
+}
+
+bool CCoinsReadCache::GetCoin(const COutPoint& outpoint, Coin& coin) const
+{
+    std::shared_lock lock(m_mutex);
+    if (m_base == nullptr) return false;
+    coin = Lookup(outpoint);
+    return true;
+}
+
+bool CCoinsReadCache::GetCoins(const std::vector<COutPoint>& outpoints, std::vector<Coin>& coins, uint256& best_block, int& best_height) const
+{
+    std::shared_lock lock(m_mutex);
+    if (m_base == nullptr) return false;
+    coins.clear();
+    coins.reserve(outpoints.size());
+    for (const auto& outpoint : outpoints) {
+        coins.push_back(Lookup(outpoint));
+    }
+    best_block = m_best_block;
+    best_height = m_best_height;
+    return true;
+}
+
 bool CCoinsViewErrorCatcher::GetCoin(const COutPoint &outpoint, Coin &coin) const {
     try {
         return CCoinsViewBacked::GetCoin(outpoint, coin);
@@ -11,13 +11,16 @@
 #include <memusage.h>
 #include <primitives/transaction.h>
 #include <serialize.h>
+#include <sync.h>
 #include <uint256.h>
 #include <util/hasher.h>
 
 #include <assert.h>
 #include <stdint.h>
 
+#include <array>
 #include <functional>
+#include <shared_mutex>
 #include <unordered_map>
 
 /**
@@ -304,6 +307,9 @@ public:
     //! Check whether all prevouts of the transaction are present in the UTXO set represented by this view
     bool HaveInputs(const CTransaction& tx) const;
 
+    //! Call func for every coin modified in this cache and not flushed yet, spent ones included
+    void ForEachDirtyCoin(const std::function<void(const COutPoint&, const Coin&)>& func) const;
+
     //! Force a reallocation of the cache map. This is required when downsizing
     //! the cache because the map's allocator may be hanging onto a lot of
     //! memory despite having called .clear().
@@ -333,6 +339,73 @@ void AddCoins(CCoinsViewCache& cache, const CTransaction& tx, int nHeight, bool
 //! lookups to database, so it should be used with care.
 const Coin& AccessByTxid(const CCoinsViewCache& cache, const uint256& txid);
 
+/**
+ * Read-only view of the UTXO set of a chainstate which can be used without cs_main.
+ *
+ * Coins changed since the chainstate was last flushed to its coins database are kept here and updated together
+ * with the chain tip, everything else is read from the database and cached. Coins are split into shards by
+ * outpoint, each with its own lock, so that concurrent readers don't contend with each other. Applying the
+ * changes of a block locks out readers, so they always see the UTXO set as of a whole block.
+ *
+ * The cache is only usable after initial block download, when mirroring the changes of every block doesn't slow
+ * down the sync, and stops being usable when the coins database is changed by anything other than connecting and
+ * disconnecting blocks. Callers fall back to the chainstate under cs_main in the meantime.
+ */
+class CCoinsReadCache
+{
+public:
+    static constexpr size_t SHARDS{16};
+    //! Max number of coins read from the database kept per shard
+    static constexpr size_t MAX_CLEAN_COINS_PER_SHARD{20000};
+
+    //! Make the cache unusable until the next call of the other overload
+    void Reset();
+    /**
+     * Serve reads from tip, the coins cache of the chainstate at best_height, dropping everything cached so far.
+     * The changes tip has not flushed yet are copied, everything else is read from base, its coins database.
+     */
+    void Reset(CCoinsView& base, const CCoinsViewCache& tip, int best_height);
+    //! Add the changes of view, which moves the UTXO set to best_height, if the cache is usable
+    void ApplyChanges(const CCoinsViewCache& view, int best_height);
+
+    bool IsReady() const;
+    //! Memory used by the cached coins, the copies of the unflushed changes make up most of it
+    size_t DynamicMemoryUsage() const;
+    //! Look up a coin, which is spent if it doesn't exist. Returns false if the cache is not usable.
+    bool GetCoin(const COutPoint& outpoint, Coin& coin) const;
+    //! Look up several coins in the same state of the UTXO set. Returns false if the cache is not usable.
+    bool GetCoins(const std::vector<COutPoint>& outpoints, std::vector<Coin>& coins, uint256& best_block, int& best_height) const;
+
+private:
+    struct Entry {
+        Coin coin;
+        //! changed since the last flush and not in the database yet
+        bool dirty{false};
+    };
+    struct Shard {
+        Mutex cs;
+        std::unordered_map<COutPoint, Entry, SaltedOutpointHasher> coins GUARDED_BY(cs);
+        size_t clean_count GUARDED_BY(cs){0};
+        //! Memory used by the coins in the map, not counting the map itself
+        size_t cached_coins_usage GUARDED_BY(cs){0};
+    };
+
+    //! Held shared by readers and exclusively to change the state of the UTXO set the cache represents
+    mutable std::shared_mutex m_mutex;
+    CCoinsView* m_base{nullptr};
+    uint256 m_best_block;
+    int m_best_height{-1};
+    mutable std::array<Shard, SHARDS> m_shards;
+    const SaltedOutpointHasher m_shard_hasher;
+
+    Shard& GetShard(const COutPoint& outpoint) const;
+    //! Require m_mutex to be held exclusively by the caller
+    void Clear();
+    void AddChanges(const CCoinsViewCache& view);
+    //! Requires m_mutex to be held by the caller, shared or exclusively
+    Coin Lookup(const COutPoint& outpoint) const;
+};
+
 /**
  * This is a minimally invasive approach to shutdown on LevelDB read errors from the
  * chainstate, while keeping user interface out of the common library, which is shared
@@ -0,0 +1,172 @@
+// Copyright (c) 2024 The Dash Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <crypto/x11.h>
+#include <crypto/common.h>
+
+#include <crypto/sph_blake.h>
+#include <crypto/sph_bmw.h>
+#include <crypto/sph_cubehash.h>
+#include <crypto/sph_echo.h>
+#include <crypto/sph_groestl.h>
+#include <crypto/sph_jh.h>
+#include <crypto/sph_keccak.h>
+#include <crypto/sph_luffa.h>
+#include <crypto/sph_shavite.h>
+#include <crypto/sph_simd.h>
+#include <crypto/sph_skein.h>
+
+#include <compat/cpuid.h>
+
+namespace x11_aesni
+{
+void Shavite512(const unsigned char* in, unsigned char* out);
+void Shavite512_4way(const unsigned char* in, unsigned char* out);
+void Echo512(const unsigned char* in, unsigned char* out);
+}
+
+// Internal implementation code.
+namespace
+{
+/** Size of the intermediate hashes passed between the X11 rounds */
+constexpr size_t ROUND_SIZE = 64;
+
+/// Portable implementations of the rounds that have an accelerated alternative.
+namespace x11_generic
+{
+void Shavite512(const unsigned char* in, unsigned char* out)
+{
+    sph_shavite512_context ctx;
+    sph_shavite512_init(&ctx);
+    sph_shavite512(&ctx, in, ROUND_SIZE);
+    sph_shavite512_close(&ctx, out);
+}
+
+void Shavite512_4way(const unsigned char* in, unsigned char* out)
+{
+    for (size_t i = 0; i < 4; ++i) {
+        Shavite512(in + i * ROUND_SIZE, out + i * ROUND_SIZE);
+    }
+}
+
+void Echo512(const unsigned char* in, unsigned char* out)
+{
+    sph_echo512_context ctx;
+    sph_echo512_init(&ctx);
+    sph_echo512(&ctx, in, ROUND_SIZE);
+    sph_echo512_close(&ctx, out);
+}
+} // namespace x11_generic
+
+typedef void (*RoundType)(const unsigned char*, unsigned char*);
+
+RoundType Shavite512 = x11_generic::Shavite512;
+RoundType Shavite512_4way = x11_generic::Shavite512_4way;
+RoundType Echo512 = x11_generic::Echo512;
+
+/** The first eight rounds, BLAKE to CubeHash, which only have a portable implementation */
+void HashPrefix(unsigned char* output, const unsigned char* input, size_t len)
+{
+    static const unsigned char blank[1]{};
+    alignas(16) unsigned char buf[ROUND_SIZE];
+
+    sph_blake512_context ctx_blake;
+    sph_blake512_init(&ctx_blake);
+    sph_blake512(&ctx_blake, len == 0 ? blank : input, len);
+    sph_blake512_close(&ctx_blake, output);
+
+    sph_bmw512_context ctx_bmw;
+    sph_bmw512_init(&ctx_bmw);
+    sph_bmw512(&ctx_bmw, output, ROUND_SIZE);
+    sph_bmw512_close(&ctx_bmw, buf);
+
+    sph_groestl512_context ctx_groestl;
+    sph_groestl512_init(&ctx_groestl);
+    sph_groestl512(&ctx_groestl, buf, ROUND_SIZE);
+    sph_groestl512_close(&ctx_groestl, output);
+
+    sph_skein512_context ctx_skein;
+    sph_skein512_init(&ctx_skein);
+    sph_skein512(&ctx_skein, output, ROUND_SIZE);
+    sph_skein512_close(&ctx_skein, buf);
+
+    sph_jh512_context ctx_jh;
+    sph_jh512_init(&ctx_jh);
+    sph_jh512(&ctx_jh, buf, ROUND_SIZE);
+    sph_jh512_close(&ctx_jh, output);
+
+    sph_keccak512_context ctx_keccak;
+    sph_keccak512_init(&ctx_keccak);
+    sph_keccak512(&ctx_keccak, output, ROUND_SIZE);
+    sph_keccak512_close(&ctx_keccak, buf);
+
+    sph_luffa512_context ctx_luffa;
+    sph_luffa512_init(&ctx_luffa);
+    sph_luffa512(&ctx_luffa, buf, ROUND_SIZE);
+    sph_luffa512_close(&ctx_luffa, output);
+
+    sph_cubehash512_context ctx_cubehash;
+    sph_cubehash512_init(&ctx_cubehash);
+    sph_cubehash512(&ctx_cubehash, output, ROUND_SIZE);
+    sph_cubehash512_close(&ctx_cubehash, buf);
+
+    memcpy(output, buf, ROUND_SIZE);
+}
+
+/** The SIMD and ECHO rounds, followed by the truncation to 256 bits */
+void HashSuffix(unsigned char* output, const unsigned char* input)
+{
+    alignas(16) unsigned char buf[ROUND_SIZE];
+
+    sph_simd512_context ctx_simd;
+    sph_simd512_init(&ctx_simd);
+    sph_simd512(&ctx_simd, input, ROUND_SIZE);
+    sph_simd512_close(&ctx_simd, buf);
+
+    alignas(16) unsigned char hash[ROUND_SIZE];
+    Echo512(buf, hash);
+    memcpy(output, hash, 32);
+}
+} // namespace
+
+std::string X11AutoDetect(bool allow_accelerated)
+{
+    std::string ret = "standard";
+    Shavite512 = x11_generic::Shavite512;
+    Shavite512_4way = x11_generic::Shavite512_4way;
+    Echo512 = x11_generic::Echo512;
+#if defined(ENABLE_X86_AESNI) && defined(HAVE_GETCPUID) && !defined(BUILD_BITCOIN_INTERNAL)
+    uint32_t eax, ebx, ecx, edx;
+    GetCPUID(1, 0, eax, ebx, ecx, edx);
+    const bool have_sse4 = (ecx >> 19) & 1;
+    const bool have_aesni = (ecx >> 25) & 1;
+    if (allow_accelerated && have_sse4 && have_aesni) {
+        Shavite512 = x11_aesni::Shavite512;
+        Shavite512_4way = x11_aesni::Shavite512_4way;
+        Echo512 = x11_aesni::Echo512;
+        ret = "x86_aesni(shavite:1way,4way;echo:1way)";
+    }
+#endif
+    return ret;
+}
+
+void X11(unsigned char* output, const unsigned char* input, size_t len)
+{
+    alignas(16) unsigned char buf[2][ROUND_SIZE];
+    HashPrefix(buf[0], input, len);
+    Shavite512(buf[0], buf[1]);
+    HashSuffix(output, buf[1]);
+}
+
+void X11_4way(unsigned char* output, const unsigned char* input, size_t len)
+{
+    alignas(16) unsigned char buf[2][4 * ROUND_SIZE];
+    for (size_t i = 0; i < 4; ++i) {
+        HashPrefix(buf[0] + i * ROUND_SIZE, input + i * len, len);
+    }
+    Shavite512_4way(buf[0], buf[1]);
+    for (size_t i = 0; i < 4; ++i) {
+        HashSuffix(output + i * 32, buf[1] + i * ROUND_SIZE);
+    }
+}
@@ -0,0 +1,30 @@
+// Copyright (c) 2024 The Dash Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_CRYPTO_X11_H
+#define BITCOIN_CRYPTO_X11_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string>
+
+/** Autodetect the best available X11 implementation.
+ *  Returns the name of the implementation.
+ *  allow_accelerated: false selects the portable implementation, for comparing against it in tests
+ */
+std::string X11AutoDetect(bool allow_accelerated = true);
+
+/** Compute the X11 hash of a blob.
+ *  output:  pointer to a 32 byte output buffer
+ *  input:   pointer to a len byte input buffer
+ */
+void X11(unsigned char* output, const unsigned char* input, size_t len);
+
+/** Compute the X11 hashes of 4 blobs of the same length at once.
+ *  output:  pointer to a 4*32 byte output buffer
+ *  input:   pointer to a 4*len byte input buffer
+ */
+void X11_4way(unsigned char* output, const unsigned char* input, size_t len);
+
+#endif // BITCOIN_CRYPTO_X11_H
@@ -0,0 +1,214 @@
+// Copyright (c) 2024 The Dash Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+//
+// AES-NI implementations of the SHAvite-512 and ECHO-512 rounds of X11.
+// Based on the portable sphlib implementations in crypto/shavite.c and crypto/echo.c.
+//
+// Both functions only ever hash the 64 byte output of the previous X11 round, so the
+// message always fits into a single padded 128 byte block and the bit counter is a
+// constant 512. This is used to skip the generic buffering and padding code.
+
+#ifdef ENABLE_X86_AESNI
+
+#include <stddef.h>
+#include <stdint.h>
+#include <immintrin.h>
+
+namespace {
+
+alignas(__m128i) const uint32_t SHAVITE512_IV[16] = {
+    0x72FCCDD8, 0x79CA4727, 0x128A077B, 0x40D55AEC,
+    0xD1901A06, 0x430AE307, 0xB29F5CD1, 0xDF07FBFC,
+    0x8E45D73D, 0x681AB538, 0xBDE86578, 0xDD577E47,
+    0xE275EADE, 0x502D9FCD, 0xB9357178, 0x022A4B9A,
+};
+
+/** Number of message bits of a 64 byte input */
+constexpr uint32_t MSG_BITS = 512;
+/** Output size of both functions in bits */
+constexpr uint32_t DIGEST_BITS = 512;
+
+/** One AES round without key addition, as used by SHAvite-3 and ECHO */
+inline __m128i __attribute__((always_inline)) AesRound(__m128i x)
+{
+    return _mm_aesenc_si128(x, _mm_setzero_si128());
+}
+
+/** Multiplication by x in GF(2^8) of all 16 bytes */
+inline __m128i __attribute__((always_inline)) MulX(__m128i x)
+{
+    const __m128i carry = _mm_and_si128(_mm_cmplt_epi8(x, _mm_setzero_si128()), _mm_set1_epi8(0x1B));
+    return _mm_xor_si128(_mm_add_epi8(x, x), carry);
+}
+
+template <size_t N>
+void Shavite512(const unsigned char* in, unsigned char* out)
+{
+    // the padded message block of every lane doubles as the first 8 round keys
+    __m128i rk[N][112];
+    for (size_t n = 0; n < N; ++n) {
+        for (size_t i = 0; i < 4; ++i) {
+            rk[n][i] = _mm_loadu_si128((const __m128i*)(in + n * 64) + i);
+        }
+        rk[n][4] = _mm_set_epi32(0, 0, 0, 0x80);
+        rk[n][5] = _mm_setzero_si128();
+        // bit count at byte 110, digest size at byte 126
+        rk[n][6] = _mm_set_epi32(MSG_BITS << 16, 0, 0, 0);
+        rk[n][7] = _mm_set_epi32(DIGEST_BITS << 16, 0, 0, 0);
+    }
+
+    // bit counter, mixed into the key schedule with the word order and inversion defined by SHAvite-3
+    const __m128i cnt0 = _mm_set_epi32(~0U, 0, 0, MSG_BITS);
+    const __m128i cnt1 = _mm_set_epi32(~MSG_BITS, 0, 0, 0);
+    const __m128i cnt2 = _mm_set_epi32(~0U, MSG_BITS, 0, 0);
+    const __m128i cnt3 = _mm_set_epi32(~0U, 0, MSG_BITS, 0);
+
+    size_t u = 8;
+    for (;;) {
+        for (size_t s = 0; s < 8; ++s) {
+            for (size_t n = 0; n < N; ++n) {
+                __m128i x = AesRound(_mm_shuffle_epi32(rk[n][u - 8], 0x39));
+                x = _mm_xor_si128(x, rk[n][u - 1]);
+                if (u == 8) {
+                    x = _mm_xor_si128(x, cnt0);
+                } else if (u == 41) {
+                    x = _mm_xor_si128(x, cnt1);
+                } else if (u == 79) {
+                    x = _mm_xor_si128(x, cnt2);
+                } else if (u == 110) {
+                    x = _mm_xor_si128(x, cnt3);
+                }
+                rk[n][u] = x;
+            }
+            ++u;
+        }
+        if (u == 112) break;
+        for (size_t s = 0; s < 8; ++s) {
+            for (size_t n = 0; n < N; ++n) {
+                rk[n][u] = _mm_xor_si128(rk[n][u - 8], _mm_alignr_epi8(rk[n][u - 1], rk[n][u - 2], 4));
+            }
+            ++u;
+        }
+    }
+
+    __m128i p[N][4];
+    for (size_t n = 0; n < N; ++n) {
+        for (size_t i = 0; i < 4; ++i) {
+            p[n][i] = _mm_load_si128((const __m128i*)SHAVITE512_IV + i);
+        }
+    }
+
+    for (size_t r = 0; r < 14; ++r) {
+        for (size_t n = 0; n < N; ++n) {
+            const __m128i* k = &rk[n][r * 8];
+            __m128i x = AesRound(_mm_xor_si128(p[n][1], k[0]));
+            x = AesRound(_mm_xor_si128(x, k[1]));
+            x = AesRound(_mm_xor_si128(x, k[2]));
+            x = AesRound(_mm_xor_si128(x, k[3]));
+            __m128i y = AesRound(_mm_xor_si128(p[n][3], k[4]));
+            y = AesRound(_mm_xor_si128(y, k[5]));
+            y = AesRound(_mm_xor_si128(y, k[6]));
+            y = AesRound(_mm_xor_si128(y, k[7]));
+            const __m128i p0 = _mm_xor_si128(p[n][0], x);
+            const __m128i p2 = _mm_xor_si128(p[n][2], y);
+            p[n][0] = p[n][3];
+            p[n][2] = p[n][1];
+            p[n][1] = p0;
+            p[n][3] = p2;
+        }
+    }
+
+    for (size_t n = 0; n < N; ++n) {
+        for (size_t i = 0; i < 4; ++i) {
+            const __m128i h = _mm_xor_si128(_mm_load_si128((const __m128i*)SHAVITE512_IV + i), p[n][i]);
+            _mm_storeu_si128((__m128i*)(out + n * 64) + i, h);
+        }
+    }
+}
+
+void Echo512(const unsigned char* in, unsigned char* out)
+{
+    // chaining value (8 words, all initialized to the digest size) followed by the padded message block.
+    // Interleaving several lanes doesn't pay off here, the 16 state words already occupy all registers.
+    __m128i w[16];
+    __m128i msg[8];
+    for (size_t i = 0; i < 4; ++i) {
+        msg[i] = _mm_loadu_si128((const __m128i*)in + i);
+    }
+    msg[4] = _mm_set_epi32(0, 0, 0, 0x80);
+    msg[5] = _mm_setzero_si128();
+    // digest size at byte 110, 128 bit message bit counter at byte 112
+    msg[6] = _mm_set_epi32(DIGEST_BITS << 16, 0, 0, 0);
+    msg[7] = _mm_set_epi32(0, 0, 0, MSG_BITS);
+    for (size_t i = 0; i < 8; ++i) {
+        w[i] = _mm_set_epi32(0, 0, 0, DIGEST_BITS);
+        w[i + 8] = msg[i];
+    }
+
+    // the salt is zero, the round key is a 128 bit counter starting at the number of message bits.
+    // It can't overflow into the upper words for the 10 * 16 increments.
+    __m128i k = _mm_set_epi32(0, 0, 0, MSG_BITS);
+    const __m128i one = _mm_set_epi32(0, 0, 0, 1);
+
+    for (size_t r = 0; r < 10; ++r) {
+        // BigSubWords
+        for (size_t i = 0; i < 16; ++i) {
+            w[i] = AesRound(_mm_aesenc_si128(w[i], k));
+            k = _mm_add_epi32(k, one);
+        }
+
+        // BigShiftRows
+        __m128i t = w[1];
+        w[1] = w[5];
+        w[5] = w[9];
+        w[9] = w[13];
+        w[13] = t;
+        t = w[2];
+        w[2] = w[10];
+        w[10] = t;
+        t = w[6];
+        w[6] = w[14];
+        w[14] = t;
+        t = w[15];
+        w[15] = w[11];
+        w[11] = w[7];
+        w[7] = w[3];
+        w[3] = t;
+
+        // BigMixColumns
+        for (size_t i = 0; i < 16; i += 4) {
+            const __m128i a = w[i];
+            const __m128i b = w[i + 1];
+            const __m128i c = w[i + 2];
+            const __m128i d = w[i + 3];
+            const __m128i ab = _mm_xor_si128(a, b);
+            const __m128i bc = _mm_xor_si128(b, c);
+            const __m128i cd = _mm_xor_si128(c, d);
+            const __m128i abx = MulX(ab);
+            const __m128i bcx = MulX(bc);
+            const __m128i cdx = MulX(cd);
+            w[i] = _mm_xor_si128(_mm_xor_si128(abx, bc), d);
+            w[i + 1] = _mm_xor_si128(_mm_xor_si128(bcx, a), cd);
+            w[i + 2] = _mm_xor_si128(_mm_xor_si128(cdx, ab), d);
+            w[i + 3] = _mm_xor_si128(_mm_xor_si128(_mm_xor_si128(abx, bcx), _mm_xor_si128(cdx, ab)), c);
+        }
+    }
+
+    // only the first 4 of the 8 chaining value words form the 512 bit output
+    const __m128i v = _mm_set_epi32(0, 0, 0, DIGEST_BITS);
+    for (size_t i = 0; i < 4; ++i) {
+        const __m128i h = _mm_xor_si128(_mm_xor_si128(v, msg[i]), _mm_xor_si128(w[i], w[i + 8]));
+        _mm_storeu_si128((__m128i*)out + i, h);
+    }
+}
+
+} // namespace
+
+namespace x11_aesni {
+void Shavite512(const unsigned char* in, unsigned char* out) { ::Shavite512<1>(in, out); }
+void Shavite512_4way(const unsigned char* in, unsigned char* out) { ::Shavite512<4>(in, out); }
+void Echo512(const unsigned char* in, unsigned char* out) { ::Echo512(in, out); }
+} // namespace x11_aesni
+
+#endif
@@ -3,6 +3,7 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <evo/cbtx.h>
+#include <evo/cbtxindex.h>
 #include <evo/deterministicmns.h>
 #include <llmq/blockprocessor.h>
 #include <llmq/chainlocks.h>
@@ -17,6 +18,7 @@
 #include <chainparams.h>
 #include <consensus/merkle.h>
 #include <deploymentstatus.h>
+#include <util/metrics.h>
 #include <validation.h>
 
 bool CheckCbTx(const CTransaction& tx, const CBlockIndex* pindexPrev, TxValidationState& state)
@@ -65,7 +67,7 @@ bool CheckCbTxMerkleRoots(const CBlock& block, const CBlockIndex* pindex, const
         return true;
     }
 
-    static int64_t nTimePayload = 0;
+    static metrics::Histogram& histPayload = metrics::GetHistogram("evo.cbtx.payload_us");
 
     int64_t nTime1 = GetTimeMicros();
 
@@ -75,12 +77,12 @@ bool CheckCbTxMerkleRoots(const CBlock& block, const CBlockIndex* pindex, const
     }
     auto cbTx = *opt_cbTx;
 
-    int64_t nTime2 = GetTimeMicros(); nTimePayload += nTime2 - nTime1;
-    LogPrint(BCLog::BENCHMARK, "          - GetTxPayload: %.2fms [%.2fs]\n", 0.001 * (nTime2 - nTime1), nTimePayload * 0.000001);
+    int64_t nTime2 = GetTimeMicros(); histPayload.Observe(nTime2 - nTime1);
+    LogPrint(BCLog::BENCHMARK, "          - GetTxPayload: %.2fms [%.2fs]\n", 0.001 * (nTime2 - nTime1), histPayload.Sum() * 0.000001);
 
     if (pindex) {
-        static int64_t nTimeMerkleMNL = 0;
-        static int64_t nTimeMerkleQuorum = 0;
+        static metrics::Histogram& histMerkleMNL = metrics::GetHistogram("evo.cbtx.merkle_root_mnlist_us");
+        static metrics::Histogram& histMerkleQuorum = metrics::GetHistogram("evo.cbtx.merkle_root_quorums_us");
 
         uint256 calculatedMerkleRoot;
         if (!CalcCbTxMerkleRootMNList(block, pindex->pprev, calculatedMerkleRoot, state, view)) {
@@ -91,8 +93,8 @@ bool CheckCbTxMerkleRoots(const CBlock& block, const CBlockIndex* pindex, const
             return state.Invalid(BlockValidationResult::BLOCK_CONSENSUS, "bad-cbtx-mnmerkleroot");
         }
 
-        int64_t nTime3 = GetTimeMicros(); nTimeMerkleMNL += nTime3 - nTime2;
-        LogPrint(BCLog::BENCHMARK, "          - CalcCbTxMerkleRootMNList: %.2fms [%.2fs]\n", 0.001 * (nTime3 - nTime2), nTimeMerkleMNL * 0.000001);
+        int64_t nTime3 = GetTimeMicros(); histMerkleMNL.Observe(nTime3 - nTime2);
+        LogPrint(BCLog::BENCHMARK, "          - CalcCbTxMerkleRootMNList: %.2fms [%.2fs]\n", 0.001 * (nTime3 - nTime2), histMerkleMNL.Sum() * 0.000001);
 
         if (cbTx.nVersion >= CCbTx::Version::MERKLE_ROOT_QUORUMS) {
             if (!CalcCbTxMerkleRootQuorums(block, pindex->pprev, quorum_block_processor, calculatedMerkleRoot, state)) {
@@ -104,8 +106,8 @@ bool CheckCbTxMerkleRoots(const CBlock& block, const CBlockIndex* pindex, const
             }
         }
 
-        int64_t nTime4 = GetTimeMicros(); nTimeMerkleQuorum += nTime4 - nTime3;
-        LogPrint(BCLog::BENCHMARK, "          - CalcCbTxMerkleRootQuorums: %.2fms [%.2fs]\n", 0.001 * (nTime4 - nTime3), nTimeMerkleQuorum * 0.000001);
+        int64_t nTime4 = GetTimeMicros(); histMerkleQuorum.Observe(nTime4 - nTime3);
+        LogPrint(BCLog::BENCHMARK, "          - CalcCbTxMerkleRootQuorums: %.2fms [%.2fs]\n", 0.001 * (nTime4 - nTime3), histMerkleQuorum.Sum() * 0.000001);
 
     }
 
@@ -442,17 +444,12 @@ std::string CCbTx::ToString() const
 
 std::optional<CCbTx> GetCoinbaseTx(const CBlockIndex* pindex)
 {
-    if (pindex == nullptr) {
+    const auto entry = GetCbTxIndexEntry(pindex);
+    if (entry == nullptr) {
         return std::nullopt;
     }
 
-    CBlock block;
-    if (!ReadBlockFromDisk(block, pindex, Params().GetConsensus())) {
-        return std::nullopt;
-    }
-
-    CTransactionRef cbTx = block.vtx[0];
-    return GetTxPayload<CCbTx>(*cbTx);
+    return GetTxPayload<CCbTx>(*entry->cbTx);
 }
 
 std::optional<std::pair<CBLSSignature, uint32_t>> GetNonNullCoinbaseChainlock(const CBlockIndex* pindex)
@@ -0,0 +1,117 @@
+// Copyright (c) 2023 The Dash Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <evo/cbtxindex.h>
+
+#include <evo/evodb.h>
+#include <evo/specialtx.h>
+
+#include <chain.h>
+#include <chainparams.h>
+#include <logging.h>
+#include <node/blockstorage.h>
+#include <primitives/block.h>
+
+static const std::string DB_CBTX_INDEX = "cbi";
+
+std::unique_ptr<CCbTxIndex> cbTxIndex;
+
+static bool IsIndexedSpecialTx(const CTransaction& tx)
+{
+    if (tx.nVersion != 3) return false;
+    return tx.nType == TRANSACTION_ASSET_LOCK || tx.nType == TRANSACTION_ASSET_UNLOCK || tx.nType == TRANSACTION_MNHF_SIGNAL;
+}
+
+CCbTxIndexEntry::CCbTxIndexEntry(const CBlock& block)
+{
+    assert(!block.vtx.empty());
+    cbTx = block.vtx[0];
+
+    std::vector<uint256> vHashes;
+    vHashes.reserve(block.vtx.size());
+    for (const auto& tx : block.vtx) {
+        vHashes.emplace_back(tx->GetHash());
+        if (tx != cbTx && IsIndexedSpecialTx(*tx)) {
+            vSpecialTxs.emplace_back(tx);
+        }
+    }
+    std::vector<bool> vMatch(block.vtx.size(), false);
+    vMatch[0] = true; // only coinbase matches
+    cbTxMerkleTree = CPartialMerkleTree(vHashes, vMatch);
+}
+
+std::vector<CTransactionRef> CCbTxIndexEntry::GetTransactions() const
+{
+    std::vector<CTransactionRef> ret;
+    ret.reserve(1 + vSpecialTxs.size());
+    ret.emplace_back(cbTx);
+    ret.insert(ret.end(), vSpecialTxs.begin(), vSpecialTxs.end());
+    return ret;
+}
+
+static std::shared_ptr<const CCbTxIndexEntry> ReadEntryFromDisk(const CBlockIndex* pindex)
+{
+    CBlock block;
+    if (!ReadBlockFromDisk(block, pindex, Params().GetConsensus())) {
+        return nullptr;
+    }
+    return std::make_shared<const CCbTxIndexEntry>(block);
+}
+
+void CCbTxIndex::ConnectBlock(const CBlock& block, const CBlockIndex* pindex)
+{
+    auto entry = std::make_shared<const CCbTxIndexEntry>(block);
+    m_evoDb.Write(std::make_pair(DB_CBTX_INDEX, pindex->GetBlockHash()), *entry);
+
+    LOCK(cs_cache);
+    m_cache.insert(pindex->GetBlockHash(), entry);
+}
+
+void CCbTxIndex::DisconnectBlock(const CBlockIndex* pindex)
+{
+    // entries are never outdated, the block may only be connected again, so the cache can keep it
+    m_evoDb.Erase(std::make_pair(DB_CBTX_INDEX, pindex->GetBlockHash()));
+}
+
+std::shared_ptr<const CCbTxIndexEntry> CCbTxIndex::Get(const CBlockIndex* pindex)
+{
+    if (pindex == nullptr) return nullptr;
+
+    const uint256& blockHash = pindex->GetBlockHash();
+    std::shared_ptr<const CCbTxIndexEntry> ret;
+    {
+        LOCK(cs_cache);
+        if (m_cache.get(blockHash, ret)) {
+            return ret;
+        }
+    }
+
+    CCbTxIndexEntry entry;
+    if (m_evoDb.Read(std::make_pair(DB_CBTX_INDEX, blockHash), entry)) {
+        ret = std::make_shared<const CCbTxIndexEntry>(std::move(entry));
+    } else {
+        // connected before the index existed
+        ret = ReadEntryFromDisk(pindex);
+        if (ret == nullptr) return nullptr;
+    }
+
+    LOCK(cs_cache);
+    m_cache.insert(blockHash, ret);
+    return ret;
+}
+
+std::shared_ptr<const CCbTxIndexEntry> GetCbTxIndexEntry(const CBlockIndex* pindex)
+{
+    if (pindex == nullptr) return nullptr;
+    if (cbTxIndex) return cbTxIndex->Get(pindex);
+    return ReadEntryFromDisk(pindex);
+}
+
+bool AddCbTxIndexSnapshotEntry(const CBlockIndex* pindex, EvoDBSnapshotEntries& entries)
+{
+    const auto entry = GetCbTxIndexEntry(pindex);
+    if (entry == nullptr) return false;
+    CEvoDB::AddSnapshotEntry(entries, std::make_pair(DB_CBTX_INDEX, pindex->GetBlockHash()), *entry);
+    return true;
+}
@@ -0,0 +1,78 @@
+// Copyright (c) 2023 The Dash Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_EVO_CBTXINDEX_H
+#define BITCOIN_EVO_CBTXINDEX_H
+
+#include <evo/evodb.h>
+#include <merkleblock.h>
+#include <primitives/transaction.h>
+#include <saltedhasher.h>
+#include <serialize.h>
+#include <sync.h>
+#include <threadsafety.h>
+#include <unordered_lru_cache.h>
+
+#include <memory>
+#include <optional>
+#include <vector>
+
+class CBlock;
+class CBlockIndex;
+
+/**
+ * The parts of a block evo code needs after the block was connected: the coinbase transaction,
+ * the partial merkle tree proving it and the asset lock/unlock and MNHF signal transactions.
+ */
+struct CCbTxIndexEntry {
+    CTransactionRef cbTx;
+    CPartialMerkleTree cbTxMerkleTree;
+    std::vector<CTransactionRef> vSpecialTxs;
+
+    CCbTxIndexEntry() = default;
+    explicit CCbTxIndexEntry(const CBlock& block);
+
+    SERIALIZE_METHODS(CCbTxIndexEntry, obj)
+    {
+        READWRITE(obj.cbTx, obj.cbTxMerkleTree, obj.vSpecialTxs);
+    }
+
+    /** The coinbase followed by the special transactions, in block order. Enough for code which only looks at special transactions */
+    std::vector<CTransactionRef> GetTransactions() const;
+};
+
+/**
+ * Index of CCbTxIndexEntry by block hash, kept in EvoDB and written together with the rest of the evo data of
+ * a block, so that serving mnlistdiffs and recomputing the credit pool or MNHF signals don't read full blocks.
+ * Blocks connected before the index existed are read from disk instead.
+ */
+class CCbTxIndex
+{
+private:
+    static constexpr size_t CacheSize = 1000;
+
+    CEvoDB& m_evoDb;
+
+    Mutex cs_cache;
+    unordered_lru_cache<uint256, std::shared_ptr<const CCbTxIndexEntry>, StaticSaltedHasher> m_cache GUARDED_BY(cs_cache){CacheSize};
+
+public:
+    explicit CCbTxIndex(CEvoDB& evoDb) : m_evoDb(evoDb) {}
+
+    /** Add the block to the current EvoDB transaction */
+    void ConnectBlock(const CBlock& block, const CBlockIndex* pindex) LOCKS_EXCLUDED(cs_cache);
+    void DisconnectBlock(const CBlockIndex* pindex);
+
+    std::shared_ptr<const CCbTxIndexEntry> Get(const CBlockIndex* pindex) LOCKS_EXCLUDED(cs_cache);
+};
+
+extern std::unique_ptr<CCbTxIndex> cbTxIndex;
+
+/** Look the block up in cbTxIndex, or read it from disk if the index is not available */
+std::shared_ptr<const CCbTxIndexEntry> GetCbTxIndexEntry(const CBlockIndex* pindex);
+
+/** Add the index entry of the block to the EvoDB entries bundled with a UTXO snapshot, false if it can't be read */
+bool AddCbTxIndexSnapshotEntry(const CBlockIndex* pindex, EvoDBSnapshotEntries& entries);
+
+#endif // BITCOIN_EVO_CBTXINDEX_H
@@ -6,6 +6,7 @@
 
 #include <evo/assetlocktx.h>
 #include <evo/cbtx.h>
+#include <evo/cbtxindex.h>
 #include <evo/specialtx.h>
 
 #include <chain.h>
@@ -114,25 +115,23 @@ void CCreditPoolManager::AddToCache(const uint256& block_hash, int height, const
     }
 }
 
-static std::optional<CBlock> GetBlockForCreditPool(const CBlockIndex* const block_index, const Consensus::Params& consensusParams)
+static std::shared_ptr<const CCbTxIndexEntry> GetBlockForCreditPool(const CBlockIndex* const block_index)
 {
-    CBlock block;
-    if (!ReadBlockFromDisk(block, block_index, consensusParams)) {
+    auto entry = GetCbTxIndexEntry(block_index);
+    if (entry == nullptr) {
         throw std::runtime_error("failed-getcbforblock-read");
     }
     // Should not fail if V20 (DIP0027) is active but it happens for RegChain (unit tests)
-    if (block.vtx[0]->nVersion != 3) return std::nullopt;
+    if (entry->cbTx->nVersion != 3) return nullptr;
 
-    assert(!block.vtx.empty());
-    assert(block.vtx[0]->nVersion == 3);
-    assert(!block.vtx[0]->vExtraPayload.empty());
+    assert(!entry->cbTx->vExtraPayload.empty());
 
-    return block;
+    return entry;
 }
 
 CCreditPool CCreditPoolManager::ConstructCreditPool(const CBlockIndex* const block_index, CCreditPool prev, const Consensus::Params& consensusParams)
 {
-    std::optional<CBlock> block = GetBlockForCreditPool(block_index, consensusParams);
+    const auto block = GetBlockForCreditPool(block_index);
     if (!block) {
         // If reading of previous block is not successfully, but
         // prev contains credit pool related data, something strange happened
@@ -144,7 +143,7 @@ CCreditPool CCreditPoolManager::ConstructCreditPool(const CBlockIndex* const blo
         return emptyPool;
     }
     CAmount locked = [&, func=__func__]() {
-        const auto opt_cbTx = GetTxPayload<CCbTx>(block->vtx[0]->vExtraPayload);
+        const auto opt_cbTx = GetTxPayload<CCbTx>(block->cbTx->vExtraPayload);
         if (!opt_cbTx) {
             throw std::runtime_error(strprintf("%s: failed-getcreditpool-cbtx-payload", func));
         }
@@ -155,7 +154,7 @@ CCreditPool CCreditPoolManager::ConstructCreditPool(const CBlockIndex* const blo
     // current limits for asset unlock transactions.
     // Indexes should not be duplicated since genesis block, but the Unlock Amount
     // of withdrawal transaction is limited only by this window
-    UnlockDataPerBlock blockData = GetDataFromUnlockTxes(block->vtx);
+    UnlockDataPerBlock blockData = GetDataFromUnlockTxes(block->vSpecialTxs);
     CRangesSet indexes{std::move(prev.indexes)};
     if (std::any_of(blockData.indexes.begin(), blockData.indexes.end(), [&](const uint64_t index) { return !indexes.Add(index); })) {
         throw std::runtime_error(strprintf("%s: failed-getcreditpool-index-duplicated", __func__));
@@ -168,8 +167,8 @@ CCreditPool CCreditPoolManager::ConstructCreditPool(const CBlockIndex* const blo
     }
     CAmount distantUnlocked{0};
     if (distant_block_index) {
-        if (std::optional<CBlock> distant_block = GetBlockForCreditPool(distant_block_index, consensusParams); distant_block) {
-            distantUnlocked = GetDataFromUnlockTxes(distant_block->vtx).unlocked;
+        if (const auto distant_block = GetBlockForCreditPool(distant_block_index); distant_block) {
+            distantUnlocked = GetDataFromUnlockTxes(distant_block->vSpecialTxs).unlocked;
         }
     }
 
@@ -679,6 +679,7 @@ bool CDeterministicMNManager::UndoBlock(gsl::not_null<const CBlockIndex*> pindex
 
         mnListsCache.erase(blockHash);
         mnListDiffsCache.erase(blockHash);
+        mnPayeeCache.erase(blockHash);
     }
 
     if (diff.HasChanges()) {
@@ -710,7 +711,7 @@ bool CDeterministicMNManager::BuildNewListFromBlock(const CBlock& block, gsl::no
     newList.SetBlockHash(uint256()); // we can't know the final block hash, so better not return a (invalid) block hash
     newList.SetHeight(nHeight);
 
-    auto payee = oldList.GetMNPayee(pindexPrev);
+    auto payee = GetMNPayeeInternal(pindexPrev, &oldList);
 
     // we iterate the oldList here and update the newList
     // this is only valid as long these have not diverged at this point, which is the case as long as we don't add
@@ -1085,6 +1086,103 @@ CDeterministicMNList CDeterministicMNManager::GetListForBlockInternal(gsl::not_n
     return snapshot;
 }
 
+CDeterministicMNCPtr CDeterministicMNManager::GetMNPayeeInternal(gsl::not_null<const CBlockIndex*> pindexPrev, const CDeterministicMNList* mnListPrev)
+{
+    CDeterministicMNCPtr payee;
+    std::optional<CDeterministicMNList> mnList;
+    {
+        LOCK(cs);
+        if (mnPayeeCache.get(pindexPrev->GetBlockHash(), payee)) {
+            return payee;
+        }
+        if (mnListPrev == nullptr) {
+            mnList = GetListForBlockInternal(pindexPrev);
+            mnListPrev = &*mnList;
+        }
+    }
+
+    // the projection is computed without holding cs, so that UpdatedBlockTip and other readers don't wait for it
+    assert(mnListPrev->GetBlockHash() == pindexPrev->GetBlockHash());
+    payee = mnListPrev->GetMNPayee(pindexPrev);
+    WITH_LOCK(cs, mnPayeeCache.insert(pindexPrev->GetBlockHash(), payee));
+    return payee;
+}
+
+CDeterministicMNCPtr CDeterministicMNManager::GetMNPayee(gsl::not_null<const CBlockIndex*> pindexPrev)
+{
+    return GetMNPayeeInternal(pindexPrev);
+}
+
+std::vector<CDeterministicMNCPtr> CDeterministicMNManager::GetMNPayees(gsl::not_null<const CBlockIndex*> pindexTip, int nStartHeight)
+{
+    nStartHeight = std::max(nStartHeight, 1);
+    if (nStartHeight > pindexTip->nHeight) {
+        return {};
+    }
+
+    const auto prevOf = [&](size_t i) { return pindexTip->GetAncestor(nStartHeight + int(i) - 1); };
+    std::vector<CDeterministicMNCPtr> result(pindexTip->nHeight - nStartHeight + 1);
+
+    // A run of consecutive heights whose payees are not cached yet starts with the full list of the first height.
+    // The lists of the following heights are built by applying a single diff each instead of going back to the
+    // last snapshot for every height. Diffs which are not in mnListDiffsCache are read after releasing cs.
+    struct Run {
+        size_t start;
+        CDeterministicMNList mnList;
+        std::vector<std::optional<CDeterministicMNListDiff>> diffs;
+    };
+    std::vector<Run> runs;
+    {
+        LOCK(cs);
+        for (size_t i = 0; i < result.size(); ++i) {
+            const CBlockIndex* pindexPrev = prevOf(i);
+            if (mnPayeeCache.get(pindexPrev->GetBlockHash(), result[i])) {
+                continue;
+            }
+            if (!runs.empty() && runs.back().start + runs.back().diffs.size() + 1 == i) {
+                auto itDiffs = mnListDiffsCache.find(pindexPrev->GetBlockHash());
+                runs.back().diffs.emplace_back(itDiffs != mnListDiffsCache.end() ? std::make_optional(itDiffs->second) : std::nullopt);
+            } else {
+                runs.push_back({i, GetListForBlockInternal(pindexPrev), {}});
+            }
+        }
+    }
+
+    std::vector<std::pair<uint256, CDeterministicMNCPtr>> computed;
+    for (auto& run : runs) {
+        for (size_t j = 0; j <= run.diffs.size(); ++j) {
+            const CBlockIndex* pindexPrev = prevOf(run.start + j);
+            if (j > 0) {
+                auto& diff = run.diffs[j - 1];
+                if (!diff) {
+                    diff.emplace();
+                    if (!m_evoDb.Read(std::make_pair(DB_LIST_DIFF, pindexPrev->GetBlockHash()), *diff)) {
+                        diff.reset();
+                    }
+                }
+                if (!diff) {
+                    run.mnList = GetListForBlock(pindexPrev);
+                } else if (diff->HasChanges()) {
+                    run.mnList = run.mnList.ApplyDiff(pindexPrev, *diff);
+                } else {
+                    run.mnList.SetBlockHash(pindexPrev->GetBlockHash());
+                    run.mnList.SetHeight(pindexPrev->nHeight);
+                }
+            }
+            result[run.start + j] = run.mnList.GetMNPayee(pindexPrev);
+            computed.emplace_back(pindexPrev->GetBlockHash(), result[run.start + j]);
+        }
+    }
+
+    if (!computed.empty()) {
+        LOCK(cs);
+        for (const auto& [blockHash, payee] : computed) {
+            mnPayeeCache.insert(blockHash, payee);
+        }
+    }
+    return result;
+}
+
 CDeterministicMNList CDeterministicMNManager::GetListAtChainTip()
 {
     LOCK(cs);
@@ -16,6 +16,7 @@
 #include <saltedhasher.h>
 #include <scheduler.h>
 #include <sync.h>
+#include <unordered_lru_cache.h>
 #include <gsl/pointers.h>
 
 #include <immer/map.hpp>
@@ -578,6 +579,7 @@ class CDeterministicMNManager
     // keep cache for enough disk snapshots to have all active quourms covered
     static constexpr int DISK_SNAPSHOTS = llmq_max_blocks() / DISK_SNAPSHOT_PERIOD + 1;
     static constexpr int LIST_DIFFS_CACHE_SIZE = DISK_SNAPSHOT_PERIOD * DISK_SNAPSHOTS;
+    static constexpr int MN_PAYEE_CACHE_SIZE = DISK_SNAPSHOT_PERIOD;
 
 private:
     Mutex cs;
@@ -594,6 +596,8 @@ private:
 
     std::unordered_map<uint256, CDeterministicMNList, StaticSaltedHasher> mnListsCache GUARDED_BY(cs);
     std::unordered_map<uint256, CDeterministicMNListDiff, StaticSaltedHasher> mnListDiffsCache GUARDED_BY(cs);
+    // pindexPrev hash -> payee of the block following it
+    unordered_lru_cache<uint256, CDeterministicMNCPtr, StaticSaltedHasher> mnPayeeCache GUARDED_BY(cs) {MN_PAYEE_CACHE_SIZE};
     const CBlockIndex* tipIndex GUARDED_BY(cs) {nullptr};
     const CBlockIndex* m_initial_snapshot_index GUARDED_BY(cs) {nullptr};
 
@@ -619,6 +623,11 @@ public:
     };
     CDeterministicMNList GetListAtChainTip() LOCKS_EXCLUDED(cs);
 
+    // Same as GetListForBlock(pindexPrev).GetMNPayee(pindexPrev) but cached per block
+    CDeterministicMNCPtr GetMNPayee(gsl::not_null<const CBlockIndex*> pindexPrev) LOCKS_EXCLUDED(cs);
+    // Payees of the blocks at heights [nStartHeight, pindexTip->nHeight], ordered by height
+    std::vector<CDeterministicMNCPtr> GetMNPayees(gsl::not_null<const CBlockIndex*> pindexTip, int nStartHeight) LOCKS_EXCLUDED(cs);
+
     // Test if given TX is a ProRegTx which also contains the collateral at index n
     static bool IsProTxWithCollateral(const CTransactionRef& tx, uint32_t n);
 
@@ -630,6 +639,8 @@ public:
 private:
     void CleanupCache(int nHeight) EXCLUSIVE_LOCKS_REQUIRED(cs);
     CDeterministicMNList GetListForBlockInternal(gsl::not_null<const CBlockIndex*> pindex) EXCLUSIVE_LOCKS_REQUIRED(cs);
+    // mnListPrev is the list at pindexPrev if the caller has it already
+    CDeterministicMNCPtr GetMNPayeeInternal(gsl::not_null<const CBlockIndex*> pindexPrev, const CDeterministicMNList* mnListPrev = nullptr) LOCKS_EXCLUDED(cs);
 };
 
 bool CheckProRegTx(const CTransaction& tx, gsl::not_null<const CBlockIndex*> pindexPrev, TxValidationState& state, const CCoinsViewCache& view, bool check_sigs);
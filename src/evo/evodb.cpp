@@ -4,7 +4,226 @@
 
 #include <evo/evodb.h>
 
+#include <hash.h>
+#include <logging.h>
+#include <streams.h>
 #include <uint256.h>
+#include <util/metrics.h>
+#include <util/strencodings.h>
+
+#include <algorithm>
+#include <array>
+
+// Prefixes of the quorum data kept by llmq/quorums.cpp for the quorums this node is a member of
+static const std::array<std::string, 2> LOCAL_KEY_PREFIXES{"q_Qsk", "q_Qqvvec"};
+
+static bool IsLocalKey(CDataStream ssKey)
+{
+    std::string prefix;
+    try {
+        ssKey >> prefix;
+    } catch (const std::exception&) {
+        return false;
+    }
+    return std::find(LOCAL_KEY_PREFIXES.begin(), LOCAL_KEY_PREFIXES.end(), prefix) != LOCAL_KEY_PREFIXES.end();
+}
+
+struct EvoDBSnapshotPrefix {
+    std::string prefix;
+    //! the prefix is followed by the hash of the block the entry belongs to
+    bool by_block;
+};
+
+// Prefixes of the consensus data written to UTXO snapshots by CEvoDB::WriteSnapshot, keep in sync with STORE_INFO
+static const std::array<EvoDBSnapshotPrefix, 8> SNAPSHOT_KEY_PREFIXES{{
+    {"dmn_S3", true},
+    {"dmn_D3", true},
+    {"q_mc", false},
+    {"q_mcih", false},
+    {"q_mcihi", false},
+    {"cpm_S", true},
+    {"mnhf_s", true},
+    {EVODB_BEST_BLOCK, false},
+}};
+// Prefixes of the entries the caller of CEvoDB::WriteSnapshot selects from the blocks up to the snapshot base
+static const std::array<std::string, 2> SNAPSHOT_CHAIN_KEY_PREFIXES{"cbi", "llmq_S"};
+
+static bool IsSnapshotKey(CDataStream ssKey, const std::function<bool(const uint256&)>& in_chain)
+{
+    std::string prefix;
+    uint256 block_hash;
+    try {
+        ssKey >> prefix;
+        const auto it = std::find_if(SNAPSHOT_KEY_PREFIXES.begin(), SNAPSHOT_KEY_PREFIXES.end(),
+                                     [&prefix](const EvoDBSnapshotPrefix& p) { return p.prefix == prefix; });
+        if (it == SNAPSHOT_KEY_PREFIXES.end()) return false;
+        if (!it->by_block) return true;
+        ssKey >> block_hash;
+    } catch (const std::exception&) {
+        return false;
+    }
+    return in_chain(block_hash);
+}
+
+static bool IsSnapshotPrefix(CDataStream ssKey)
+{
+    std::string prefix;
+    try {
+        ssKey >> prefix;
+    } catch (const std::exception&) {
+        return false;
+    }
+    return std::any_of(SNAPSHOT_KEY_PREFIXES.begin(), SNAPSHOT_KEY_PREFIXES.end(), [&prefix](const EvoDBSnapshotPrefix& p) { return p.prefix == prefix; }) ||
+           std::find(SNAPSHOT_CHAIN_KEY_PREFIXES.begin(), SNAPSHOT_CHAIN_KEY_PREFIXES.end(), prefix) != SNAPSHOT_CHAIN_KEY_PREFIXES.end();
+}
+
+struct EvoDBStoreInfo {
+    std::string name;
+    //! keep in sync with the DB_ constants of the modules using the store
+    std::vector<std::string> prefixes;
+    //! percentage of the store caches' memory
+    size_t cache_share;
+};
+
+static const std::array<EvoDBStoreInfo, EVODB_STORE_COUNT> STORE_INFO{{
+    {"dmn_list", {"dmn_S3", "dmn_D3"}, 50},
+    {"quorum_commitments", {"q_mc", "q_mcih", "q_mcihi", "q_bbu2"}, 20},
+    {"quorum_data", {"llmq_S", "q_Qsk", "q_Qqvvec"}, 10},
+    {"credit_pool", {"cpm_S"}, 5},
+    {"mnhf", {"mnhf_s"}, 5},
+    {"cbtx_index", {"cbi"}, 5},
+    {"other", {}, 5},
+}};
+
+CEvoDBStores::CEvoDBStores(CDBWrapper& db, CDBBatch& batch, size_t cache_size) :
+    m_db(db),
+    m_batch(batch)
+{
+    for (size_t i = 0; i < EVODB_STORE_COUNT; ++i) {
+        const std::string& name = STORE_INFO[i].name;
+        m_stores[i].limit = cache_size / 100 * STORE_INFO[i].cache_share;
+        m_stores[i].hits = &metrics::GetCounter("evo.evodb." + name + ".hits");
+        m_stores[i].misses = &metrics::GetCounter("evo.evodb." + name + ".misses");
+        m_stores[i].read_latency = &metrics::GetHistogram("evo.evodb." + name + ".read_us");
+    }
+}
+
+static std::string_view AsStringView(const CDataStream& ss)
+{
+    return {(const char*)ss.data(), ss.size()};
+}
+
+EvoDBStore CEvoDBStores::GetStore(const CDataStream& ssKey)
+{
+    // Keys start with the serialized prefix string, a single length byte for the short prefixes in use
+    if (ssKey.empty()) return EvoDBStore::OTHER;
+    const size_t len = static_cast<uint8_t>(ssKey[0]);
+    if (len >= 253 || ssKey.size() < 1 + len) return EvoDBStore::OTHER;
+    const std::string_view prefix = AsStringView(ssKey).substr(1, len);
+    for (size_t i = 0; i < EVODB_STORE_COUNT; ++i) {
+        for (const auto& store_prefix : STORE_INFO[i].prefixes) {
+            if (prefix == store_prefix) return static_cast<EvoDBStore>(i);
+        }
+    }
+    return EvoDBStore::OTHER;
+}
+
+std::string CEvoDBStores::GetStoreName(EvoDBStore store)
+{
+    return STORE_INFO[static_cast<size_t>(store)].name;
+}
+
+std::optional<EvoDBStore> CEvoDBStores::GetStoreByName(const std::string& name)
+{
+    for (size_t i = 0; i < EVODB_STORE_COUNT; ++i) {
+        if (STORE_INFO[i].name == name) return static_cast<EvoDBStore>(i);
+    }
+    return std::nullopt;
+}
+
+const std::vector<std::string>& CEvoDBStores::GetStorePrefixes(EvoDBStore store)
+{
+    return STORE_INFO[static_cast<size_t>(store)].prefixes;
+}
+
+bool CEvoDBStores::ReadDataStream(Store& store, const CDataStream& ssKey, CDataStream& ssValue)
+{
+    const std::string_view key = AsStringView(ssKey);
+    if (const auto it = store.index.find(key); it != store.index.end()) {
+        store.hits->Inc();
+        store.lru.splice(store.lru.begin(), store.lru, it->second);
+        ssValue.write(it->second->second.data(), it->second->second.size());
+        return true;
+    }
+    store.misses->Inc();
+    // Only values which exist are cached, LevelDB's bloom filters already make looking up missing keys cheap
+    if (!m_db.ReadDataStream(ssKey, ssValue)) {
+        return false;
+    }
+
+    const size_t usage = ssKey.size() + ssValue.size() + CACHE_ENTRY_OVERHEAD;
+    if (usage > store.limit) return true;
+    while (store.usage + usage > store.limit) {
+        const auto& [old_key, old_value] = store.lru.back();
+        store.usage -= old_key.size() + old_value.size() + CACHE_ENTRY_OVERHEAD;
+        store.index.erase(old_key);
+        store.lru.pop_back();
+    }
+    store.lru.emplace_front(std::string(key), std::string(AsStringView(ssValue)));
+    store.index.emplace(store.lru.front().first, store.lru.begin());
+    store.usage += usage;
+    return true;
+}
+
+bool CEvoDBStores::Exists(const CDataStream& ssKey)
+{
+    Store& store = GetStoreData(ssKey);
+    if (store.index.count(AsStringView(ssKey))) {
+        store.hits->Inc();
+        return true;
+    }
+    store.misses->Inc();
+    return m_db.Exists(ssKey);
+}
+
+void CEvoDBStores::Invalidate(const CDataStream& ssKey)
+{
+    Store& store = GetStoreData(ssKey);
+    if (const auto it = store.index.find(AsStringView(ssKey)); it != store.index.end()) {
+        const auto lru_it = it->second;
+        store.usage -= lru_it->first.size() + lru_it->second.size() + CACHE_ENTRY_OVERHEAD;
+        store.index.erase(it);
+        store.lru.erase(lru_it);
+    }
+}
+
+void CEvoDBStores::ClearCache(EvoDBStore store)
+{
+    Store& data = m_stores[static_cast<size_t>(store)];
+    data.index.clear();
+    data.lru.clear();
+    data.usage = 0;
+}
+
+void CEvoDBStores::ClearCaches()
+{
+    for (size_t i = 0; i < EVODB_STORE_COUNT; ++i) {
+        ClearCache(static_cast<EvoDBStore>(i));
+    }
+}
+
+CEvoDBStores::Stats CEvoDBStores::GetStats(EvoDBStore store) const
+{
+    const Store& data = m_stores[static_cast<size_t>(store)];
+    Stats stats;
+    stats.cache_entries = data.index.size();
+    stats.cache_usage = data.usage;
+    stats.cache_limit = data.limit;
+    stats.hits = data.hits->Get();
+    stats.misses = data.misses->Get();
+    stats.read_latency = data.read_latency->GetSnapshot();
+    return stats;
+}
 
 CEvoDBScopedCommitter::CEvoDBScopedCommitter(CEvoDB &_evoDB) :
     evoDB(_evoDB)
@@ -32,9 +251,10 @@ void CEvoDBScopedCommitter::Rollback()
 }
 
 CEvoDB::CEvoDB(size_t nCacheSize, bool fMemory, bool fWipe) :
-    db(fMemory ? "" : (GetDataDir() / "evodb"), nCacheSize, fMemory, fWipe),
+    db(fMemory ? "" : (GetDataDir() / "evodb"), nCacheSize / 2, fMemory, fWipe),
     rootBatch(db),
-    rootDBTransaction(db, rootBatch),
+    stores(db, rootBatch, nCacheSize / 2),
+    rootDBTransaction(stores, stores),
     curDBTransaction(rootDBTransaction, rootDBTransaction)
 {
 }
@@ -53,6 +273,8 @@ void CEvoDB::RollbackCurTransaction()
 
 bool CEvoDB::CommitRootTransaction()
 {
+    static metrics::Histogram& histCommit = metrics::GetHistogram("evo.evodb.commit_us");
+    metrics::ScopedTimer timer(histCommit);
     LOCK(cs);
     assert(curDBTransaction.IsClean());
     rootDBTransaction.Commit();
@@ -61,6 +283,62 @@ bool CEvoDB::CommitRootTransaction()
     return ret;
 }
 
+CEvoDBStores::Stats CEvoDB::GetStoreStats(EvoDBStore store)
+{
+    LOCK(cs);
+    return stores.GetStats(store);
+}
+
+// Keys of a store are the ones starting with one of its serialized prefixes
+static std::vector<std::pair<std::vector<unsigned char>, std::vector<unsigned char>>> GetStoreKeyRanges(EvoDBStore store)
+{
+    std::vector<std::pair<std::vector<unsigned char>, std::vector<unsigned char>>> ranges;
+    for (const auto& prefix : CEvoDBStores::GetStorePrefixes(store)) {
+        CDataStream ssPrefix(SER_DISK, CLIENT_VERSION);
+        ssPrefix << prefix;
+        std::vector<unsigned char> begin{ssPrefix.begin(), ssPrefix.end()};
+        std::vector<unsigned char> end{begin};
+        ++end.back();
+        ranges.emplace_back(std::move(begin), std::move(end));
+    }
+    return ranges;
+}
+
+size_t CEvoDB::EstimateStoreSize(EvoDBStore store)
+{
+    if (store == EvoDBStore::OTHER) {
+        const std::vector<unsigned char> begin, end(8, 0xff);
+        size_t other = db.EstimateSize(Span<const unsigned char>{begin}, Span<const unsigned char>{end});
+        for (size_t i = 0; i < EVODB_STORE_COUNT; ++i) {
+            if (static_cast<EvoDBStore>(i) == EvoDBStore::OTHER) continue;
+            other -= std::min(other, EstimateStoreSize(static_cast<EvoDBStore>(i)));
+        }
+        return other;
+    }
+    size_t size{0};
+    for (const auto& [begin, end] : GetStoreKeyRanges(store)) {
+        size += db.EstimateSize(Span<const unsigned char>{begin}, Span<const unsigned char>{end});
+    }
+    return size;
+}
+
+void CEvoDB::CompactStore(EvoDBStore store)
+{
+    if (store == EvoDBStore::OTHER) {
+        db.CompactFull();
+        return;
+    }
+    for (const auto& [begin, end] : GetStoreKeyRanges(store)) {
+        db.CompactRange(Span<const unsigned char>{begin}, Span<const unsigned char>{end});
+    }
+}
+
+void CEvoDB::ClearStoreCache(EvoDBStore store)
+{
+    LOCK(cs);
+    stores.ClearCache(store);
+}
+
 bool CEvoDB::VerifyBestBlock(const uint256& hash)
 {
     // Make sure evodb is consistent.
@@ -76,3 +354,133 @@ void CEvoDB::WriteBestBlock(const uint256& hash)
 {
     Write(EVODB_BEST_BLOCK, hash);
 }
+
+EvoDBSnapshotStats CEvoDB::WriteSnapshot(CDBIterator& cursor, const std::function<bool(const uint256&)>& in_chain,
+                                         const EvoDBSnapshotEntries& chain_entries, CAutoFile& file,
+                                         const std::function<void()>& interruption_point)
+{
+    EvoDBSnapshotStats stats;
+    uint64_t seen{0};
+    for (cursor.SeekToFirst(); cursor.Valid(); cursor.Next()) {
+        if (++seen % 5000 == 0) interruption_point();
+        const CDataStream ssKey = cursor.GetKey();
+        if (!IsSnapshotKey(ssKey, in_chain)) continue;
+        ++stats.entries;
+        ++stats.store_entries[static_cast<size_t>(CEvoDBStores::GetStore(ssKey))];
+    }
+    for (const auto& [key, value] : chain_entries) {
+        assert(IsSnapshotPrefix(CDataStream(key, SER_DISK, CLIENT_VERSION)));
+        ++stats.entries;
+        ++stats.store_entries[static_cast<size_t>(CEvoDBStores::GetStore(CDataStream(key, SER_DISK, CLIENT_VERSION)))];
+    }
+    file << stats.entries;
+
+    CHashWriter hasher(SER_GETHASH, 0);
+    uint64_t written{0};
+    seen = 0;
+    for (cursor.SeekToFirst(); cursor.Valid(); cursor.Next()) {
+        if (++seen % 5000 == 0) interruption_point();
+        const CDataStream ssKey = cursor.GetKey();
+        if (!IsSnapshotKey(ssKey, in_chain)) continue;
+        const CDataStream ssValue = cursor.GetValue();
+        const std::vector<unsigned char> key{ssKey.begin(), ssKey.end()};
+        const std::vector<unsigned char> value{ssValue.begin(), ssValue.end()};
+        file << key << value;
+        hasher << key << value;
+        ++written;
+    }
+    for (const auto& [key, value] : chain_entries) {
+        file << key << value;
+        hasher << key << value;
+        ++written;
+    }
+    assert(written == stats.entries);
+
+    stats.hash = hasher.GetHash();
+    file << stats.hash;
+    return stats;
+}
+
+std::optional<EvoDBSnapshotStats> CEvoDB::VerifySnapshot(CAutoFile& file)
+{
+    EvoDBSnapshotStats stats;
+    CHashWriter hasher(SER_GETHASH, 0);
+    try {
+        file >> stats.entries;
+        std::vector<unsigned char> key, value;
+        for (uint64_t i = 0; i < stats.entries; ++i) {
+            file >> key >> value;
+            hasher << key << value;
+            const CDataStream ssKey(key, SER_DISK, CLIENT_VERSION);
+            if (!IsSnapshotPrefix(ssKey)) {
+                LogPrintf("[snapshot] unexpected key %s in EvoDB section\n", HexStr(key));
+                return std::nullopt;
+            }
+            ++stats.store_entries[static_cast<size_t>(CEvoDBStores::GetStore(ssKey))];
+        }
+        file >> stats.hash;
+    } catch (const std::ios_base::failure&) {
+        LogPrintf("[snapshot] bad snapshot format or truncated EvoDB section\n");
+        return std::nullopt;
+    }
+    if (stats.hash != hasher.GetHash()) {
+        LogPrintf("[snapshot] bad EvoDB section hash: expected %s, got %s\n", stats.hash.ToString(), hasher.GetHash().ToString());
+        return std::nullopt;
+    }
+    return stats;
+}
+
+bool CEvoDB::LoadSnapshot(CAutoFile& file, const EvoDBSnapshotStats& expected)
+{
+    static constexpr size_t BATCH_SIZE{16 << 20};
+
+    LOCK(cs);
+    curDBTransaction.Clear();
+    rootDBTransaction.Clear();
+    rootBatch.Clear();
+    stores.ClearCaches();
+
+    CDBBatch batch(db);
+    {
+        std::unique_ptr<CDBIterator> cursor(db.NewIterator());
+        for (cursor->SeekToFirst(); cursor->Valid(); cursor->Next()) {
+            const CDataStream ssKey = cursor->GetKey();
+            if (IsLocalKey(ssKey)) continue;
+            batch.Erase(ssKey);
+            if (batch.SizeEstimate() > BATCH_SIZE) {
+                if (!db.WriteBatch(batch)) return false;
+                batch.Clear();
+            }
+        }
+    }
+    if (!db.WriteBatch(batch)) return false;
+    batch.Clear();
+
+    CHashWriter hasher(SER_GETHASH, 0);
+    try {
+        uint64_t entries;
+        file >> entries;
+        if (entries != expected.entries) return false;
+        std::vector<unsigned char> key, value;
+        for (uint64_t i = 0; i < entries; ++i) {
+            file >> key >> value;
+            hasher << key << value;
+            batch.Write(CDataStream(key, SER_DISK, CLIENT_VERSION), Span<const unsigned char>{value});
+            if (batch.SizeEstimate() > BATCH_SIZE) {
+                if (!db.WriteBatch(batch)) return false;
+                batch.Clear();
+            }
+        }
+    } catch (const std::ios_base::failure&) {
+        LogPrintf("[snapshot] failed to read EvoDB section\n");
+        return false;
+    }
+    if (hasher.GetHash() != expected.hash) {
+        LogPrintf("[snapshot] EvoDB section changed since it was verified\n");
+        return false;
+    }
+    if (!db.WriteBatch(batch, true)) return false;
+
+    LogPrintf("[snapshot] loaded %d EvoDB entries with hash %s\n", expected.entries, expected.hash.ToString());
+    return true;
+}
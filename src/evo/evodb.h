@@ -7,16 +7,155 @@
 
 #include <dbwrapper.h>
 #include <sync.h>
+#include <uint256.h>
+#include <util/metrics.h>
 
-class uint256;
+#include <array>
+#include <functional>
+#include <list>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+class CAutoFile;
 // "b_b" was used in the initial version of deterministic MN storage
 // "b_b2" was used after compact diffs were introduced
 // "b_b3" was used after masternode type introduction in evoDB
 // "b_b4" was used after storing protx version for each masternode in evoDB
 static const std::string EVODB_BEST_BLOCK = "b_b4";
 
+//! -evodbcache default (MiB)
+static constexpr int64_t DEFAULT_EVODB_CACHE{64};
+
 class CEvoDB;
 
+/** The stores EvoDB is split into, by the prefix of their keys */
+enum class EvoDBStore : uint8_t {
+    DMN_LIST,           //!< deterministic masternode list snapshots and diffs
+    QUORUM_COMMITMENTS, //!< mined final commitments and their indexes
+    QUORUM_DATA,        //!< quorum snapshots, quorum verification vectors and secret key shares
+    CREDIT_POOL,        //!< credit pool snapshots
+    MNHF,               //!< MNHF signals
+    CBTX_INDEX,         //!< coinbase transaction index
+    OTHER,              //!< everything else, e.g. the best block
+};
+static constexpr size_t EVODB_STORE_COUNT{7};
+
+/** Number of entries and hash of the EvoDB contents bundled with a UTXO snapshot */
+struct EvoDBSnapshotStats {
+    uint64_t entries{0};
+    uint256 hash;
+    //! number of entries of each store, indexed by EvoDBStore
+    std::array<uint64_t, EVODB_STORE_COUNT> store_entries{};
+};
+
+/** Raw key/value pairs of EvoDB entries bundled with a UTXO snapshot, ordered by key */
+using EvoDBSnapshotEntries = std::map<std::vector<unsigned char>, std::vector<unsigned char>>;
+
+/**
+ * Number of blocks, up to the base of a UTXO snapshot, whose coinbase index entries and quorum snapshots are bundled
+ * with it. The credit pool, MNHF signals and rotated quorum members of the blocks after the base are computed from
+ * them, but they can't be rebuilt without the blocks, which a node loading the snapshot doesn't have.
+ */
+static constexpr int EVODB_SNAPSHOT_CHAIN_DEPTH{2880};
+
+/**
+ * EvoDB split into typed stores by key prefix. All stores live in the same LevelDB database, so that the changes
+ * of a block are still written atomically, but each store has its own cache of the values read recently, sized
+ * for its access pattern, and its own statistics. Large masternode list snapshots don't evict the small values
+ * read for every block, like mined commitments, this way.
+ *
+ * This is the parent of EvoDB's root transaction: it reads through the caches and commits into the root batch,
+ * dropping what was cached for the keys written. Not thread safe, CEvoDB::cs protects it.
+ */
+class CEvoDBStores
+{
+public:
+    struct Stats {
+        size_t cache_entries{0};
+        size_t cache_usage{0};
+        size_t cache_limit{0};
+        uint64_t hits{0};
+        uint64_t misses{0};
+        metrics::Histogram::Snapshot read_latency;
+    };
+
+    CEvoDBStores(CDBWrapper& db, CDBBatch& batch, size_t cache_size);
+
+    static EvoDBStore GetStore(const CDataStream& ssKey);
+    static std::string GetStoreName(EvoDBStore store);
+    static std::optional<EvoDBStore> GetStoreByName(const std::string& name);
+    //! Key prefixes of a store, empty for EvoDBStore::OTHER which holds all keys not matching another store
+    static const std::vector<std::string>& GetStorePrefixes(EvoDBStore store);
+
+    template <typename V>
+    bool Read(const CDataStream& ssKey, V& value)
+    {
+        Store& store = GetStoreData(ssKey);
+        metrics::ScopedTimer timer(*store.read_latency);
+        CDataStream ssValue(SER_DISK, CLIENT_VERSION);
+        if (!ReadDataStream(store, ssKey, ssValue)) {
+            return false;
+        }
+        try {
+            ssValue >> value;
+        } catch (const std::exception&) {
+            return false;
+        }
+        return true;
+    }
+
+    bool Exists(const CDataStream& ssKey);
+
+    CDBIterator* NewIterator() { return m_db.NewIterator(); }
+
+    template <typename V>
+    void Write(const CDataStream& ssKey, const V& value)
+    {
+        Invalidate(ssKey);
+        m_batch.Write(ssKey, value);
+    }
+
+    void Erase(const CDataStream& ssKey)
+    {
+        Invalidate(ssKey);
+        m_batch.Erase(ssKey);
+    }
+
+    //! Drop the cached values of a store, e.g. after its keys were changed in the database directly
+    void ClearCache(EvoDBStore store);
+    void ClearCaches();
+
+    Stats GetStats(EvoDBStore store) const;
+
+private:
+    //! Memory used per cached value on top of its key and value
+    static constexpr size_t CACHE_ENTRY_OVERHEAD{128};
+
+    struct Store {
+        //! Most recently used first
+        std::list<std::pair<std::string, std::string>> lru;
+        //! Points into lru, which doesn't move its elements
+        std::unordered_map<std::string_view, decltype(lru)::iterator> index;
+        size_t usage{0};
+        size_t limit{0};
+        metrics::Counter* hits{nullptr};
+        metrics::Counter* misses{nullptr};
+        metrics::Histogram* read_latency{nullptr};
+    };
+
+    CDBWrapper& m_db;
+    CDBBatch& m_batch;
+    std::array<Store, EVODB_STORE_COUNT> m_stores;
+
+    Store& GetStoreData(const CDataStream& ssKey) { return m_stores[static_cast<size_t>(GetStore(ssKey))]; }
+    bool ReadDataStream(Store& store, const CDataStream& ssKey, CDataStream& ssValue);
+    void Invalidate(const CDataStream& ssKey);
+};
+
 class CEvoDBScopedCommitter
 {
 private:
@@ -38,10 +177,11 @@ public:
 private:
     CDBWrapper db;
 
-    using RootTransaction = CDBTransaction<CDBWrapper, CDBBatch>;
+    using RootTransaction = CDBTransaction<CEvoDBStores, CEvoDBStores>;
     using CurTransaction = CDBTransaction<RootTransaction, RootTransaction>;
 
     CDBBatch rootBatch;
+    CEvoDBStores stores;
     RootTransaction rootDBTransaction;
     CurTransaction curDBTransaction;
 
@@ -100,11 +240,49 @@ public:
 
     bool CommitRootTransaction() LOCKS_EXCLUDED(cs);
 
+    CEvoDBStores::Stats GetStoreStats(EvoDBStore store) LOCKS_EXCLUDED(cs);
+    //! Approximate size of a store on disk
+    size_t EstimateStoreSize(EvoDBStore store);
+    //! Compact the part of the database holding a store, or the whole database for EvoDBStore::OTHER
+    void CompactStore(EvoDBStore store);
+    //! Drop the cached values of a store after its keys were changed through GetRawDB()
+    void ClearStoreCache(EvoDBStore store) LOCKS_EXCLUDED(cs);
+
     bool IsEmpty() { return db.IsEmpty(); }
 
     bool VerifyBestBlock(const uint256& hash);
     void WriteBestBlock(const uint256& hash);
 
+    /**
+     * Write the EvoDB section of a UTXO snapshot: the number of entries, the raw key/value pairs and their hash.
+     * Only consensus data is written, so that the hash doesn't depend on the history of the node: the masternode
+     * lists, mined commitments, credit pool snapshots, MNHF signals and best block seen through the cursor, those
+     * keyed by block only if in_chain accepts the block, followed by chain_entries.
+     */
+    static EvoDBSnapshotStats WriteSnapshot(CDBIterator& cursor, const std::function<bool(const uint256&)>& in_chain,
+                                            const EvoDBSnapshotEntries& chain_entries, CAutoFile& file,
+                                            const std::function<void()>& interruption_point);
+    /**
+     * Read the EvoDB section of a UTXO snapshot and check it against the hash it ends with, without writing anything.
+     * Sections with keys WriteSnapshot doesn't write are refused.
+     */
+    static std::optional<EvoDBSnapshotStats> VerifySnapshot(CAutoFile& file);
+    /** Add an entry, serialized like the database does, to the entries bundled with a UTXO snapshot */
+    template <typename K, typename V>
+    static void AddSnapshotEntry(EvoDBSnapshotEntries& entries, const K& key, const V& value)
+    {
+        CDataStream ssKey(SER_DISK, CLIENT_VERSION);
+        ssKey << key;
+        CDataStream ssValue(SER_DISK, CLIENT_VERSION);
+        ssValue << value;
+        entries.emplace(std::vector<unsigned char>{ssKey.begin(), ssKey.end()}, std::vector<unsigned char>{ssValue.begin(), ssValue.end()});
+    }
+    /**
+     * Replace the contents of the database, except for node-local data, with the EvoDB section of a UTXO snapshot
+     * which was checked by VerifySnapshot before. Uncommitted changes are dropped.
+     */
+    bool LoadSnapshot(CAutoFile& file, const EvoDBSnapshotStats& expected) LOCKS_EXCLUDED(cs);
+
 private:
     // only CEvoDBScopedCommitter is allowed to invoke these
     friend class CEvoDBScopedCommitter;
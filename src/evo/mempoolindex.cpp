@@ -0,0 +1,230 @@
+// Copyright (c) 2024 The Dash Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <evo/mempoolindex.h>
+
+#include <evo/specialtx.h>
+#include <memusage.h>
+
+namespace {
+template <typename T>
+CSpecialTxPayloadPtr MakePayload(const CTransaction& tx)
+{
+    auto opt_payload = GetTxPayload<T>(tx);
+    if (!opt_payload) return nullptr;
+    return std::make_shared<const CSpecialTxPayload>(CSpecialTxPayload{std::move(*opt_payload)});
+}
+
+template <typename K, typename M>
+void EraseIfOwner(M& map, const K& key, const uint256& txHash)
+{
+    auto it = map.find(key);
+    if (it != map.end() && it->second == txHash) {
+        map.erase(it);
+    }
+}
+
+template <typename K, typename M>
+std::optional<uint256> FindTx(const M& map, const K& key)
+{
+    auto it = map.find(key);
+    if (it == map.end()) return std::nullopt;
+    return it->second;
+}
+} // anonymous namespace
+
+bool IsMempoolIndexedSpecialTx(uint16_t nType)
+{
+    switch (nType) {
+    case TRANSACTION_PROVIDER_REGISTER:
+    case TRANSACTION_PROVIDER_UPDATE_SERVICE:
+    case TRANSACTION_PROVIDER_UPDATE_REGISTRAR:
+    case TRANSACTION_PROVIDER_UPDATE_REVOKE:
+    case TRANSACTION_ASSET_LOCK:
+    case TRANSACTION_ASSET_UNLOCK:
+    case TRANSACTION_MNHF_SIGNAL:
+        return true;
+    default:
+        return false;
+    }
+}
+
+CSpecialTxPayloadPtr ParseSpecialTxPayload(const CTransaction& tx)
+{
+    switch (tx.nType) {
+    case TRANSACTION_PROVIDER_REGISTER:
+        return MakePayload<CProRegTx>(tx);
+    case TRANSACTION_PROVIDER_UPDATE_SERVICE:
+        return MakePayload<CProUpServTx>(tx);
+    case TRANSACTION_PROVIDER_UPDATE_REGISTRAR:
+        return MakePayload<CProUpRegTx>(tx);
+    case TRANSACTION_PROVIDER_UPDATE_REVOKE:
+        return MakePayload<CProUpRevTx>(tx);
+    case TRANSACTION_ASSET_LOCK:
+        return MakePayload<CAssetLockPayload>(tx);
+    case TRANSACTION_ASSET_UNLOCK:
+        return MakePayload<CAssetUnlockPayload>(tx);
+    case TRANSACTION_MNHF_SIGNAL:
+        return MakePayload<MNHFTxPayload>(tx);
+    default:
+        return nullptr;
+    }
+}
+
+void CSpecialTxMempoolIndex::Add(const uint256& txHash, const CSpecialTxPayloadPtr& payload)
+{
+    if (!payload) return;
+    if (!m_payloads.emplace(txHash, payload).second) return;
+
+    if (const auto* proTx = payload->Get<CProRegTx>()) {
+        if (!proTx->collateralOutpoint.hash.IsNull()) {
+            m_protx_refs.emplace(txHash, proTx->collateralOutpoint.hash);
+        }
+        m_protx_addresses.emplace(proTx->addr, txHash);
+        m_protx_pubkey_ids.emplace(proTx->keyIDOwner, txHash);
+        m_protx_bls_pubkey_hashes.emplace(proTx->pubKeyOperator.GetHash(), txHash);
+        if (!proTx->collateralOutpoint.hash.IsNull()) {
+            m_protx_collaterals.emplace(proTx->collateralOutpoint, txHash);
+        } else {
+            m_protx_collaterals.emplace(COutPoint(txHash, proTx->collateralOutpoint.n), txHash);
+        }
+    } else if (const auto* proTx = payload->Get<CProUpServTx>()) {
+        m_protx_refs.emplace(proTx->proTxHash, txHash);
+        m_protx_addresses.emplace(proTx->addr, txHash);
+    } else if (const auto* proTx = payload->Get<CProUpRegTx>()) {
+        m_protx_refs.emplace(proTx->proTxHash, txHash);
+        m_protx_bls_pubkey_hashes.emplace(proTx->pubKeyOperator.GetHash(), txHash);
+    } else if (const auto* proTx = payload->Get<CProUpRevTx>()) {
+        m_protx_refs.emplace(proTx->proTxHash, txHash);
+    } else if (const auto* assetUnlockTx = payload->Get<CAssetUnlockPayload>()) {
+        m_asset_unlock_indexes.emplace(assetUnlockTx->getIndex(), txHash);
+        m_asset_unlock_expiry.emplace(txHash, assetUnlockTx->getHeightToExpiry());
+    }
+}
+
+void CSpecialTxMempoolIndex::Remove(const uint256& txHash)
+{
+    auto it = m_payloads.find(txHash);
+    if (it == m_payloads.end()) return;
+    const CSpecialTxPayloadPtr payload = std::move(it->second);
+    m_payloads.erase(it);
+
+    if (const auto* proTx = payload->Get<CProRegTx>()) {
+        if (!proTx->collateralOutpoint.hash.IsNull()) {
+            EraseProTxRef(txHash, proTx->collateralOutpoint.hash);
+        }
+        EraseIfOwner(m_protx_addresses, proTx->addr, txHash);
+        EraseIfOwner(m_protx_pubkey_ids, proTx->keyIDOwner, txHash);
+        EraseIfOwner(m_protx_bls_pubkey_hashes, proTx->pubKeyOperator.GetHash(), txHash);
+        EraseIfOwner(m_protx_collaterals, proTx->collateralOutpoint, txHash);
+        EraseIfOwner(m_protx_collaterals, COutPoint(txHash, proTx->collateralOutpoint.n), txHash);
+    } else if (const auto* proTx = payload->Get<CProUpServTx>()) {
+        EraseProTxRef(proTx->proTxHash, txHash);
+        EraseIfOwner(m_protx_addresses, proTx->addr, txHash);
+    } else if (const auto* proTx = payload->Get<CProUpRegTx>()) {
+        EraseProTxRef(proTx->proTxHash, txHash);
+        EraseIfOwner(m_protx_bls_pubkey_hashes, proTx->pubKeyOperator.GetHash(), txHash);
+    } else if (const auto* proTx = payload->Get<CProUpRevTx>()) {
+        EraseProTxRef(proTx->proTxHash, txHash);
+    } else if (const auto* assetUnlockTx = payload->Get<CAssetUnlockPayload>()) {
+        EraseIfOwner(m_asset_unlock_indexes, assetUnlockTx->getIndex(), txHash);
+        m_asset_unlock_expiry.erase(txHash);
+    }
+}
+
+void CSpecialTxMempoolIndex::Clear()
+{
+    m_payloads.clear();
+    m_protx_refs.clear();
+    m_protx_addresses.clear();
+    m_protx_pubkey_ids.clear();
+    m_protx_bls_pubkey_hashes.clear();
+    m_protx_collaterals.clear();
+    m_asset_unlock_indexes.clear();
+    m_asset_unlock_expiry.clear();
+}
+
+CSpecialTxPayloadPtr CSpecialTxMempoolIndex::GetPayload(const uint256& txHash) const
+{
+    auto it = m_payloads.find(txHash);
+    return it == m_payloads.end() ? nullptr : it->second;
+}
+
+std::optional<uint256> CSpecialTxMempoolIndex::GetTxByAddress(const CService& addr) const
+{
+    return FindTx(m_protx_addresses, addr);
+}
+
+std::optional<uint256> CSpecialTxMempoolIndex::GetTxByOwnerKey(const CKeyID& keyId) const
+{
+    return FindTx(m_protx_pubkey_ids, keyId);
+}
+
+std::optional<uint256> CSpecialTxMempoolIndex::GetTxByOperatorKey(const uint256& pubKeyHash) const
+{
+    return FindTx(m_protx_bls_pubkey_hashes, pubKeyHash);
+}
+
+std::optional<uint256> CSpecialTxMempoolIndex::GetTxByCollateral(const COutPoint& outpoint) const
+{
+    return FindTx(m_protx_collaterals, outpoint);
+}
+
+std::optional<uint256> CSpecialTxMempoolIndex::GetFirstProTxRef(const uint256& proTxHash) const
+{
+    return FindTx(m_protx_refs, proTxHash);
+}
+
+std::vector<uint256> CSpecialTxMempoolIndex::GetProTxRefs(const uint256& proTxHash) const
+{
+    std::vector<uint256> ret;
+    auto its = m_protx_refs.equal_range(proTxHash);
+    for (auto it = its.first; it != its.second; ++it) {
+        ret.emplace_back(it->second);
+    }
+    return ret;
+}
+
+void CSpecialTxMempoolIndex::EraseProTxRef(const uint256& proTxHash, const uint256& txHash)
+{
+    auto its = m_protx_refs.equal_range(proTxHash);
+    for (auto it = its.first; it != its.second;) {
+        if (it->second == txHash) {
+            it = m_protx_refs.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+std::optional<uint256> CSpecialTxMempoolIndex::GetAssetUnlockByIndex(uint64_t index) const
+{
+    return FindTx(m_asset_unlock_indexes, index);
+}
+
+std::vector<uint256> CSpecialTxMempoolIndex::GetExpiredAssetUnlocks(int nBlockHeight) const
+{
+    std::vector<uint256> ret;
+    for (const auto& [txHash, expiry] : m_asset_unlock_expiry) {
+        if (expiry < nBlockHeight) {
+            ret.emplace_back(txHash);
+        }
+    }
+    return ret;
+}
+
+size_t CSpecialTxMempoolIndex::DynamicMemoryUsage() const
+{
+    // all maps are empty when no payload is indexed, don't account their bucket arrays then
+    if (m_payloads.empty()) return 0;
+    return memusage::DynamicUsage(m_payloads) +
+           memusage::MallocUsage(sizeof(CSpecialTxPayload)) * m_payloads.size() +
+           memusage::DynamicUsage(m_protx_refs) +
+           memusage::DynamicUsage(m_protx_addresses) +
+           memusage::DynamicUsage(m_protx_pubkey_ids) +
+           memusage::DynamicUsage(m_protx_bls_pubkey_hashes) +
+           memusage::DynamicUsage(m_protx_collaterals) +
+           memusage::DynamicUsage(m_asset_unlock_indexes) +
+           memusage::DynamicUsage(m_asset_unlock_expiry);
+}
@@ -0,0 +1,123 @@
+// Copyright (c) 2024 The Dash Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_EVO_MEMPOOLINDEX_H
+#define BITCOIN_EVO_MEMPOOLINDEX_H
+
+#include <evo/assetlocktx.h>
+#include <evo/mnhftx.h>
+#include <evo/providertx.h>
+
+#include <netaddress.h>
+#include <primitives/transaction.h>
+#include <pubkey.h>
+#include <saltedhasher.h>
+#include <uint256.h>
+
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+template<>
+struct SaltedHasherImpl<COutPoint>
+{
+    static std::size_t CalcHash(const COutPoint& v, uint64_t k0, uint64_t k1)
+    {
+        return SipHashUint256Extra(k0, k1, v.hash, v.n);
+    }
+};
+
+template<>
+struct SaltedHasherImpl<CKeyID>
+{
+    static std::size_t CalcHash(const CKeyID& v, uint64_t k0, uint64_t k1)
+    {
+        return CSipHasher(k0, k1).Write(v.begin(), v.size()).Finalize();
+    }
+};
+
+template<>
+struct SaltedHasherImpl<CService>
+{
+    static std::size_t CalcHash(const CService& v, uint64_t k0, uint64_t k1)
+    {
+        const auto key = v.GetKey();
+        return CSipHasher(k0, k1).Write(key.data(), key.size()).Finalize();
+    }
+};
+
+/**
+ * Parsed payload of a special transaction which is tracked by CSpecialTxMempoolIndex.
+ * The payload is deserialized once when the mempool entry is created and shared from there on.
+ */
+struct CSpecialTxPayload
+{
+    std::variant<CProRegTx, CProUpServTx, CProUpRegTx, CProUpRevTx, CAssetLockPayload, CAssetUnlockPayload, MNHFTxPayload> data;
+
+    template <typename T>
+    const T* Get() const { return std::get_if<T>(&data); }
+};
+using CSpecialTxPayloadPtr = std::shared_ptr<const CSpecialTxPayload>;
+
+/** Whether transactions of this type have their payload tracked by the mempool */
+bool IsMempoolIndexedSpecialTx(uint16_t nType);
+
+/**
+ * Deserializes the payload of a special transaction tracked by the mempool.
+ * Returns nullptr for all other transactions or if the payload is malformed.
+ */
+CSpecialTxPayloadPtr ParseSpecialTxPayload(const CTransaction& tx);
+
+/**
+ * Conflict and lookup index for the special transactions in the mempool.
+ *
+ * Keeps the parsed payload of every tracked transaction together with salted hash maps
+ * for the unique ProTx fields (service address, owner key, operator key, collateral),
+ * references from ProTx updates to the ProRegTx they modify and the withdrawal index and
+ * expiry height of Asset Unlock transactions.
+ *
+ * Not thread-safe on its own, it is guarded by CTxMemPool::cs.
+ */
+class CSpecialTxMempoolIndex
+{
+private:
+    std::unordered_map<uint256, CSpecialTxPayloadPtr, StaticSaltedHasher> m_payloads;
+
+    std::unordered_multimap<uint256, uint256, StaticSaltedHasher> m_protx_refs; // proTxHash -> transaction (all TXs that refer to an existing proTx)
+    std::unordered_map<CService, uint256, StaticSaltedHasher> m_protx_addresses;
+    std::unordered_map<CKeyID, uint256, StaticSaltedHasher> m_protx_pubkey_ids;
+    std::unordered_map<uint256, uint256, StaticSaltedHasher> m_protx_bls_pubkey_hashes;
+    std::unordered_map<COutPoint, uint256, StaticSaltedHasher> m_protx_collaterals;
+
+    std::unordered_map<uint64_t, uint256> m_asset_unlock_indexes; // withdrawal index -> tx hash
+    std::unordered_map<uint256, int /* expiry height */, StaticSaltedHasher> m_asset_unlock_expiry;
+
+public:
+    /** Indexes a transaction, payload must be the result of ParseSpecialTxPayload() for it */
+    void Add(const uint256& txHash, const CSpecialTxPayloadPtr& payload);
+    void Remove(const uint256& txHash);
+    void Clear();
+
+    CSpecialTxPayloadPtr GetPayload(const uint256& txHash) const;
+
+    std::optional<uint256> GetTxByAddress(const CService& addr) const;
+    std::optional<uint256> GetTxByOwnerKey(const CKeyID& keyId) const;
+    std::optional<uint256> GetTxByOperatorKey(const uint256& pubKeyHash) const;
+    std::optional<uint256> GetTxByCollateral(const COutPoint& outpoint) const;
+
+    bool HasProTxRefs(const uint256& proTxHash) const { return m_protx_refs.count(proTxHash) != 0; }
+    std::optional<uint256> GetFirstProTxRef(const uint256& proTxHash) const;
+    std::vector<uint256> GetProTxRefs(const uint256& proTxHash) const;
+    void EraseProTxRef(const uint256& proTxHash, const uint256& txHash);
+
+    std::optional<uint256> GetAssetUnlockByIndex(uint64_t index) const;
+    std::vector<uint256> GetExpiredAssetUnlocks(int nBlockHeight) const;
+
+    size_t Size() const { return m_payloads.size(); }
+    size_t DynamicMemoryUsage() const;
+};
+
+#endif // BITCOIN_EVO_MEMPOOLINDEX_H
@@ -4,6 +4,7 @@
 
 #include <consensus/validation.h>
 #include <deploymentstatus.h>
+#include <evo/cbtxindex.h>
 #include <evo/mnhftx.h>
 #include <evo/specialtx.h>
 #include <llmq/commitment.h>
@@ -275,13 +276,15 @@ CMNHFManager::Signals CMNHFManager::GetForBlock(const CBlockIndex* pindex)
         pindex = pindex->pprev;
     }
 
-    const Consensus::Params& consensusParams{Params().GetConsensus()};
     while (!to_calculate.empty()) {
         const CBlockIndex* pindex_top{to_calculate.top()};
-        CBlock block;
-        if (!ReadBlockFromDisk(block, pindex_top, consensusParams)) {
+        // only the special transactions of the block are needed to extract its signals
+        const auto entry = GetCbTxIndexEntry(pindex_top);
+        if (entry == nullptr) {
             throw std::runtime_error("failed-getehfforblock-read");
         }
+        CBlock block;
+        block.vtx = entry->GetTransactions();
         BlockValidationState state;
         signalsTmp = ProcessBlock(block, pindex_top, false, state);
         if (!signalsTmp.has_value()) {
@@ -5,6 +5,7 @@
 #include <evo/simplifiedmns.h>
 
 #include <evo/cbtx.h>
+#include <evo/cbtxindex.h>
 #include <core_io.h>
 #include <deploymentstatus.h>
 #include <evo/deterministicmns.h>
@@ -369,22 +370,14 @@ bool BuildSimplifiedMNListDiff(const uint256& baseBlockHash, const uint256& bloc
         }
     }
 
-    // TODO store coinbase TX in CBlockIndex
-    CBlock block;
-    if (!ReadBlockFromDisk(block, blockIndex, Params().GetConsensus())) {
+    const auto cbTxEntry = GetCbTxIndexEntry(blockIndex);
+    if (cbTxEntry == nullptr) {
         errorRet = strprintf("failed to read block %s from disk", blockHash.ToString());
         return false;
     }
 
-    mnListDiffRet.cbTx = block.vtx[0];
-
-    std::vector<uint256> vHashes;
-    std::vector<bool> vMatch(block.vtx.size(), false);
-    for (const auto& tx : block.vtx) {
-        vHashes.emplace_back(tx->GetHash());
-    }
-    vMatch[0] = true; // only coinbase matches
-    mnListDiffRet.cbTxMerkleTree = CPartialMerkleTree(vHashes, vMatch);
+    mnListDiffRet.cbTx = cbTxEntry->cbTx;
+    mnListDiffRet.cbTxMerkleTree = cbTxEntry->cbTxMerkleTree;
 
     return true;
 }
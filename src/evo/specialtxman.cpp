@@ -8,6 +8,7 @@
 #include <consensus/validation.h>
 #include <deploymentstatus.h>
 #include <evo/cbtx.h>
+#include <evo/cbtxindex.h>
 #include <evo/creditpool.h>
 #include <evo/deterministicmns.h>
 #include <evo/mnhftx.h>
@@ -17,6 +18,7 @@
 #include <llmq/blockprocessor.h>
 #include <llmq/commitment.h>
 #include <primitives/block.h>
+#include <util/metrics.h>
 #include <validation.h>
 
 static bool CheckSpecialTxInner(const CTransaction& tx, const CBlockIndex* pindexPrev, const CCoinsViewCache& view, const std::optional<CRangesSet>& indexes, bool check_sigs, TxValidationState& state)
@@ -139,12 +141,12 @@ bool ProcessSpecialTxsInBlock(const CBlock& block, const CBlockIndex* pindex, CM
     AssertLockHeld(cs_main);
 
     try {
-        static int64_t nTimeLoop = 0;
-        static int64_t nTimeQuorum = 0;
-        static int64_t nTimeDMN = 0;
-        static int64_t nTimeMerkle = 0;
-        static int64_t nTimeCbTxCL = 0;
-        static int64_t nTimeMnehf = 0;
+        static metrics::Histogram& histLoop = metrics::GetHistogram("evo.specialtxs.loop_us");
+        static metrics::Histogram& histQuorum = metrics::GetHistogram("evo.specialtxs.quorum_block_processor_us");
+        static metrics::Histogram& histDMN = metrics::GetHistogram("evo.specialtxs.mn_manager_us");
+        static metrics::Histogram& histMerkle = metrics::GetHistogram("evo.specialtxs.cbtx_merkle_roots_us");
+        static metrics::Histogram& histCbTxCL = metrics::GetHistogram("evo.specialtxs.cbtx_best_chainlock_us");
+        static metrics::Histogram& histMnehf = metrics::GetHistogram("evo.specialtxs.mnhf_manager_us");
 
         int64_t nTime1 = GetTimeMicros();
 
@@ -170,8 +172,8 @@ bool ProcessSpecialTxsInBlock(const CBlock& block, const CBlockIndex* pindex, CM
         }
 
         int64_t nTime2 = GetTimeMicros();
-        nTimeLoop += nTime2 - nTime1;
-        LogPrint(BCLog::BENCHMARK, "        - Loop: %.2fms [%.2fs]\n", 0.001 * (nTime2 - nTime1), nTimeLoop * 0.000001);
+        histLoop.Observe(nTime2 - nTime1);
+        LogPrint(BCLog::BENCHMARK, "        - Loop: %.2fms [%.2fs]\n", 0.001 * (nTime2 - nTime1), histLoop.Sum() * 0.000001);
 
         if (!quorum_block_processor.ProcessBlock(block, pindex, state, fJustCheck, fCheckCbTxMerleRoots)) {
             // pass the state returned by the function above
@@ -179,8 +181,8 @@ bool ProcessSpecialTxsInBlock(const CBlock& block, const CBlockIndex* pindex, CM
         }
 
         int64_t nTime3 = GetTimeMicros();
-        nTimeQuorum += nTime3 - nTime2;
-        LogPrint(BCLog::BENCHMARK, "        - quorumBlockProcessor: %.2fms [%.2fs]\n", 0.001 * (nTime3 - nTime2), nTimeQuorum * 0.000001);
+        histQuorum.Observe(nTime3 - nTime2);
+        LogPrint(BCLog::BENCHMARK, "        - quorumBlockProcessor: %.2fms [%.2fs]\n", 0.001 * (nTime3 - nTime2), histQuorum.Sum() * 0.000001);
 
         if (!deterministicMNManager->ProcessBlock(block, pindex, state, view, fJustCheck, updatesRet)) {
             // pass the state returned by the function above
@@ -188,8 +190,8 @@ bool ProcessSpecialTxsInBlock(const CBlock& block, const CBlockIndex* pindex, CM
         }
 
         int64_t nTime4 = GetTimeMicros();
-        nTimeDMN += nTime4 - nTime3;
-        LogPrint(BCLog::BENCHMARK, "        - deterministicMNManager: %.2fms [%.2fs]\n", 0.001 * (nTime4 - nTime3), nTimeDMN * 0.000001);
+        histDMN.Observe(nTime4 - nTime3);
+        LogPrint(BCLog::BENCHMARK, "        - deterministicMNManager: %.2fms [%.2fs]\n", 0.001 * (nTime4 - nTime3), histDMN.Sum() * 0.000001);
 
         if (fCheckCbTxMerleRoots && !CheckCbTxMerkleRoots(block, pindex, quorum_block_processor, state, view)) {
             // pass the state returned by the function above
@@ -197,8 +199,8 @@ bool ProcessSpecialTxsInBlock(const CBlock& block, const CBlockIndex* pindex, CM
         }
 
         int64_t nTime5 = GetTimeMicros();
-        nTimeMerkle += nTime5 - nTime4;
-        LogPrint(BCLog::BENCHMARK, "        - CheckCbTxMerkleRoots: %.2fms [%.2fs]\n", 0.001 * (nTime5 - nTime4), nTimeMerkle * 0.000001);
+        histMerkle.Observe(nTime5 - nTime4);
+        LogPrint(BCLog::BENCHMARK, "        - CheckCbTxMerkleRoots: %.2fms [%.2fs]\n", 0.001 * (nTime5 - nTime4), histMerkle.Sum() * 0.000001);
 
         if (fCheckCbTxMerleRoots && !CheckCbTxBestChainlock(block, pindex, chainlock_handler, state)) {
             // pass the state returned by the function above
@@ -206,8 +208,8 @@ bool ProcessSpecialTxsInBlock(const CBlock& block, const CBlockIndex* pindex, CM
         }
 
         int64_t nTime6 = GetTimeMicros();
-        nTimeCbTxCL += nTime6 - nTime5;
-        LogPrint(BCLog::BENCHMARK, "        - CheckCbTxBestChainlock: %.2fms [%.2fs]\n", 0.001 * (nTime6 - nTime5), nTimeCbTxCL * 0.000001);
+        histCbTxCL.Observe(nTime6 - nTime5);
+        LogPrint(BCLog::BENCHMARK, "        - CheckCbTxBestChainlock: %.2fms [%.2fs]\n", 0.001 * (nTime6 - nTime5), histCbTxCL.Sum() * 0.000001);
 
         if (!mnhfManager.ProcessBlock(block, pindex, fJustCheck, state)) {
             // pass the state returned by the function above
@@ -215,8 +217,12 @@ bool ProcessSpecialTxsInBlock(const CBlock& block, const CBlockIndex* pindex, CM
         }
 
         int64_t nTime7 = GetTimeMicros();
-        nTimeMnehf += nTime7 - nTime6;
-        LogPrint(BCLog::BENCHMARK, "        - mnhfManager: %.2fms [%.2fs]\n", 0.001 * (nTime7 - nTime6), nTimeMnehf * 0.000001);
+        histMnehf.Observe(nTime7 - nTime6);
+        LogPrint(BCLog::BENCHMARK, "        - mnhfManager: %.2fms [%.2fs]\n", 0.001 * (nTime7 - nTime6), histMnehf.Sum() * 0.000001);
+
+        if (!fJustCheck) {
+            cbTxIndex->ConnectBlock(block, pindex);
+        }
 
         if (Params().GetConsensus().V19Height == pindex->nHeight + 1) {
             // NOTE: The block next to the activation is the one that is using new rules.
@@ -264,6 +270,8 @@ bool UndoSpecialTxsInBlock(const CBlock& block, const CBlockIndex* pindex, CMNHF
         if (!quorum_block_processor.UndoBlock(block, pindex)) {
             return false;
         }
+
+        cbTxIndex->DisconnectBlock(pindex);
     } catch (const std::exception& e) {
         bls::bls_legacy_scheme.store(bls_legacy_scheme);
         LogPrintf("%s: bls_legacy_scheme=%d\n", __func__, bls::bls_legacy_scheme.load());
@@ -25,6 +25,14 @@
 /** WWW-Authenticate to present with 401 Unauthorized response */
 static const char* WWW_AUTH_HEADER_DATA = "Basic realm=\"jsonrpc\"";
 
+/** RPC methods with potentially huge results. Their result is still built in full by the method, but the reply is
+ *  streamed to the client instead of being copied into a reply object and serialized into one string first. */
+static const std::set<std::string> STREAMED_REPLY_METHODS{
+    "getaddressdeltas", "getblock", "gobject", "masternodelist", "protx", "quorum",
+};
+/** Size of the chunks streamed replies are sent in */
+static const size_t STREAMED_REPLY_CHUNK_SIZE{64 * 1024};
+
 /** Simple one-shot callback timer to be used by the RPC mechanism to e.g.
  * re-lock the wallet.
  */
@@ -200,6 +208,16 @@ static bool HTTPReq_JSONRPC(const CoreContext& context, HTTPRequest* req)
             }
             UniValue result = tableRPC.execute(jreq);
 
+            if (STREAMED_REPLY_METHODS.count(jreq.strMethod)) {
+                req->WriteHeader("Content-Type", "application/json");
+                req->WriteReplyStart(HTTP_OK);
+                if (!JSONRPCReplyStream(result, NullUniValue, jreq.id, STREAMED_REPLY_CHUNK_SIZE, [req](const std::string& chunk) { return req->WriteReplyChunk(chunk); })) {
+                    LogPrint(BCLog::RPC, "Client disconnected while receiving the reply of %s\n", jreq.strMethod);
+                }
+                req->WriteReplyEnd();
+                return true;
+            }
+
             // Send reply
             strReply = JSONRPCReply(result, NullUniValue, jreq.id);
 
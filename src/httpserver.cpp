@@ -15,11 +15,15 @@
 #include <shutdown.h>
 #include <sync.h>
 #include <util/strencodings.h>
+#include <util/string.h>
 #include <util/system.h>
 #include <util/threadnames.h>
+#include <util/time.h>
 #include <util/translation.h>
 
+#include <atomic>
 #include <deque>
+#include <map>
 #include <stdio.h>
 #include <string>
 
@@ -38,26 +42,11 @@
 
 /** Maximum size of http request (request line + headers) */
 static const size_t MAX_HEADERS_SIZE = 8192;
+/** Maximum amount of a chunked reply waiting to be sent to the client */
+static const size_t MAX_REPLY_BUFFER_SIZE = 1024 * 1024;
+/** How often to check whether a client received enough of a chunked reply to send more */
+static const int REPLY_BUFFER_POLL_MS = 10;
 
-/** HTTP request work item */
-class HTTPWorkItem final : public HTTPClosure
-{
-public:
-    HTTPWorkItem(std::unique_ptr<HTTPRequest> _req, const std::string &_path, const HTTPRequestHandler& _func):
-        req(std::move(_req)), path(_path), func(_func)
-    {
-    }
-    void operator()() override
-    {
-        func(req.get(), path);
-    }
-
-    std::unique_ptr<HTTPRequest> req;
-
-private:
-    std::string path;
-    HTTPRequestHandler func;
-};
 
 /** Simple work queue for distributing work over multiple threads.
  * Work items are simply callable objects.
@@ -117,6 +106,62 @@ public:
         running = false;
         cond.notify_all();
     }
+    /** Return current depth of queue */
+    size_t Depth()
+    {
+        LOCK(cs);
+        return queue.size();
+    }
+    size_t MaxDepth() const { return maxDepth; }
+};
+
+/** Work queue with its own worker threads. Requests are assigned to a class by the RPC method
+ * they call, so that slow methods can't occupy the workers of cheap ones.
+ */
+struct HTTPWorkClass
+{
+    HTTPWorkClass(std::string _name, int _threads, size_t _maxDepth) :
+        name(std::move(_name)), threads(_threads), queue(_maxDepth)
+    {
+    }
+    const std::string name;
+    const int threads;
+    WorkQueue<HTTPClosure> queue;
+    std::vector<std::thread> workers;
+
+    std::atomic<uint64_t> requests{0};
+    std::atomic<uint64_t> rejected{0};
+    //! Requests picked up by a worker and the time they spent in the queue before, in microseconds
+    std::atomic<uint64_t> dequeued{0};
+    std::atomic<int64_t> queue_time_total{0};
+    std::atomic<int64_t> queue_time_max{0};
+};
+
+/** HTTP request work item */
+class HTTPWorkItem final : public HTTPClosure
+{
+public:
+    HTTPWorkItem(std::unique_ptr<HTTPRequest> _req, const std::string &_path, const HTTPRequestHandler& _func, HTTPWorkClass& _work_class):
+        req(std::move(_req)), path(_path), func(_func), work_class(_work_class), time_enqueued(GetTimeMicros())
+    {
+    }
+    void operator()() override
+    {
+        const int64_t queue_time = GetTimeMicros() - time_enqueued;
+        work_class.queue_time_total += queue_time;
+        ++work_class.dequeued;
+        int64_t queue_time_max = work_class.queue_time_max;
+        while (queue_time > queue_time_max && !work_class.queue_time_max.compare_exchange_weak(queue_time_max, queue_time)) {}
+        func(req.get(), path);
+    }
+
+    std::unique_ptr<HTTPRequest> req;
+
+private:
+    std::string path;
+    HTTPRequestHandler func;
+    HTTPWorkClass& work_class;
+    const int64_t time_enqueued;
 };
 
 struct HTTPPathHandler
@@ -138,8 +183,10 @@ static struct event_base* eventBase = nullptr;
 static struct evhttp* eventHTTP = nullptr;
 //! List of subnets to allow RPC connections from
 static std::vector<CSubNet> rpc_allow_subnets;
-//! Work queue for handling longer requests off the event loop thread
-static std::unique_ptr<WorkQueue<HTTPClosure>> g_work_queue{nullptr};
+//! Work queues for handling longer requests off the event loop thread, the first one is the default
+static std::vector<std::unique_ptr<HTTPWorkClass>> g_work_classes;
+//! Work classes of RPC methods which don't use the default one
+static std::map<std::string, HTTPWorkClass*> g_method_work_classes;
 //! Handlers for (sub)paths
 static std::vector<HTTPPathHandler> pathHandlers;
 //! Bound listening sockets
@@ -205,6 +252,47 @@ std::string RequestMethodString(HTTPRequest::RequestMethod m)
     }
 }
 
+/** Pick the work queue for a JSON-RPC body by the method it calls. Only the beginning of the
+ * body is scanned for the method name, batches and anything unusual go to the default queue.
+ */
+static HTTPWorkClass& GetWorkClass(const std::string& body)
+{
+    HTTPWorkClass& default_class = *g_work_classes.front();
+    size_t pos = body.find("\"method\"");
+    if (pos == std::string::npos || body.find_first_not_of(" \t\r\n") != body.find('{')) {
+        return default_class;
+    }
+    pos = body.find_first_not_of(" \t\r\n", pos + 8);
+    if (pos == std::string::npos || body[pos] != ':') {
+        return default_class;
+    }
+    pos = body.find_first_not_of(" \t\r\n", pos + 1);
+    if (pos == std::string::npos || body[pos] != '"') {
+        return default_class;
+    }
+    const size_t end = body.find('"', pos + 1);
+    if (end == std::string::npos) {
+        return default_class;
+    }
+    const auto it = g_method_work_classes.find(body.substr(pos + 1, end - pos - 1));
+    return it != g_method_work_classes.end() ? *it->second : default_class;
+}
+
+/** Pick the work queue for a request, the body is only looked at if any method has its own class */
+static HTTPWorkClass& GetWorkClass(HTTPRequest& req)
+{
+    if (g_method_work_classes.empty() || req.GetRequestMethod() != HTTPRequest::POST) {
+        return *g_work_classes.front();
+    }
+    return GetWorkClass(req.PeekBody(HTTP_WORK_CLASS_SCAN_SIZE));
+}
+
+std::string GetHTTPWorkClassName(const std::string& body)
+{
+    assert(!g_work_classes.empty());
+    return GetWorkClass(body.substr(0, HTTP_WORK_CLASS_SCAN_SIZE)).name;
+}
+
 /** HTTP request callback */
 static void http_request_cb(struct evhttp_request* req, void* arg)
 {
@@ -258,12 +346,16 @@ static void http_request_cb(struct evhttp_request* req, void* arg)
 
     // Dispatch to worker thread
     if (i != iend) {
-        auto item{std::make_unique<HTTPWorkItem>(std::move(hreq), path, i->handler)};
-        assert(g_work_queue);
-        if (g_work_queue->Enqueue(item.get())) {
+        assert(!g_work_classes.empty());
+        HTTPWorkClass& work_class = GetWorkClass(*hreq);
+        auto item{std::make_unique<HTTPWorkItem>(std::move(hreq), path, i->handler, work_class)};
+        ++work_class.requests;
+        if (work_class.queue.Enqueue(item.get())) {
             item.release(); /* if true, queue took ownership */
         } else {
-            LogPrintf("WARNING: request rejected because http work queue depth exceeded, it can be increased with the -rpcworkqueue= setting\n");
+            --work_class.requests;
+            ++work_class.rejected;
+            LogPrintf("WARNING: request rejected because http work queue depth of class %s exceeded, it can be increased with the -rpcworkqueue= or -rpcworkclass= setting\n", work_class.name);
             item->req->WriteReply(HTTP_SERVICE_UNAVAILABLE, "Work queue depth exceeded");
         }
     } else {
@@ -335,12 +427,70 @@ static bool HTTPBindAddresses(struct evhttp* http)
 }
 
 /** Simple wrapper to set thread name and run work queue */
-static void HTTPWorkQueueRun(WorkQueue<HTTPClosure>* queue, int worker_num)
+static void HTTPWorkQueueRun(WorkQueue<HTTPClosure>* queue, const std::string& class_name, int worker_num)
 {
-    util::ThreadRename(strprintf("httpworker.%i", worker_num));
+    util::ThreadRename(class_name == HTTP_WORK_CLASS_DEFAULT ? strprintf("httpworker.%i", worker_num) : strprintf("http%s.%i", class_name, worker_num));
     queue->Run();
 }
 
+bool InitHTTPWorkClasses(const ArgsManager& args)
+{
+    g_work_classes.clear();
+    g_method_work_classes.clear();
+
+    int rpcThreads = std::max((long)args.GetArg("-rpcthreads", DEFAULT_HTTP_THREADS), 1L);
+    int workQueueDepth = std::max((long)args.GetArg("-rpcworkqueue", DEFAULT_HTTP_WORKQUEUE), 1L);
+    LogPrintf("HTTP: creating work queue of depth %d\n", workQueueDepth);
+    g_work_classes.emplace_back(std::make_unique<HTTPWorkClass>(HTTP_WORK_CLASS_DEFAULT, rpcThreads, workQueueDepth));
+
+    std::map<std::string, std::pair<int, int>> mapClasses;
+    for (const std::string& strClass : args.GetArgs("-rpcworkclass")) {
+        const std::vector<std::string> vecParts = SplitString(strClass, ':');
+        int threads, depth;
+        if (vecParts.size() != 3 || vecParts[0].empty() || vecParts[0] == HTTP_WORK_CLASS_DEFAULT ||
+            !ParseInt32(vecParts[1], &threads) || !ParseInt32(vecParts[2], &depth) || threads < 1 || depth < 1) {
+            uiInterface.ThreadSafeMessageBox(
+                strprintf(Untranslated("Invalid -rpcworkclass specification: %s. Expected <class>:<threads>:<depth>."), strClass),
+                "", CClientUIInterface::MSG_ERROR);
+            return false;
+        }
+        mapClasses[vecParts[0]] = {threads, depth};
+    }
+    std::map<std::string, HTTPWorkClass*> mapClassByName{{HTTP_WORK_CLASS_DEFAULT, g_work_classes.front().get()}};
+    for (const auto& [name, params] : mapClasses) {
+        LogPrintf("HTTP: creating work queue %s of depth %d\n", name, params.second);
+        g_work_classes.emplace_back(std::make_unique<HTTPWorkClass>(name, params.first, params.second));
+        mapClassByName.emplace(name, g_work_classes.back().get());
+    }
+
+    // the heavy class is opt-in, once it's created it serves the known slow methods by default
+    if (const auto it = mapClassByName.find(HTTP_WORK_CLASS_HEAVY); it != mapClassByName.end()) {
+        for (const auto& method : DEFAULT_HTTP_HEAVY_METHODS) {
+            g_method_work_classes.emplace(method, it->second);
+        }
+    }
+    for (const std::string& strMethodClass : args.GetArgs("-rpcmethodclass")) {
+        const std::vector<std::string> vecParts = SplitString(strMethodClass, ':');
+        const auto it = vecParts.size() == 2 ? mapClassByName.find(vecParts[1]) : mapClassByName.end();
+        if (vecParts[0].empty() || it == mapClassByName.end()) {
+            uiInterface.ThreadSafeMessageBox(
+                strprintf(Untranslated("Invalid -rpcmethodclass specification: %s. Expected <method>:<class> with a class defined by -rpcworkclass."), strMethodClass),
+                "", CClientUIInterface::MSG_ERROR);
+            return false;
+        }
+        g_method_work_classes[vecParts[0]] = it->second;
+    }
+    // methods explicitly moved back to the default class don't need a lookup entry
+    for (auto it = g_method_work_classes.begin(); it != g_method_work_classes.end();) {
+        if (it->second == g_work_classes.front().get()) {
+            it = g_method_work_classes.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    return true;
+}
+
 /** libevent event log callback */
 static void libevent_log_cb(int severity, const char *msg)
 {
@@ -356,6 +506,9 @@ bool InitHTTPServer()
     if (!InitHTTPAllowList())
         return false;
 
+    if (!InitHTTPWorkClasses(gArgs))
+        return false;
+
     // Redirect libevent's logging to our own log
     event_set_log_callback(&libevent_log_cb);
     // Update libevent's log handling. Returns false if our version of
@@ -392,10 +545,7 @@ bool InitHTTPServer()
     }
 
     LogPrint(BCLog::HTTP, "Initialized HTTP server\n");
-    int workQueueDepth = std::max((long)gArgs.GetArg("-rpcworkqueue", DEFAULT_HTTP_WORKQUEUE), 1L);
-    LogPrintf("HTTP: creating work queue of depth %d\n", workQueueDepth);
 
-    g_work_queue = std::make_unique<WorkQueue<HTTPClosure>>(workQueueDepth);
     // transfer ownership to eventBase/HTTP via .release()
     eventBase = base_ctr.release();
     eventHTTP = http_ctr.release();
@@ -417,17 +567,17 @@ bool UpdateHTTPServerLogging(bool enable) {
 }
 
 static std::thread g_thread_http;
-static std::vector<std::thread> g_thread_http_workers;
 
 void StartHTTPServer()
 {
     LogPrint(BCLog::HTTP, "Starting HTTP server\n");
-    int rpcThreads = std::max((long)gArgs.GetArg("-rpcthreads", DEFAULT_HTTP_THREADS), 1L);
-    LogPrintf("HTTP: starting %d worker threads\n", rpcThreads);
     g_thread_http = std::thread(ThreadHTTP, eventBase);
 
-    for (int i = 0; i < rpcThreads; i++) {
-        g_thread_http_workers.emplace_back(HTTPWorkQueueRun, g_work_queue.get(), i);
+    for (auto& work_class : g_work_classes) {
+        LogPrintf("HTTP: starting %d worker threads for work queue %s\n", work_class->threads, work_class->name);
+        for (int i = 0; i < work_class->threads; i++) {
+            work_class->workers.emplace_back(HTTPWorkQueueRun, &work_class->queue, work_class->name, i);
+        }
     }
 }
 
@@ -438,20 +588,22 @@ void InterruptHTTPServer()
         // Reject requests on current connections
         evhttp_set_gencb(eventHTTP, http_reject_request_cb, nullptr);
     }
-    if (g_work_queue) {
-        g_work_queue->Interrupt();
+    for (auto& work_class : g_work_classes) {
+        work_class->queue.Interrupt();
     }
 }
 
 void StopHTTPServer()
 {
     LogPrint(BCLog::HTTP, "Stopping HTTP server\n");
-    if (g_work_queue) {
+    if (!g_work_classes.empty()) {
         LogPrint(BCLog::HTTP, "Waiting for HTTP worker threads to exit\n");
-        for (auto& thread : g_thread_http_workers) {
-            thread.join();
+        for (auto& work_class : g_work_classes) {
+            for (auto& thread : work_class->workers) {
+                thread.join();
+            }
+            work_class->workers.clear();
         }
-        g_thread_http_workers.clear();
     }
     // Unlisten sockets, these are what make the event loop running, which means
     // that after this and all connections are closed the event loop will quit.
@@ -471,10 +623,21 @@ void StopHTTPServer()
         event_base_free(eventBase);
         eventBase = nullptr;
     }
-    g_work_queue.reset();
+    g_method_work_classes.clear();
+    g_work_classes.clear();
     LogPrint(BCLog::HTTP, "Stopped HTTP server\n");
 }
 
+std::vector<HTTPWorkClassStats> GetHTTPWorkClassStats()
+{
+    std::vector<HTTPWorkClassStats> ret;
+    for (const auto& work_class : g_work_classes) {
+        ret.push_back({work_class->name, work_class->threads, work_class->queue.Depth(), work_class->queue.MaxDepth(),
+                       work_class->requests, work_class->rejected, work_class->dequeued, work_class->queue_time_total, work_class->queue_time_max});
+    }
+    return ret;
+}
+
 struct event_base* EventBase()
 {
     return eventBase;
@@ -531,6 +694,18 @@ std::pair<bool, std::string> HTTPRequest::GetHeader(const std::string& hdr) cons
         return std::make_pair(false, "");
 }
 
+std::string HTTPRequest::PeekBody(size_t max_size)
+{
+    struct evbuffer* buf = evhttp_request_get_input_buffer(req);
+    if (!buf)
+        return "";
+    size_t size = std::min(evbuffer_get_length(buf), max_size);
+    const char* data = (const char*)evbuffer_pullup(buf, size);
+    if (!data)
+        return "";
+    return std::string(data, size);
+}
+
 std::string HTTPRequest::ReadBody()
 {
     struct evbuffer* buf = evhttp_request_get_input_buffer(req);
@@ -558,11 +733,95 @@ void HTTPRequest::WriteHeader(const std::string& hdr, const std::string& value)
     evhttp_add_header(headers, hdr.c_str(), value.c_str());
 }
 
-/** Closure sent to main thread to request a reply to be sent to
- * a HTTP request.
- * Replies must be sent in the main loop in the main http thread,
- * this cannot be done from worker threads.
- */
+/** Run func on the event loop thread and wait until it returns true, it's retried as long as it returns false */
+static void RunInEventLoop(const std::function<bool()>& func)
+{
+    struct State {
+        Mutex cs;
+        std::condition_variable cond;
+        bool done GUARDED_BY(cs){false};
+    };
+    auto state = std::make_shared<State>();
+    std::function<void(struct timeval*)> schedule;
+    schedule = [&func, &schedule, state](struct timeval* tv) {
+        HTTPEvent* ev = new HTTPEvent(eventBase, true, [&func, &schedule, state] {
+            if (!func()) {
+                struct timeval tv{0, REPLY_BUFFER_POLL_MS * 1000};
+                schedule(&tv);
+                return;
+            }
+            LOCK(state->cs);
+            state->done = true;
+            state->cond.notify_all();
+        });
+        ev->trigger(tv);
+    };
+    schedule(nullptr);
+
+    WAIT_LOCK(state->cs, lock);
+    state->cond.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(state->cs) { return state->done; });
+}
+
+void HTTPRequest::WriteReplyStart(int nStatus)
+{
+    assert(!replySent && req);
+    if (ShutdownRequested()) {
+        WriteHeader("Connection", "close");
+    }
+    auto req_copy = req;
+    RunInEventLoop([req_copy, nStatus] {
+        evhttp_send_reply_start(req_copy, nStatus, nullptr);
+        return true;
+    });
+    replySent = true;
+}
+
+bool HTTPRequest::WriteReplyChunk(const std::string& strChunk)
+{
+    assert(replySent && req);
+    auto req_copy = req;
+    bool connected{true};
+    RunInEventLoop([req_copy, &strChunk, &connected] {
+        // libevent detaches the request from its connection when the client disconnects
+        evhttp_connection* conn = evhttp_request_get_connection(req_copy);
+        if (!conn) {
+            connected = false;
+            return true;
+        }
+        bufferevent* bev = evhttp_connection_get_bufferevent(conn);
+        if (bev && evbuffer_get_length(bufferevent_get_output(bev)) > MAX_REPLY_BUFFER_SIZE) {
+            return false;
+        }
+        struct evbuffer* evb = evbuffer_new();
+        evbuffer_add(evb, strChunk.data(), strChunk.size());
+        evhttp_send_reply_chunk(req_copy, evb);
+        evbuffer_free(evb);
+        return true;
+    });
+    return connected;
+}
+
+void HTTPRequest::WriteReplyEnd()
+{
+    assert(replySent && req);
+    auto req_copy = req;
+    HTTPEvent* ev = new HTTPEvent(eventBase, true, [req_copy] {
+        // Re-enable reading from the socket, see WriteReply.
+        if (event_get_version_number() >= 0x02010600 && event_get_version_number() < 0x02020001) {
+            evhttp_connection* conn = evhttp_request_get_connection(req_copy);
+            if (conn) {
+                bufferevent* bev = evhttp_connection_get_bufferevent(conn);
+                if (bev) {
+                    bufferevent_enable(bev, EV_READ | EV_WRITE);
+                }
+            }
+        }
+        evhttp_send_reply_end(req_copy);
+    });
+    ev->trigger(nullptr);
+    req = nullptr; // transferred back to main thread
+}
+
 void HTTPRequest::WriteReply(int nStatus, const std::string& strReply)
 {
     assert(!replySent && req);
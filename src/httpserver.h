@@ -5,15 +5,28 @@
 #ifndef BITCOIN_HTTPSERVER_H
 #define BITCOIN_HTTPSERVER_H
 
+#include <cstdint>
 #include <string>
 #include <functional>
+#include <vector>
 
 static const int DEFAULT_HTTP_THREADS=4;
 static const int DEFAULT_HTTP_WORKQUEUE=16;
 static const int DEFAULT_HTTP_SERVER_TIMEOUT=30;
 
+static const std::string HTTP_WORK_CLASS_DEFAULT{"default"};
+static const std::string HTTP_WORK_CLASS_HEAVY{"heavy"};
+/** RPC methods which are served by the heavy work class once it is created by -rpcworkclass, unless
+ * configured otherwise */
+static const std::vector<std::string> DEFAULT_HTTP_HEAVY_METHODS{
+    "getaddressdeltas", "getaddresstxids", "getaddressutxos", "gobject", "masternodelist", "protx", "quorum",
+};
+/** How much of a request body is scanned for the RPC method name */
+static const size_t HTTP_WORK_CLASS_SCAN_SIZE{1024};
+
 struct evhttp_request;
 struct event_base;
+class ArgsManager;
 class CService;
 class HTTPRequest;
 
@@ -45,6 +58,28 @@ void RegisterHTTPHandler(const std::string &prefix, bool exactMatch, const HTTPR
 /** Unregister handler for prefix */
 void UnregisterHTTPHandler(const std::string &prefix, bool exactMatch);
 
+/** Set up the work queues from -rpcthreads, -rpcworkqueue, -rpcworkclass and -rpcmethodclass.
+ * Called by InitHTTPServer, the worker threads are started by StartHTTPServer.
+ */
+bool InitHTTPWorkClasses(const ArgsManager& args);
+/** Name of the work class which serves a POST request with the given JSON-RPC body */
+std::string GetHTTPWorkClassName(const std::string& body);
+
+/** Load and queue time statistics of a work class */
+struct HTTPWorkClassStats
+{
+    std::string name;
+    int threads;
+    size_t depth;
+    size_t max_depth;
+    uint64_t requests;
+    uint64_t rejected;
+    uint64_t dequeued;
+    int64_t queue_time_total;
+    int64_t queue_time_max;
+};
+std::vector<HTTPWorkClassStats> GetHTTPWorkClassStats();
+
 /** Return evhttp event base. This can be used by submodules to
  * queue timers or custom events.
  */
@@ -89,6 +124,11 @@ public:
      */
     std::pair<bool, std::string> GetHeader(const std::string& hdr) const;
 
+    /**
+     * Return up to max_size bytes from the beginning of the request body without consuming them.
+     */
+    std::string PeekBody(size_t max_size);
+
     /**
      * Read request body.
      *
@@ -113,6 +153,24 @@ public:
      * main thread, do not call any other HTTPRequest methods after calling this.
      */
     void WriteReply(int nStatus, const std::string& strReply = "");
+
+    /**
+     * Start a chunked HTTP reply, its body is sent with WriteReplyChunk and finished with WriteReplyEnd.
+     * Use instead of WriteReply for large replies to avoid serializing them into one string first.
+     */
+    void WriteReplyStart(int nStatus);
+    /**
+     * Send the next part of a chunked reply. Waits while the client didn't receive most of the previous
+     * parts yet, so that the output buffer of the connection doesn't grow with the reply. Returns false if the client is gone.
+     */
+    bool WriteReplyChunk(const std::string& strChunk);
+    /**
+     * Finish a chunked reply.
+     *
+     * @note As this will give the request back to the main thread, do not call any other
+     * HTTPRequest methods after calling this.
+     */
+    void WriteReplyEnd();
 };
 
 /** Event handler closure.
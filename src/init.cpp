@@ -58,6 +58,7 @@
 #include <txmempool.h>
 #include <util/asmap.h>
 #include <util/error.h>
+#include <util/metrics.h>
 #include <util/moneystr.h>
 #include <util/strencodings.h>
 #include <util/string.h>
@@ -88,8 +89,10 @@
 #include <spork.h>
 #include <walletinitinterface.h>
 
+#include <evo/cbtxindex.h>
 #include <evo/creditpool.h>
 #include <evo/deterministicmns.h>
+#include <evo/evodb.h>
 #include <evo/mnhftx.h>
 #include <llmq/blockprocessor.h>
 #include <llmq/chainlocks.h>
@@ -104,7 +107,9 @@
 
 #include <statsd_client.h>
 
+#include <algorithm>
 #include <functional>
+#include <map>
 #include <set>
 #include <stdint.h>
 #include <stdio.h>
@@ -238,6 +243,7 @@ void PrepareShutdown(NodeContext& node)
     StopRPC();
     StopHTTPServer();
     if (node.llmq_ctx) node.llmq_ctx->Stop();
+    if (node.cj_ctx) node.cj_ctx->server->Stop();
 
     for (const auto& client : node.chain_clients) {
         client->flush();
@@ -345,6 +351,7 @@ void PrepareShutdown(NodeContext& node)
         deterministicMNManager.reset();
         creditPoolManager.reset();
         node.creditPoolManager = nullptr;
+        cbTxIndex.reset();
         node.mnhf_manager.reset();
         node.evodb.reset();
     }
@@ -404,6 +411,7 @@ void Shutdown(NodeContext& node)
     }
     // Shutdown part 2: delete wallet instance
     ECC_Stop();
+    node.block_template_cache.reset();
     node.mempool.reset();
     node.fee_estimator.reset();
     node.chainman = nullptr;
@@ -513,6 +521,7 @@ void SetupServerArgs(NodeContext& node)
     argsman.AddArg("-alertnotify=<cmd>", "Execute command when an alert is raised (%s in cmd is replaced by message)", ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
 #endif
     argsman.AddArg("-assumevalid=<hex>", strprintf("If this block is in the chain assume that it and its ancestors are valid and potentially skip their script verification (0 to verify all, default: %s, testnet: %s)", defaultChainParams->GetConsensus().defaultAssumeValid.GetHex(), testnetChainParams->GetConsensus().defaultAssumeValid.GetHex()), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-chainlockfastsync", strprintf("Skip script verification of blocks which are buried under a ChainLock, either the best one received from the network or one embedded in the coinbase of a downloaded block which is not connected yet, once its signature was verified against the responsible quorum. Skipped ranges are logged (default: %u)", DEFAULT_CHAINLOCK_FAST_SYNC), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-blocksdir=<dir>", "Specify directory to hold blocks subdirectory for *.dat files (default: <datadir>)", ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-fastprune", "Use smaller block files and lower minimum prune height for testing purposes", ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::DEBUG_TEST);
 #if HAVE_SYSTEM
@@ -529,7 +538,9 @@ void SetupServerArgs(NodeContext& node)
     argsman.AddArg("-dbbatchsize", strprintf("Maximum database write batch size in bytes (default: %u)", nDefaultDbBatchSize), ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::OPTIONS);
     argsman.AddArg("-dbcache=<n>", strprintf("Maximum database cache size <n> MiB (%d to %d, default: %d). In addition, unused mempool memory is shared for this cache (see -maxmempool).", nMinDbCache, nMaxDbCache, nDefaultDbCache), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-debuglogfile=<file>", strprintf("Specify location of debug log file. Relative paths will be prefixed by a net-specific datadir location. (-nodebuglogfile to disable; default: %s)", DEFAULT_DEBUGLOGFILE), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-evodbcache=<n>", strprintf("Maximum EvoDB cache size <n> MiB, split between the caches of its stores and the database cache (default: %d)", DEFAULT_EVODB_CACHE), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-includeconf=<file>", "Specify additional configuration file, relative to the -datadir path (only useable from configuration file, not command line)", ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-inputprefetch=<n>", strprintf("Set the number of threads reading the coins spent by blocks from the database before they are validated (0 to %d, 0 = disable, default: %d)", MAX_INPUT_PREFETCH_THREADS, DEFAULT_INPUT_PREFETCH_THREADS), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-loadblock=<file>", "Imports blocks from external file on startup", ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-maxmempool=<n>", strprintf("Keep the transaction memory pool below <n> megabytes (default: %u)", DEFAULT_MAX_MEMPOOL_SIZE), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-maxorphantxsize=<n>", strprintf("Maximum total size of all orphan transactions in megabytes (default: %u)", DEFAULT_MAX_ORPHAN_TRANSACTIONS_SIZE), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
@@ -711,6 +722,7 @@ void SetupServerArgs(NodeContext& node)
     argsman.AddArg("-limitancestorsize=<n>", strprintf("Do not accept transactions whose size with all in-mempool ancestors exceeds <n> kilobytes (default: %u)", DEFAULT_ANCESTOR_SIZE_LIMIT), ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::DEBUG_TEST);
     argsman.AddArg("-limitdescendantcount=<n>", strprintf("Do not accept transactions if any ancestor would have <n> or more in-mempool descendants (default: %u)", DEFAULT_DESCENDANT_LIMIT), ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::DEBUG_TEST);
     argsman.AddArg("-limitdescendantsize=<n>", strprintf("Do not accept transactions if any ancestor would have more than <n> kilobytes of in-mempool descendants (default: %u).", DEFAULT_DESCENDANT_SIZE_LIMIT), ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::DEBUG_TEST);
+    argsman.AddArg("-lockprofile=<n>", strprintf("Time one in <n> lock acquisitions of each thread to find contended locks, see getlockcontention (default: %u, 0 = disabled)", DEFAULT_LOCK_PROFILE_RATE), ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::DEBUG_TEST);
     argsman.AddArg("-stopafterblockimport", strprintf("Stop running after importing blocks from disk (default: %u)", DEFAULT_STOPAFTERBLOCKIMPORT), ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::DEBUG_TEST);
     argsman.AddArg("-stopatheight", strprintf("Stop running after reaching the given height in the main chain (default: %u)", DEFAULT_STOPATHEIGHT), ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::DEBUG_TEST);
     argsman.AddArg("-watchquorums=<n>", strprintf("Watch and validate quorum communication (default: %u)", llmq::DEFAULT_WATCH_QUORUMS), ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::DEBUG_TEST);
@@ -767,6 +779,7 @@ void SetupServerArgs(NodeContext& node)
     argsman.AddArg("-rpcauth=<userpw>", "Username and HMAC-SHA-256 hashed password for JSON-RPC connections. The field <userpw> comes in the format: <USERNAME>:<SALT>$<HASH>. A canonical python script is included in share/rpcuser. The client then connects normally using the rpcuser=<USERNAME>/rpcpassword=<PASSWORD> pair of arguments. This option can be specified multiple times", ArgsManager::ALLOW_ANY | ArgsManager::SENSITIVE, OptionsCategory::RPC);
     argsman.AddArg("-rpcbind=<addr>[:port]", "Bind to given address to listen for JSON-RPC connections. Do not expose the RPC server to untrusted networks such as the public internet! This option is ignored unless -rpcallowip is also passed. Port is optional and overrides -rpcport. Use [host]:port notation for IPv6. This option can be specified multiple times (default: 127.0.0.1 and ::1 i.e., localhost, or if -rpcallowip has been specified, 0.0.0.0 and :: i.e., all addresses)", ArgsManager::ALLOW_ANY | ArgsManager::NETWORK_ONLY | ArgsManager::SENSITIVE, OptionsCategory::RPC);
     argsman.AddArg("-rpccookiefile=<loc>", "Location of the auth cookie. Relative paths will be prefixed by a net-specific datadir location. (default: data dir)", ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
+    argsman.AddArg("-rpcmethodclass=<method>:<class>", strprintf("Serve calls of the given RPC method by the work queue of the given class, use \"%s\" to serve it by the -rpcthreads workers. Once a \"%s\" class is created by -rpcworkclass, it serves %s unless configured otherwise. This option can be specified multiple times", HTTP_WORK_CLASS_DEFAULT, HTTP_WORK_CLASS_HEAVY, Join(DEFAULT_HTTP_HEAVY_METHODS, ", ")), ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
     argsman.AddArg("-rpcpassword=<pw>", "Password for JSON-RPC connections", ArgsManager::ALLOW_ANY | ArgsManager::SENSITIVE, OptionsCategory::RPC);
     argsman.AddArg("-rpcport=<port>", strprintf("Listen for JSON-RPC connections on <port> (default: %u, testnet: %u, regtest: %u)", defaultBaseParams->RPCPort(), testnetBaseParams->RPCPort(), regtestBaseParams->RPCPort()), ArgsManager::ALLOW_ANY | ArgsManager::NETWORK_ONLY, OptionsCategory::RPC);
     argsman.AddArg("-rpcservertimeout=<n>", strprintf("Timeout during HTTP requests (default: %d)", DEFAULT_HTTP_SERVER_TIMEOUT), ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::RPC);
@@ -774,6 +787,7 @@ void SetupServerArgs(NodeContext& node)
     argsman.AddArg("-rpcuser=<user>", "Username for JSON-RPC connections", ArgsManager::ALLOW_ANY | ArgsManager::SENSITIVE, OptionsCategory::RPC);
     argsman.AddArg("-rpcwhitelist=<whitelist>", "Set a whitelist to filter incoming RPC calls for a specific user. The field <whitelist> comes in the format: <USERNAME>:<rpc 1>,<rpc 2>,...,<rpc n>. If multiple whitelists are set for a given user, they are set-intersected. See -rpcwhitelistdefault documentation for information on default whitelist behavior.", ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
     argsman.AddArg("-rpcwhitelistdefault", "Sets default behavior for rpc whitelisting. Unless rpcwhitelistdefault is set to 0, if any -rpcwhitelist is set, the rpc server acts as if all rpc users are subject to empty-unless-otherwise-specified whitelists. If rpcwhitelistdefault is set to 1 and no -rpcwhitelist is set, rpc server acts as if all rpc users are subject to empty whitelists.", ArgsManager::ALLOW_BOOL, OptionsCategory::RPC);
+    argsman.AddArg("-rpcworkclass=<class>:<threads>:<depth>", strprintf("Create a work queue for RPC calls of the given class with its own worker threads and depth, see -rpcmethodclass. All calls are served by the -rpcthreads workers unless a class is created. This option can be specified multiple times (e.g. %s:2:16)", HTTP_WORK_CLASS_HEAVY), ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
     argsman.AddArg("-rpcworkqueue=<n>", strprintf("Set the depth of the work queue to service RPC calls (default: %d)", DEFAULT_HTTP_WORKQUEUE), ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::RPC);
     argsman.AddArg("-server", "Accept command line and JSON-RPC commands", ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
 
@@ -929,6 +943,26 @@ static void PeriodicStats(ArgsManager& args, const CTxMemPool& mempool)
         statsClient.gauge("transactions.mempool.memoryUsageBytes", (int64_t) mempool.DynamicMemoryUsage(), 1.0f);
         statsClient.gauge("transactions.mempool.minFeePerKb", mempool.GetMinFee(args.GetArg("-maxmempool", DEFAULT_MAX_MEMPOOL_SIZE) * 1000000).GetFeePerK(), 1.0f);
     }
+
+    // statsd is a sink of the metrics registry, push everything the subsystems collected so far
+    const auto snapshot = metrics::GetSnapshot();
+    for (const auto& [name, value] : snapshot.counters) {
+        statsClient.gauge(name, value, 1.0f);
+    }
+    for (const auto& [name, value] : snapshot.gauges) {
+        statsClient.gaugeDouble(name, value);
+    }
+    // histograms are cumulative, report what was observed since the last push only
+    static std::map<std::string, metrics::Histogram::Snapshot> prev_histograms;
+    for (const auto& [name, total] : snapshot.histograms) {
+        const auto hist = total.Since(prev_histograms[name]);
+        prev_histograms[name] = total;
+        statsClient.gauge(name + ".count", hist.count, 1.0f);
+        statsClient.gauge(name + ".avg", hist.count ? hist.sum / hist.count : 0, 1.0f);
+        statsClient.gauge(name + ".max", hist.max, 1.0f);
+        statsClient.gauge(name + ".p50", hist.Quantile(0.5), 1.0f);
+        statsClient.gauge(name + ".p99", hist.Quantile(0.99), 1.0f);
+    }
 }
 
 /** Sanity checks
@@ -1301,6 +1335,7 @@ bool AppInitParameterInteraction(const ArgsManager& args)
 
     fCheckBlockIndex = args.GetBoolArg("-checkblockindex", chainparams.DefaultConsistencyChecks());
     fCheckpointsEnabled = args.GetBoolArg("-checkpoints", DEFAULT_CHECKPOINTS_ENABLED);
+    g_lock_profile_rate = std::max<int64_t>(args.GetArg("-lockprofile", DEFAULT_LOCK_PROFILE_RATE), 0);
 
     hashAssumeValid = uint256S(args.GetArg("-assumevalid", chainparams.GetConsensus().defaultAssumeValid.GetHex()));
     if (!hashAssumeValid.IsNull())
@@ -1308,6 +1343,10 @@ bool AppInitParameterInteraction(const ArgsManager& args)
     else
         LogPrintf("Validating signatures for all blocks.\n");
 
+    g_chainlock_fast_sync = args.GetBoolArg("-chainlockfastsync", DEFAULT_CHAINLOCK_FAST_SYNC);
+    if (g_chainlock_fast_sync)
+        LogPrintf("Assuming blocks buried under a ChainLock have valid signatures.\n");
+
     if (args.IsArgSet("-minimumchainwork")) {
         const std::string minChainWorkStr = args.GetArg("-minimumchainwork", "");
         if (!IsHexNumber(minChainWorkStr)) {
@@ -1491,6 +1530,8 @@ bool AppInitSanityChecks()
     // Initialize elliptic curve code
     std::string sha256_algo = SHA256AutoDetect();
     LogPrintf("Using the '%s' SHA256 implementation\n", sha256_algo);
+    std::string x11_algo = X11AutoDetect();
+    LogPrintf("Using the '%s' X11 implementation\n", x11_algo);
     RandomInit();
     ECC_Start();
 
@@ -1601,6 +1642,9 @@ bool AppInitMain(const CoreContext& context, NodeContext& node, interfaces::Bloc
         StartScriptCheckWorkerThreads(script_threads);
     }
 
+    g_input_prefetch_threads = std::clamp<int>(args.GetArg("-inputprefetch", DEFAULT_INPUT_PREFETCH_THREADS), 0, MAX_INPUT_PREFETCH_THREADS);
+    LogPrintf("Block input prefetching uses %d threads\n", g_input_prefetch_threads);
+
     assert(activeMasternodeInfo.blsKeyOperator == nullptr);
     assert(activeMasternodeInfo.blsPubKeyOperator == nullptr);
     fMasternodeMode = false;
@@ -1697,6 +1741,7 @@ bool AppInitMain(const CoreContext& context, NodeContext& node, interfaces::Bloc
     assert(!node.mempool);
     int check_ratio = std::min<int>(std::max<int>(args.GetArg("-checkmempool", chainparams.DefaultConsistencyChecks() ? 1 : 0), 0), 1000000);
     node.mempool = std::make_unique<CTxMemPool>(node.fee_estimator.get(), check_ratio);
+    node.block_template_cache = std::make_unique<BlockTemplateCache>();
 
     assert(!node.chainman);
     node.chainman = &g_chainman;
@@ -1905,7 +1950,7 @@ bool AppInitMain(const CoreContext& context, NodeContext& node, interfaces::Bloc
     nTotalCache -= nCoinDBCache;
     int64_t nCoinCacheUsage = nTotalCache; // the rest goes to in-memory cache
     int64_t nMempoolSizeMax = args.GetArg("-maxmempool", DEFAULT_MAX_MEMPOOL_SIZE) * 1000000;
-    int64_t nEvoDbCache = 1024 * 1024 * 64; // TODO
+    int64_t nEvoDbCache = std::max<int64_t>(args.GetArg("-evodbcache", DEFAULT_EVODB_CACHE), 1) << 20;
     LogPrintf("Cache configuration:\n");
     LogPrintf("* Using %.1f MiB for block index database\n", nBlockTreeDBCache * (1.0 / 1024 / 1024));
     if (args.GetBoolArg("-txindex", DEFAULT_TXINDEX)) {
@@ -1917,6 +1962,7 @@ bool AppInitMain(const CoreContext& context, NodeContext& node, interfaces::Bloc
     }
     LogPrintf("* Using %.1f MiB for chain state database\n", nCoinDBCache * (1.0 / 1024 / 1024));
     LogPrintf("* Using %.1f MiB for in-memory UTXO set (plus up to %.1f MiB of unused mempool space)\n", nCoinCacheUsage * (1.0 / 1024 / 1024), nMempoolSizeMax * (1.0 / 1024 / 1024));
+    LogPrintf("* Using %.1f MiB for EvoDB\n", nEvoDbCache * (1.0 / 1024 / 1024));
 
     bool fLoaded = false;
 
@@ -1941,8 +1987,17 @@ bool AppInitMain(const CoreContext& context, NodeContext& node, interfaces::Bloc
                 node.mnhf_manager = std::make_unique<CMNHFManager>(*node.evodb);
 
 
+                // A chainstate created by loadtxoutset is continued from, unless the chainstate is rebuilt from the
+                // blocks on disk. The EvoDB was replaced along with it and matches its tip.
+                std::optional<uint256> snapshot_blockhash = FindSnapshotChainstate(GetDataDir());
+                if (snapshot_blockhash && (fReset || fReindexChainState)) {
+                    LogPrintf("Removing the chainstate of snapshot %s, it is rebuilt from the blocks on disk\n", snapshot_blockhash->ToString());
+                    fs::remove_all(GetDataDir() / ("chainstate_" + snapshot_blockhash->ToString()));
+                    snapshot_blockhash.reset();
+                }
+
                 chainman.Reset();
-                chainman.InitializeChainstate(Assert(node.mempool.get()), *node.mnhf_manager, *node.evodb, llmq::chainLocksHandler, llmq::quorumInstantSendManager, llmq::quorumBlockProcessor);
+                chainman.InitializeChainstate(Assert(node.mempool.get()), *node.mnhf_manager, *node.evodb, llmq::chainLocksHandler, llmq::quorumInstantSendManager, llmq::quorumBlockProcessor, snapshot_blockhash);
                 chainman.m_total_coinstip_cache = nCoinCacheUsage;
                 chainman.m_total_coinsdb_cache = nCoinDBCache;
 
@@ -1959,6 +2014,8 @@ bool AppInitMain(const CoreContext& context, NodeContext& node, interfaces::Bloc
                 creditPoolManager.reset();
                 creditPoolManager = std::make_unique<CCreditPoolManager>(*node.evodb);
                 node.creditPoolManager = creditPoolManager.get();
+                cbTxIndex.reset();
+                cbTxIndex = std::make_unique<CCbTxIndex>(*node.evodb);
                 llmq::quorumSnapshotManager.reset();
                 llmq::quorumSnapshotManager.reset(new llmq::CQuorumSnapshotManager(*node.evodb));
 
@@ -1967,7 +2024,9 @@ bool AppInitMain(const CoreContext& context, NodeContext& node, interfaces::Bloc
                     node.llmq_ctx->Stop();
                 }
                 node.llmq_ctx.reset();
-                node.llmq_ctx.reset(new LLMQContext(chainman.ActiveChainstate(), *node.connman, *node.evodb, *::sporkManager, *node.mempool, node.peerman, false, fReset || fReindexChainState));
+                node.llmq_ctx.reset(new LLMQContext(chainman.ActiveChainstate(), *node.connman, *node.evodb, *::sporkManager, *node.mempool, node.peerman,
+                                                    [&node](NodeId from, int howmuch) { if (node.peerman) node.peerman->Misbehaving(from, howmuch); },
+                                                    false, fReset || fReindexChainState));
                 // Have to start it early to let VerifyDB check ChainLock signatures in coinbase
                 node.llmq_ctx->Start();
 
@@ -2325,7 +2384,7 @@ bool AppInitMain(const CoreContext& context, NodeContext& node, interfaces::Bloc
     }
 
     if (fMasternodeMode) {
-        node.scheduler->scheduleEvery(std::bind(&CCoinJoinServer::DoMaintenance, std::ref(*node.cj_ctx->server)), std::chrono::seconds{1});
+        node.cj_ctx->server->Start();
         node.scheduler->scheduleEvery(std::bind(&llmq::CDKGSessionManager::CleanupOldContributions, std::ref(*node.llmq_ctx->qdkgsman)), std::chrono::hours{1});
 #ifdef ENABLE_WALLET
     } else if (!ignores_incoming_txs) {
@@ -3,10 +3,12 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <llmq/chainlocks.h>
+#include <llmq/commitment.h>
 #include <llmq/quorums.h>
 #include <llmq/instantsend.h>
 #include <llmq/signing_shares.h>
 
+#include <bls/bls_worker.h>
 #include <chain.h>
 #include <chainparams.h>
 #include <consensus/validation.h>
@@ -16,6 +18,7 @@
 #include <scheduler.h>
 #include <spork.h>
 #include <txmempool.h>
+#include <util/metrics.h>
 #include <util/thread.h>
 #include <util/time.h>
 #include <validation.h>
@@ -27,7 +30,7 @@ std::unique_ptr<CChainLocksHandler> chainLocksHandler;
 
 CChainLocksHandler::CChainLocksHandler(CChainState& chainstate, CConnman& _connman, CMasternodeSync& mn_sync, CQuorumManager& _qman,
                                        CSigningManager& _sigman, CSigSharesManager& _shareman, CSporkManager& sporkManager,
-                                       CTxMemPool& _mempool) :
+                                       CTxMemPool& _mempool, CBLSWorker& _blsWorker, PeerMisbehavingFunc peer_misbehaving) :
     m_chainstate(chainstate),
     connman(_connman),
     m_mn_sync(mn_sync),
@@ -36,6 +39,8 @@ CChainLocksHandler::CChainLocksHandler(CChainState& chainstate, CConnman& _connm
     shareman(_shareman),
     spork_manager(sporkManager),
     mempool(_mempool),
+    blsWorker(_blsWorker),
+    m_peer_misbehaving(std::move(peer_misbehaving)),
     scheduler(std::make_unique<CScheduler>()),
     scheduler_thread(std::make_unique<std::thread>(std::thread(util::TraceThread, "cl-schdlr", [&] { scheduler->serviceQueue(); })))
 {
@@ -117,6 +122,7 @@ PeerMsgRet CChainLocksHandler::ProcessNewChainLock(const NodeId from, const llmq
 
     {
         LOCK(cs);
+        // this also dedupes CLSIGs which are still waiting for verification
         if (!seenChainLocks.emplace(hash, GetTimeMillis()).second) {
             return {};
         }
@@ -127,18 +133,67 @@ PeerMsgRet CChainLocksHandler::ProcessNewChainLock(const NodeId from, const llmq
         }
     }
 
-    if (!VerifyChainLock(clsig)) {
+    if (from == -1) {
+        // our own recovered sig or a CLSIG submitted via RPC, verify it right away so it is applied on return
+        ProcessVerifiedChainLock(from, clsig, hash, VerifyChainLock(clsig));
+        return {};
+    }
+
+    // Verifying the signature is a pairing check, don't do it on the message handler thread. CBLSWorker batches
+    // it with other pending verifications and we apply the result on the scheduler thread.
+    const auto llmqType = Params().GetConsensus().llmqTypeChainLocks;
+    const uint256 nRequestId = ::SerializeHash(std::make_pair(llmq::CLSIG_REQUESTID_PREFIX, clsig.getHeight()));
+    const auto quorum = CSigningManager::SelectQuorumForSigning(Params().GetLLMQ(llmqType).value(), qman, nRequestId, clsig.getHeight());
+    if (!quorum) {
+        ProcessVerifiedChainLock(from, clsig, hash, false);
+        return {};
+    }
+    const uint256 signHash = BuildSignHash(llmqType, quorum->qc->quorumHash, nRequestId, clsig.getBlockHash());
+    VerifyChainLockAsync(from, clsig, hash, quorum->qc->quorumPublicKey, signHash);
+    return {};
+}
+
+void CChainLocksHandler::VerifyChainLockAsync(const NodeId from, const llmq::CChainLockSig& clsig, const uint256& hash,
+                                              const CBLSPublicKey& pubKey, const uint256& signHash)
+{
+    const int height = clsig.getHeight();
+    blsWorker.AsyncVerifySig(clsig.getSig(), pubKey, signHash,
+        [this, from, clsig, hash](bool valid) {
+            scheduler->scheduleFromNow([this, from, clsig, hash, valid]() {
+                ProcessVerifiedChainLock(from, clsig, hash, valid);
+            }, std::chrono::seconds{0});
+        },
+        [this, height]() {
+            // a better CLSIG got accepted in the meantime, no need to verify this one anymore
+            LOCK(cs);
+            return !bestChainLock.IsNull() && height <= bestChainLock.getHeight();
+        });
+}
+
+void CChainLocksHandler::ProcessVerifiedChainLock(const NodeId from, const llmq::CChainLockSig& clsig, const uint256& hash, bool valid)
+{
+    static metrics::Histogram& histProcess = metrics::GetHistogram("llmq.chainlocks.process_new_us");
+    metrics::ScopedTimer timer(histProcess);
+
+    if (!valid) {
         LogPrint(BCLog::CHAINLOCKS, "CChainLocksHandler::%s -- invalid CLSIG (%s), peer=%d\n", __func__, clsig.ToString(), from);
-        if (from != -1) {
-            return tl::unexpected{10};
+        if (from != -1 && m_peer_misbehaving) {
+            m_peer_misbehaving(from, 10);
         }
-        return {};
+        return;
     }
 
+    CInv clsigInv(MSG_CLSIG, hash);
+
     CBlockIndex* pindex = WITH_LOCK(cs_main, return m_chainstate.m_blockman.LookupBlockIndex(clsig.getBlockHash()));
 
     {
         LOCK(cs);
+        if (!bestChainLock.IsNull() && clsig.getHeight() <= bestChainLock.getHeight()) {
+            // a better CLSIG got accepted while this one was verified
+            return;
+        }
+
         bestChainLockHash = hash;
         bestChainLock = clsig;
 
@@ -149,7 +204,7 @@ PeerMsgRet CChainLocksHandler::ProcessNewChainLock(const NodeId from, const llmq
                 LogPrintf("CChainLocksHandler::%s -- height of CLSIG (%s) does not match the specified block's height (%d)\n",
                         __func__, clsig.ToString(), pindex->nHeight);
                 // Note: not relaying clsig here
-                return {};
+                return;
             }
 
             bestChainLockWithKnownBlock = bestChainLock;
@@ -166,7 +221,7 @@ PeerMsgRet CChainLocksHandler::ProcessNewChainLock(const NodeId from, const llmq
     if (pindex == nullptr) {
         // we don't know the block/header for this CLSIG yet, so bail out for now
         // when the block or the header later comes in, we will enforce the correct chain
-        return {};
+        return;
     }
 
     scheduler->scheduleFromNow([&]() {
@@ -176,7 +231,6 @@ PeerMsgRet CChainLocksHandler::ProcessNewChainLock(const NodeId from, const llmq
 
     LogPrint(BCLog::CHAINLOCKS, "CChainLocksHandler::%s -- processed new CLSIG (%s), peer=%d\n",
               __func__, clsig.ToString(), from);
-    return {};
 }
 
 void CChainLocksHandler::AcceptedBlockHeader(gsl::not_null<const CBlockIndex*> pindexNew)
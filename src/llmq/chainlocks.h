@@ -19,13 +19,16 @@
 #include <gsl/pointers.h>
 
 #include <atomic>
+#include <functional>
 #include <map>
 #include <unordered_map>
 #include <unordered_set>
 
+class CBLSWorker;
 class CChainState;
 class CConnman;
 class CBlockIndex;
+class CBLSPublicKey;
 class CMasternodeSync;
 class CScheduler;
 class CSporkManager;
@@ -44,6 +47,10 @@ class CChainLocksHandler : public CRecoveredSigsListener
     // how long to wait for islocks until we consider a block with non-islocked TXs to be safe to sign
     static constexpr int64_t WAIT_FOR_ISLOCK_TIMEOUT = 10 * 60;
 
+public:
+    /// Adds to the misbehavior score of a peer, invalid CLSIGs are only known to be invalid after the message was handled
+    using PeerMisbehavingFunc = std::function<void(NodeId, int)>;
+
 private:
     CChainState& m_chainstate;
     CConnman& connman;
@@ -53,6 +60,8 @@ private:
     CSigSharesManager& shareman;
     CSporkManager& spork_manager;
     CTxMemPool& mempool;
+    CBLSWorker& blsWorker;
+    const PeerMisbehavingFunc m_peer_misbehaving;
 
     std::unique_ptr<CScheduler> scheduler;
     std::unique_ptr<std::thread> scheduler_thread;
@@ -88,7 +97,7 @@ private:
 public:
     explicit CChainLocksHandler(CChainState& chainstate, CConnman& _connman, CMasternodeSync& mn_sync, CQuorumManager& _qman,
                                 CSigningManager& _sigman, CSigSharesManager& _shareman, CSporkManager& sporkManager,
-                                CTxMemPool& _mempool);
+                                CTxMemPool& _mempool, CBLSWorker& _blsWorker, PeerMisbehavingFunc peer_misbehaving);
     ~CChainLocksHandler();
 
     void Start();
@@ -99,6 +108,10 @@ public:
     CChainLockSig GetBestChainLock() const LOCKS_EXCLUDED(cs);
 
     PeerMsgRet ProcessMessage(const CNode& pfrom, const std::string& msg_type, CDataStream& vRecv);
+    /**
+     * CLSIGs received from peers are verified asynchronously and applied on the scheduler thread once verified,
+     * CLSIGs from other sources (from == -1) are verified and applied before returning.
+     */
     PeerMsgRet ProcessNewChainLock(NodeId from, const CChainLockSig& clsig, const uint256& hash) LOCKS_EXCLUDED(cs);
 
     void AcceptedBlockHeader(gsl::not_null<const CBlockIndex*> pindexNew) LOCKS_EXCLUDED(cs);
@@ -117,11 +130,18 @@ public:
 
     bool IsTxSafeForMining(const uint256& txid) const LOCKS_EXCLUDED(cs);
 
+protected:
+    /// Verify the signature of a CLSIG from a peer on the BLS worker and apply it on the scheduler thread
+    void VerifyChainLockAsync(NodeId from, const CChainLockSig& clsig, const uint256& hash, const CBLSPublicKey& pubKey,
+                              const uint256& signHash) LOCKS_EXCLUDED(cs);
+
 private:
     // these require locks to be held already
     bool InternalHasChainLock(int nHeight, const uint256& blockHash) const EXCLUSIVE_LOCKS_REQUIRED(cs);
     bool InternalHasConflictingChainLock(int nHeight, const uint256& blockHash) const EXCLUSIVE_LOCKS_REQUIRED(cs);
 
+    void ProcessVerifiedChainLock(NodeId from, const CChainLockSig& clsig, const uint256& hash, bool valid) LOCKS_EXCLUDED(cs);
+
     BlockTxs::mapped_type GetBlockTxs(const uint256& blockHash) LOCKS_EXCLUDED(cs);
 
     void Cleanup() LOCKS_EXCLUDED(cs);
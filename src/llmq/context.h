@@ -5,6 +5,7 @@
 #ifndef BITCOIN_LLMQ_CONTEXT_H
 #define BITCOIN_LLMQ_CONTEXT_H
 
+#include <functional>
 #include <memory>
 
 class CBLSWorker;
@@ -16,6 +17,8 @@ class CSporkManager;
 class CTxMemPool;
 class PeerManager;
 
+using NodeId = int64_t;
+
 namespace llmq {
 class CChainLocksHandler;
 class CDKGDebugManager;
@@ -33,7 +36,8 @@ struct LLMQContext {
     LLMQContext(const LLMQContext&) = delete;
     LLMQContext(CChainState& chainstate, CConnman& connman, CEvoDB& evo_db, CSporkManager& sporkman,
                 CTxMemPool& mempool,
-                const std::unique_ptr<PeerManager>& peerman, bool unit_tests, bool wipe);
+                const std::unique_ptr<PeerManager>& peerman, std::function<void(NodeId, int)> peer_misbehaving,
+                bool unit_tests, bool wipe);
     ~LLMQContext();
 
     void Interrupt();
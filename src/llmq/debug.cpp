@@ -42,6 +42,12 @@ UniValue CDKGDebugSessionStatus::ToJson(int quorumIndex, int detailLevel) const
     ret.pushKV("sentPrematureCommitment", statusBits.sentPrematureCommitment);
     ret.pushKV("aborted", statusBits.aborted);
 
+    UniValue phaseTimesObj(UniValue::VOBJ);
+    for (const auto& [dkgPhase, nTimeMs] : phaseProcessingTimes) {
+        phaseTimesObj.pushKV(strprintf("%d", ToUnderlying(dkgPhase)), nTimeMs);
+    }
+    ret.pushKV("phaseProcessingTimes", phaseTimesObj);
+
     struct ArrOrCount {
         int count{0};
         UniValue arr{UniValue::VARR};
@@ -170,6 +176,7 @@ void CDKGDebugManager::InitLocalSessionStatus(const Consensus::LLMQParams& llmqP
     session.statusBitset = 0;
     session.members.clear();
     session.members.resize((size_t)llmqParams.size);
+    session.phaseProcessingTimes.clear();
 }
 
 void CDKGDebugManager::UpdateLocalSessionStatus(Consensus::LLMQType llmqType, int quorumIndex, std::function<bool(CDKGDebugSessionStatus& status)>&& func)
@@ -10,6 +10,7 @@
 #include <univalue.h>
 
 #include <functional>
+#include <map>
 #include <set>
 
 class CDataStream;
@@ -71,6 +72,9 @@ public:
 
     std::vector<CDKGDebugMemberStatus> members;
 
+    // milliseconds spent on processing (local actions and received messages) per DKG phase
+    std::map<QuorumPhase, int64_t> phaseProcessingTimes;
+
 public:
     CDKGDebugSessionStatus() : statusBitset(0) {}
 
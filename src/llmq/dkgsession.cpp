@@ -314,97 +314,149 @@ void CDKGSession::ReceiveMessage(const CDKGContribution& qc, bool& retBan)
 
     dkgManager.WriteVerifiedVvecContribution(params.type, m_quorum_base_block_index, qc.proTxHash, qc.vvec);
 
-    bool complain = false;
-    CBLSSecretKey skContribution;
-    if (!qc.contributions->Decrypt(*myIdx, WITH_LOCK(activeMasternodeInfoCs, return *activeMasternodeInfo.blsKeyOperator), skContribution, PROTOCOL_VERSION)) {
-        logger.Batch("contribution from %s could not be decrypted", member->dmn->proTxHash.ToString());
-        complain = true;
-    } else if (member->idx != myIdx && ShouldSimulateError(DKGError::type::COMPLAIN_LIE)) {
-        logger.Batch("lying/complaining for %s", member->dmn->proTxHash.ToString());
-        complain = true;
-    }
-
-    if (complain) {
-        member->weComplain = true;
-        dkgDebugManager.UpdateLocalMemberStatus(params.type, quorumIndex, member->idx, [&](CDKGDebugMemberStatus& status) {
-            status.statusBits.weComplain = true;
-            return true;
-        });
-        return;
-    }
+    // Decryption of our share happens on the BLS worker threads, so that it runs in parallel with the handling of
+    // further contributions. Verification of the decrypted shares is started in batches, see StartContributionVerification
+    vecEncryptedContributions[member->idx] = qc.contributions;
+    pendingContributionDecryptions.emplace_back(member->idx, blsWorker.AsyncDecryptContributionShare(qc.contributions, *myIdx,
+                                                WITH_LOCK(activeMasternodeInfoCs, return *activeMasternodeInfo.blsKeyOperator), PROTOCOL_VERSION));
 
-    logger.Batch("decrypted our contribution share. time=%d", t2.count());
+    logger.Batch("queued decryption of our contribution share. time=%d", t2.count());
 
-    bool verifyPending = false;
-    receivedSkContributions[member->idx] = skContribution;
-    vecEncryptedContributions[member->idx] = qc.contributions;
-    pendingContributionVerifications.emplace_back(member->idx);
-    if (pendingContributionVerifications.size() >= 32) {
-        verifyPending = true;
+    // 8 is the batch size used by CBLSWorker to aggregate contributions, so every started verification is a single
+    // aggregated batch which the BLS worker verifies in parallel to other batches
+    if (pendingContributionDecryptions.size() >= 8) {
+        StartContributionVerification();
     }
+    CollectContributionVerifications(/*wait=*/false);
+}
 
-    if (verifyPending) {
-        VerifyPendingContributions();
+CDKGSession::~CDKGSession()
+{
+    // the BLS worker still references the vectors of batches which are in progress
+    LOCK(cs_pending);
+    for (auto& batch : pendingContributionVerifications) {
+        batch.result.wait();
     }
 }
 
-// Verifies all pending secret key contributions in one batch
+// Starts the verification of all decrypted secret key contributions in one batch
 // This is done by aggregating the verification vectors belonging to the secret key contributions
 // The resulting aggregated vvec is then used to recover a public key share
 // The public key share must match the public key belonging to the aggregated secret key contributions
 // See CBLSWorker::VerifyContributionShares for more details.
-void CDKGSession::VerifyPendingContributions()
+void CDKGSession::StartContributionVerification()
 {
     AssertLockHeld(cs_pending);
 
     CDKGLogger logger(*this, __func__);
 
-    cxxtimer::Timer t1(true);
-
-    std::vector<size_t> pend = std::move(pendingContributionVerifications);
+    auto pend = std::move(pendingContributionDecryptions);
+    pendingContributionDecryptions.clear();
     if (pend.empty()) {
         return;
     }
 
-    std::vector<size_t> memberIndexes;
-    std::vector<BLSVerificationVectorPtr> vvecs;
-    std::vector<CBLSSecretKey> skContributions;
+    ContributionVerificationBatch batch;
 
-    for (const auto& idx : pend) {
+    for (auto& [idx, skFuture] : pend) {
         const auto& m = members[idx];
-        if (m->bad || m->weComplain) {
+        const auto opt_skContribution = skFuture.get();
+
+        bool complain = false;
+        if (!opt_skContribution) {
+            logger.Batch("contribution from %s could not be decrypted", m->dmn->proTxHash.ToString());
+            complain = true;
+        } else if (m->idx != myIdx && ShouldSimulateError(DKGError::type::COMPLAIN_LIE)) {
+            logger.Batch("lying/complaining for %s", m->dmn->proTxHash.ToString());
+            complain = true;
+        }
+
+        if (complain) {
+            m->weComplain = true;
+            dkgDebugManager.UpdateLocalMemberStatus(params.type, quorumIndex, m->idx, [&](CDKGDebugMemberStatus& status) {
+                status.statusBits.weComplain = true;
+                return true;
+            });
+            continue;
+        }
+
+        receivedSkContributions[idx] = *opt_skContribution;
+
+        if (m->bad) {
             continue;
         }
-        memberIndexes.emplace_back(idx);
-        vvecs.emplace_back(receivedVvecs[idx]);
-        skContributions.emplace_back(receivedSkContributions[idx]);
+        batch.memberIndexes.emplace_back(idx);
+        batch.vvecs.emplace_back(receivedVvecs[idx]);
+        batch.skContributions.emplace_back(*opt_skContribution);
         // Write here to definitely store one contribution for each member no matter if
         // our share is valid or not, could be that others are still correct
         dkgManager.WriteEncryptedContributions(params.type, m_quorum_base_block_index, m->dmn->proTxHash, *vecEncryptedContributions[idx]);
     }
 
-    auto result = blsWorker.VerifyContributionShares(myId, vvecs, skContributions);
-    if (result.size() != memberIndexes.size()) {
-        logger.Batch("VerifyContributionShares returned result of size %d but size %d was expected, something is wrong", result.size(), memberIndexes.size());
+    if (batch.memberIndexes.empty()) {
         return;
     }
 
-    for (const auto i : irange::range(memberIndexes.size())) {
-        if (!result[i]) {
-            const auto& m = members[memberIndexes[i]];
-            logger.Batch("invalid contribution from %s. will complain later", m->dmn->proTxHash.ToString());
-            m->weComplain = true;
-            dkgDebugManager.UpdateLocalMemberStatus(params.type, quorumIndex, m->idx, [&](CDKGDebugMemberStatus& status) {
-                status.statusBits.weComplain = true;
-                return true;
-            });
-        } else {
-            size_t memberIdx = memberIndexes[i];
-            dkgManager.WriteVerifiedSkContribution(params.type, m_quorum_base_block_index, members[memberIdx]->dmn->proTxHash, skContributions[i]);
+    // the BLS worker keeps references to the vectors, so they must not move anymore
+    auto& startedBatch = pendingContributionVerifications.emplace_back(std::move(batch));
+    startedBatch.result = blsWorker.AsyncVerifyContributionShares(myId, startedBatch.vvecs, startedBatch.skContributions, /*parallel=*/true, /*aggregated=*/true);
+
+    logger.Batch("started verification of %d contributions", startedBatch.memberIndexes.size());
+}
+
+void CDKGSession::CollectContributionVerifications(bool wait)
+{
+    AssertLockHeld(cs_pending);
+
+    CDKGLogger logger(*this, __func__);
+
+    for (auto it = pendingContributionVerifications.begin(); it != pendingContributionVerifications.end();) {
+        if (!wait && it->result.wait_for(std::chrono::seconds::zero()) != std::future_status::ready) {
+            ++it;
+            continue;
+        }
+
+        const auto& memberIndexes = it->memberIndexes;
+        auto result = it->result.get();
+        if (result.size() != memberIndexes.size()) {
+            logger.Batch("VerifyContributionShares returned result of size %d but size %d was expected, something is wrong", result.size(), memberIndexes.size());
+            it = pendingContributionVerifications.erase(it);
+            continue;
         }
+
+        for (const auto i : irange::range(memberIndexes.size())) {
+            if (!result[i]) {
+                const auto& m = members[memberIndexes[i]];
+                logger.Batch("invalid contribution from %s. will complain later", m->dmn->proTxHash.ToString());
+                m->weComplain = true;
+                dkgDebugManager.UpdateLocalMemberStatus(params.type, quorumIndex, m->idx, [&](CDKGDebugMemberStatus& status) {
+                    status.statusBits.weComplain = true;
+                    return true;
+                });
+            } else {
+                size_t memberIdx = memberIndexes[i];
+                dkgManager.WriteVerifiedSkContribution(params.type, m_quorum_base_block_index, members[memberIdx]->dmn->proTxHash, it->skContributions[i]);
+            }
+        }
+
+        logger.Batch("verified %d contributions", memberIndexes.size());
+        it = pendingContributionVerifications.erase(it);
     }
+}
+
+// Finishes the verification of all received contributions, waiting for the ones which are still in progress
+void CDKGSession::VerifyPendingContributions()
+{
+    AssertLockHeld(cs_pending);
+
+    CDKGLogger logger(*this, __func__);
+
+    cxxtimer::Timer t1(true);
+
+    StartContributionVerification();
+    CollectContributionVerifications(/*wait=*/true);
 
-    logger.Batch("verified %d pending contributions. time=%d", pend.size(), t1.count());
+    logger.Batch("verified pending contributions. time=%d", t1.count());
 }
 
 void CDKGSession::VerifyAndComplain(CDKGPendingMessages& pendingMessages)
@@ -13,6 +13,8 @@
 #include <util/underlying.h>
 #include <sync.h>
 
+#include <future>
+#include <list>
 #include <optional>
 
 class UniValue;
@@ -304,8 +306,18 @@ private:
     std::map<uint256, CDKGJustification> justifications GUARDED_BY(invCs);
     std::map<uint256, CDKGPrematureCommitment> prematureCommitments GUARDED_BY(invCs);
 
+    // A batch of decrypted contributions which is verified by the BLS worker in the background
+    struct ContributionVerificationBatch {
+        std::vector<size_t> memberIndexes;
+        std::vector<BLSVerificationVectorPtr> vvecs;
+        std::vector<CBLSSecretKey> skContributions;
+        std::future<std::vector<bool>> result;
+    };
+
     mutable RecursiveMutex cs_pending;
-    std::vector<size_t> pendingContributionVerifications GUARDED_BY(cs_pending);
+    // our secret key shares are decrypted by the BLS worker as soon as the contributions arrive
+    std::vector<std::pair<size_t, std::future<std::optional<CBLSSecretKey>>>> pendingContributionDecryptions GUARDED_BY(cs_pending);
+    std::list<ContributionVerificationBatch> pendingContributionVerifications GUARDED_BY(cs_pending);
 
     // filled by ReceivePrematureCommitment and used by FinalizeCommitments
     std::set<uint256> validCommitments GUARDED_BY(invCs);
@@ -313,6 +325,7 @@ private:
 public:
     CDKGSession(const Consensus::LLMQParams& _params, CBLSWorker& _blsWorker, CDKGSessionManager& _dkgManager, CDKGDebugManager& _dkgDebugManager, CConnman& _connman) :
         params(_params), blsWorker(_blsWorker), cache(_blsWorker), dkgManager(_dkgManager), dkgDebugManager(_dkgDebugManager), connman(_connman) {}
+    ~CDKGSession();
 
     bool Init(gsl::not_null<const CBlockIndex*> pQuorumBaseBlockIndex, Span<CDeterministicMNCPtr> mns, const uint256& _myProTxHash, int _quorumIndex);
 
@@ -336,6 +349,8 @@ public:
     void SendContributions(CDKGPendingMessages& pendingMessages);
     bool PreVerifyMessage(const CDKGContribution& qc, bool& retBan) const;
     void ReceiveMessage(const CDKGContribution& qc, bool& retBan);
+    void StartContributionVerification() EXCLUSIVE_LOCKS_REQUIRED(cs_pending);
+    void CollectContributionVerifications(bool wait) EXCLUSIVE_LOCKS_REQUIRED(cs_pending);
     void VerifyPendingContributions() EXCLUSIVE_LOCKS_REQUIRED(cs_pending);
 
     // Phase 2: complaint
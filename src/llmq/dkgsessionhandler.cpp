@@ -16,8 +16,10 @@
 #include <deploymentstatus.h>
 #include <masternode/node.h>
 #include <chainparams.h>
+#include <cxxtimer.hpp>
 #include <net_processing.h>
 #include <validation.h>
+#include <util/metrics.h>
 #include <util/thread.h>
 #include <util/underlying.h>
 
@@ -328,9 +330,26 @@ void CDKGSessionHandler::HandlePhase(QuorumPhase curPhase,
 {
     LogPrint(BCLog::LLMQ_DKG, "CDKGSessionManager::%s -- %s qi[%d] - starting, curPhase=%d, nextPhase=%d\n", __func__, params.name, quorumIndex, ToUnderlying(curPhase), ToUnderlying(nextPhase));
 
-    SleepBeforePhase(curPhase, expectedQuorumHash, randomSleepFactor, runWhileWaiting);
+    // only measure the time spent on actual work, not the time spent waiting for blocks
+    cxxtimer::Timer t1;
+    const auto timedRunWhileWaiting = [&t1, &runWhileWaiting]() {
+        t1.start();
+        bool ret = runWhileWaiting();
+        t1.stop();
+        return ret;
+    };
+
+    SleepBeforePhase(curPhase, expectedQuorumHash, randomSleepFactor, timedRunWhileWaiting);
+    t1.start();
     startPhaseFunc();
-    WaitForNextPhase(curPhase, nextPhase, expectedQuorumHash, runWhileWaiting);
+    t1.stop();
+    WaitForNextPhase(curPhase, nextPhase, expectedQuorumHash, timedRunWhileWaiting);
+
+    metrics::GetHistogram(strprintf("llmq.dkg.phase%d_us", ToUnderlying(curPhase))).Observe(t1.count<std::chrono::microseconds>());
+    dkgDebugManager.UpdateLocalSessionStatus(params.type, quorumIndex, [&](CDKGDebugSessionStatus& status) {
+        status.phaseProcessingTimes[curPhase] = t1.count();
+        return true;
+    });
 
     LogPrint(BCLog::LLMQ_DKG, "CDKGSessionManager::%s -- %s qi[%d] - done, curPhase=%d, nextPhase=%d\n", __func__, params.name, quorumIndex, ToUnderlying(curPhase), ToUnderlying(nextPhase));
 }
@@ -19,6 +19,7 @@
 #include <spork.h>
 #include <txmempool.h>
 #include <util/irange.h>
+#include <util/metrics.h>
 #include <util/ranges.h>
 #include <util/thread.h>
 #include <validation.h>
@@ -833,6 +834,9 @@ bool CInstantSendManager::ProcessPendingInstantSendLocks()
         return false;
     }
 
+    static metrics::Histogram& histProcess = metrics::GetHistogram("llmq.instantsend.process_pending_us");
+    metrics::ScopedTimer timer(histProcess);
+
     {
         LOCK(cs_pendingLocks);
         // only process a max 32 locks at a time to avoid duplicate verification of recovered signatures which have been
@@ -855,6 +859,9 @@ bool CInstantSendManager::ProcessPendingInstantSendLocks()
         for (const auto& islockHash : removed) {
             pendingInstantSendLocks.erase(islockHash);
         }
+
+        static metrics::Gauge& gaugePending = metrics::GetGauge("llmq.instantsend.pending_locks");
+        gaugePending.Set(pendingInstantSendLocks.size());
     }
 
     if (pend.empty()) {
@@ -19,8 +19,10 @@
 #include <masternode/sync.h>
 #include <net.h>
 #include <netmessagemaker.h>
+#include <scheduler.h>
 #include <univalue.h>
 #include <util/irange.h>
+#include <util/thread.h>
 #include <util/time.h>
 #include <util/underlying.h>
 #include <validation.h>
@@ -38,6 +40,13 @@ std::unique_ptr<CQuorumManager> quorumManager;
 RecursiveMutex cs_data_requests;
 static std::unordered_map<CQuorumDataRequestKey, CQuorumDataRequest, StaticSaltedHasher> mapQuorumDataRequests GUARDED_BY(cs_data_requests);
 
+// Members asked for the data of a single quorum at the same time
+static constexpr size_t QUORUM_DATA_RECOVERY_PARALLEL_REQUESTS{3};
+// Members asked for quorum data at the same time over all quorums
+static constexpr size_t QUORUM_DATA_RECOVERY_MAX_REQUESTS{16};
+// Time a member has to connect and answer before we give up on it
+static constexpr std::chrono::seconds QUORUM_DATA_RECOVERY_TIMEOUT{10};
+
 static uint256 MakeQuorumKey(const CQuorum& q)
 {
     CHashWriter hw(SER_NETWORK, 0);
@@ -203,12 +212,21 @@ CQuorumManager::CQuorumManager(CBLSWorker& _blsWorker, CChainState& chainstate,
     quorumThreadInterrupt.reset();
 }
 
+CQuorumManager::~CQuorumManager()
+{
+    Stop();
+}
+
 void CQuorumManager::Start()
 {
     int workerCount = std::thread::hardware_concurrency() / 2;
     workerCount = std::max(std::min(1, workerCount), 4);
     workerPool.resize(workerCount);
     RenameThreadPool(workerPool, "q-mngr");
+
+    scheduler = std::make_unique<CScheduler>();
+    scheduler_thread = std::make_unique<std::thread>(std::thread(util::TraceThread, "q-recovery", [&] { scheduler->serviceQueue(); }));
+    scheduler->scheduleEvery([&]() { ProcessQuorumDataRecovery(); }, std::chrono::seconds{1});
 }
 
 void CQuorumManager::Stop()
@@ -216,9 +234,15 @@ void CQuorumManager::Stop()
     quorumThreadInterrupt();
     workerPool.clear_queue();
     workerPool.stop(true);
+
+    if (scheduler_thread != nullptr) {
+        scheduler->stop();
+        scheduler_thread->join();
+        scheduler_thread.reset();
+    }
 }
 
-void CQuorumManager::TriggerQuorumDataRecoveryThreads(const CBlockIndex* pIndex) const
+void CQuorumManager::TriggerQuorumDataRecovery(const CBlockIndex* pIndex) const
 {
     if ((!fMasternodeMode && !IsWatchQuorumsEnabled()) || !QuorumDataRecoveryEnabled() || pIndex == nullptr) {
         return;
@@ -238,8 +262,8 @@ void CQuorumManager::TriggerQuorumDataRecoveryThreads(const CBlockIndex* pIndex)
         });
 
         for (const auto& pQuorum : vecQuorums) {
-            // If there is already a thread running for this specific quorum skip it
-            if (pQuorum->fQuorumDataRecoveryThreadRunning) {
+            // If we are already recovering data for this specific quorum skip it
+            if (WITH_LOCK(cs_recovery, return mapDataRecovery.count({pQuorum->qc->llmqType, pQuorum->qc->quorumHash}) > 0)) {
                 continue;
             }
 
@@ -263,8 +287,8 @@ void CQuorumManager::TriggerQuorumDataRecoveryThreads(const CBlockIndex* pIndex)
                 continue;
             }
 
-            // Finally start the thread which triggers the requests for this quorum
-            StartQuorumDataRecoveryThread(pQuorum, pIndex, nDataMask);
+            // Finally let the recovery scheduler trigger the requests for this quorum
+            StartQuorumDataRecovery(pQuorum, pIndex, nDataMask);
         }
     }
 }
@@ -290,7 +314,7 @@ void CQuorumManager::UpdatedBlockTip(const CBlockIndex* pindexNew, bool fInitial
         }
     }
 
-    TriggerQuorumDataRecoveryThreads(pindexNew);
+    TriggerQuorumDataRecovery(pindexNew);
     StartCleanupOldQuorumDataThread(pindexNew);
 }
 
@@ -780,21 +804,29 @@ PeerMsgRet CQuorumManager::ProcessMessage(CNode& pfrom, const std::string& msg_t
             }
         }
 
+        // We ask several members at once, the data might have arrived from another one already
+        const bool fNeedVvec = (request.GetDataMask() & CQuorumDataRequest::QUORUM_VERIFICATION_VECTOR) && !pQuorum->HasVerificationVector();
+        const bool fNeedSkShare = (request.GetDataMask() & CQuorumDataRequest::ENCRYPTED_CONTRIBUTIONS) && !pQuorum->GetSkShare().IsValid();
+        if (!fNeedVvec && !fNeedSkShare) {
+            return errorHandler("Data already recovered", 0);
+        }
+
         // Check if request has QUORUM_VERIFICATION_VECTOR data
         if (request.GetDataMask() & CQuorumDataRequest::QUORUM_VERIFICATION_VECTOR) {
 
             std::vector<CBLSPublicKey> verificationVector;
             vRecv >> verificationVector;
 
-            if (pQuorum->SetVerificationVector(verificationVector)) {
+            if (fNeedVvec) {
+                if (!pQuorum->SetVerificationVector(verificationVector)) {
+                    return errorHandler("Invalid quorum verification vector");
+                }
                 StartCachePopulatorThread(pQuorum);
-            } else {
-                return errorHandler("Invalid quorum verification vector");
             }
         }
 
         // Check if request has ENCRYPTED_CONTRIBUTIONS data
-        if (request.GetDataMask() & CQuorumDataRequest::ENCRYPTED_CONTRIBUTIONS) {
+        if (fNeedSkShare) {
 
             if (WITH_LOCK(pQuorum->cs, return pQuorum->quorumVvec->size() != size_t(pQuorum->params.threshold))) {
                 return errorHandler("No valid quorum verification vector available", 0); // Don't bump score because we asked for it
@@ -858,125 +890,186 @@ void CQuorumManager::StartCachePopulatorThread(const CQuorumCPtr pQuorum) const
     });
 }
 
-void CQuorumManager::StartQuorumDataRecoveryThread(const CQuorumCPtr pQuorum, const CBlockIndex* pIndex, uint16_t nDataMaskIn) const
+void CQuorumManager::StartQuorumDataRecovery(const CQuorumCPtr pQuorum, const CBlockIndex* pIndex, uint16_t nDataMask) const
 {
-    if (pQuorum->fQuorumDataRecoveryThreadRunning) {
+    LOCK(cs_recovery);
+    auto [it, inserted] = mapDataRecovery.try_emplace({pQuorum->qc->llmqType, pQuorum->qc->quorumHash});
+    if (!inserted) {
         LogPrint(BCLog::LLMQ, "CQuorumManager::%s -- Already running\n", __func__);
         return;
     }
-    pQuorum->fQuorumDataRecoveryThreadRunning = true;
-
-    workerPool.push([pQuorum, pIndex, nDataMaskIn, this](int threadId) {
-        size_t nTries{0};
-        uint16_t nDataMask{nDataMaskIn};
-        int64_t nTimeLastSuccess{0};
-        uint256* pCurrentMemberHash{nullptr};
-        std::vector<uint256> vecMemberHashes;
-        const size_t nMyStartOffset{GetQuorumRecoveryStartOffset(pQuorum, pIndex)};
-        const int64_t nRequestTimeout{10};
-
-        auto printLog = [&](const std::string& strMessage) {
-            const std::string strMember{pCurrentMemberHash == nullptr ? "nullptr" : pCurrentMemberHash->ToString()};
-            LogPrint(BCLog::LLMQ, "CQuorumManager::StartQuorumDataRecoveryThread -- %s - for llmqType %d, quorumHash %s, nDataMask (%d/%d), pCurrentMemberHash %s, nTries %d\n",
-                strMessage, ToUnderlying(pQuorum->qc->llmqType), pQuorum->qc->quorumHash.ToString(), nDataMask, nDataMaskIn, strMember, nTries);
-        };
-        printLog("Start");
+    it->second.pQuorum = pQuorum;
+    it->second.pIndex = pIndex;
+    it->second.nDataMask = nDataMask;
+    it->second.nTimeStart = GetTime<std::chrono::seconds>();
+    LogPrint(BCLog::LLMQ, "CQuorumManager::%s -- Start - for llmqType %d, quorumHash %s, nDataMask %d\n",
+        __func__, ToUnderlying(pQuorum->qc->llmqType), pQuorum->qc->quorumHash.ToString(), nDataMask);
+}
 
-        while (!m_mn_sync->IsBlockchainSynced() && !quorumThreadInterrupt) {
-            quorumThreadInterrupt.sleep_for(std::chrono::seconds(nRequestTimeout));
-        }
+void CQuorumManager::ProcessQuorumDataRecovery() const
+{
+    if (!m_mn_sync->IsBlockchainSynced()) {
+        return;
+    }
 
-        if (quorumThreadInterrupt) {
-            printLog("Aborted");
-            return;
-        }
+    const auto nTimeNow = GetTime<std::chrono::seconds>();
+    const auto proTxHash = WITH_LOCK(activeMasternodeInfoCs, return activeMasternodeInfo.proTxHash);
 
-        vecMemberHashes.reserve(pQuorum->qc->validMembers.size());
-        for (auto& member : pQuorum->members) {
-            if (pQuorum->IsValidMember(member->proTxHash) && member->proTxHash != WITH_LOCK(activeMasternodeInfoCs, return activeMasternodeInfo.proTxHash)) {
-                vecMemberHashes.push_back(member->proTxHash);
-            }
+    // Members we want to send QGETDATA to once we are connected to them
+    std::map<uint256, std::vector<std::pair<CQuorumCPtr, uint16_t>>> mapWanted;
+    // Members we only connected to for data which arrived already
+    std::set<uint256> setDisconnect;
+    {
+        LOCK(cs_recovery);
+        size_t nInFlight{0};
+        for (const auto& [_, recovery] : mapDataRecovery) {
+            nInFlight += recovery.mapPending.size();
         }
-        std::sort(vecMemberHashes.begin(), vecMemberHashes.end());
 
-        printLog("Try to request");
+        for (auto it = mapDataRecovery.begin(); it != mapDataRecovery.end();) {
+            auto& recovery = it->second;
+            const auto& pQuorum = recovery.pQuorum;
 
-        while (nDataMask > 0 && !quorumThreadInterrupt) {
+            auto printLog = [&](const std::string& strMessage, const uint256& memberHash = uint256()) {
+                LogPrint(BCLog::LLMQ, "CQuorumManager::ProcessQuorumDataRecovery -- %s - for llmqType %d, quorumHash %s, nDataMask %d, member %s, nTries %d, nPending %d\n",
+                    strMessage, ToUnderlying(pQuorum->qc->llmqType), pQuorum->qc->quorumHash.ToString(), recovery.nDataMask,
+                    memberHash.ToString(), recovery.nTries, recovery.mapPending.size());
+            };
 
-            if (nDataMask & llmq::CQuorumDataRequest::QUORUM_VERIFICATION_VECTOR &&
-                pQuorum->HasVerificationVector()) {
-                nDataMask &= ~llmq::CQuorumDataRequest::QUORUM_VERIFICATION_VECTOR;
+            if (recovery.nDataMask & llmq::CQuorumDataRequest::QUORUM_VERIFICATION_VECTOR && pQuorum->HasVerificationVector()) {
+                recovery.nDataMask &= ~llmq::CQuorumDataRequest::QUORUM_VERIFICATION_VECTOR;
                 printLog("Received quorumVvec");
             }
 
-            if (nDataMask & llmq::CQuorumDataRequest::ENCRYPTED_CONTRIBUTIONS && pQuorum->GetSkShare().IsValid()) {
-                nDataMask &= ~llmq::CQuorumDataRequest::ENCRYPTED_CONTRIBUTIONS;
+            if (recovery.nDataMask & llmq::CQuorumDataRequest::ENCRYPTED_CONTRIBUTIONS && pQuorum->GetSkShare().IsValid()) {
+                recovery.nDataMask &= ~llmq::CQuorumDataRequest::ENCRYPTED_CONTRIBUTIONS;
                 printLog("Received skShare");
             }
 
-            if (nDataMask == 0) {
+            if (recovery.nDataMask == 0) {
+                // Requests still in flight are cancelled, their answers are dropped when they arrive
+                for (const auto& [memberHash, pending] : recovery.mapPending) {
+                    if (pending.fRequested) setDisconnect.emplace(memberHash);
+                }
+                nInFlight -= recovery.mapPending.size();
                 printLog("Success");
-                break;
+                it = mapDataRecovery.erase(it);
+                continue;
             }
 
-            if ((GetTime<std::chrono::seconds>().count() - nTimeLastSuccess) > nRequestTimeout) {
-                if (nTries >= vecMemberHashes.size()) {
-                    printLog("All tried but failed");
-                    break;
+            // Free the slots of members which answered without the data or didn't answer in time
+            for (auto pit = recovery.mapPending.begin(); pit != recovery.mapPending.end();) {
+                const auto& [memberHash, pending] = *pit;
+                bool fProcessed{false};
+                if (pending.fRequested) {
+                    LOCK(cs_data_requests);
+                    const CQuorumDataRequestKey key(memberHash, true, pQuorum->qc->quorumHash, pQuorum->qc->llmqType);
+                    auto rit = mapQuorumDataRequests.find(key);
+                    fProcessed = rit == mapQuorumDataRequests.end() || rit->second.IsProcessed();
+                }
+                if (fProcessed) {
+                    printLog("Processed", memberHash);
+                    setDisconnect.emplace(memberHash);
+                } else if (nTimeNow - pending.nTime > QUORUM_DATA_RECOVERY_TIMEOUT) {
+                    printLog("Timeout", memberHash);
+                } else {
+                    ++pit;
+                    continue;
+                }
+                pit = recovery.mapPending.erase(pit);
+                --nInFlight;
+            }
+
+            if (recovery.nTries == 0 && recovery.vecMemberHashes.empty()) {
+                recovery.vecMemberHashes.reserve(pQuorum->qc->validMembers.size());
+                for (auto& member : pQuorum->members) {
+                    if (pQuorum->IsValidMember(member->proTxHash) && member->proTxHash != proTxHash) {
+                        recovery.vecMemberHashes.push_back(member->proTxHash);
+                    }
                 }
+                std::sort(recovery.vecMemberHashes.begin(), recovery.vecMemberHashes.end());
+                recovery.nStartOffset = GetQuorumRecoveryStartOffset(pQuorum, recovery.pIndex);
+                // Delay the start depending on the offset to balance out multiple requests to the same masternode
+                recovery.nTimeStart = nTimeNow + std::chrono::seconds{recovery.nStartOffset / 10};
+                printLog("Try to request");
+            }
+
+            if (recovery.nTimeStart > nTimeNow) {
+                ++it;
+                continue;
+            }
+
+            while (recovery.mapPending.size() < QUORUM_DATA_RECOVERY_PARALLEL_REQUESTS && nInFlight < QUORUM_DATA_RECOVERY_MAX_REQUESTS &&
+                   recovery.nTries < recovery.vecMemberHashes.size()) {
                 // Access the member list of the quorum with the calculated offset applied to balance the load equally
-                pCurrentMemberHash = &vecMemberHashes[(nMyStartOffset + nTries++) % vecMemberHashes.size()];
+                const uint256& memberHash = recovery.vecMemberHashes[(recovery.nStartOffset + recovery.nTries++) % recovery.vecMemberHashes.size()];
                 {
                     LOCK(cs_data_requests);
-                    const CQuorumDataRequestKey key(*pCurrentMemberHash, true, pQuorum->qc->quorumHash, pQuorum->qc->llmqType);
-                    auto it = mapQuorumDataRequests.find(key);
-                    if (it != mapQuorumDataRequests.end() && !it->second.IsExpired(/*add_bias=*/true)) {
-                        printLog("Already asked");
+                    const CQuorumDataRequestKey key(memberHash, true, pQuorum->qc->quorumHash, pQuorum->qc->llmqType);
+                    auto rit = mapQuorumDataRequests.find(key);
+                    if (rit != mapQuorumDataRequests.end() && !rit->second.IsExpired(/*add_bias=*/true)) {
+                        printLog("Already asked", memberHash);
                         continue;
                     }
                 }
-                // Sleep a bit depending on the start offset to balance out multiple requests to same masternode
-                quorumThreadInterrupt.sleep_for(std::chrono::milliseconds(nMyStartOffset * 100));
-                nTimeLastSuccess = GetTime<std::chrono::seconds>().count();
-                connman.AddPendingMasternode(*pCurrentMemberHash);
-                printLog("Connect");
+                connman.AddPendingMasternode(memberHash);
+                recovery.mapPending.emplace(memberHash, PendingDataRequest{nTimeNow});
+                ++nInFlight;
+                printLog("Connect", memberHash);
             }
 
-            auto proTxHash = WITH_LOCK(activeMasternodeInfoCs, return activeMasternodeInfo.proTxHash);
-            connman.ForEachNode([&](CNode* pNode) {
-                auto verifiedProRegTxHash = pNode->GetVerifiedProRegTxHash();
-                if (pCurrentMemberHash == nullptr || verifiedProRegTxHash != *pCurrentMemberHash) {
-                    return;
+            if (recovery.mapPending.empty()) {
+                // Nothing in flight and nobody left to ask, unless we are waiting for a free slot
+                if (recovery.nTries >= recovery.vecMemberHashes.size()) {
+                    printLog("All tried but failed");
+                    it = mapDataRecovery.erase(it);
+                    continue;
                 }
+            }
 
-                if (RequestQuorumData(pNode, pQuorum->qc->llmqType, pQuorum->m_quorum_base_block_index, nDataMask, proTxHash)) {
-                    nTimeLastSuccess = GetTime<std::chrono::seconds>().count();
-                    printLog("Requested");
-                } else {
-                    LOCK(cs_data_requests);
-                    const CQuorumDataRequestKey key(*pCurrentMemberHash, true, pQuorum->qc->quorumHash, pQuorum->qc->llmqType);
-                    auto it = mapQuorumDataRequests.find(key);
-                    if (it == mapQuorumDataRequests.end()) {
-                        printLog("Failed");
-                        pNode->fDisconnect = true;
-                        pCurrentMemberHash = nullptr;
-                        return;
-                    } else if (it->second.IsProcessed()) {
-                        printLog("Processed");
-                        pNode->fDisconnect = true;
-                        pCurrentMemberHash = nullptr;
-                        return;
-                    } else {
-                        printLog("Waiting");
-                        return;
-                    }
+            for (const auto& [memberHash, pending] : recovery.mapPending) {
+                if (!pending.fRequested) {
+                    mapWanted[memberHash].emplace_back(pQuorum, recovery.nDataMask);
                 }
-            });
-            quorumThreadInterrupt.sleep_for(std::chrono::seconds(1));
+            }
+            ++it;
+        }
+    }
+
+    if (mapWanted.empty() && setDisconnect.empty()) {
+        return;
+    }
+
+    std::vector<std::pair<uint256, std::pair<Consensus::LLMQType, uint256>>> vecRequested;
+    connman.ForEachNode([&](CNode* pNode) {
+        const auto verifiedProRegTxHash = pNode->GetVerifiedProRegTxHash();
+        if (verifiedProRegTxHash.IsNull()) {
+            return;
+        }
+        auto it = mapWanted.find(verifiedProRegTxHash);
+        if (it == mapWanted.end()) {
+            if (setDisconnect.count(verifiedProRegTxHash)) {
+                pNode->fDisconnect = true;
+            }
+            return;
+        }
+        for (const auto& [pQuorum, nDataMask] : it->second) {
+            if (RequestQuorumData(pNode, pQuorum->qc->llmqType, pQuorum->m_quorum_base_block_index, nDataMask, proTxHash)) {
+                vecRequested.emplace_back(verifiedProRegTxHash, std::make_pair(pQuorum->qc->llmqType, pQuorum->qc->quorumHash));
+            }
         }
-        pQuorum->fQuorumDataRecoveryThreadRunning = false;
-        printLog("Done");
     });
+
+    LOCK(cs_recovery);
+    for (const auto& [memberHash, quorumKey] : vecRequested) {
+        auto it = mapDataRecovery.find(quorumKey);
+        if (it == mapDataRecovery.end()) continue;
+        auto pit = it->second.mapPending.find(memberHash);
+        if (pit == it->second.mapPending.end()) continue;
+        pit->second = PendingDataRequest{nTimeNow, true};
+        LogPrint(BCLog::LLMQ, "CQuorumManager::%s -- Requested - for llmqType %d, quorumHash %s, member %s\n",
+            __func__, ToUnderlying(quorumKey.first), quorumKey.second.ToString(), memberHash.ToString());
+    }
 }
 
 static void DataCleanupHelper(CDBWrapper& db, std::set<uint256> skip_list, bool compact = false)
@@ -1075,6 +1168,7 @@ void CQuorumManager::StartCleanupOldQuorumDataThread(const CBlockIndex* pIndex)
 
         if (!quorumThreadInterrupt) {
             DataCleanupHelper(m_evoDb.GetRawDB(), dbKeysToSkip);
+            m_evoDb.ClearStoreCache(EvoDBStore::QUORUM_DATA);
         }
 
         LogPrint(BCLog::LLMQ, "CQuorumManager::StartCleanupOldQuorumDataThread -- done. time=%d\n", t.count());
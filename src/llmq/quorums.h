@@ -19,7 +19,10 @@
 #include <gsl/pointers.h>
 
 #include <atomic>
+#include <chrono>
 #include <map>
+#include <memory>
+#include <thread>
 
 class CBlockIndex;
 class CChainState;
@@ -27,6 +30,7 @@ class CConnman;
 class CDeterministicMN;
 class CMasternodeSync;
 class CNode;
+class CScheduler;
 
 using CDeterministicMNCPtr = std::shared_ptr<const CDeterministicMN>;
 
@@ -177,7 +181,6 @@ private:
     // Recovery of public key shares is very slow, so we start a background thread that pre-populates a cache so that
     // the public key shares are ready when needed later
     mutable CBLSWorkerCache blsCache;
-    mutable std::atomic<bool> fQuorumDataRecoveryThreadRunning{false};
 
     mutable RecursiveMutex cs;
     // These are only valid when we either participated in the DKG or fully watched it
@@ -232,15 +235,36 @@ private:
     mutable ctpl::thread_pool workerPool;
     mutable CThreadInterrupt quorumThreadInterrupt;
 
+    struct PendingDataRequest {
+        std::chrono::seconds nTime; // when we connected to the member or sent QGETDATA to it
+        bool fRequested{false};
+    };
+    // Data we are missing for a quorum. The recovery scheduler asks several members of the quorum at once
+    // and stops asking the remaining ones as soon as one of them delivered.
+    struct QuorumDataRecovery {
+        CQuorumCPtr pQuorum;
+        const CBlockIndex* pIndex;
+        uint16_t nDataMask;
+        std::chrono::seconds nTimeStart;
+        std::vector<uint256> vecMemberHashes;
+        size_t nStartOffset{0};
+        size_t nTries{0};
+        std::map<uint256, PendingDataRequest> mapPending;
+    };
+    mutable Mutex cs_recovery;
+    mutable std::map<std::pair<Consensus::LLMQType, uint256>, QuorumDataRecovery> mapDataRecovery GUARDED_BY(cs_recovery);
+    std::unique_ptr<CScheduler> scheduler;
+    std::unique_ptr<std::thread> scheduler_thread;
+
 public:
     CQuorumManager(CBLSWorker& _blsWorker, CChainState& chainstate, CConnman& _connman, CDKGSessionManager& _dkgManager,
                    CEvoDB& _evoDb, CQuorumBlockProcessor& _quorumBlockProcessor, const std::unique_ptr<CMasternodeSync>& mn_sync);
-    ~CQuorumManager() { Stop(); };
+    ~CQuorumManager();
 
     void Start();
     void Stop();
 
-    void TriggerQuorumDataRecoveryThreads(const CBlockIndex* pIndex) const;
+    void TriggerQuorumDataRecovery(const CBlockIndex* pIndex) const LOCKS_EXCLUDED(cs_recovery);
 
     void UpdatedBlockTip(const CBlockIndex *pindexNew, bool fInitialDownload) const;
 
@@ -271,7 +295,9 @@ private:
     size_t GetQuorumRecoveryStartOffset(const CQuorumCPtr pQuorum, const CBlockIndex* pIndex) const;
 
     void StartCachePopulatorThread(const CQuorumCPtr pQuorum) const;
-    void StartQuorumDataRecoveryThread(const CQuorumCPtr pQuorum, const CBlockIndex* pIndex, uint16_t nDataMask) const;
+    void StartQuorumDataRecovery(const CQuorumCPtr pQuorum, const CBlockIndex* pIndex, uint16_t nDataMask) const LOCKS_EXCLUDED(cs_recovery);
+    /// Sends out QGETDATA for all quorums we are recovering data for, runs on the recovery scheduler
+    void ProcessQuorumDataRecovery() const LOCKS_EXCLUDED(cs_recovery);
 
     void StartCleanupOldQuorumDataThread(const CBlockIndex* pIndex) const;
 };
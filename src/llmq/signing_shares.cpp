@@ -17,6 +17,7 @@
 #include <netmessagemaker.h>
 #include <spork.h>
 #include <util/irange.h>
+#include <util/metrics.h>
 #include <util/thread.h>
 #include <util/time.h>
 #include <util/underlying.h>
@@ -748,6 +749,9 @@ void CSigSharesManager::TryRecoverSig(const CQuorumCPtr& quorum, const uint256&
         return;
     }
 
+    static metrics::Histogram& histRecover = metrics::GetHistogram("llmq.signing.try_recover_us");
+    metrics::ScopedTimer timer(histRecover);
+
     std::vector<CBLSSignature> sigSharesForRecovery;
     std::vector<CBLSId> idsForRecovery;
     {
@@ -801,6 +805,8 @@ void CSigSharesManager::TryRecoverSig(const CQuorumCPtr& quorum, const uint256&
         }
     }
 
+    static metrics::Counter& counterRecovered = metrics::GetCounter("llmq.signing.recovered_sigs");
+    counterRecovered.Inc();
     sigman.ProcessRecoveredSig(rs);
 }
 
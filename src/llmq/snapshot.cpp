@@ -361,4 +361,12 @@ void CQuorumSnapshotManager::StoreSnapshotForBlock(const Consensus::LLMQType llm
     quorumSnapshotCache.insert(snapshotHash, snapshot);
 }
 
+void CQuorumSnapshotManager::AddToUTXOSnapshot(const Consensus::LLMQType llmqType, const CBlockIndex* pindex, EvoDBSnapshotEntries& entries)
+{
+    const auto snapshot = GetSnapshotForBlock(llmqType, pindex);
+    if (!snapshot) return;
+    auto snapshotHash = ::SerializeHash(std::make_pair(llmqType, pindex->GetBlockHash()));
+    CEvoDB::AddSnapshotEntry(entries, std::make_pair(DB_QUORUM_SNAPSHOT, snapshotHash), *snapshot);
+}
+
 } // namespace llmq
@@ -226,6 +226,8 @@ public:
 
     std::optional<CQuorumSnapshot> GetSnapshotForBlock(Consensus::LLMQType llmqType, const CBlockIndex* pindex);
     void StoreSnapshotForBlock(Consensus::LLMQType llmqType, const CBlockIndex* pindex, const CQuorumSnapshot& snapshot);
+    /** Add the quorum snapshot of the block, if there is one, to the EvoDB entries bundled with a UTXO snapshot */
+    void AddToUTXOSnapshot(Consensus::LLMQType llmqType, const CBlockIndex* pindex, EvoDBSnapshotEntries& entries);
 };
 
 extern std::unique_ptr<CQuorumSnapshotManager> quorumSnapshotManager;
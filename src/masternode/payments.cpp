@@ -45,7 +45,7 @@
         voutMasternodePaymentsRet.emplace_back(platformReward, CScript() << OP_RETURN);
     }
 
-    auto dmnPayee = deterministicMNManager->GetListForBlock(pindexPrev).GetMNPayee(pindexPrev);
+    auto dmnPayee = deterministicMNManager->GetMNPayee(pindexPrev);
     if (!dmnPayee) {
         return false;
     }
@@ -14,6 +14,7 @@
 #include <consensus/tx_verify.h>
 #include <consensus/validation.h>
 #include <deploymentstatus.h>
+#include <hash.h>
 #include <policy/feerate.h>
 #include <policy/policy.h>
 #include <pow.h>
@@ -25,8 +26,10 @@
 #include <evo/specialtx.h>
 #include <evo/cbtx.h>
 #include <evo/creditpool.h>
+#include <evo/deterministicmns.h>
 #include <evo/mnhftx.h>
 #include <evo/simplifiedmns.h>
+#include <governance/classes.h>
 #include <governance/governance.h>
 #include <llmq/blockprocessor.h>
 #include <llmq/chainlocks.h>
@@ -38,6 +41,7 @@
 #include <validation.h>
 
 #include <algorithm>
+#include <set>
 #include <utility>
 
 int64_t UpdateTime(CBlockHeader* pblock, const Consensus::Params& consensusParams, const CBlockIndex* pindexPrev)
@@ -55,6 +59,72 @@ int64_t UpdateTime(CBlockHeader* pblock, const Consensus::Params& consensusParam
     return nNewTime - nOldTime;
 }
 
+uint256 CalcCbTxTemplateKey(const CBlock& block, const CBlockIndex* pindexPrev, const CDeterministicMNList& mnList,
+                            CCbTx::Version nVersion, CAmount blockSubsidy)
+{
+    CHashWriter hw(SER_GETHASH, 0);
+    hw << pindexPrev->GetBlockHash() << static_cast<uint16_t>(nVersion) << blockSubsidy;
+    // transactions are in dependency order, so the outputs of relevant ones are known before they are spent
+    std::set<uint256> relevantTxids;
+    for (const auto& tx : block.vtx) {
+        // the coinbase is not filled in yet
+        if (tx == nullptr || tx->IsCoinBase()) continue;
+        bool fRelevant = tx->nType != TRANSACTION_NORMAL;
+        for (size_t i = 0; !fRelevant && i < tx->vin.size(); ++i) {
+            fRelevant = relevantTxids.count(tx->vin[i].prevout.hash) || mnList.HasMNByCollateral(tx->vin[i].prevout);
+        }
+        if (fRelevant) {
+            relevantTxids.emplace(tx->GetHash());
+            hw << tx->GetHash();
+        }
+    }
+    return hw.GetHash();
+}
+
+/**
+ * Identifies everything a template is built from except for the mempool: the previous block, the coinbase
+ * script, the block limits and the quorum commitments already added to the block.
+ */
+static uint256 CalcTemplateKey(const CBlock& block, const CBlockIndex* pindexPrev, const CScript& scriptPubKey,
+                               unsigned int nBlockMaxSize, const CFeeRate& blockMinFeeRate)
+{
+    CHashWriter hw(SER_GETHASH, 0);
+    hw << pindexPrev->GetBlockHash() << scriptPubKey << nBlockMaxSize << blockMinFeeRate.GetFeePerK();
+    for (const auto& tx : block.vtx) {
+        if (tx == nullptr || tx->IsCoinBase()) continue;
+        hw << tx->GetHash();
+    }
+    return hw.GetHash();
+}
+
+std::unique_ptr<CBlockTemplate> BlockTemplateCache::GetTemplate(const uint256& key) const
+{
+    LOCK(cs);
+    if (m_template == nullptr || m_template_key != key) return nullptr;
+    return std::make_unique<CBlockTemplate>(*m_template);
+}
+
+void BlockTemplateCache::SetTemplate(const uint256& key, const CBlockTemplate& block_template)
+{
+    LOCK(cs);
+    m_template_key = key;
+    m_template = std::make_unique<CBlockTemplate>(block_template);
+}
+
+std::optional<CCbTx> BlockTemplateCache::GetCbTx(const uint256& key) const
+{
+    LOCK(cs);
+    if (m_cbtx_key.IsNull() || m_cbtx_key != key) return std::nullopt;
+    return m_cbtx;
+}
+
+void BlockTemplateCache::SetCbTx(const uint256& key, const CCbTx& cbTx)
+{
+    LOCK(cs);
+    m_cbtx_key = key;
+    m_cbtx = cbTx;
+}
+
 BlockAssembler::Options::Options() {
     blockMinFeeRate = CFeeRate(DEFAULT_BLOCK_MIN_TX_FEE);
     nBlockMaxSize = DEFAULT_BLOCK_MAX_SIZE;
@@ -70,13 +140,14 @@ BlockAssembler::BlockAssembler(const CSporkManager& sporkManager, CGovernanceMan
       quorum_block_processor(*llmq_ctx.quorum_block_processor),
       m_clhandler(*llmq_ctx.clhandler),
       m_isman(*llmq_ctx.isman),
-      m_evoDb(evoDb)
+      m_evoDb(evoDb),
+      m_template_cache(options.template_cache)
 {
     blockMinFeeRate = options.blockMinFeeRate;
     nBlockMaxSize = options.nBlockMaxSize;
 }
 
-static BlockAssembler::Options DefaultOptions()
+static BlockAssembler::Options DefaultOptions(BlockTemplateCache* template_cache)
 {
     // Block resource limits
     BlockAssembler::Options options;
@@ -90,12 +161,14 @@ static BlockAssembler::Options DefaultOptions()
     } else {
         options.blockMinFeeRate = CFeeRate{DEFAULT_BLOCK_MIN_TX_FEE};
     }
+    options.template_cache = template_cache;
     return options;
 }
 
 BlockAssembler::BlockAssembler(const CSporkManager& sporkManager, CGovernanceManager& governanceManager,
-                               LLMQContext& llmq_ctx, CEvoDB& evoDb, CChainState& chainstate, const CTxMemPool& mempool, const CChainParams& params)
-    : BlockAssembler(sporkManager, governanceManager, llmq_ctx, evoDb, chainstate, mempool, params, DefaultOptions()) {}
+                               LLMQContext& llmq_ctx, CEvoDB& evoDb, CChainState& chainstate, const CTxMemPool& mempool, const CChainParams& params,
+                               BlockTemplateCache* template_cache)
+    : BlockAssembler(sporkManager, governanceManager, llmq_ctx, evoDb, chainstate, mempool, params, DefaultOptions(template_cache)) {}
 
 void BlockAssembler::resetBlock()
 {
@@ -172,6 +245,13 @@ std::unique_ptr<CBlockTemplate> BlockAssembler::CreateNewBlock(const CScript& sc
         }
     }
 
+    // Templates are usually requested many times for the same tip. Keep the transactions of the last one
+    // while all of them are still in the mempool and only add the packages which arrived since then, as long
+    // as none of those pays more than the kept ones.
+    const uint256 templateKey = CalcTemplateKey(*pblock, pindexPrev, scriptPubKeyIn, nBlockMaxSize, blockMinFeeRate);
+    const std::unique_ptr<CBlockTemplate> prevTemplate = m_template_cache ? m_template_cache->GetTemplate(templateKey) : nullptr;
+    const bool fIncremental = prevTemplate != nullptr && AddTemplateTxs(*prevTemplate);
+
     int nPackagesSelected = 0;
     int nDescendantsUpdated = 0;
 
@@ -217,22 +297,26 @@ std::unique_ptr<CBlockTemplate> BlockAssembler::CreateNewBlock(const CScript& sc
 
         cbTx.nHeight = nHeight;
 
-        BlockValidationState state;
-        if (!CalcCbTxMerkleRootMNList(*pblock, pindexPrev, cbTx.merkleRootMNList, state, ::ChainstateActive().CoinsTip())) {
-            throw std::runtime_error(strprintf("%s: CalcCbTxMerkleRootMNList failed: %s", __func__, state.ToString()));
-        }
-        if (fDIP0008Active_context) {
-            if (!CalcCbTxMerkleRootQuorums(*pblock, pindexPrev, quorum_block_processor, cbTx.merkleRootQuorums, state)) {
-                throw std::runtime_error(strprintf("%s: CalcCbTxMerkleRootQuorums failed: %s", __func__, state.ToString()));
+        // Most of the time the selected transactions don't touch the masternode list, quorums or credit pool
+        // in a different way than for the last template. Reuse the roots and the credit pool balance then.
+        const uint256 cbTxKey = CalcCbTxTemplateKey(*pblock, pindexPrev, deterministicMNManager->GetListAtChainTip(), cbTx.nVersion, blockSubsidy);
+        const std::optional<CCbTx> cbTxCached = m_template_cache ? m_template_cache->GetCbTx(cbTxKey) : std::nullopt;
+        const bool fCbTxCached = cbTxCached.has_value();
+        if (fCbTxCached) {
+            cbTx.merkleRootMNList = cbTxCached->merkleRootMNList;
+            cbTx.merkleRootQuorums = cbTxCached->merkleRootQuorums;
+            cbTx.creditPoolBalance = cbTxCached->creditPoolBalance;
+        } else {
+            BlockValidationState state;
+            if (!CalcCbTxMerkleRootMNList(*pblock, pindexPrev, cbTx.merkleRootMNList, state, ::ChainstateActive().CoinsTip())) {
+                throw std::runtime_error(strprintf("%s: CalcCbTxMerkleRootMNList failed: %s", __func__, state.ToString()));
             }
-            if (fV20Active_context) {
-                if (CalcCbTxBestChainlock(m_clhandler, pindexPrev, cbTx.bestCLHeightDiff, cbTx.bestCLSignature)) {
-                    LogPrintf("CreateNewBlock() h[%d] CbTx bestCLHeightDiff[%d] CLSig[%s]\n", nHeight, cbTx.bestCLHeightDiff, cbTx.bestCLSignature.ToString());
-                } else {
-                    // not an error
-                    LogPrintf("CreateNewBlock() h[%d] CbTx failed to find best CL. Inserting null CL\n", nHeight);
+            if (fDIP0008Active_context) {
+                if (!CalcCbTxMerkleRootQuorums(*pblock, pindexPrev, quorum_block_processor, cbTx.merkleRootQuorums, state)) {
+                    throw std::runtime_error(strprintf("%s: CalcCbTxMerkleRootQuorums failed: %s", __func__, state.ToString()));
                 }
-                BlockValidationState state;
+            }
+            if (fV20Active_context) {
                 const auto creditPoolDiff = GetCreditPoolDiffForBlock(*pblock, pindexPrev, chainparams.GetConsensus(), blockSubsidy, state);
                 if (creditPoolDiff == std::nullopt) {
                     throw std::runtime_error(strprintf("%s: GetCreditPoolDiffForBlock failed: %s", __func__, state.ToString()));
@@ -240,6 +324,21 @@ std::unique_ptr<CBlockTemplate> BlockAssembler::CreateNewBlock(const CScript& sc
 
                 cbTx.creditPoolBalance = creditPoolDiff->GetTotalLocked();
             }
+
+            if (m_template_cache) {
+                m_template_cache->SetCbTx(cbTxKey, cbTx);
+            }
+        }
+        LogPrint(BCLog::BENCHMARK, "CreateNewBlock() h[%d] CbTx roots %s\n", nHeight, fCbTxCached ? "reused" : "calculated");
+
+        // The best ChainLock can change while the tip stays the same, always look it up
+        if (fV20Active_context) {
+            if (CalcCbTxBestChainlock(m_clhandler, pindexPrev, cbTx.bestCLHeightDiff, cbTx.bestCLSignature)) {
+                LogPrintf("CreateNewBlock() h[%d] CbTx bestCLHeightDiff[%d] CLSig[%s]\n", nHeight, cbTx.bestCLHeightDiff, cbTx.bestCLSignature.ToString());
+            } else {
+                // not an error
+                LogPrintf("CreateNewBlock() h[%d] CbTx failed to find best CL. Inserting null CL\n", nHeight);
+            }
         }
 
         SetTxPayload(coinbaseTx, cbTx);
@@ -265,6 +364,10 @@ std::unique_ptr<CBlockTemplate> BlockAssembler::CreateNewBlock(const CScript& sc
     if (!TestBlockValidity(state, m_clhandler, m_evoDb, chainparams, m_chainstate, *pblock, pindexPrev, false, false)) {
         throw std::runtime_error(strprintf("%s: TestBlockValidity failed: %s", __func__, state.ToString()));
     }
+    if (m_template_cache) {
+        m_template_cache->SetTemplate(templateKey, *pblocktemplate);
+    }
+    LogPrint(BCLog::BENCHMARK, "CreateNewBlock() h[%d] template %s\n", nHeight, fIncremental ? "extended" : "rebuilt");
     int64_t nTime2 = GetTimeMicros();
 
     LogPrint(BCLog::BENCHMARK, "CreateNewBlock() packages: %.2fms (%d packages, %d updated descendants), validity: %.2fms (total %.2fms)\n", 0.001 * (nTime1 - nTimeStart), nPackagesSelected, nDescendantsUpdated, 0.001 * (nTime2 - nTime1), 0.001 * (nTime2 - nTimeStart));
@@ -332,6 +435,39 @@ void BlockAssembler::AddToBlock(CTxMemPool::txiter iter)
     }
 }
 
+bool BlockAssembler::AddTemplateTxs(const CBlockTemplate& prev_template)
+{
+    AssertLockHeld(m_mempool.cs);
+
+    CTxMemPool::setEntries entries;
+    std::vector<CTxMemPool::txiter> sortedEntries;
+    for (const auto& tx : prev_template.block.vtx) {
+        // the coinbase is created anew and the quorum commitments were added already
+        if (tx->IsCoinBase() || tx->nType == TRANSACTION_QUORUM_COMMITMENT) continue;
+        // special transactions are checked against the credit pool and EHF signals while selecting packages
+        if (tx->nType != TRANSACTION_NORMAL) return false;
+        const auto it = m_mempool.GetIter(tx->GetHash());
+        if (!it) return false;
+        entries.insert(*it);
+        sortedEntries.push_back(*it);
+    }
+    if (!TestPackageTransactions(entries)) return false;
+
+    // Packages which arrived since then and pay more than the kept ones would be selected before them. Start from
+    // scratch then, the kept transactions must be the ones with the best fee rates in the mempool.
+    size_t nKeptSeen{0};
+    for (const auto& entry : m_mempool.mapTx.get<ancestor_score>()) {
+        if (nKeptSeen == entries.size()) break;
+        if (!entries.count(m_mempool.mapTx.iterator_to(entry))) return false;
+        ++nKeptSeen;
+    }
+
+    for (const auto& it : sortedEntries) {
+        AddToBlock(it);
+    }
+    return true;
+}
+
 int BlockAssembler::UpdatePackagesForAdded(const CTxMemPool::setEntries& alreadyAdded,
         indexed_modified_transaction_set &mapModifiedTx)
 {
@@ -420,6 +556,9 @@ void BlockAssembler::addPackageTxs(int &nPackagesSelected, int &nDescendantsUpda
     // Keep track of entries that failed inclusion, to avoid duplicate work
     CTxMemPool::setEntries failedTx;
 
+    // Transactions kept from the last template change the packages of their descendants
+    nDescendantsUpdated += UpdatePackagesForAdded(inBlock, mapModifiedTx);
+
     CTxMemPool::indexed_transaction_set::index<ancestor_score>::type::iterator mi = m_mempool.mapTx.get<ancestor_score>().begin();
     CTxMemPool::txiter iter;
 
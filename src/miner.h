@@ -6,8 +6,11 @@
 #ifndef BITCOIN_MINER_H
 #define BITCOIN_MINER_H
 
+#include <evo/cbtx.h>
 #include <primitives/block.h>
+#include <sync.h>
 #include <txmempool.h>
+#include <uint256.h>
 
 #include <memory>
 #include <optional>
@@ -19,6 +22,7 @@
 class CBlockIndex;
 class CChainParams;
 class CConnman;
+class CDeterministicMNList;
 class CEvoDB;
 class CGovernanceManager;
 class CScript;
@@ -44,6 +48,30 @@ struct CBlockTemplate
     std::vector<CTxOut> voutSuperblockPayments; // superblock payment
 };
 
+/**
+ * What CreateNewBlock calculated for the last template, used by the next template built on the same tip.
+ * The transactions of the last template are kept as long as all of them are still in the mempool and only
+ * packages which entered the mempool since then are added, unless one of those pays a better fee rate. The CbTx roots and credit pool balance are
+ * reused while the transactions affecting them stay the same.
+ */
+class BlockTemplateCache
+{
+private:
+    mutable Mutex cs;
+    uint256 m_template_key GUARDED_BY(cs);
+    std::unique_ptr<CBlockTemplate> m_template GUARDED_BY(cs);
+    uint256 m_cbtx_key GUARDED_BY(cs);
+    CCbTx m_cbtx GUARDED_BY(cs);
+
+public:
+    /** Copy of the last template if it was built for the given key */
+    std::unique_ptr<CBlockTemplate> GetTemplate(const uint256& key) const;
+    void SetTemplate(const uint256& key, const CBlockTemplate& block_template);
+    /** CbTx with the roots and credit pool balance calculated for the given key */
+    std::optional<CCbTx> GetCbTx(const uint256& key) const;
+    void SetCbTx(const uint256& key, const CCbTx& cbTx);
+};
+
 // Container for tracking updates to ancestor feerate as we include (parent)
 // transactions in a block
 struct CTxMemPoolModifiedEntry {
@@ -164,16 +192,19 @@ private:
     llmq::CChainLocksHandler& m_clhandler;
     llmq::CInstantSendManager& m_isman;
     CEvoDB& m_evoDb;
+    BlockTemplateCache* const m_template_cache;
 
 public:
     struct Options {
         Options();
         size_t nBlockMaxSize;
         CFeeRate blockMinFeeRate;
+        BlockTemplateCache* template_cache{nullptr};
     };
 
     explicit BlockAssembler(const CSporkManager& sporkManager, CGovernanceManager& governanceManager,
-                            LLMQContext& llmq_ctx, CEvoDB& evoDb, CChainState& chainstate, const CTxMemPool& mempool, const CChainParams& params);
+                            LLMQContext& llmq_ctx, CEvoDB& evoDb, CChainState& chainstate, const CTxMemPool& mempool, const CChainParams& params,
+                            BlockTemplateCache* template_cache = nullptr);
     explicit BlockAssembler(const CSporkManager& sporkManager, CGovernanceManager& governanceManager,
                             LLMQContext& llmq_ctx, CEvoDB& evoDb, CChainState& chainstate, const CTxMemPool& mempool, const CChainParams& params, const Options& options);
 
@@ -189,6 +220,10 @@ private:
     void resetBlock();
     /** Add a tx to the block */
     void AddToBlock(CTxMemPool::txiter iter);
+    /** Add the mempool transactions of a previous template for the same tip to the block. Returns false
+      * without adding any if one of them left the mempool or is a special transaction, or if a transaction
+      * which is not in the template has a better ancestor fee rate than one of them. */
+    bool AddTemplateTxs(const CBlockTemplate& prev_template) EXCLUSIVE_LOCKS_REQUIRED(m_mempool.cs);
 
     // Methods for how to add transactions to a block.
     /** Add transactions based on feerate including unconfirmed ancestors
@@ -218,6 +253,15 @@ private:
     int UpdatePackagesForAdded(const CTxMemPool::setEntries& alreadyAdded, indexed_modified_transaction_set& mapModifiedTx) EXCLUSIVE_LOCKS_REQUIRED(m_mempool.cs);
 };
 
+/**
+ * Identifies the inputs of the Dash-specific coinbase payload fields: the previous block, the coinbase
+ * version and subsidy, and all transactions of the block which may modify the masternode list, the mined
+ * quorums or the credit pool. These are special transactions, spends of masternode collaterals and spends
+ * of outputs of such transactions in the same block.
+ */
+uint256 CalcCbTxTemplateKey(const CBlock& block, const CBlockIndex* pindexPrev, const CDeterministicMNList& mnList,
+                            CCbTx::Version nVersion, CAmount blockSubsidy);
+
 /** Modify the extranonce in a block */
 void IncrementExtraNonce(CBlock* pblock, const CBlockIndex* pindexPrev, unsigned int& nExtraNonce);
 int64_t UpdateTime(CBlockHeader* pblock, const Consensus::Params& consensusParams, const CBlockIndex* pindexPrev);
@@ -30,6 +30,7 @@
 #include <index/txindex.h>
 #include <txmempool.h>
 #include <util/check.h> // For NDEBUG compile time check
+#include <util/metrics.h>
 #include <util/system.h>
 #include <util/strencodings.h>
 
@@ -2006,6 +2007,14 @@ void PeerManagerImpl::ProcessGetBlockData(CNode& pfrom, const CChainParams& chai
         std::shared_ptr<const CBlock> pblock;
         if (a_recent_block && a_recent_block->GetHash() == pindex->GetBlockHash()) {
             pblock = a_recent_block;
+        } else if (inv.type == MSG_BLOCK) {
+            // Send the block as stored on disk, without deserializing and hashing it first
+            const auto block_data = GetRawBlock(pindex, m_chainparams.MessageStart());
+            if (!block_data) {
+                assert(!"cannot load block from disk");
+            }
+            connman.PushMessage(&pfrom, msgMaker.Make(NetMsgType::BLOCK, Span{*block_data}));
+            // pblock stays nullptr, the block has been sent already
         } else {
             // Send block from disk
             std::shared_ptr<CBlock> pblockRead = std::make_shared<CBlock>();
@@ -2331,6 +2340,9 @@ void PeerManagerImpl::ProcessHeadersMessage(CNode& pfrom, const std::vector<CBlo
         return;
     }
 
+    // Hash all headers at once and before taking cs_main, the hashes are reused when accepting them
+    const std::vector<uint256> hashes = GetBlockHeaderHashes(headers);
+
     bool received_new_header = false;
     const CBlockIndex *pindexLast = nullptr;
     {
@@ -2350,7 +2362,7 @@ void PeerManagerImpl::ProcessHeadersMessage(CNode& pfrom, const std::vector<CBlo
             std::string msg_type = (pfrom.nServices & NODE_HEADERS_COMPRESSED) ? NetMsgType::GETHEADERS2 : NetMsgType::GETHEADERS;
             m_connman.PushMessage(&pfrom, msgMaker.Make(msg_type, m_chainman.ActiveChain().GetLocator(pindexBestHeader), uint256()));
             LogPrint(BCLog::NET, "received header %s: missing prev block %s, sending %s (%d) to end (peer=%d, nUnconnectingHeaders=%d)\n",
-                    headers[0].GetHash().ToString(),
+                    hashes[0].ToString(),
                     headers[0].hashPrevBlock.ToString(),
                     msg_type,
                     pindexBestHeader->nHeight,
@@ -2358,7 +2370,7 @@ void PeerManagerImpl::ProcessHeadersMessage(CNode& pfrom, const std::vector<CBlo
             // Set hashLastUnknownBlock for this peer, so that if we
             // eventually get the headers - even from a different peer -
             // we can use this peer to download.
-            UpdateBlockAvailability(pfrom.GetId(), headers.back().GetHash());
+            UpdateBlockAvailability(pfrom.GetId(), hashes.back());
 
             if (nodestate->nUnconnectingHeaders % MAX_UNCONNECTING_HEADERS == 0) {
                 Misbehaving(pfrom.GetId(), 20, strprintf("%d non-connecting headers", nodestate->nUnconnectingHeaders));
@@ -2367,12 +2379,12 @@ void PeerManagerImpl::ProcessHeadersMessage(CNode& pfrom, const std::vector<CBlo
         }
 
         uint256 hashLastBlock;
-        for (const CBlockHeader& header : headers) {
-            if (!hashLastBlock.IsNull() && header.hashPrevBlock != hashLastBlock) {
+        for (size_t i = 0; i < nCount; ++i) {
+            if (!hashLastBlock.IsNull() && headers[i].hashPrevBlock != hashLastBlock) {
                 Misbehaving(pfrom.GetId(), 20, "non-continuous headers sequence");
                 return;
             }
-            hashLastBlock = header.GetHash();
+            hashLastBlock = hashes[i];
         }
 
         // If we don't have the last header, then they'll have given us
@@ -2383,7 +2395,7 @@ void PeerManagerImpl::ProcessHeadersMessage(CNode& pfrom, const std::vector<CBlo
     }
 
     BlockValidationState state;
-    if (!m_chainman.ProcessNewBlockHeaders(headers, state, m_chainparams, &pindexLast)) {
+    if (!m_chainman.ProcessNewBlockHeaders(headers, state, m_chainparams, &pindexLast, hashes)) {
         if (state.IsInvalid()) {
             MaybePunishNodeForBlock(pfrom.GetId(), state, via_compact_block, "invalid header received");
             return;
@@ -4418,6 +4430,21 @@ bool PeerManagerImpl::MaybeDiscourageAndDisconnect(CNode& pnode)
     return true;
 }
 
+/** Histogram of the time spent processing messages of the given type, unknown types share one */
+static metrics::Histogram& GetMessageProcessingHistogram(const std::string& msg_type)
+{
+    static const std::map<std::string, metrics::Histogram*> histograms = [] {
+        std::map<std::string, metrics::Histogram*> ret;
+        for (const auto& type : getAllNetMessageTypes()) {
+            ret.emplace(type, &metrics::GetHistogram("net.msg." + type + ".process_us"));
+        }
+        return ret;
+    }();
+    static metrics::Histogram& other = metrics::GetHistogram("net.msg.other.process_us");
+    const auto it = histograms.find(msg_type);
+    return it != histograms.end() ? *it->second : other;
+}
+
 bool PeerManagerImpl::ProcessMessages(CNode* pfrom, std::atomic<bool>& interruptMsgProc)
 {
     bool fMoreWork = false;
@@ -4478,6 +4505,7 @@ bool PeerManagerImpl::ProcessMessages(CNode* pfrom, std::atomic<bool>& interrupt
     unsigned int nMessageSize = msg.m_message_size;
 
     try {
+        metrics::ScopedTimer timer(GetMessageProcessingHistogram(msg_type));
         ProcessMessage(*pfrom, msg_type, msg.m_recv, msg.m_time, interruptMsgProc);
         if (interruptMsgProc) return false;
         {
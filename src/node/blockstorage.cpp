@@ -13,8 +13,12 @@
 #include <fs.h>
 #include <masternode/node.h>
 #include <pow.h>
+#include <saltedhasher.h>
 #include <shutdown.h>
 #include <streams.h>
+#include <sync.h>
+#include <unordered_lru_cache.h>
+#include <util/strencodings.h>
 #include <util/system.h>
 #include <validation.h>
 #include <walletinitinterface.h>
@@ -84,6 +88,103 @@ bool ReadBlockFromDisk(CBlock& block, const CBlockIndex* pindex, const Consensus
     return true;
 }
 
+bool ReadCoinbaseFromDisk(CTransactionRef& tx, const CBlockIndex* pindex)
+{
+    const FlatFilePos block_pos{WITH_LOCK(cs_main, return pindex->GetBlockPos())};
+
+    CAutoFile filein(OpenBlockFile(block_pos, true), SER_DISK, CLIENT_VERSION);
+    if (filein.IsNull()) {
+        return error("%s: OpenBlockFile failed for %s", __func__, block_pos.ToString());
+    }
+
+    try {
+        CBlockHeader header;
+        filein >> header;
+        if (header.GetHash() != pindex->GetBlockHash()) {
+            return error("%s: GetHash() doesn't match index for %s at %s", __func__, pindex->ToString(), block_pos.ToString());
+        }
+        // the coinbase is the first entry of the transactions which follow the header
+        if (ReadCompactSize(filein) == 0) return false;
+        filein >> tx;
+    } catch (const std::exception& e) {
+        return error("%s: Deserialize or I/O error - %s at %s", __func__, e.what(), block_pos.ToString());
+    }
+    return true;
+}
+
+bool ReadRawBlockFromDisk(std::vector<uint8_t>& block, const FlatFilePos& pos, const CMessageHeader::MessageStartChars& message_start)
+{
+    if (pos.nPos < 8) {
+        return error("%s: Invalid block position %s", __func__, pos.ToString());
+    }
+    FlatFilePos hpos = pos;
+    hpos.nPos -= 8; // Seek back 8 bytes for the message start and size written by WriteBlockToDisk
+
+    CAutoFile filein(OpenBlockFile(hpos, true), SER_DISK, CLIENT_VERSION);
+    if (filein.IsNull()) {
+        return error("%s: OpenBlockFile failed for %s", __func__, pos.ToString());
+    }
+
+    try {
+        CMessageHeader::MessageStartChars blk_start;
+        unsigned int blk_size;
+
+        filein >> blk_start >> blk_size;
+
+        if (memcmp(blk_start, message_start, CMessageHeader::MESSAGE_START_SIZE)) {
+            return error("%s: Block magic mismatch for %s: %s versus expected %s", __func__, pos.ToString(),
+                         HexStr(blk_start), HexStr(message_start));
+        }
+
+        if (blk_size > MAX_SIZE) {
+            return error("%s: Block data is larger than maximum deserialization size for %s: %s versus %s", __func__, pos.ToString(),
+                         blk_size, MAX_SIZE);
+        }
+
+        block.resize(blk_size);
+        filein.read(reinterpret_cast<char*>(block.data()), blk_size);
+    } catch (const std::exception& e) {
+        return error("%s: Read from block file failed: %s for %s", __func__, e.what(), pos.ToString());
+    }
+
+    return true;
+}
+
+namespace {
+/** Raw blocks recently returned by GetRawBlock, peers catching up usually ask several of their peers for the same blocks */
+Mutex g_raw_block_cache_mutex;
+unordered_lru_cache<uint256, std::shared_ptr<const std::vector<uint8_t>>, StaticSaltedHasher> g_raw_block_cache GUARDED_BY(g_raw_block_cache_mutex){RAW_BLOCK_CACHE_SIZE};
+} // anonymous namespace
+
+std::shared_ptr<const std::vector<uint8_t>> GetRawBlock(const CBlockIndex* pindex, const CMessageHeader::MessageStartChars& message_start)
+{
+    const uint256 hash = pindex->GetBlockHash();
+    std::shared_ptr<const std::vector<uint8_t>> ret;
+    if (WITH_LOCK(g_raw_block_cache_mutex, return g_raw_block_cache.get(hash, ret))) {
+        return ret;
+    }
+
+    const FlatFilePos block_pos{WITH_LOCK(cs_main, return pindex->GetBlockPos())};
+    auto block = std::make_shared<std::vector<uint8_t>>();
+    if (!ReadRawBlockFromDisk(*block, block_pos, message_start)) {
+        return nullptr;
+    }
+
+    // The block passed the PoW check when it was accepted, comparing the header on disk with the index
+    // is enough to know we read the right block and spares hashing it again.
+    CDataStream ssHeader(SER_NETWORK, PROTOCOL_VERSION);
+    ssHeader << pindex->GetBlockHeader();
+    if (block->size() < ssHeader.size() || memcmp(block->data(), ssHeader.data(), ssHeader.size()) != 0) {
+        error("%s: Block header doesn't match index for %s at %s", __func__, pindex->ToString(), block_pos.ToString());
+        return nullptr;
+    }
+
+    ret = std::move(block);
+    LOCK(g_raw_block_cache_mutex);
+    g_raw_block_cache.insert(hash, ret);
+    return ret;
+}
+
 /** Store block on disk. If dbp is non-nullptr, the file is known to already reside on disk */
 FlatFilePos SaveBlockToDisk(const CBlock& block, int nHeight, CChain& active_chain, const CChainParams& chainparams, const FlatFilePos* dbp)
 {
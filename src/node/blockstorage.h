@@ -6,9 +6,11 @@
 #define BITCOIN_NODE_BLOCKSTORAGE_H
 
 #include <fs.h>
+#include <primitives/transaction.h>
 #include <protocol.h> // For CMessageHeader::MessageStartChars
 
 #include <cstdint>
+#include <memory>
 #include <vector>
 
 class ArgsManager;
@@ -25,10 +27,21 @@ struct Params;
 }
 
 static constexpr bool DEFAULT_STOPAFTERBLOCKIMPORT{false};
+/** Number of serialized blocks kept around by GetRawBlock */
+static constexpr size_t RAW_BLOCK_CACHE_SIZE{8};
 
 /** Functions for disk access for blocks */
 bool ReadBlockFromDisk(CBlock& block, const FlatFilePos& pos, const Consensus::Params& consensusParams);
 bool ReadBlockFromDisk(CBlock& block, const CBlockIndex* pindex, const Consensus::Params& consensusParams);
+/** Read only the coinbase transaction of the block of pindex, the header read with it is checked against pindex */
+bool ReadCoinbaseFromDisk(CTransactionRef& tx, const CBlockIndex* pindex);
+/** Read the serialized block at pos as written to disk, without deserializing or hashing it */
+bool ReadRawBlockFromDisk(std::vector<uint8_t>& block, const FlatFilePos& pos, const CMessageHeader::MessageStartChars& message_start);
+/**
+ * Serialized block of pindex for serving it to peers and clients. The header read from disk is checked
+ * against pindex instead of recomputing the block hash. Returns nullptr if the block can't be read.
+ */
+std::shared_ptr<const std::vector<uint8_t>> GetRawBlock(const CBlockIndex* pindex, const CMessageHeader::MessageStartChars& message_start);
 
 bool UndoReadFromDisk(CBlockUndo& blockundo, const CBlockIndex* pindex);
 
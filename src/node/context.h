@@ -12,6 +12,7 @@
 
 class ArgsManager;
 class BanMan;
+class BlockTemplateCache;
 class CAddrMan;
 class CBlockPolicyEstimator;
 class CConnman;
@@ -69,6 +70,8 @@ struct NodeContext {
     std::unique_ptr<CJContext> cj_ctx;
 
     std::unique_ptr<CEvoDB> evodb;
+    //! What getblocktemplate reuses between templates for the same tip
+    std::unique_ptr<BlockTemplateCache> block_template_cache;
 
     //! Declare default constructor and destructor that are not inline, so code
     //! instantiating the NodeContext struct doesn't need to #include class
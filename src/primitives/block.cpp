@@ -5,6 +5,7 @@
 
 #include <primitives/block.h>
 
+#include <crypto/x11.h>
 #include <hash.h>
 #include <streams.h>
 #include <tinyformat.h>
@@ -17,6 +18,27 @@ uint256 CBlockHeader::GetHash() const
     return HashX11((const char *)vch.data(), (const char *)vch.data() + vch.size());
 }
 
+std::vector<uint256> GetBlockHeaderHashes(const std::vector<CBlockHeader>& headers)
+{
+    static constexpr size_t HEADER_SIZE = 80;
+    std::vector<uint256> hashes(headers.size());
+    std::vector<unsigned char> vch(4 * HEADER_SIZE);
+    unsigned char out[4 * 32];
+    size_t i = 0;
+    for (; i + 4 <= headers.size(); i += 4) {
+        CVectorWriter ss(SER_GETHASH, PROTOCOL_VERSION, vch, 0);
+        ss << headers[i] << headers[i + 1] << headers[i + 2] << headers[i + 3];
+        X11_4way(out, vch.data(), HEADER_SIZE);
+        for (size_t j = 0; j < 4; ++j) {
+            memcpy(hashes[i + j].begin(), out + j * 32, 32);
+        }
+    }
+    for (; i < headers.size(); ++i) {
+        hashes[i] = headers[i].GetHash();
+    }
+    return hashes;
+}
+
 std::string CBlock::ToString() const
 {
     std::stringstream s;
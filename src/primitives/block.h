@@ -61,6 +61,9 @@ public:
     }
 };
 
+/** Compute the hashes of a batch of headers, using the multi-buffer X11 implementation where possible */
+std::vector<uint256> GetBlockHeaderHashes(const std::vector<CBlockHeader>& headers);
+
 class CompressedHeaderBitField
 {
     std::byte bit_field{0};
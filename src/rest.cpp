@@ -23,11 +23,14 @@
 #include <sync.h>
 #include <txmempool.h>
 #include <util/check.h>
+#include <util/metrics.h>
 #include <validation.h>
 #include <version.h>
 
 #include <univalue.h>
 
+#include <algorithm>
+
 static const size_t MAX_GETUTXOS_OUTPOINTS = 15; //allow a max of 15 outpoints to be queried at once
 
 enum class RetFormat {
@@ -269,7 +272,6 @@ static bool rest_block(const CoreContext& context,
     if (!ParseHashStr(hashStr, hash))
         return RESTERR(req, HTTP_BAD_REQUEST, "Invalid hash: " + hashStr);
 
-    CBlock block;
     CBlockIndex* pblockindex = nullptr;
     CBlockIndex* tip = nullptr;
     {
@@ -285,31 +287,33 @@ static bool rest_block(const CoreContext& context,
 
         if (IsBlockPruned(pblockindex))
             return RESTERR(req, HTTP_NOT_FOUND, hashStr + " not available (pruned data)");
-
-        if (!ReadBlockFromDisk(block, pblockindex, Params().GetConsensus()))
-            return RESTERR(req, HTTP_NOT_FOUND, hashStr + " not found");
     }
 
     switch (rf) {
     case RetFormat::BINARY: {
-        CDataStream ssBlock(SER_NETWORK, PROTOCOL_VERSION);
-        ssBlock << block;
-        std::string binaryBlock = ssBlock.str();
+        const auto block_data = GetRawBlock(pblockindex, Params().MessageStart());
+        if (!block_data)
+            return RESTERR(req, HTTP_NOT_FOUND, hashStr + " not found");
+        std::string binaryBlock(block_data->begin(), block_data->end());
         req->WriteHeader("Content-Type", "application/octet-stream");
         req->WriteReply(HTTP_OK, binaryBlock);
         return true;
     }
 
     case RetFormat::HEX: {
-        CDataStream ssBlock(SER_NETWORK, PROTOCOL_VERSION);
-        ssBlock << block;
-        std::string strHex = HexStr(ssBlock) + "\n";
+        const auto block_data = GetRawBlock(pblockindex, Params().MessageStart());
+        if (!block_data)
+            return RESTERR(req, HTTP_NOT_FOUND, hashStr + " not found");
+        std::string strHex = HexStr(*block_data) + "\n";
         req->WriteHeader("Content-Type", "text/plain");
         req->WriteReply(HTTP_OK, strHex);
         return true;
     }
 
     case RetFormat::JSON: {
+        CBlock block;
+        if (!ReadBlockFromDisk(block, pblockindex, Params().GetConsensus()))
+            return RESTERR(req, HTTP_NOT_FOUND, hashStr + " not found");
         UniValue objBlock = blockToJSON(block, tip, pblockindex, *llmq::chainLocksHandler, *llmq::quorumInstantSendManager, showTxDetails);
         std::string strJSON = objBlock.write() + "\n";
         req->WriteHeader("Content-Type", "application/json");
@@ -704,6 +708,42 @@ static bool rest_blockhash_by_height(const CoreContext& context, HTTPRequest* re
     }
 }
 
+static bool rest_metrics(const CoreContext& context, HTTPRequest* req, const std::string& strURIPart)
+{
+    if (!strURIPart.empty()) {
+        return RESTERR(req, HTTP_NOT_FOUND, "output format not found (available: text)");
+    }
+
+    // Prometheus text exposition format, metric names may not contain dots there
+    const auto name = [](const std::string& metric) {
+        std::string ret = metric;
+        std::replace(ret.begin(), ret.end(), '.', '_');
+        return ret;
+    };
+    const auto snapshot = metrics::GetSnapshot();
+    std::string strText;
+    for (const auto& [metric, value] : snapshot.counters) {
+        strText += strprintf("# TYPE %s counter\n%s %d\n", name(metric), name(metric), value);
+    }
+    for (const auto& [metric, value] : snapshot.gauges) {
+        strText += strprintf("# TYPE %s gauge\n%s %f\n", name(metric), name(metric), value);
+    }
+    for (const auto& [metric, hist] : snapshot.histograms) {
+        strText += strprintf("# TYPE %s histogram\n", name(metric));
+        uint64_t cumulative{0};
+        for (size_t i = 0; i < metrics::Histogram::BUCKETS - 1; ++i) {
+            cumulative += hist.buckets[i];
+            // Bucket i holds the whole microseconds below 2^i, le is inclusive
+            strText += strprintf("%s_bucket{le=\"%d\"} %d\n", name(metric), (uint64_t{1} << i) - 1, cumulative);
+        }
+        strText += strprintf("%s_bucket{le=\"+Inf\"} %d\n", name(metric), hist.count);
+        strText += strprintf("%s_sum %d\n%s_count %d\n", name(metric), hist.sum, name(metric), hist.count);
+    }
+    req->WriteHeader("Content-Type", "text/plain; version=0.0.4");
+    req->WriteReply(HTTP_OK, strText);
+    return true;
+}
+
 static const struct {
     const char* prefix;
     bool (*handler)(const CoreContext& context, HTTPRequest* req, const std::string& strReq);
@@ -717,6 +757,7 @@ static const struct {
       {"/rest/headers/", rest_headers},
       {"/rest/getutxos", rest_getutxos},
       {"/rest/blockhashbyheight/", rest_blockhash_by_height},
+      {"/rest/metrics", rest_metrics},
 };
 
 void StartREST(const CoreContext& context)
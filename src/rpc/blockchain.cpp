@@ -31,6 +31,7 @@
 #include <rpc/server.h>
 #include <rpc/util.h>
 #include <script/descriptor.h>
+#include <shutdown.h>
 #include <streams.h>
 #include <sync.h>
 #include <txmempool.h>
@@ -45,10 +46,14 @@
 
 #include <evo/specialtx.h>
 #include <evo/cbtx.h>
+#include <evo/cbtxindex.h>
 #include <evo/evodb.h>
 
 #include <llmq/chainlocks.h>
 #include <llmq/instantsend.h>
+#include <llmq/options.h>
+#include <llmq/snapshot.h>
+#include <llmq/utils.h>
 
 #include <stdint.h>
 
@@ -1063,6 +1068,23 @@ static CBlock GetBlockChecked(const CBlockIndex* pblockindex)
     return block;
 }
 
+static std::shared_ptr<const std::vector<uint8_t>> GetRawBlockChecked(const CBlockIndex* pblockindex)
+{
+    if (IsBlockPruned(pblockindex)) {
+        throw JSONRPCError(RPC_MISC_ERROR, "Block not available (pruned data)");
+    }
+
+    auto block_data = GetRawBlock(pblockindex, Params().MessageStart());
+    if (!block_data) {
+        // Block not found on disk. This could be because we have the block
+        // header in our index but not yet have the block or did not accept the
+        // block.
+        throw JSONRPCError(RPC_MISC_ERROR, "Block not found on disk");
+    }
+
+    return block_data;
+}
+
 static CBlockUndo GetUndoChecked(const CBlockIndex* pblockindex)
 {
     CBlockUndo blockUndo;
@@ -1224,6 +1246,7 @@ static UniValue getblock(const JSONRPCRequest& request)
     const NodeContext& node = EnsureAnyNodeContext(request.context);
 
     CBlock block;
+    std::shared_ptr<const std::vector<uint8_t>> block_data;
     const CBlockIndex* pblockindex;
     const CBlockIndex* tip;
     {
@@ -1236,15 +1259,16 @@ static UniValue getblock(const JSONRPCRequest& request)
             throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Block not found");
         }
 
-        block = GetBlockChecked(pblockindex);
+        if (verbosity <= 0) {
+            block_data = GetRawBlockChecked(pblockindex);
+        } else {
+            block = GetBlockChecked(pblockindex);
+        }
     }
 
     if (verbosity <= 0)
     {
-        CDataStream ssBlock(SER_NETWORK, PROTOCOL_VERSION);
-        ssBlock << block;
-        std::string strHex = HexStr(ssBlock);
-        return strHex;
+        return HexStr(*block_data);
     }
 
     LLMQContext& llmq_ctx = EnsureLLMQContext(node);
@@ -1502,11 +1526,6 @@ static UniValue gettxout(const JSONRPCRequest& request)
     const NodeContext& node = EnsureAnyNodeContext(request.context);
 
     ChainstateManager& chainman = EnsureChainman(node);
-    LOCK(cs_main);
-
-    CChainState& active_chainstate = chainman.ActiveChainstate();
-
-    UniValue ret(UniValue::VOBJ);
 
     uint256 hash(ParseHashV(request.params[0], "txid"));
     int n = request.params[1].get_int();
@@ -1515,6 +1534,39 @@ static UniValue gettxout(const JSONRPCRequest& request)
     if (!request.params[2].isNull())
         fMempool = request.params[2].get_bool();
 
+    const auto coin_to_univ = [](const Coin& coin, const uint256& best_block, int best_height) {
+        UniValue ret(UniValue::VOBJ);
+        ret.pushKV("bestblock", best_block.GetHex());
+        if (coin.nHeight == MEMPOOL_HEIGHT) {
+            ret.pushKV("confirmations", 0);
+        } else {
+            ret.pushKV("confirmations", (int64_t)(best_height - coin.nHeight + 1));
+        }
+        ret.pushKV("value", ValueFromAmount(coin.out.nValue));
+        UniValue o(UniValue::VOBJ);
+        ScriptPubKeyToUniv(coin.out.scriptPubKey, o, true);
+        ret.pushKV("scriptPubKey", o);
+        ret.pushKV("coinbase", (bool)coin.fCoinBase);
+        return ret;
+    };
+
+    if (!fMempool) {
+        // avoid cs_main if the chain tip's UTXO set can be read without it
+        std::vector<Coin> coins;
+        uint256 best_block;
+        int best_height;
+        if (const auto read_cache = chainman.ActiveCoinsReadCache(); read_cache && read_cache->GetCoins({out}, coins, best_block, best_height)) {
+            if (coins[0].IsSpent()) {
+                return NullUniValue;
+            }
+            return coin_to_univ(coins[0], best_block, best_height);
+        }
+    }
+
+    LOCK(cs_main);
+
+    CChainState& active_chainstate = chainman.ActiveChainstate();
+
     Coin coin;
     CCoinsViewCache* coins_view = &active_chainstate.CoinsTip();
 
@@ -1532,19 +1584,7 @@ static UniValue gettxout(const JSONRPCRequest& request)
     }
 
     const CBlockIndex* pindex = active_chainstate.m_blockman.LookupBlockIndex(coins_view->GetBestBlock());
-    ret.pushKV("bestblock", pindex->GetBlockHash().GetHex());
-    if (coin.nHeight == MEMPOOL_HEIGHT) {
-        ret.pushKV("confirmations", 0);
-    } else {
-        ret.pushKV("confirmations", (int64_t)(pindex->nHeight - coin.nHeight + 1));
-    }
-    ret.pushKV("value", ValueFromAmount(coin.out.nValue));
-    UniValue o(UniValue::VOBJ);
-    ScriptPubKeyToUniv(coin.out.scriptPubKey, o, true);
-    ret.pushKV("scriptPubKey", o);
-    ret.pushKV("coinbase", (bool)coin.fCoinBase);
-
-    return ret;
+    return coin_to_univ(coin, pindex->GetBlockHash(), pindex->nHeight);
 }
 
 static UniValue verifychain(const JSONRPCRequest& request)
@@ -2861,7 +2901,7 @@ UniValue dumptxoutset(const JSONRPCRequest& request)
 {
     RPCHelpMan{
         "dumptxoutset",
-        "Write the serialized UTXO set to disk.",
+        "Write the serialized UTXO set to disk, together with the EvoDB contents at the same block.",
         {
             {"path", RPCArg::Type::STR, RPCArg::Optional::NO, "Path to the output file. If relative, will be prefixed by datadir."},
         },
@@ -2869,6 +2909,12 @@ UniValue dumptxoutset(const JSONRPCRequest& request)
             RPCResult::Type::OBJ, "", "",
                 {
                     {RPCResult::Type::NUM, "coins_written", "the number of coins written in the snapshot"},
+                    {RPCResult::Type::NUM, "evodb_entries", "the number of EvoDB entries written in the snapshot"},
+                    {RPCResult::Type::STR_HEX, "evodb_hash", "the hash of the EvoDB entries written in the snapshot"},
+                    {RPCResult::Type::OBJ_DYN, "evodb_stores", "the number of EvoDB entries written in the snapshot by store",
+                    {
+                        {RPCResult::Type::NUM, "store", "the number of entries of the store"},
+                    }},
                     {RPCResult::Type::STR_HEX, "base_hash", "the hash of the base of the snapshot"},
                     {RPCResult::Type::NUM, "base_height", "the height of the base of the snapshot"},
                     {RPCResult::Type::STR, "path", "the absolute path that the snapshot was written to"},
@@ -2901,9 +2947,19 @@ UniValue dumptxoutset(const JSONRPCRequest& request)
     return result;
 }
 
+static UniValue EvoDBStoreEntriesToUniv(const EvoDBSnapshotStats& stats)
+{
+    UniValue ret(UniValue::VOBJ);
+    for (size_t i = 0; i < EVODB_STORE_COUNT; ++i) {
+        ret.pushKV(CEvoDBStores::GetStoreName(static_cast<EvoDBStore>(i)), stats.store_entries[i]);
+    }
+    return ret;
+}
+
 UniValue CreateUTXOSnapshot(NodeContext& node, CChainState& chainstate, CAutoFile& afile)
 {
     std::unique_ptr<CCoinsViewCursor> pcursor;
+    std::unique_ptr<CDBIterator> evodb_cursor;
     CCoinsStats stats{CoinStatsHashType::NONE};
     CBlockIndex* tip;
 
@@ -2931,12 +2987,49 @@ UniValue CreateUTXOSnapshot(NodeContext& node, CChainState& chainstate, CAutoFil
         pcursor = chainstate.CoinsDB().Cursor();
         tip = chainstate.m_blockman.LookupBlockIndex(stats.hashBlock);
         CHECK_NONFATAL(tip);
+
+        // The flush above also committed EvoDB, so this cursor sees the evo state at the same block as the coins
+        CHECK_NONFATAL(node.evodb);
+        CHECK_NONFATAL(node.evodb->VerifyBestBlock(tip->GetBlockHash()));
+        evodb_cursor.reset(node.evodb->GetRawDB().NewIterator());
+    }
+
+    // Only consensus data of EvoDB is written, so that every node writes the same section for the same block. A node
+    // loading the snapshot doesn't have the blocks up to the base, the entries derived from them which the blocks after
+    // the base depend on are recomputed for the last blocks, oldest first: the members of a rotated quorum, and so its
+    // quorum snapshot, are computed from the quorum snapshots of the previous cycles.
+    CHECK_NONFATAL(llmq::quorumSnapshotManager);
+    std::vector<const CBlockIndex*> chain_blocks;
+    for (const CBlockIndex* pindex = tip; pindex->pprev && pindex->nHeight > tip->nHeight - EVODB_SNAPSHOT_CHAIN_DEPTH; pindex = pindex->pprev) {
+        chain_blocks.push_back(pindex);
+    }
+    EvoDBSnapshotEntries chain_entries;
+    for (auto it = chain_blocks.rbegin(); it != chain_blocks.rend(); ++it) {
+        const CBlockIndex* pindex = *it;
+        node.rpc_interruption_point();
+        if (!AddCbTxIndexSnapshotEntry(pindex, chain_entries)) {
+            throw JSONRPCError(RPC_INTERNAL_ERROR, strprintf("Unable to read the coinbase of block %s", pindex->GetBlockHash().ToString()));
+        }
+        for (const auto& llmq_params : Params().GetConsensus().llmqs) {
+            if (!llmq_params.useRotation || pindex->nHeight % llmq_params.dkgInterval != 0) continue;
+            if (!llmq::IsQuorumRotationEnabled(llmq_params, pindex)) continue;
+            llmq::utils::GetAllQuorumMembers(llmq_params.type, pindex);
+            llmq::quorumSnapshotManager->AddToUTXOSnapshot(llmq_params.type, pindex, chain_entries);
+        }
     }
+    const auto in_chain = [&](const uint256& hash) {
+        LOCK(::cs_main);
+        const CBlockIndex* pindex = chainstate.m_blockman.LookupBlockIndex(hash);
+        return pindex != nullptr && tip->GetAncestor(pindex->nHeight) == pindex;
+    };
 
     SnapshotMetadata metadata{tip->GetBlockHash(), stats.coins_count, tip->nChainTx};
 
     afile << metadata;
 
+    // The EvoDB section comes before the coins, ActivateSnapshot() expects the coins to end the file
+    const EvoDBSnapshotStats evodb_stats = CEvoDB::WriteSnapshot(*evodb_cursor, in_chain, chain_entries, afile, node.rpc_interruption_point);
+
     COutPoint key;
     Coin coin;
     unsigned int iter{0};
@@ -2956,12 +3049,232 @@ UniValue CreateUTXOSnapshot(NodeContext& node, CChainState& chainstate, CAutoFil
 
     UniValue result(UniValue::VOBJ);
     result.pushKV("coins_written", stats.coins_count);
+    result.pushKV("evodb_entries", evodb_stats.entries);
+    result.pushKV("evodb_hash", evodb_stats.hash.ToString());
+    result.pushKV("evodb_stores", EvoDBStoreEntriesToUniv(evodb_stats));
     result.pushKV("base_hash", tip->GetBlockHash().ToString());
     result.pushKV("base_height", tip->nHeight);
 
     return result;
 }
 
+/**
+ * Load a UTXO set and EvoDB contents written by dumptxoutset and activate a chainstate based on them.
+ *
+ * @see ChainstateManager::ActivateSnapshot
+ */
+static UniValue loadtxoutset(const JSONRPCRequest& request)
+{
+    RPCHelpMan{
+        "loadtxoutset",
+        "Load a UTXO set and EvoDB contents written by dumptxoutset and make a chainstate based on them the active one.\n"
+        "The header of the base block must be known and its height must have assumeutxo data, including the hash of the\n"
+        "EvoDB contents, in the chain parameters.\n"
+        "Only a node which hasn't connected any block after the genesis block yet can load a snapshot. Its EvoDB contents are\n"
+        "replaced and it shuts down afterwards, when started again it continues syncing from the base of the snapshot.",
+        {
+            {"path", RPCArg::Type::STR, RPCArg::Optional::NO, "Path to the snapshot file. If relative, will be prefixed by datadir."},
+        },
+        RPCResult{
+            RPCResult::Type::OBJ, "", "",
+                {
+                    {RPCResult::Type::NUM, "coins_loaded", "the number of coins loaded from the snapshot"},
+                    {RPCResult::Type::NUM, "evodb_entries", "the number of EvoDB entries loaded from the snapshot"},
+                    {RPCResult::Type::STR_HEX, "evodb_hash", "the hash of the EvoDB entries loaded from the snapshot"},
+                    {RPCResult::Type::OBJ_DYN, "evodb_stores", "the number of EvoDB entries loaded from the snapshot by store",
+                    {
+                        {RPCResult::Type::NUM, "store", "the number of entries of the store"},
+                    }},
+                    {RPCResult::Type::STR_HEX, "base_hash", "the hash of the base of the snapshot"},
+                    {RPCResult::Type::NUM, "base_height", "the height of the base of the snapshot"},
+                    {RPCResult::Type::STR, "path", "the absolute path that the snapshot was loaded from"},
+                }
+        },
+        RPCExamples{
+            HelpExampleCli("loadtxoutset", "utxo.dat")
+        }
+    }.Check(request);
+
+    NodeContext& node = EnsureAnyNodeContext(request.context);
+    ChainstateManager& chainman = EnsureChainman(node);
+    CHECK_NONFATAL(node.evodb);
+
+    const fs::path path = fsbridge::AbsPathJoin(GetDataDir(), request.params[0].get_str());
+    FILE* file{fsbridge::fopen(path, "rb")};
+    CAutoFile afile{file, SER_DISK, CLIENT_VERSION};
+    if (afile.IsNull()) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Couldn't open file " + path.string() + " for reading.");
+    }
+
+    SnapshotMetadata metadata;
+    try {
+        afile >> metadata;
+    } catch (const std::ios_base::failure&) {
+        throw JSONRPCError(RPC_DESERIALIZATION_ERROR, "Unable to read snapshot metadata");
+    }
+
+    // No block may be connected, and so written to EvoDB, while the chainstate and the EvoDB contents are replaced
+    LOCK(cs_main);
+
+    // The evo and LLMQ managers stay bound to the chainstate the node started with until it restarts into the snapshot
+    // chainstate, the replaced EvoDB contents are only consistent with it if it has no block but the genesis block
+    if (chainman.ActiveHeight() > 0 || chainman.SnapshotBlockhash()) {
+        throw JSONRPCError(RPC_MISC_ERROR, "A snapshot can only be loaded by a node which hasn't connected any block after the genesis block");
+    }
+
+    const CBlockIndex* base = chainman.m_blockman.LookupBlockIndex(metadata.m_base_blockhash);
+    if (!base) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, strprintf("The header of the snapshot base block %s is not known", metadata.m_base_blockhash.ToString()));
+    }
+
+    // The EvoDB contents are not covered by the UTXO set hash and are only trusted if they match the committed hash
+    const AssumeutxoData* au_data = ExpectedAssumeutxo(base->nHeight, Params());
+    if (!au_data) {
+        throw JSONRPCError(RPC_VERIFY_ERROR, strprintf("No assumeutxo data for the snapshot base height %d", base->nHeight));
+    }
+    if (au_data->evodb_hash.IsNull()) {
+        throw JSONRPCError(RPC_VERIFY_ERROR, strprintf("No EvoDB hash in the assumeutxo data for the snapshot base height %d", base->nHeight));
+    }
+
+    // The EvoDB section is verified first and only written once the coins were loaded and verified as well
+    const long evodb_pos = ftell(afile.Get());
+    const std::optional<EvoDBSnapshotStats> evodb_stats = CEvoDB::VerifySnapshot(afile);
+    if (evodb_pos < 0 || !evodb_stats) {
+        throw JSONRPCError(RPC_DESERIALIZATION_ERROR, "Bad EvoDB section in snapshot, see debug.log");
+    }
+    if (au_data->evodb_hash != evodb_stats->hash) {
+        throw JSONRPCError(RPC_VERIFY_ERROR, strprintf("Bad EvoDB content hash: expected %s, got %s", au_data->evodb_hash.ToString(), evodb_stats->hash.ToString()));
+    }
+
+    if (!chainman.ActivateSnapshot(afile, metadata, /* in_memory */ false)) {
+        throw JSONRPCError(RPC_VERIFY_ERROR, "Unable to load UTXO set from snapshot, see debug.log");
+    }
+
+    if (fseek(afile.Get(), evodb_pos, SEEK_SET) != 0 || !node.evodb->LoadSnapshot(afile, *evodb_stats)) {
+        throw JSONRPCError(RPC_DATABASE_ERROR, "Failed to write EvoDB contents of the snapshot, restart with -reindex");
+    }
+    LogPrintf("[snapshot] loaded snapshot %s, shutting down to continue from it after a restart\n", base->GetBlockHash().ToString());
+    StartShutdown();
+
+    UniValue result(UniValue::VOBJ);
+    result.pushKV("coins_loaded", metadata.m_coins_count);
+    result.pushKV("evodb_entries", evodb_stats->entries);
+    result.pushKV("evodb_hash", evodb_stats->hash.ToString());
+    result.pushKV("evodb_stores", EvoDBStoreEntriesToUniv(*evodb_stats));
+    result.pushKV("base_hash", base->GetBlockHash().ToString());
+    result.pushKV("base_height", base->nHeight);
+    result.pushKV("path", path.string());
+    return result;
+}
+
+static UniValue getevodbinfo(const JSONRPCRequest& request)
+{
+    RPCHelpMan{
+        "getevodbinfo",
+        "Returns the caches, read statistics and size on disk of the stores EvoDB is split into.",
+        {},
+        RPCResult{
+            RPCResult::Type::OBJ_DYN, "", "",
+            {
+                {RPCResult::Type::OBJ, "store", "",
+                {
+                    {RPCResult::Type::ARR, "prefixes", "the key prefixes of the store, empty for the store of all other keys",
+                    {
+                        {RPCResult::Type::STR, "", "key prefix"},
+                    }},
+                    {RPCResult::Type::NUM, "cache_entries", "the number of values cached"},
+                    {RPCResult::Type::NUM, "cache_usage", "the memory used by the cached values in bytes"},
+                    {RPCResult::Type::NUM, "cache_limit", "the memory the cached values may use in bytes"},
+                    {RPCResult::Type::NUM, "hits", "the number of reads served by the cache since startup"},
+                    {RPCResult::Type::NUM, "misses", "the number of reads served by the database since startup"},
+                    {RPCResult::Type::NUM, "hit_rate", "the share of reads served by the cache"},
+                    {RPCResult::Type::OBJ, "read_latency", "the durations of reads in microseconds",
+                    {
+                        {RPCResult::Type::NUM, "count", "Number of observations"},
+                        {RPCResult::Type::NUM, "avg", "Average observation"},
+                        {RPCResult::Type::NUM, "max", "Largest observation"},
+                        {RPCResult::Type::NUM, "p50", "Estimated median, precise up to a power of two"},
+                        {RPCResult::Type::NUM, "p99", "Estimated 99th percentile, precise up to a power of two"},
+                    }},
+                    {RPCResult::Type::NUM, "size_on_disk", "the estimated size of the store on disk in bytes"},
+                }},
+            }
+        },
+        RPCExamples{
+            HelpExampleCli("getevodbinfo", "")
+          + HelpExampleRpc("getevodbinfo", "")
+        },
+    }.Check(request);
+
+    NodeContext& node = EnsureAnyNodeContext(request.context);
+    CHECK_NONFATAL(node.evodb);
+
+    UniValue result(UniValue::VOBJ);
+    for (size_t i = 0; i < EVODB_STORE_COUNT; ++i) {
+        const EvoDBStore store = static_cast<EvoDBStore>(i);
+        const CEvoDBStores::Stats stats = node.evodb->GetStoreStats(store);
+
+        UniValue prefixes(UniValue::VARR);
+        for (const auto& prefix : CEvoDBStores::GetStorePrefixes(store)) {
+            prefixes.push_back(prefix);
+        }
+        UniValue latency(UniValue::VOBJ);
+        latency.pushKV("count", stats.read_latency.count);
+        latency.pushKV("avg", stats.read_latency.count ? stats.read_latency.sum / stats.read_latency.count : 0);
+        latency.pushKV("max", stats.read_latency.max);
+        latency.pushKV("p50", stats.read_latency.Quantile(0.5));
+        latency.pushKV("p99", stats.read_latency.Quantile(0.99));
+
+        UniValue obj(UniValue::VOBJ);
+        obj.pushKV("prefixes", prefixes);
+        obj.pushKV("cache_entries", (uint64_t)stats.cache_entries);
+        obj.pushKV("cache_usage", (uint64_t)stats.cache_usage);
+        obj.pushKV("cache_limit", (uint64_t)stats.cache_limit);
+        obj.pushKV("hits", stats.hits);
+        obj.pushKV("misses", stats.misses);
+        obj.pushKV("hit_rate", stats.hits + stats.misses ? double(stats.hits) / (stats.hits + stats.misses) : 0.0);
+        obj.pushKV("read_latency", latency);
+        obj.pushKV("size_on_disk", (uint64_t)node.evodb->EstimateStoreSize(store));
+        result.pushKV(CEvoDBStores::GetStoreName(store), obj);
+    }
+    return result;
+}
+
+static UniValue compactevodb(const JSONRPCRequest& request)
+{
+    RPCHelpMan{
+        "compactevodb",
+        "Compact the part of EvoDB on disk holding a store. Compacting the store of all other keys compacts the whole database.",
+        {
+            {"store", RPCArg::Type::STR, RPCArg::Optional::NO, "The name of the store, as listed by getevodbinfo"},
+        },
+        RPCResult{
+            RPCResult::Type::OBJ, "", "",
+            {
+                {RPCResult::Type::NUM, "size_before", "the estimated size of the store on disk before compacting"},
+                {RPCResult::Type::NUM, "size_after", "the estimated size of the store on disk after compacting"},
+            }
+        },
+        RPCExamples{
+            HelpExampleCli("compactevodb", "\"dmn_list\"")
+        },
+    }.Check(request);
+
+    NodeContext& node = EnsureAnyNodeContext(request.context);
+    CHECK_NONFATAL(node.evodb);
+
+    const std::optional<EvoDBStore> store = CEvoDBStores::GetStoreByName(request.params[0].get_str());
+    if (!store) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, strprintf("Unknown EvoDB store %s", request.params[0].get_str()));
+    }
+
+    UniValue result(UniValue::VOBJ);
+    result.pushKV("size_before", (uint64_t)node.evodb->EstimateStoreSize(*store));
+    node.evodb->CompactStore(*store);
+    result.pushKV("size_after", (uint64_t)node.evodb->EstimateStoreSize(*store));
+    return result;
+}
+
 void RegisterBlockchainRPCCommands(CRPCTable &t)
 {
 // clang-format off
@@ -2982,6 +3295,7 @@ static const CRPCCommand commands[] =
     { "blockchain",         "getmerkleblocks",        &getmerkleblocks,        {"filter","blockhash","count"} },
     { "blockchain",         "getchaintips",           &getchaintips,           {"count","branchlen"} },
     { "blockchain",         "getdifficulty",          &getdifficulty,          {} },
+    { "blockchain",         "getevodbinfo",           &getevodbinfo,           {} },
     { "blockchain",         "getmempoolancestors",    &getmempoolancestors,    {"txid","verbose"} },
     { "blockchain",         "getmempooldescendants",  &getmempooldescendants,  {"txid","verbose"} },
     { "blockchain",         "getmempoolentry",        &getmempoolentry,        {"txid"} },
@@ -3006,6 +3320,8 @@ static const CRPCCommand commands[] =
     { "hidden",             "waitforblockheight",     &waitforblockheight,     {"height","timeout"} },
     { "hidden",             "syncwithvalidationinterfacequeue", &syncwithvalidationinterfacequeue, {} },
     { "hidden",             "dumptxoutset",           &dumptxoutset,           {"path"} },
+    { "hidden",             "loadtxoutset",           &loadtxoutset,           {"path"} },
+    { "hidden",             "compactevodb",           &compactevodb,           {"store"} },
 };
 // clang-format on
 
@@ -168,6 +168,8 @@ static const CRPCConvertParam vRPCConvertParams[] =
     { "setcoinjoinrounds", 0, "rounds" },
     { "setcoinjoinamount", 0, "amount" },
     { "setwalletflag", 1, "value" },
+    { "getlockcontention", 0, "count" },
+    { "getlockcontention", 1, "reset" },
     { "getmempoolancestors", 1, "verbose" },
     { "getmempooldescendants", 1, "verbose" },
     { "logging", 0, "include" },
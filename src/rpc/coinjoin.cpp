@@ -138,6 +138,20 @@ static UniValue getcoinjoininfo(const JSONRPCRequest& request)
                             {RPCResult::Type::NUM, "denomination", "The denomination of the mixing session in " + CURRENCY_UNIT + ""},
                             {RPCResult::Type::STR_HEX, "state", "Current state of the mixing session"},
                             {RPCResult::Type::NUM, "entries_count", "The number of entries in the mixing session"},
+                            {RPCResult::Type::NUM, "sessions_completed", "How many mixing sessions completed successfully since startup"},
+                            {RPCResult::Type::NUM, "sessions_failed", "How many mixing sessions failed since startup"},
+                            {RPCResult::Type::ARR, "sessions", "Mixing sessions currently hosted by this masternode",
+                            {
+                                {RPCResult::Type::OBJ, "", "",
+                                {
+                                    {RPCResult::Type::NUM, "session_id", "The id of the mixing session"},
+                                    {RPCResult::Type::NUM, "denomination", "The denomination of the mixing session in " + CURRENCY_UNIT + ""},
+                                    {RPCResult::Type::STR_HEX, "state", "Current state of the mixing session"},
+                                    {RPCResult::Type::NUM, "participants", "The number of participants accepted to the mixing session"},
+                                    {RPCResult::Type::NUM, "entries_count", "The number of entries in the mixing session"},
+                                    {RPCResult::Type::NUM, "age", "Seconds since the mixing session was created"},
+                                }},
+                            }},
                         }},
                 },
                 RPCExamples{
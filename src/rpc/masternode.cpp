@@ -353,10 +353,10 @@ static UniValue masternode_winners(const JSONRPCRequest& request, const Chainsta
     int nChainTipHeight = pindexTip->nHeight;
     int nStartHeight = std::max(nChainTipHeight - nCount, 1);
 
-    for (int h = nStartHeight; h <= nChainTipHeight; h++) {
-        const CBlockIndex* pIndex = pindexTip->GetAncestor(h - 1);
-        auto payee = deterministicMNManager->GetListForBlock(pIndex).GetMNPayee(pIndex);
-        std::string strPayments = GetRequiredPaymentsString(h, payee);
+    const auto payees = deterministicMNManager->GetMNPayees(pindexTip, nStartHeight);
+    for (size_t i = 0; i < payees.size(); i++) {
+        int h = nStartHeight + i;
+        std::string strPayments = GetRequiredPaymentsString(h, payees[i]);
         if (strFilter != "" && strPayments.find(strFilter) == std::string::npos) continue;
         obj.pushKV(strprintf("%d", h), strPayments);
     }
@@ -481,7 +481,7 @@ static UniValue masternode_payments(const JSONRPCRequest& request, const Chainst
         }
 
         // NOTE: we use _previous_ block to find a payee for the current one
-        const auto dmnPayee = deterministicMNManager->GetListForBlock(pindex->pprev).GetMNPayee(pindex->pprev);
+        const auto dmnPayee = deterministicMNManager->GetMNPayee(pindex->pprev);
         protxObj.pushKV("proTxHash", dmnPayee == nullptr ? "" : dmnPayee->proTxHash.ToString());
         protxObj.pushKV("amount", payedPerMasternode);
         protxObj.pushKV("payees", payeesArr);
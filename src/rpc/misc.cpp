@@ -26,6 +26,7 @@
 #include <txmempool.h>
 #include <util/check.h>
 #include <util/message.h> // For MessageSign(), MessageVerify()
+#include <util/metrics.h>
 #include <util/strencodings.h>
 #include <util/system.h>
 #include <validation.h>
@@ -1364,13 +1365,152 @@ static RPCHelpMan getindexinfo()
     };
 }
 
+static RPCHelpMan getlockcontention()
+{
+    return RPCHelpMan{"getlockcontention",
+                "\nReturns the lock sites threads waited for the longest, as sampled by the lock contention profiler.\n"
+                "The profiler is enabled with -lockprofile=<n>, which times one in <n> lock acquisitions of each thread.\n"
+                "Samples are flushed from the threads that took them in batches, the latest ones may not be included yet.\n",
+                {
+                    {"count", RPCArg::Type::NUM, /* default */ "10", "The number of lock sites to return"},
+                    {"reset", RPCArg::Type::BOOL, /* default */ "false", "Clear the collected samples after returning them"},
+                },
+                RPCResult{
+                    RPCResult::Type::ARR, "", "",
+                    {
+                        {RPCResult::Type::OBJ, "", "",
+                        {
+                            {RPCResult::Type::STR, "lock", "The name of the lock"},
+                            {RPCResult::Type::STR, "site", "The file and line the lock was taken at"},
+                            {RPCResult::Type::NUM, "samples", "The number of sampled acquisitions"},
+                            {RPCResult::Type::NUM, "contended", "The number of sampled acquisitions which had to wait for the lock"},
+                            {RPCResult::Type::NUM, "wait_total", "Total time waited for the lock in microseconds"},
+                            {RPCResult::Type::NUM, "wait_max", "Longest wait for the lock in microseconds"},
+                            {RPCResult::Type::NUM, "hold_total", "Total time the lock was held in microseconds"},
+                            {RPCResult::Type::NUM, "hold_max", "Longest time the lock was held in microseconds"},
+                        }},
+                    }
+                },
+                RPCExamples{
+                    HelpExampleCli("getlockcontention", "")
+                  + HelpExampleCli("getlockcontention", "20 true")
+                  + HelpExampleRpc("getlockcontention", "20, true")
+                },
+                [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    const int count = request.params[0].isNull() ? 10 : request.params[0].get_int();
+    if (count < 1) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "count must be positive");
+    }
+    const bool reset = !request.params[1].isNull() && request.params[1].get_bool();
+
+    const auto profile = GetLockProfile();
+    if (reset) ResetLockProfile();
+
+    UniValue result(UniValue::VARR);
+    for (size_t i = 0; i < profile.size() && i < size_t(count); ++i) {
+        const auto& site = profile[i];
+        UniValue obj(UniValue::VOBJ);
+        obj.pushKV("lock", site.name);
+        obj.pushKV("site", strprintf("%s:%d", site.file, site.line));
+        obj.pushKV("samples", site.samples);
+        obj.pushKV("contended", site.contended);
+        obj.pushKV("wait_total", site.wait_total_ns / 1000);
+        obj.pushKV("wait_max", site.wait_max_ns / 1000);
+        obj.pushKV("hold_total", site.hold_total_ns / 1000);
+        obj.pushKV("hold_max", site.hold_max_ns / 1000);
+        result.push_back(obj);
+    }
+    return result;
+},
+    };
+}
+
+static RPCHelpMan getmetrics()
+{
+    return RPCHelpMan{"getmetrics",
+                "\nReturns the counters, gauges and latency histograms collected by this node's subsystems.\n",
+                {
+                    {"prefix", RPCArg::Type::STR, RPCArg::Optional::OMITTED_NAMED_ARG, "Only return metrics whose name starts with this prefix, e.g. \"llmq.\""},
+                },
+                RPCResult{
+                    RPCResult::Type::OBJ, "", "",
+                    {
+                        {RPCResult::Type::OBJ_DYN, "counters", "",
+                        {
+                            {RPCResult::Type::NUM, "name", "Number of events counted since startup"},
+                        }},
+                        {RPCResult::Type::OBJ_DYN, "gauges", "",
+                        {
+                            {RPCResult::Type::NUM, "name", "Last value set"},
+                        }},
+                        {RPCResult::Type::OBJ_DYN, "histograms", "",
+                        {
+                            {RPCResult::Type::OBJ, "name", "Durations in microseconds observed since startup",
+                            {
+                                {RPCResult::Type::NUM, "count", "Number of observations"},
+                                {RPCResult::Type::NUM, "sum", "Total of all observations"},
+                                {RPCResult::Type::NUM, "avg", "Average observation"},
+                                {RPCResult::Type::NUM, "max", "Largest observation"},
+                                {RPCResult::Type::NUM, "p50", "Estimated median, precise up to a power of two"},
+                                {RPCResult::Type::NUM, "p90", "Estimated 90th percentile, precise up to a power of two"},
+                                {RPCResult::Type::NUM, "p99", "Estimated 99th percentile, precise up to a power of two"},
+                            }},
+                        }},
+                    }
+                },
+                RPCExamples{
+                    HelpExampleCli("getmetrics", "")
+                  + HelpExampleCli("getmetrics", "\"validation.\"")
+                  + HelpExampleRpc("getmetrics", "\"llmq.\"")
+                },
+                [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    const std::string prefix = request.params[0].isNull() ? "" : request.params[0].get_str();
+    const auto snapshot = metrics::GetSnapshot();
+
+    UniValue counters(UniValue::VOBJ);
+    for (const auto& [name, value] : snapshot.counters) {
+        if (name.rfind(prefix, 0) != 0) continue;
+        counters.pushKV(name, value);
+    }
+    UniValue gauges(UniValue::VOBJ);
+    for (const auto& [name, value] : snapshot.gauges) {
+        if (name.rfind(prefix, 0) != 0) continue;
+        gauges.pushKV(name, value);
+    }
+    UniValue histograms(UniValue::VOBJ);
+    for (const auto& [name, hist] : snapshot.histograms) {
+        if (name.rfind(prefix, 0) != 0) continue;
+        UniValue obj(UniValue::VOBJ);
+        obj.pushKV("count", hist.count);
+        obj.pushKV("sum", hist.sum);
+        obj.pushKV("avg", hist.count ? hist.sum / hist.count : 0);
+        obj.pushKV("max", hist.max);
+        obj.pushKV("p50", hist.Quantile(0.5));
+        obj.pushKV("p90", hist.Quantile(0.9));
+        obj.pushKV("p99", hist.Quantile(0.99));
+        histograms.pushKV(name, obj);
+    }
+
+    UniValue result(UniValue::VOBJ);
+    result.pushKV("counters", counters);
+    result.pushKV("gauges", gauges);
+    result.pushKV("histograms", histograms);
+    return result;
+},
+    };
+}
+
 void RegisterMiscRPCCommands(CRPCTable &t)
 {
 static const CRPCCommand commands[] =
 { //  category              name                      actor (function)         argNames
   //  --------------------- ------------------------  -----------------------  ----------
     { "control",            "debug",                  &debug,                  {} },
+    { "control",            "getlockcontention",      &getlockcontention,      {"count", "reset"} },
     { "control",            "getmemoryinfo",          &getmemoryinfo,          {"mode"} },
+    { "control",            "getmetrics",             &getmetrics,             {"prefix"} },
     { "control",            "logging",                &logging,                {"include", "exclude"}},
     { "util",               "validateaddress",        &validateaddress,        {"address"} },
     { "util",               "createmultisig",         &createmultisig,         {"nrequired","keys"} },
@@ -524,20 +524,7 @@ static UniValue getassetunlockstatuses(const JSONRPCRequest& request)
             if (poolOnTip.has_value() && poolOnTip->indexes.Contains(index)) {
                 return "mined";
             }
-            bool is_mempooled = [&]() {
-                LOCK(mempool.cs);
-                return std::any_of(mempool.mapTx.begin(), mempool.mapTx.end(), [index](const CTxMemPoolEntry &e) {
-                    if (e.GetTx().nType == CAssetUnlockPayload::SPECIALTX_TYPE) {
-                        if (auto opt_assetUnlockTx = GetTxPayload<CAssetUnlockPayload>(e.GetTx())) {
-                            return index == opt_assetUnlockTx->getIndex();
-                        } else {
-                            throw JSONRPCError(RPC_TRANSACTION_ERROR, "bad-assetunlocktx-payload");
-                        }
-                    }
-                    return false;
-                });
-            }();
-            return is_mempooled ? "mempooled" : "unknown";
+            return mempool.existsAssetUnlockIndex(index) ? "mempooled" : "unknown";
         };
         obj.pushKV("status", status_to_push());
         result_arr.push_back(obj);
@@ -48,6 +48,73 @@ std::string JSONRPCReply(const UniValue& result, const UniValue& error, const Un
     return reply.write() + "\n";
 }
 
+namespace {
+class JSONStreamWriter
+{
+private:
+    const size_t m_chunk_size;
+    const std::function<bool(const std::string&)>& m_write;
+    std::string m_buffer;
+
+public:
+    JSONStreamWriter(size_t chunk_size, const std::function<bool(const std::string&)>& write) : m_chunk_size(chunk_size), m_write(write)
+    {
+        m_buffer.reserve(chunk_size);
+    }
+
+    bool Append(const std::string& str)
+    {
+        m_buffer += str;
+        if (m_buffer.size() < m_chunk_size) return true;
+        return Flush();
+    }
+
+    bool Flush()
+    {
+        if (m_buffer.empty()) return true;
+        bool ret = m_write(m_buffer);
+        m_buffer.clear();
+        return ret;
+    }
+
+    bool Write(const UniValue& value)
+    {
+        switch (value.getType()) {
+        case UniValue::VOBJ: {
+            if (!Append("{")) return false;
+            const auto& keys = value.getKeys();
+            const auto& values = value.getValues();
+            for (size_t i = 0; i < keys.size(); ++i) {
+                if (!Append((i > 0 ? "," : "") + UniValue(keys[i]).write() + ":")) return false;
+                if (!Write(values[i])) return false;
+            }
+            return Append("}");
+        }
+        case UniValue::VARR: {
+            if (!Append("[")) return false;
+            const auto& values = value.getValues();
+            for (size_t i = 0; i < values.size(); ++i) {
+                if (i > 0 && !Append(",")) return false;
+                if (!Write(values[i])) return false;
+            }
+            return Append("]");
+        }
+        default:
+            return Append(value.write());
+        }
+    }
+};
+} // anonymous namespace
+
+bool JSONRPCReplyStream(const UniValue& result, const UniValue& error, const UniValue& id, size_t chunk_size, const std::function<bool(const std::string&)>& write)
+{
+    JSONStreamWriter writer(chunk_size, write);
+    return writer.Append("{\"result\":") &&
+           writer.Write(error.isNull() ? result : NullUniValue) &&
+           writer.Append(",\"error\":" + error.write() + ",\"id\":" + id.write() + "}\n") &&
+           writer.Flush();
+}
+
 UniValue JSONRPCError(int code, const std::string& message)
 {
     UniValue error(UniValue::VOBJ);
@@ -8,6 +8,7 @@
 
 #include <context.h>
 
+#include <functional>
 #include <string>
 
 #include <univalue.h>
@@ -15,6 +16,10 @@
 UniValue JSONRPCRequestObj(const std::string& strMethod, const UniValue& params, const UniValue& id);
 UniValue JSONRPCReplyObj(const UniValue& result, const UniValue& error, const UniValue& id);
 std::string JSONRPCReply(const UniValue& result, const UniValue& error, const UniValue& id);
+/** Write the same reply as JSONRPCReply piece by piece, without copying result into a reply object or serializing it into
+ * one string. The output is handed to write in chunks of about chunk_size bytes. Stops and returns false as soon as write
+ * returns false. */
+bool JSONRPCReplyStream(const UniValue& result, const UniValue& error, const UniValue& id, size_t chunk_size, const std::function<bool(const std::string&)>& write);
 UniValue JSONRPCError(int code, const std::string& message);
 
 /** Generate a new RPC authentication cookie and write it to disk */
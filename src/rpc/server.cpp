@@ -7,6 +7,7 @@
 #include <rpc/server.h>
 
 #include <chainparams.h>
+#include <httpserver.h>
 #include <rpc/util.h>
 #include <shutdown.h>
 #include <sync.h>
@@ -242,6 +243,20 @@ static RPCHelpMan getrpcinfo()
                             }},
                         }},
                         {RPCResult::Type::STR, "logpath", "The complete file path to the debug log"},
+                        {RPCResult::Type::ARR, "work_queues", "The work queues of the HTTP server",
+                        {
+                            {RPCResult::Type::OBJ, "", "",
+                            {
+                                 {RPCResult::Type::STR, "class", "The class of RPC methods served by this queue"},
+                                 {RPCResult::Type::NUM, "threads", "The number of worker threads"},
+                                 {RPCResult::Type::NUM, "depth", "The number of queued requests"},
+                                 {RPCResult::Type::NUM, "max_depth", "The maximum number of queued requests"},
+                                 {RPCResult::Type::NUM, "requests", "The number of requests queued since startup"},
+                                 {RPCResult::Type::NUM, "rejected", "The number of requests rejected because the queue was full"},
+                                 {RPCResult::Type::NUM, "avg_queue_time", "The average time requests waited for a worker in microseconds"},
+                                 {RPCResult::Type::NUM, "max_queue_time", "The longest time a request waited for a worker in microseconds"},
+                            }},
+                        }},
                     }
                 },
                 RPCExamples{
@@ -266,6 +281,21 @@ static RPCHelpMan getrpcinfo()
     UniValue log_path(UniValue::VSTR, path);
     result.pushKV("logpath", log_path);
 
+    UniValue work_queues(UniValue::VARR);
+    for (const auto& stats : GetHTTPWorkClassStats()) {
+        UniValue entry(UniValue::VOBJ);
+        entry.pushKV("class", stats.name);
+        entry.pushKV("threads", stats.threads);
+        entry.pushKV("depth", (uint64_t)stats.depth);
+        entry.pushKV("max_depth", (uint64_t)stats.max_depth);
+        entry.pushKV("requests", stats.requests);
+        entry.pushKV("rejected", stats.rejected);
+        entry.pushKV("avg_queue_time", stats.dequeued > 0 ? stats.queue_time_total / (int64_t)stats.dequeued : 0);
+        entry.pushKV("max_queue_time", stats.queue_time_max);
+        work_queues.push_back(entry);
+    }
+    result.pushKV("work_queues", work_queues);
+
     return result;
 }
     };
@@ -27,19 +27,20 @@ std::unique_ptr<CSporkManager> sporkManager;
 
 const std::string SporkStore::SERIALIZATION_VERSION_STRING = "CSporkManager-Version-2";
 
+static std::optional<size_t> GetSporkDefIndex(SporkId nSporkID)
+{
+    for (size_t i = 0; i < sporkDefs.size(); ++i) {
+        if (sporkDefs[i].sporkId == nSporkID) return i;
+    }
+    return std::nullopt;
+}
+
 std::optional<SporkValue> CSporkManager::SporkValueIfActive(SporkId nSporkID) const
 {
     AssertLockHeld(cs);
 
     if (!mapSporksActive.count(nSporkID)) return std::nullopt;
 
-    {
-        LOCK(cs_mapSporksCachedValues);
-        if (auto it = mapSporksCachedValues.find(nSporkID); it != mapSporksCachedValues.end()) {
-            return {it->second};
-        }
-    }
-
     // calc how many values we have and how many signers vote for every value
     std::unordered_map<SporkValue, int> mapValueCounts;
     for (const auto& [_, spork] : mapSporksActive.at(nSporkID)) {
@@ -47,10 +48,6 @@ std::optional<SporkValue> CSporkManager::SporkValueIfActive(SporkId nSporkID) co
         if (mapValueCounts.at(spork.nValue) >= nMinSporkKeys) {
             // nMinSporkKeys is always more than the half of the max spork keys number,
             // so there is only one such value and we can stop here
-            {
-                LOCK(cs_mapSporksCachedValues);
-                mapSporksCachedValues[nSporkID] = spork.nValue;
-            }
             return {spork.nValue};
         }
     }
@@ -58,6 +55,19 @@ std::optional<SporkValue> CSporkManager::SporkValueIfActive(SporkId nSporkID) co
     return std::nullopt;
 }
 
+void CSporkManager::UpdateSporkValues()
+{
+    AssertLockHeld(cs);
+
+    for (size_t i = 0; i < sporkDefs.size(); ++i) {
+        const auto opt_sporkValue = SporkValueIfActive(sporkDefs[i].sporkId);
+        const SporkValue nValue = opt_sporkValue.value_or(sporkDefs[i].defaultValue);
+        if (sporkValues[i].exchange(nValue) != nValue) {
+            sporksCachedActive[i] = false;
+        }
+    }
+}
+
 void SporkStore::Clear()
 {
     LOCK(cs);
@@ -70,6 +80,10 @@ void SporkStore::Clear()
 CSporkManager::CSporkManager() :
     m_db{std::make_unique<db_type>("sporks.dat", "magicSporkCache")}
 {
+    for (size_t i = 0; i < sporkDefs.size(); ++i) {
+        sporkValues[i] = sporkDefs[i].defaultValue;
+        sporksCachedActive[i] = false;
+    }
 }
 
 CSporkManager::~CSporkManager()
@@ -85,6 +99,7 @@ bool CSporkManager::LoadCache()
     if (is_valid) {
         CheckAndRemove();
     }
+    WITH_LOCK(cs, UpdateSporkValues());
     return is_valid;
 }
 
@@ -127,6 +142,8 @@ void CSporkManager::CheckAndRemove()
         }
         ++itByHash;
     }
+
+    UpdateSporkValues();
 }
 
 PeerMsgRet CSporkManager::ProcessMessage(CNode& peer, CConnman& connman, std::string_view msg_type, CDataStream& vRecv)
@@ -191,9 +208,7 @@ PeerMsgRet CSporkManager::ProcessSpork(const CNode& peer, CConnman& connman, CDa
         LOCK(cs); // make sure to not lock this together with cs_main
         mapSporksByHash[hash] = spork;
         mapSporksActive[spork.nSporkID][keyIDSigner] = spork;
-        // Clear cached values on new spork being processed
-        WITH_LOCK(cs_mapSporksCachedActive, mapSporksCachedActive.erase(spork.nSporkID));
-        WITH_LOCK(cs_mapSporksCachedValues, mapSporksCachedValues.erase(spork.nSporkID));
+        UpdateSporkValues();
     }
     spork.Relay(connman);
     return {};
@@ -232,9 +247,7 @@ bool CSporkManager::UpdateSpork(SporkId nSporkID, SporkValue nValue, CConnman& c
 
         mapSporksByHash[spork.GetHash()] = spork;
         mapSporksActive[nSporkID][*opt_keyIDSigner] = spork;
-        // Clear cached values on new spork being processed
-        WITH_LOCK(cs_mapSporksCachedActive, mapSporksCachedActive.erase(spork.nSporkID));
-        WITH_LOCK(cs_mapSporksCachedValues, mapSporksCachedValues.erase(spork.nSporkID));
+        UpdateSporkValues();
     }
 
     spork.Relay(connman);
@@ -243,41 +256,34 @@ bool CSporkManager::UpdateSpork(SporkId nSporkID, SporkValue nValue, CConnman& c
 
 bool CSporkManager::IsSporkActive(SporkId nSporkID) const
 {
+    const auto opt_index = GetSporkDefIndex(nSporkID);
     // If nSporkID is cached, and the cached value is true, then return early true
-    {
-        LOCK(cs_mapSporksCachedActive);
-        if (auto it = mapSporksCachedActive.find(nSporkID); it != mapSporksCachedActive.end() && it->second) {
-            return true;
-        }
+    if (opt_index && sporksCachedActive[*opt_index]) {
+        return true;
     }
 
     SporkValue nSporkValue = GetSporkValue(nSporkID);
     // Get time is somewhat costly it looks like
     bool ret = nSporkValue < GetAdjustedTime();
     // Only cache true values
-    if (ret) {
-        LOCK(cs_mapSporksCachedActive);
-        mapSporksCachedActive[nSporkID] = ret;
+    if (ret && opt_index) {
+        sporksCachedActive[*opt_index] = true;
+        // the value could have been changed in the meantime, don't keep a stale entry then
+        if (sporkValues[*opt_index] != nSporkValue) {
+            sporksCachedActive[*opt_index] = false;
+        }
     }
     return ret;
 }
 
 SporkValue CSporkManager::GetSporkValue(SporkId nSporkID) const
 {
-    LOCK(cs);
-
-    if (auto opt_sporkValue = SporkValueIfActive(nSporkID)) {
-        return *opt_sporkValue;
+    if (const auto opt_index = GetSporkDefIndex(nSporkID)) {
+        return sporkValues[*opt_index];
     }
 
-
-    if (auto optSpork = ranges::find_if_opt(sporkDefs,
-                                            [&nSporkID](const auto& sporkDef){return sporkDef.sporkId == nSporkID;})) {
-        return optSpork->defaultValue;
-    } else {
-        LogPrint(BCLog::SPORK, "CSporkManager::GetSporkValue -- Unknown Spork ID %d\n", nSporkID);
-        return -1;
-    }
+    LogPrint(BCLog::SPORK, "CSporkManager::GetSporkValue -- Unknown Spork ID %d\n", nSporkID);
+    return -1;
 }
 
 SporkId CSporkManager::GetSporkIDByName(std::string_view strName)
@@ -322,6 +328,7 @@ bool CSporkManager::SetMinSporkKeys(int minSporkKeys)
         return false;
     }
     nMinSporkKeys = minSporkKeys;
+    UpdateSporkValues();
     return true;
 }
 
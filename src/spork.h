@@ -15,6 +15,7 @@
 #include <uint256.h>
 
 #include <array>
+#include <atomic>
 #include <optional>
 #include <string_view>
 #include <unordered_map>
@@ -221,11 +222,14 @@ private:
     const std::unique_ptr<db_type> m_db;
     bool is_valid{false};
 
-    mutable Mutex cs_mapSporksCachedActive;
-    mutable std::unordered_map<const SporkId, bool> mapSporksCachedActive GUARDED_BY(cs_mapSporksCachedActive);
-
-    mutable Mutex cs_mapSporksCachedValues;
-    mutable std::unordered_map<SporkId, SporkValue> mapSporksCachedValues GUARDED_BY(cs_mapSporksCachedValues);
+    /**
+     * Effective values of all sporks, indexed in the order of sporkDefs. They are
+     * republished by UpdateSporkValues() whenever the set of spork messages changes,
+     * so that hot paths calling GetSporkValue/IsSporkActive don't need to lock.
+     */
+    std::array<std::atomic<SporkValue>, sporkDefs.size()> sporkValues;
+    // Only true values are cached, they are reset on every change of the spork value
+    mutable std::array<std::atomic<bool>, sporkDefs.size()> sporksCachedActive;
 
     std::set<CKeyID> setSporkPubKeyIDs GUARDED_BY(cs);
     int nMinSporkKeys GUARDED_BY(cs) {std::numeric_limits<int>::max()};
@@ -237,6 +241,12 @@ private:
      */
     std::optional<SporkValue> SporkValueIfActive(SporkId nSporkID) const EXCLUSIVE_LOCKS_REQUIRED(cs);
 
+    /**
+     * UpdateSporkValues recalculates the effective value of every known spork
+     * and publishes them for lock-free reads.
+     */
+    void UpdateSporkValues() EXCLUSIVE_LOCKS_REQUIRED(cs);
+
 public:
     CSporkManager();
     ~CSporkManager();
@@ -295,7 +305,7 @@ public:
      * GetSporkValue returns the spork value given a Spork ID. If no active spork
      * message has yet been received by the node, it returns the default value.
      */
-    SporkValue GetSporkValue(SporkId nSporkID) const LOCKS_EXCLUDED(cs);
+    SporkValue GetSporkValue(SporkId nSporkID) const;
 
     /**
      * GetSporkIDByName returns the internal Spork ID given the spork name.
@@ -13,6 +13,7 @@
 #include <util/strencodings.h>
 #include <util/threadnames.h>
 
+#include <algorithm>
 #include <map>
 #include <mutex>
 #include <set>
@@ -33,6 +34,97 @@ void PrintLockContention(const char* pszName, const char* pszFile, int nLine)
 }
 #endif /* DEBUG_LOCKCONTENTION */
 
+std::atomic<uint32_t> g_lock_profile_rate{DEFAULT_LOCK_PROFILE_RATE};
+std::atomic<int> g_lock_profile_waiters{0};
+
+namespace {
+/** Samples are flushed into the global profile once a thread collected this many */
+constexpr size_t LOCK_PROFILE_BUFFER_SIZE{256};
+
+struct LockProfileData {
+    // plain std::mutex, the profiler must not profile itself
+    std::mutex mutex;
+    std::map<std::pair<std::string, int>, LockSiteStats> sites;
+};
+
+LockProfileData& GetLockProfileData()
+{
+    // never destroyed, threads may still flush their buffers during static destruction
+    static LockProfileData* data = new LockProfileData();
+    return *data;
+}
+
+struct LockProfileBuffer {
+    std::vector<std::pair<LockProfileSample, int64_t>> samples;
+
+    void Flush()
+    {
+        auto& data = GetLockProfileData();
+        std::lock_guard<std::mutex> lock(data.mutex);
+        for (const auto& [sample, hold_ns] : samples) {
+            auto& site = data.sites[{sample.file, sample.line}];
+            if (site.samples == 0) {
+                site.name = sample.name;
+                site.file = sample.file;
+                site.line = sample.line;
+            }
+            ++site.samples;
+            if (sample.wait_ns > 0) ++site.contended;
+            site.wait_total_ns += sample.wait_ns;
+            site.wait_max_ns = std::max(site.wait_max_ns, sample.wait_ns);
+            site.hold_total_ns += hold_ns;
+            site.hold_max_ns = std::max(site.hold_max_ns, hold_ns);
+        }
+        samples.clear();
+    }
+
+    ~LockProfileBuffer();
+};
+
+// locks may still be released by destructors of other thread locals after the buffer is gone
+thread_local bool g_lock_profile_buffer_destroyed{false};
+
+LockProfileBuffer::~LockProfileBuffer()
+{
+    Flush();
+    g_lock_profile_buffer_destroyed = true;
+}
+} // namespace
+
+void RecordLockProfileSample(const LockProfileSample& sample)
+{
+    if (g_lock_profile_buffer_destroyed) return;
+    static thread_local LockProfileBuffer buffer;
+    buffer.samples.emplace_back(sample, LockProfileNow() - sample.acquired_ns);
+    if (buffer.samples.size() >= LOCK_PROFILE_BUFFER_SIZE) {
+        buffer.Flush();
+    }
+}
+
+std::vector<LockSiteStats> GetLockProfile()
+{
+    auto& data = GetLockProfileData();
+    std::vector<LockSiteStats> ret;
+    {
+        std::lock_guard<std::mutex> lock(data.mutex);
+        ret.reserve(data.sites.size());
+        for (const auto& [_, site] : data.sites) {
+            ret.push_back(site);
+        }
+    }
+    std::sort(ret.begin(), ret.end(), [](const LockSiteStats& a, const LockSiteStats& b) {
+        return a.wait_total_ns > b.wait_total_ns;
+    });
+    return ret;
+}
+
+void ResetLockProfile()
+{
+    auto& data = GetLockProfileData();
+    std::lock_guard<std::mutex> lock(data.mutex);
+    data.sites.clear();
+}
+
 #ifdef DEBUG_LOCKORDER
 //
 // Early deadlock detection.
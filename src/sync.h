@@ -9,10 +9,14 @@
 #include <threadsafety.h>
 #include <util/macros.h>
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <condition_variable>
 #include <mutex>
 #include <string>
 #include <thread>
+#include <vector>
 
 /////////////////////////////////////////////////
 //                                             //
@@ -128,14 +132,83 @@ typedef AnnotatedMixin<std::mutex> Mutex;
 void PrintLockContention(const char* pszName, const char* pszFile, int nLine);
 #endif
 
+/**
+ * Lock contention profiler. When enabled, one in every g_lock_profile_rate acquisitions of
+ * each thread is timed: how long the thread waited for the lock and how long it held it.
+ * Samples are collected in per-thread buffers and aggregated per LOCK site (file:line).
+ * Hold times of locks used with condition variables include the time spent waiting on them.
+ */
+extern std::atomic<uint32_t> g_lock_profile_rate;
+//! Number of threads blocked in a sampled acquisition right now
+extern std::atomic<int> g_lock_profile_waiters;
+static constexpr uint32_t DEFAULT_LOCK_PROFILE_RATE{0};
+
+struct LockProfileSample {
+    const char* name{nullptr};
+    const char* file{nullptr};
+    int line{0};
+    int64_t wait_ns{0};
+    int64_t acquired_ns{0};
+};
+
+struct LockSiteStats {
+    std::string name;
+    std::string file;
+    int line{0};
+    uint64_t samples{0};
+    uint64_t contended{0};
+    int64_t wait_total_ns{0};
+    int64_t wait_max_ns{0};
+    int64_t hold_total_ns{0};
+    int64_t hold_max_ns{0};
+};
+
+inline int64_t LockProfileNow()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+inline bool LockProfileShouldSample()
+{
+    const uint32_t rate = g_lock_profile_rate.load(std::memory_order_relaxed);
+    if (rate == 0) return false;
+    static thread_local uint32_t acquisitions{0};
+    return ++acquisitions % rate == 0;
+}
+
+/** Account a sample of a lock which is being released now */
+void RecordLockProfileSample(const LockProfileSample& sample);
+/** Lock sites sorted by total time threads waited for them, samples still buffered by other threads are not included */
+std::vector<LockSiteStats> GetLockProfile();
+void ResetLockProfile();
+
 /** Wrapper around std::unique_lock style lock for Mutex. */
 template <typename Mutex, typename Base = typename Mutex::UniqueLock>
 class SCOPED_LOCKABLE UniqueLock : public Base
 {
 private:
+    LockProfileSample m_profile_sample;
+
     void Enter(const char* pszName, const char* pszFile, int nLine)
     {
         EnterCritical(pszName, pszFile, nLine, Base::mutex());
+        if (LockProfileShouldSample()) {
+            m_profile_sample = {pszName, pszFile, nLine};
+            const int64_t start = LockProfileNow();
+            if (!Base::try_lock()) {
+#ifdef DEBUG_LOCKCONTENTION
+                PrintLockContention(pszName, pszFile, nLine);
+#endif
+                ++g_lock_profile_waiters;
+                Base::lock();
+                --g_lock_profile_waiters;
+                m_profile_sample.acquired_ns = LockProfileNow();
+                m_profile_sample.wait_ns = m_profile_sample.acquired_ns - start;
+            } else {
+                m_profile_sample.acquired_ns = start;
+            }
+            return;
+        }
 #ifdef DEBUG_LOCKCONTENTION
         if (!Base::try_lock()) {
             PrintLockContention(pszName, pszFile, nLine);
@@ -178,8 +251,10 @@ public:
 
     ~UniqueLock() UNLOCK_FUNCTION()
     {
-        if (Base::owns_lock())
+        if (Base::owns_lock()) {
+            if (m_profile_sample.name) RecordLockProfileSample(m_profile_sample);
             LeaveCritical();
+        }
     }
 
     operator bool()
@@ -199,6 +274,8 @@ public:
     public:
         explicit reverse_lock(UniqueLock& _lock, const char* _guardname, const char* _file, int _line) : lock(_lock), file(_file), line(_line) {
             CheckLastCritical((void*)lock.mutex(), lockname, _guardname, _file, _line);
+            // the hold time is no longer meaningful once the lock was released in between
+            lock.m_profile_sample = {};
             lock.unlock();
             LeaveCritical();
             lock.swap(templock);
@@ -0,0 +1,146 @@
+// Copyright (c) 2023 The Dash Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <arith_uint256.h>
+#include <chain.h>
+#include <chainparams.h>
+#include <flatfile.h>
+#include <node/blockstorage.h>
+#include <primitives/block.h>
+#include <streams.h>
+#include <txdb.h>
+#include <util/strencodings.h>
+#include <validation.h>
+#include <version.h>
+
+#include <test/util/setup_common.h>
+
+#include <map>
+#include <memory>
+#include <thread>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(blockmanager_tests, TestChain100Setup)
+
+BOOST_AUTO_TEST_CASE(blockmanager_raw_block)
+{
+    const CBlockIndex* pindex = WITH_LOCK(cs_main, return ::ChainActive()[50]);
+    const auto& message_start = Params().MessageStart();
+
+    CBlock block;
+    BOOST_REQUIRE(ReadBlockFromDisk(block, pindex, Params().GetConsensus()));
+    CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
+    ss << block;
+
+    const auto block_data = GetRawBlock(pindex, message_start);
+    BOOST_REQUIRE(block_data != nullptr);
+    BOOST_CHECK_EQUAL(HexStr(*block_data), HexStr(ss));
+    // served again from the cache
+    BOOST_CHECK_EQUAL(GetRawBlock(pindex, message_start), block_data);
+
+    const FlatFilePos pos{WITH_LOCK(cs_main, return pindex->GetBlockPos())};
+    std::vector<uint8_t> raw;
+    BOOST_CHECK(ReadRawBlockFromDisk(raw, pos, message_start));
+    BOOST_CHECK(raw == *block_data);
+
+    // wrong network magic
+    CMessageHeader::MessageStartChars other_start;
+    memcpy(other_start, message_start, CMessageHeader::MESSAGE_START_SIZE);
+    other_start[0] ^= 0xff;
+    BOOST_CHECK(!ReadRawBlockFromDisk(raw, pos, other_start));
+
+    // position not pointing at the start of a block
+    FlatFilePos bad_pos = pos;
+    bad_pos.nPos += 1;
+    BOOST_CHECK(!ReadRawBlockFromDisk(raw, bad_pos, message_start));
+}
+
+BOOST_AUTO_TEST_CASE(blockmanager_coinbase)
+{
+    const CBlockIndex* pindex = WITH_LOCK(cs_main, return ::ChainActive()[50]);
+    CBlock block;
+    BOOST_REQUIRE(ReadBlockFromDisk(block, pindex, Params().GetConsensus()));
+
+    CTransactionRef coinbase;
+    BOOST_REQUIRE(ReadCoinbaseFromDisk(coinbase, pindex));
+    BOOST_CHECK(coinbase->IsCoinBase());
+    BOOST_CHECK_EQUAL(coinbase->GetHash(), block.vtx[0]->GetHash());
+
+    // the header on disk doesn't belong to the index entry
+    CBlockIndex other{*pindex};
+    const uint256 other_hash{InsecureRand256()};
+    other.phashBlock = &other_hash;
+    BOOST_CHECK(!ReadCoinbaseFromDisk(coinbase, &other));
+}
+
+static bool LoadBlockIndexFromDB(CBlockTreeDB& blocktree, std::map<uint256, std::unique_ptr<CBlockIndex>>& loaded)
+{
+    const std::thread::id caller = std::this_thread::get_id();
+    return blocktree.LoadBlockIndexGuts(Params().GetConsensus(), [&loaded, caller](const uint256& hash) -> CBlockIndex* {
+        // the entries are linked by the calling thread only
+        BOOST_REQUIRE(std::this_thread::get_id() == caller);
+        if (hash.IsNull()) return nullptr;
+        auto it = loaded.try_emplace(hash).first;
+        if (!it->second) {
+            it->second = std::make_unique<CBlockIndex>();
+            it->second->phashBlock = &it->first;
+        }
+        return it->second.get();
+    });
+}
+
+BOOST_AUTO_TEST_CASE(blockmanager_load_block_index)
+{
+    const uint32_t bits = UintToArith256(Params().GetConsensus().powLimit).GetCompact();
+
+    // enough entries to have some in every part of the key range the loader threads split it into and to make
+    // them wait for batches to be linked
+    std::vector<uint256> hashes(BLOCK_INDEX_LOAD_BATCH_SIZE * MAX_BLOCK_INDEX_LOAD_THREADS * 3);
+    std::vector<std::unique_ptr<CBlockIndex>> chain;
+    std::vector<const CBlockIndex*> to_write;
+    for (size_t i = 0; i < hashes.size(); ++i) {
+        hashes[i] = InsecureRand256();
+        // stay below the regtest PoW limit
+        *(hashes[i].end() - 1) &= 0x3f;
+        auto pindex = std::make_unique<CBlockIndex>();
+        pindex->phashBlock = &hashes[i];
+        pindex->pprev = chain.empty() ? nullptr : chain.back().get();
+        pindex->nHeight = i;
+        pindex->nBits = bits;
+        to_write.push_back(pindex.get());
+        chain.push_back(std::move(pindex));
+    }
+
+    {
+        CBlockTreeDB blocktree(1 << 20, true);
+        BOOST_REQUIRE(blocktree.WriteBatchSync({}, 0, to_write));
+
+        std::map<uint256, std::unique_ptr<CBlockIndex>> loaded;
+        BOOST_REQUIRE(LoadBlockIndexFromDB(blocktree, loaded));
+        BOOST_REQUIRE_EQUAL(loaded.size(), hashes.size());
+        for (size_t i = 0; i < hashes.size(); ++i) {
+            const CBlockIndex* pindex = loaded.at(hashes[i]).get();
+            BOOST_CHECK_EQUAL(pindex->nHeight, int(i));
+            BOOST_CHECK_EQUAL(pindex->nBits, bits);
+            if (i == 0) {
+                BOOST_CHECK(pindex->pprev == nullptr);
+            } else {
+                BOOST_CHECK_EQUAL(pindex->pprev->GetBlockHash(), hashes[i - 1]);
+            }
+        }
+    }
+
+    {
+        // an entry failing the PoW check fails the whole load
+        *(hashes[hashes.size() / 2].end() - 1) = 0xff;
+        CBlockTreeDB blocktree(1 << 20, true);
+        BOOST_REQUIRE(blocktree.WriteBatchSync({}, 0, to_write));
+
+        std::map<uint256, std::unique_ptr<CBlockIndex>> loaded;
+        BOOST_CHECK(!LoadBlockIndexFromDB(blocktree, loaded));
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,223 @@
+// Copyright (c) 2024 The Dash Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <test/util/setup_common.h>
+
+#include <bls/bls.h>
+#include <coinjoin/common.h>
+#include <coinjoin/server.h>
+#include <masternode/node.h>
+#include <masternode/sync.h>
+#include <random.h>
+#include <util/system.h>
+#include <util/time.h>
+#include <validation.h>
+
+#include <boost/test/unit_test.hpp>
+
+class TestCoinJoinServer : public CCoinJoinServer
+{
+public:
+    explicit TestCoinJoinServer(NodeContext& node) :
+        CCoinJoinServer(node.chainman->ActiveChainstate(), *node.connman, *node.mempool, *::masternodeSync)
+    {
+        // collaterals are not validated and the new queues are not announced
+        fUnitTest = true;
+    }
+
+    using CCoinJoinServer::CleanupSessions;
+    using CCoinJoinServer::GetPeerSession;
+    using CCoinJoinServer::GetSessionsCount;
+    using CCoinJoinServer::HasOpenOwnQueue;
+    using CCoinJoinServer::JoinSession;
+    using CCoinJoinServer::SelectSession;
+
+    void AddQueue(const CCoinJoinQueue& dsq) { LOCK(cs_vecqueue); vecCoinJoinQueue.push_back(dsq); }
+    std::vector<CCoinJoinQueue> GetQueue() const { LOCK(cs_vecqueue); return vecCoinJoinQueue; }
+};
+
+struct CoinJoinServerTestingSetup : public TestingSetup {
+    TestCoinJoinServer server{m_node};
+    const int nDenom{CoinJoin::AmountToDenomination(CoinJoin::GetSmallestDenomination())};
+    NodeId nextNodeId{0};
+
+    CoinJoinServerTestingSetup()
+    {
+        fMasternodeMode = true;
+        LOCK(activeMasternodeInfoCs);
+        activeMasternodeInfo.blsKeyOperator = std::make_unique<CBLSSecretKey>();
+        activeMasternodeInfo.blsKeyOperator->MakeNewKey();
+        activeMasternodeInfo.outpoint = COutPoint(GetRandHash(), 0);
+    }
+
+    ~CoinJoinServerTestingSetup()
+    {
+        SetMockTime(0);
+        fMasternodeMode = false;
+        LOCK(activeMasternodeInfoCs);
+        activeMasternodeInfo.blsKeyOperator.reset();
+        activeMasternodeInfo.outpoint.SetNull();
+    }
+
+    /// Let a new peer accept the session the server picks, returns the session it ended up in
+    std::shared_ptr<CCoinJoinServerSession> Accept(NodeId nodeid, int denom)
+    {
+        std::shared_ptr<CCoinJoinServerSession> session;
+        PoolMessage nMessageID = MSG_NOERR;
+        if (!server.SelectSession(nodeid, session, nMessageID)) return nullptr;
+        if (!server.JoinSession(nodeid, session, CCoinJoinAccept(denom, CMutableTransaction()), nMessageID)) return nullptr;
+        return session;
+    }
+
+    /// Start a new session and fill it up so it stops accepting participants
+    std::shared_ptr<CCoinJoinServerSession> FillSession()
+    {
+        auto session = Accept(nextNodeId++, nDenom);
+        BOOST_REQUIRE(session != nullptr);
+        while (session->IsOpen()) {
+            BOOST_REQUIRE(Accept(nextNodeId++, nDenom) == session);
+        }
+        BOOST_CHECK_EQUAL(session->GetParticipantsCount(), CoinJoin::GetMaxPoolParticipants());
+        return session;
+    }
+};
+
+BOOST_FIXTURE_TEST_SUITE(coinjoin_server_tests, CoinJoinServerTestingSetup)
+
+BOOST_AUTO_TEST_CASE(session_selection)
+{
+    // the first peer starts a session, everyone else joins it while it's gathering participants
+    const auto session = Accept(nextNodeId++, nDenom);
+    BOOST_REQUIRE(session != nullptr);
+    BOOST_CHECK(session->IsOpen());
+    BOOST_CHECK(Accept(nextNodeId++, nDenom) == session);
+    BOOST_CHECK_EQUAL(server.GetSessionsCount(), 1U);
+    BOOST_CHECK_EQUAL(session->GetParticipantsCount(), 2);
+
+    // a peer with another denomination is rejected and not routed to the session
+    const NodeId other_denom_peer = nextNodeId++;
+    std::shared_ptr<CCoinJoinServerSession> selected;
+    PoolMessage nMessageID = MSG_NOERR;
+    BOOST_CHECK(server.SelectSession(other_denom_peer, selected, nMessageID));
+    BOOST_CHECK(selected == session);
+    const int other_denom = CoinJoin::AmountToDenomination(CoinJoin::GetStandardDenominations().front());
+    BOOST_CHECK(!server.JoinSession(other_denom_peer, selected, CCoinJoinAccept(other_denom, CMutableTransaction()), nMessageID));
+    BOOST_CHECK_EQUAL(nMessageID, ERR_DENOM);
+    BOOST_CHECK(server.GetPeerSession(other_denom_peer) == nullptr);
+
+    // once the session is full, its participants are told so and new peers start another session
+    while (session->IsOpen()) {
+        BOOST_REQUIRE(Accept(nextNodeId++, nDenom) == session);
+    }
+    nMessageID = MSG_NOERR;
+    BOOST_CHECK(!server.SelectSession(0, selected, nMessageID));
+    BOOST_CHECK(selected == session);
+    BOOST_CHECK_EQUAL(nMessageID, ERR_QUEUE_FULL);
+
+    const auto next_session = Accept(nextNodeId++, nDenom);
+    BOOST_REQUIRE(next_session != nullptr);
+    BOOST_CHECK(next_session != session);
+    BOOST_CHECK_EQUAL(server.GetSessionsCount(), 2U);
+}
+
+BOOST_AUTO_TEST_CASE(max_sessions)
+{
+    for (int i = 0; i < COINJOIN_SERVER_MAX_SESSIONS; ++i) {
+        FillSession();
+    }
+    BOOST_CHECK_EQUAL(server.GetSessionsCount(), size_t{COINJOIN_SERVER_MAX_SESSIONS});
+
+    // all sessions are busy, a new peer can't start another one
+    std::shared_ptr<CCoinJoinServerSession> selected;
+    PoolMessage nMessageID = MSG_NOERR;
+    BOOST_CHECK(!server.SelectSession(nextNodeId++, selected, nMessageID));
+    BOOST_CHECK(selected == nullptr);
+    BOOST_CHECK_EQUAL(nMessageID, ERR_QUEUE_FULL);
+    BOOST_CHECK_EQUAL(server.GetSessionsCount(), size_t{COINJOIN_SERVER_MAX_SESSIONS});
+}
+
+BOOST_AUTO_TEST_CASE(peer_routing)
+{
+    const NodeId first_peer = nextNodeId;
+    const auto first = FillSession();
+    const NodeId second_peer = nextNodeId;
+    const auto second = FillSession();
+    BOOST_CHECK(first != second);
+
+    // messages of every participant go to the session it joined, unknown peers have none
+    for (NodeId nodeid = first_peer; nodeid < second_peer; ++nodeid) {
+        BOOST_CHECK(server.GetPeerSession(nodeid) == first);
+    }
+    for (NodeId nodeid = second_peer; nodeid < nextNodeId; ++nodeid) {
+        BOOST_CHECK(server.GetPeerSession(nodeid) == second);
+    }
+    BOOST_CHECK(server.GetPeerSession(nextNodeId) == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(parallel_sessions)
+{
+    // the queue of a session which is gathering participants holds back new sessions
+    const auto first = Accept(nextNodeId++, nDenom);
+    BOOST_REQUIRE(first != nullptr);
+    BOOST_CHECK(server.HasOpenOwnQueue());
+
+    // once the session is full its queue doesn't, the next session starts while the first one is running
+    while (first->IsOpen()) {
+        BOOST_REQUIRE(Accept(nextNodeId++, nDenom) == first);
+    }
+    BOOST_CHECK(!server.HasOpenOwnQueue());
+    const auto second = Accept(nextNodeId++, nDenom);
+    BOOST_REQUIRE(second != nullptr);
+    BOOST_CHECK(second != first);
+    BOOST_CHECK(!first->IsFinished());
+    BOOST_CHECK(second->IsOpen());
+    BOOST_CHECK_EQUAL(server.GetSessionsCount(), 2U);
+    BOOST_CHECK(server.HasOpenOwnQueue());
+
+    // both queues are announced at the same time
+    const auto queue = server.GetQueue();
+    BOOST_REQUIRE_EQUAL(queue.size(), 2U);
+    BOOST_CHECK(first->GetQueue() == queue[0]);
+    BOOST_CHECK(second->GetQueue() == queue[1]);
+
+    // a queue of this masternode without a session holds back new sessions as well
+    server.CleanupSessions();
+    const COutPoint mnOutpoint = WITH_LOCK(activeMasternodeInfoCs, return activeMasternodeInfo.outpoint);
+    TestCoinJoinServer other_server{m_node};
+    other_server.AddQueue(CCoinJoinQueue(nDenom, mnOutpoint, GetRandHash(), GetAdjustedTime(), false));
+    BOOST_CHECK(other_server.HasOpenOwnQueue());
+}
+
+BOOST_AUTO_TEST_CASE(cleanup_sessions)
+{
+    const auto full = FillSession();
+    SetMockTime(GetTime());
+    const NodeId waiting_peer = nextNodeId;
+    const auto waiting = Accept(nextNodeId++, nDenom);
+    BOOST_REQUIRE(waiting != nullptr);
+
+    // queues of other masternodes stay, only the one of the session is dropped once it ends
+    const COutPoint otherOutpoint(GetRandHash(), 0);
+    server.AddQueue(CCoinJoinQueue(nDenom, otherOutpoint, GetRandHash(), GetAdjustedTime(), false));
+    BOOST_CHECK_EQUAL(server.GetQueue().size(), 3U);
+
+    // the session which didn't get enough participants in time fails
+    SetMockTime(GetTime() + COINJOIN_QUEUE_TIMEOUT + 1);
+    waiting->Check();
+    BOOST_CHECK(waiting->IsFinished());
+    BOOST_CHECK(!full->IsFinished());
+    BOOST_CHECK(server.GetPeerSession(waiting_peer) == nullptr);
+
+    const auto queue = server.GetQueue();
+    BOOST_REQUIRE_EQUAL(queue.size(), 2U);
+    BOOST_CHECK(full->GetQueue() == queue[0]);
+    BOOST_CHECK(!waiting->GetQueue());
+    BOOST_CHECK(queue[1].masternodeOutpoint == otherOutpoint);
+
+    server.CleanupSessions();
+    BOOST_CHECK_EQUAL(server.GetSessionsCount(), 1U);
+    BOOST_CHECK(server.GetPeerSession(0) == full);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
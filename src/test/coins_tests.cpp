@@ -10,9 +10,13 @@
 #include <txdb.h>
 #include <uint256.h>
 #include <undo.h>
+#include <util/metrics.h>
 #include <util/strencodings.h>
 
+#include <atomic>
+#include <chrono>
 #include <map>
+#include <thread>
 #include <vector>
 
 #include <boost/test/unit_test.hpp>
@@ -877,4 +881,183 @@ BOOST_AUTO_TEST_CASE(ccoins_write)
                     CheckWriteCoins(parent_value, child_value, parent_value, parent_flags, child_flags, parent_flags);
 }
 
+BOOST_AUTO_TEST_CASE(ccoins_read_cache)
+{
+    CCoinsViewTest base;
+    CCoinsReadCache read_cache;
+
+    const COutPoint outpoint_a{InsecureRand256(), 0};
+    const COutPoint outpoint_b{InsecureRand256(), 1};
+    const COutPoint outpoint_c{InsecureRand256(), 2};
+    const uint256 block1 = InsecureRand256();
+    const uint256 block2 = InsecureRand256();
+    {
+        CCoinsViewCache setup(&base);
+        setup.AddCoin(outpoint_a, Coin(CTxOut(1, CScript() << OP_TRUE), 1, false), false);
+        setup.SetBestBlock(block1);
+        BOOST_REQUIRE(setup.Flush());
+    }
+
+    Coin coin;
+    BOOST_CHECK(!read_cache.IsReady());
+    BOOST_CHECK(!read_cache.GetCoin(outpoint_a, coin));
+
+    // the chain tip's coins cache, with a change not flushed to the base
+    CCoinsViewCache tip(&base);
+    tip.AddCoin(outpoint_c, Coin(CTxOut(3, CScript() << OP_TRUE), 1, false), false);
+
+    const size_t empty_usage = read_cache.DynamicMemoryUsage();
+    read_cache.Reset(base, tip, 1);
+    BOOST_CHECK(read_cache.IsReady());
+    // the unflushed change is copied
+    BOOST_CHECK(read_cache.DynamicMemoryUsage() > empty_usage);
+    BOOST_CHECK(read_cache.GetCoin(outpoint_a, coin));
+    BOOST_CHECK_EQUAL(coin.out.nValue, 1);
+    BOOST_CHECK(read_cache.GetCoin(outpoint_c, coin));
+    BOOST_CHECK_EQUAL(coin.out.nValue, 3);
+    // coins missing from the base are returned spent
+    BOOST_CHECK(read_cache.GetCoin(outpoint_b, coin));
+    BOOST_CHECK(coin.IsSpent());
+
+    // a block spending a and creating b
+    CCoinsViewCache view(&tip);
+    view.SpendCoin(outpoint_a);
+    view.AddCoin(outpoint_b, Coin(CTxOut(2, CScript() << OP_TRUE), 2, false), false);
+    view.SetBestBlock(block2);
+    read_cache.ApplyChanges(view, 2);
+    BOOST_REQUIRE(view.Flush());
+
+    std::vector<Coin> coins;
+    uint256 best_block;
+    int best_height{0};
+    BOOST_CHECK(read_cache.GetCoins({outpoint_a, outpoint_b}, coins, best_block, best_height));
+    BOOST_REQUIRE_EQUAL(coins.size(), 2U);
+    BOOST_CHECK(coins[0].IsSpent());
+    BOOST_CHECK_EQUAL(coins[1].out.nValue, 2);
+    BOOST_CHECK_EQUAL(best_block, block2);
+    BOOST_CHECK_EQUAL(best_height, 2);
+
+    // filling the shards with coins read from the base never drops changes which are not in the base yet
+    const uint256 txid = InsecureRand256();
+    for (uint32_t n = 0; n < CCoinsReadCache::MAX_CLEAN_COINS_PER_SHARD * CCoinsReadCache::SHARDS * 2; ++n) {
+        BOOST_CHECK(read_cache.GetCoin(COutPoint(txid, n), coin));
+    }
+    BOOST_CHECK(read_cache.GetCoin(outpoint_a, coin));
+    BOOST_CHECK(coin.IsSpent());
+    BOOST_CHECK(read_cache.GetCoin(outpoint_b, coin));
+    BOOST_CHECK_EQUAL(coin.out.nValue, 2);
+    // the coins read from the base are capped, and so is the memory they use
+    const size_t usage = read_cache.DynamicMemoryUsage();
+    for (uint32_t n = 0; n < CCoinsReadCache::MAX_CLEAN_COINS_PER_SHARD * CCoinsReadCache::SHARDS; ++n) {
+        BOOST_CHECK(read_cache.GetCoin(COutPoint(txid, n), coin));
+    }
+    BOOST_CHECK(read_cache.DynamicMemoryUsage() <= usage * 2);
+
+    // readers see the changes of a block either completely or not at all
+    std::atomic<bool> stop{false};
+    std::atomic<int> inconsistent{0};
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 4; ++i) {
+        readers.emplace_back([&] {
+            std::vector<Coin> coins;
+            uint256 best_block;
+            int best_height;
+            while (!stop) {
+                if (!read_cache.GetCoins({outpoint_a, outpoint_b}, coins, best_block, best_height) ||
+                        coins[0].IsSpent() == coins[1].IsSpent() || !coins[best_height % 2].IsSpent()) {
+                    ++inconsistent;
+                }
+            }
+        });
+    }
+    for (int height = 3; height < 1000; ++height) {
+        // odd heights have a, even ones b
+        CCoinsViewCache block(&tip);
+        const bool move_to_a = height % 2 == 1;
+        block.SpendCoin(move_to_a ? outpoint_b : outpoint_a);
+        block.AddCoin(move_to_a ? outpoint_a : outpoint_b, Coin(CTxOut(height, CScript() << OP_TRUE), height, false), true);
+        block.SetBestBlock(InsecureRand256());
+        read_cache.ApplyChanges(block, height);
+        BOOST_CHECK(block.Flush());
+    }
+    stop = true;
+    for (auto& reader : readers) reader.join();
+    BOOST_CHECK_EQUAL(inconsistent, 0);
+
+    read_cache.Reset();
+    BOOST_CHECK(!read_cache.IsReady());
+    BOOST_CHECK(!read_cache.GetCoin(outpoint_a, coin));
+}
+
+static bool WaitForPrefetched(const CCoinsViewPrefetch& prefetch, size_t count)
+{
+    for (int i = 0; i < 1000 && prefetch.GetPrefetchedCount() < count; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return prefetch.GetPrefetchedCount() == count;
+}
+
+BOOST_AUTO_TEST_CASE(ccoins_prefetch)
+{
+    CCoinsViewDB db{"test", /*nCacheSize*/ 1 << 20, /*fMemory*/ true, /*fWipe*/ false};
+    CCoinsViewPrefetch prefetch(&db, 2);
+    prefetch.SetMaxUsage(1 << 20);
+
+    const COutPoint outpoint_a{InsecureRand256(), 0};
+    const COutPoint outpoint_b{InsecureRand256(), 1};
+    const COutPoint outpoint_c{InsecureRand256(), 2};
+    {
+        CCoinsViewCache setup(&prefetch);
+        for (const auto& outpoint : {outpoint_a, outpoint_b, outpoint_c}) {
+            setup.AddCoin(outpoint, Coin(CTxOut(outpoint.n + 1, CScript() << OP_TRUE), 1, false), false);
+        }
+        setup.SetBestBlock(InsecureRand256());
+        BOOST_REQUIRE(setup.Flush());
+    }
+
+    // a block spending a, b and c as well as an output it creates itself
+    CMutableTransaction tx1;
+    tx1.vin = {CTxIn(outpoint_a), CTxIn(outpoint_b), CTxIn(outpoint_c)};
+    tx1.vout = {CTxOut(1, CScript() << OP_TRUE)};
+    CMutableTransaction tx2;
+    tx2.vin = {CTxIn(COutPoint(tx1.GetHash(), 0))};
+    tx2.vout = {CTxOut(1, CScript() << OP_TRUE)};
+    CBlock block;
+    block.vtx = {MakeTransactionRef(tx1), MakeTransactionRef(tx2)};
+
+    // the tip already has c, so only a and b are read
+    CCoinsViewCache tip(&prefetch);
+    BOOST_REQUIRE(tip.HaveCoin(outpoint_c));
+    prefetch.Prefetch(block, tip);
+    BOOST_REQUIRE(WaitForPrefetched(prefetch, 2));
+    const size_t usage = prefetch.DynamicMemoryUsage();
+    BOOST_CHECK(usage > 0);
+
+    auto& hits = metrics::GetCounter("coins.prefetch.hits");
+    const uint64_t hits_before = hits.Get();
+    BOOST_CHECK_EQUAL(tip.AccessCoin(outpoint_a).out.nValue, 1);
+    BOOST_CHECK_EQUAL(hits.Get(), hits_before + 1);
+    // handed out coins are left to the coins cache
+    BOOST_CHECK_EQUAL(prefetch.GetPrefetchedCount(), 1U);
+    BOOST_CHECK(prefetch.DynamicMemoryUsage() < usage);
+
+    // writing to the database drops what was prefetched, b would be stale afterwards
+    CCoinsViewCache view(&tip);
+    view.SpendCoin(outpoint_a);
+    view.SpendCoin(outpoint_b);
+    view.SetBestBlock(InsecureRand256());
+    BOOST_REQUIRE(view.Flush());
+    BOOST_REQUIRE(tip.Flush());
+    BOOST_CHECK_EQUAL(prefetch.GetPrefetchedCount(), 0U);
+    BOOST_CHECK(!tip.HaveCoin(outpoint_b));
+
+    // prefetching again after stopping restarts the workers
+    prefetch.Stop();
+    CCoinsViewCache tip2(&prefetch);
+    prefetch.Prefetch(block, tip2);
+    BOOST_REQUIRE(WaitForPrefetched(prefetch, 1));
+    BOOST_CHECK_EQUAL(tip2.AccessCoin(outpoint_c).out.nValue, 3);
+    BOOST_CHECK_EQUAL(prefetch.GetPrefetchedCount(), 0U);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -16,6 +16,9 @@
 #include <crypto/sha256.h>
 #include <crypto/sha3.h>
 #include <crypto/sha512.h>
+#include <crypto/x11.h>
+#include <chainparams.h>
+#include <primitives/block.h>
 #include <random.h>
 #include <streams.h>
 #include <test/util/setup_common.h>
@@ -876,6 +879,87 @@ BOOST_AUTO_TEST_CASE(sha256d64)
     }
 }
 
+BOOST_AUTO_TEST_CASE(x11_testvectors)
+{
+    // mainnet genesis block
+    const CBlockHeader genesis = Params().GenesisBlock().GetBlockHeader();
+    BOOST_CHECK_EQUAL(genesis.GetHash().ToString(), "00000ffd590b1485b3caadc19b22e6379c733355108f107a430458cdf3407ab6");
+
+    for (const size_t len : {0, 1, 32, 63, 64, 80, 127, 128}) {
+        unsigned char in[4 * 128];
+        unsigned char out1[4 * 32], out2[4 * 32];
+        for (size_t j = 0; j < 4 * len; ++j) {
+            in[j] = InsecureRandBits(8);
+        }
+        for (int j = 0; j < 4; ++j) {
+            X11(out1 + 32 * j, in + len * j, len);
+        }
+        X11_4way(out2, in, len);
+        BOOST_CHECK(memcmp(out1, out2, sizeof(out1)) == 0);
+    }
+
+    std::vector<CBlockHeader> headers;
+    for (int i = 0; i < 10; ++i) {
+        const std::vector<uint256> hashes = GetBlockHeaderHashes(headers);
+        BOOST_CHECK_EQUAL(hashes.size(), headers.size());
+        for (size_t j = 0; j < headers.size(); ++j) {
+            BOOST_CHECK(hashes[j] == headers[j].GetHash());
+        }
+        CBlockHeader header = genesis;
+        header.hashPrevBlock = InsecureRand256();
+        header.nNonce = InsecureRand32();
+        headers.push_back(header);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(x11_implementations)
+{
+    // random inputs of the lengths hashed in practice, block headers with and without extra payload among them
+    std::vector<std::vector<unsigned char>> inputs;
+    for (const size_t len : {0, 1, 32, 64, 80, 112, 128, 200}) {
+        for (int i = 0; i < 8; ++i) {
+            std::vector<unsigned char> in(len);
+            for (auto& c : in) {
+                c = InsecureRandBits(8);
+            }
+            inputs.push_back(std::move(in));
+        }
+    }
+    const auto hash_all = [&]() {
+        std::vector<uint256> ret;
+        for (size_t i = 0; i < inputs.size(); i += 4) {
+            uint256 out;
+            X11(out.begin(), inputs[i].data(), inputs[i].size());
+            ret.push_back(out);
+            // groups of 4 inputs of the same length go through the 4-way path as well
+            std::vector<unsigned char> in4;
+            for (size_t j = i; j < i + 4; ++j) {
+                in4.insert(in4.end(), inputs[j].begin(), inputs[j].end());
+            }
+            unsigned char out4[4 * 32];
+            X11_4way(out4, in4.data(), inputs[i].size());
+            for (size_t j = 0; j < 4; ++j) {
+                ret.emplace_back(Span<const unsigned char>{out4 + 32 * j, 32});
+            }
+        }
+        return ret;
+    };
+
+    // the portable implementation uses the sph reference code for all rounds
+    BOOST_CHECK_EQUAL(X11AutoDetect(/*allow_accelerated=*/false), "standard");
+    const std::vector<uint256> reference = hash_all();
+    BOOST_CHECK_EQUAL(Params().GenesisBlock().GetHash().ToString(), "00000ffd590b1485b3caadc19b22e6379c733355108f107a430458cdf3407ab6");
+    for (size_t i = 0; i < reference.size(); i += 5) {
+        // the 1-way digest of the first input of the group equals its 4-way one
+        BOOST_CHECK(reference[i] == reference[i + 1]);
+    }
+
+    const std::string accelerated = X11AutoDetect();
+    BOOST_TEST_MESSAGE("Comparing X11 implementation " << accelerated << " against the portable one");
+    BOOST_CHECK(hash_all() == reference);
+    BOOST_CHECK_EQUAL(Params().GenesisBlock().GetHash().ToString(), "00000ffd590b1485b3caadc19b22e6379c733355108f107a430458cdf3407ab6");
+}
+
 static void TestSHA3_256(const std::string& input, const std::string& output)
 {
     const auto in_bytes = ParseHex(input);
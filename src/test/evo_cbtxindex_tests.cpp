@@ -0,0 +1,56 @@
+// Copyright (c) 2023 The Dash Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <test/util/setup_common.h>
+
+#include <chain.h>
+#include <chainparams.h>
+#include <evo/cbtxindex.h>
+#include <node/context.h>
+#include <streams.h>
+#include <validation.h>
+#include <version.h>
+
+#include <boost/test/unit_test.hpp>
+
+static std::string Serialized(const CCbTxIndexEntry& entry)
+{
+    CDataStream ss(SER_DISK, CLIENT_VERSION);
+    ss << entry;
+    return ss.str();
+}
+
+BOOST_FIXTURE_TEST_SUITE(evo_cbtxindex_tests, TestChain100Setup)
+
+BOOST_AUTO_TEST_CASE(cbtxindex_connect)
+{
+    const CBlock block = CreateAndProcessBlock({}, coinbaseKey);
+    const CBlockIndex* pindex = WITH_LOCK(cs_main, return ::ChainActive().Tip());
+    BOOST_REQUIRE_EQUAL(pindex->GetBlockHash(), block.GetHash());
+
+    const auto entry = cbTxIndex->Get(pindex);
+    BOOST_REQUIRE(entry != nullptr);
+    BOOST_CHECK_EQUAL(entry->cbTx->GetHash(), block.vtx[0]->GetHash());
+    BOOST_CHECK(entry->vSpecialTxs.empty());
+
+    // the partial merkle tree proves the coinbase against the block header
+    CPartialMerkleTree tree = entry->cbTxMerkleTree;
+    std::vector<uint256> matches;
+    std::vector<unsigned int> indexes;
+    BOOST_CHECK_EQUAL(tree.ExtractMatches(matches, indexes), block.hashMerkleRoot);
+    BOOST_CHECK(matches == std::vector<uint256>{block.vtx[0]->GetHash()});
+
+    // a fresh index without cached entries reads what was written to EvoDB when the block was connected
+    CCbTxIndex index(*m_node.evodb);
+    const auto stored = index.Get(pindex);
+    BOOST_REQUIRE(stored != nullptr);
+    BOOST_CHECK_EQUAL(Serialized(*stored), Serialized(CCbTxIndexEntry(block)));
+
+    // blocks connected before the index existed are read from disk
+    const auto genesis = index.Get(pindex->GetAncestor(0));
+    BOOST_REQUIRE(genesis != nullptr);
+    BOOST_CHECK_EQUAL(genesis->cbTx->GetHash(), Params().GenesisBlock().vtx[0]->GetHash());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -453,8 +453,10 @@ void FuncDIP3Protx(TestChainSetup& setup)
     nHeight++;
 
     // check MN reward payments
+    std::vector<uint256> paidProTxHashes;
     for (size_t i = 0; i < 20; i++) {
         auto dmnExpectedPayee = deterministicMNManager->GetListAtChainTip().GetMNPayee(::ChainActive().Tip());
+        BOOST_CHECK_EQUAL(deterministicMNManager->GetMNPayee(::ChainActive().Tip())->proTxHash.ToString(), dmnExpectedPayee->proTxHash.ToString());
 
         CBlock block = setup.CreateAndProcessBlock({}, setup.coinbaseKey);
         deterministicMNManager->UpdatedBlockTip(::ChainActive().Tip());
@@ -463,10 +465,18 @@ void FuncDIP3Protx(TestChainSetup& setup)
         auto dmnPayout = FindPayoutDmn(block);
         BOOST_ASSERT(dmnPayout != nullptr);
         BOOST_CHECK_EQUAL(dmnPayout->proTxHash.ToString(), dmnExpectedPayee->proTxHash.ToString());
+        paidProTxHashes.emplace_back(dmnPayout->proTxHash);
 
         nHeight++;
     }
 
+    // check that the payee range matches the actual payments
+    auto rangePayees = deterministicMNManager->GetMNPayees(::ChainActive().Tip(), nHeight - 19);
+    BOOST_REQUIRE_EQUAL(rangePayees.size(), paidProTxHashes.size());
+    for (size_t i = 0; i < rangePayees.size(); i++) {
+        BOOST_CHECK_EQUAL(rangePayees[i]->proTxHash.ToString(), paidProTxHashes[i].ToString());
+    }
+
     // register multiple MNs per block
     for (size_t i = 0; i < 3; i++) {
         std::vector<CMutableTransaction> txns;
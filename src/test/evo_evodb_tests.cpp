@@ -0,0 +1,134 @@
+// Copyright (c) 2023 The Dash Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <test/util/setup_common.h>
+
+#include <clientversion.h>
+#include <evo/evodb.h>
+#include <streams.h>
+#include <uint256.h>
+
+#include <string>
+#include <utility>
+
+#include <boost/test/unit_test.hpp>
+
+template <typename K>
+static EvoDBStore StoreOf(const K& key)
+{
+    CDataStream ssKey(SER_DISK, CLIENT_VERSION);
+    ssKey << key;
+    return CEvoDBStores::GetStore(ssKey);
+}
+
+static void CommitWrite(CEvoDB& evodb, const std::pair<std::string, uint256>& key, const std::string& value)
+{
+    auto tx = evodb.BeginTransaction();
+    evodb.Write(key, value);
+    tx->Commit();
+    BOOST_REQUIRE(evodb.CommitRootTransaction());
+}
+
+BOOST_FIXTURE_TEST_SUITE(evo_evodb_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(evodb_store_keys)
+{
+    const uint256 hash = InsecureRand256();
+    BOOST_CHECK(StoreOf(std::make_pair(std::string("dmn_S3"), hash)) == EvoDBStore::DMN_LIST);
+    BOOST_CHECK(StoreOf(std::make_pair(std::string("dmn_D3"), hash)) == EvoDBStore::DMN_LIST);
+    BOOST_CHECK(StoreOf(std::make_pair(std::string("q_mc"), std::make_pair(uint8_t{1}, hash))) == EvoDBStore::QUORUM_COMMITMENTS);
+    BOOST_CHECK(StoreOf(std::make_pair(std::string("q_mcih"), hash)) == EvoDBStore::QUORUM_COMMITMENTS);
+    BOOST_CHECK(StoreOf(std::make_pair(std::string("q_Qsk"), hash)) == EvoDBStore::QUORUM_DATA);
+    BOOST_CHECK(StoreOf(std::make_pair(std::string("cpm_S"), hash)) == EvoDBStore::CREDIT_POOL);
+    BOOST_CHECK(StoreOf(std::make_pair(std::string("mnhf_s"), hash)) == EvoDBStore::MNHF);
+    BOOST_CHECK(StoreOf(std::make_pair(std::string("cbi"), hash)) == EvoDBStore::CBTX_INDEX);
+    BOOST_CHECK(StoreOf(EVODB_BEST_BLOCK) == EvoDBStore::OTHER);
+    // keys of older formats, prefixes of store keys and keys which aren't strings
+    BOOST_CHECK(StoreOf(std::make_pair(std::string("dmn_S2"), hash)) == EvoDBStore::OTHER);
+    BOOST_CHECK(StoreOf(std::make_pair(std::string("q_m"), hash)) == EvoDBStore::OTHER);
+    BOOST_CHECK(StoreOf(hash) == EvoDBStore::OTHER);
+    BOOST_CHECK(CEvoDBStores::GetStore(CDataStream(SER_DISK, CLIENT_VERSION)) == EvoDBStore::OTHER);
+
+    for (size_t i = 0; i < EVODB_STORE_COUNT; ++i) {
+        const auto store = static_cast<EvoDBStore>(i);
+        BOOST_CHECK(CEvoDBStores::GetStoreByName(CEvoDBStores::GetStoreName(store)) == store);
+    }
+    BOOST_CHECK(!CEvoDBStores::GetStoreByName("unknown"));
+}
+
+BOOST_AUTO_TEST_CASE(evodb_store_cache)
+{
+    CEvoDB evodb(1 << 20, true);
+    const auto key = std::make_pair(std::string("q_mc"), InsecureRand256());
+    const auto other_key = std::make_pair(std::string("dmn_S3"), InsecureRand256());
+    CommitWrite(evodb, key, "value1");
+    CommitWrite(evodb, other_key, "other");
+
+    const auto before = evodb.GetStoreStats(EvoDBStore::QUORUM_COMMITMENTS);
+    const auto other_before = evodb.GetStoreStats(EvoDBStore::DMN_LIST);
+    std::string value;
+    BOOST_CHECK(evodb.Read(key, value));
+    BOOST_CHECK_EQUAL(value, "value1");
+    BOOST_CHECK(evodb.Read(key, value));
+    BOOST_CHECK(evodb.Exists(key));
+    const auto after = evodb.GetStoreStats(EvoDBStore::QUORUM_COMMITMENTS);
+    BOOST_CHECK_EQUAL(after.misses - before.misses, 1U);
+    BOOST_CHECK_EQUAL(after.hits - before.hits, 2U);
+    BOOST_CHECK_EQUAL(after.cache_entries, 1U);
+    BOOST_CHECK_EQUAL(after.read_latency.count - before.read_latency.count, 2U);
+    // other stores are not affected
+    BOOST_CHECK_EQUAL(evodb.GetStoreStats(EvoDBStore::DMN_LIST).hits, other_before.hits);
+    BOOST_CHECK_EQUAL(evodb.GetStoreStats(EvoDBStore::DMN_LIST).cache_entries, 0U);
+
+    // committed writes and erases replace what was cached
+    CommitWrite(evodb, key, "value2");
+    BOOST_CHECK_EQUAL(evodb.GetStoreStats(EvoDBStore::QUORUM_COMMITMENTS).cache_entries, 0U);
+    BOOST_CHECK(evodb.Read(key, value));
+    BOOST_CHECK_EQUAL(value, "value2");
+    {
+        auto tx = evodb.BeginTransaction();
+        evodb.Erase(key);
+        tx->Commit();
+        BOOST_REQUIRE(evodb.CommitRootTransaction());
+    }
+    BOOST_CHECK(!evodb.Read(key, value));
+    BOOST_CHECK(!evodb.Exists(key));
+
+    // changes made to the database directly are only seen once the cache of the store is cleared
+    CommitWrite(evodb, key, "value3");
+    BOOST_CHECK(evodb.Read(key, value));
+    BOOST_REQUIRE(evodb.GetRawDB().Write(key, std::string("value4")));
+    BOOST_CHECK(evodb.Read(key, value));
+    BOOST_CHECK_EQUAL(value, "value3");
+    evodb.ClearStoreCache(EvoDBStore::QUORUM_COMMITMENTS);
+    BOOST_CHECK(evodb.Read(key, value));
+    BOOST_CHECK_EQUAL(value, "value4");
+}
+
+BOOST_AUTO_TEST_CASE(evodb_store_cache_limit)
+{
+    CEvoDB evodb(1 << 20, true);
+    const auto stats = evodb.GetStoreStats(EvoDBStore::CBTX_INDEX);
+    BOOST_REQUIRE_GT(stats.cache_limit, 0U);
+
+    std::vector<std::pair<std::string, uint256>> keys;
+    for (int i = 0; i < 100; ++i) {
+        keys.emplace_back("cbi", InsecureRand256());
+        CommitWrite(evodb, keys.back(), std::string(stats.cache_limit / 10, 'x'));
+    }
+    std::string value;
+    for (const auto& key : keys) {
+        BOOST_CHECK(evodb.Read(key, value));
+    }
+    const auto after = evodb.GetStoreStats(EvoDBStore::CBTX_INDEX);
+    BOOST_CHECK_LE(after.cache_usage, after.cache_limit);
+    BOOST_CHECK_GT(after.cache_entries, 0U);
+    BOOST_CHECK_LT(after.cache_entries, keys.size());
+    // the most recently read values are kept
+    const auto hits = after.hits;
+    BOOST_CHECK(evodb.Read(keys.back(), value));
+    BOOST_CHECK_EQUAL(evodb.GetStoreStats(EvoDBStore::CBTX_INDEX).hits, hits + 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,137 @@
+// Copyright (c) 2024 The Dash Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <test/util/setup_common.h>
+
+#include <bls/bls.h>
+#include <evo/mempoolindex.h>
+#include <evo/specialtx.h>
+#include <netbase.h>
+#include <primitives/transaction.h>
+#include <random.h>
+
+#include <boost/test/unit_test.hpp>
+
+template <typename T>
+static CTransactionRef MakeSpecialTx(const T& payload)
+{
+    CMutableTransaction tx;
+    tx.nVersion = 3;
+    tx.nType = T::SPECIALTX_TYPE;
+    tx.vin.emplace_back(COutPoint(GetRandHash(), 0));
+    SetTxPayload(tx, payload);
+    return MakeTransactionRef(tx);
+}
+
+BOOST_FIXTURE_TEST_SUITE(evo_mempoolindex_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(parse_payload)
+{
+    CMutableTransaction tx;
+    BOOST_CHECK(ParseSpecialTxPayload(CTransaction(tx)) == nullptr);
+
+    tx.nVersion = 3;
+    tx.nType = TRANSACTION_PROVIDER_REGISTER;
+    tx.vExtraPayload = {0x01};
+    BOOST_CHECK(IsMempoolIndexedSpecialTx(tx.nType));
+    BOOST_CHECK(ParseSpecialTxPayload(CTransaction(tx)) == nullptr);
+
+    tx.nType = TRANSACTION_COINBASE;
+    BOOST_CHECK(!IsMempoolIndexedSpecialTx(tx.nType));
+}
+
+BOOST_AUTO_TEST_CASE(protx_conflicts)
+{
+    CSpecialTxMempoolIndex index;
+
+    CBLSSecretKey sk;
+    sk.MakeNewKey();
+
+    CProRegTx proRegTx;
+    proRegTx.collateralOutpoint = COutPoint(GetRandHash(), 1);
+    proRegTx.addr = LookupNumeric("1.1.1.1", 1000);
+    proRegTx.keyIDOwner = CKeyID(uint160(g_insecure_rand_ctx.randbytes(20)));
+    proRegTx.pubKeyOperator.Set(sk.GetPublicKey(), bls::bls_legacy_scheme.load());
+    const auto regTx = MakeSpecialTx(proRegTx);
+    const auto regPayload = ParseSpecialTxPayload(*regTx);
+    BOOST_REQUIRE(regPayload != nullptr);
+    BOOST_CHECK(regPayload->Get<CProRegTx>() != nullptr);
+    index.Add(regTx->GetHash(), regPayload);
+
+    BOOST_CHECK(index.GetPayload(regTx->GetHash()) == regPayload);
+    BOOST_CHECK(index.GetTxByAddress(proRegTx.addr) == regTx->GetHash());
+    BOOST_CHECK(index.GetTxByOwnerKey(proRegTx.keyIDOwner) == regTx->GetHash());
+    BOOST_CHECK(index.GetTxByOperatorKey(proRegTx.pubKeyOperator.GetHash()) == regTx->GetHash());
+    BOOST_CHECK(index.GetTxByCollateral(proRegTx.collateralOutpoint) == regTx->GetHash());
+    BOOST_CHECK(index.GetFirstProTxRef(regTx->GetHash()) == proRegTx.collateralOutpoint.hash);
+
+    const uint256 proTxHash = GetRandHash();
+    CProUpServTx proUpServTx;
+    proUpServTx.proTxHash = proTxHash;
+    proUpServTx.addr = LookupNumeric("2.2.2.2", 1000);
+    const auto servTx = MakeSpecialTx(proUpServTx);
+    index.Add(servTx->GetHash(), ParseSpecialTxPayload(*servTx));
+
+    CProUpRevTx proUpRevTx;
+    proUpRevTx.proTxHash = proTxHash;
+    const auto revTx = MakeSpecialTx(proUpRevTx);
+    index.Add(revTx->GetHash(), ParseSpecialTxPayload(*revTx));
+
+    auto refs = index.GetProTxRefs(proTxHash);
+    BOOST_CHECK_EQUAL(refs.size(), 2U);
+    BOOST_CHECK(std::count(refs.begin(), refs.end(), servTx->GetHash()) == 1);
+    BOOST_CHECK(std::count(refs.begin(), refs.end(), revTx->GetHash()) == 1);
+    BOOST_CHECK_EQUAL(index.Size(), 3U);
+
+    // removing a tx must only drop the entries it owns
+    index.Remove(servTx->GetHash());
+    BOOST_CHECK(!index.GetTxByAddress(proUpServTx.addr));
+    BOOST_CHECK(index.GetTxByAddress(proRegTx.addr) == regTx->GetHash());
+    BOOST_CHECK(index.GetProTxRefs(proTxHash) == std::vector<uint256>{revTx->GetHash()});
+
+    index.Remove(regTx->GetHash());
+    BOOST_CHECK(!index.GetTxByAddress(proRegTx.addr));
+    BOOST_CHECK(!index.GetTxByOwnerKey(proRegTx.keyIDOwner));
+    BOOST_CHECK(!index.GetTxByOperatorKey(proRegTx.pubKeyOperator.GetHash()));
+    BOOST_CHECK(!index.GetTxByCollateral(proRegTx.collateralOutpoint));
+    BOOST_CHECK(!index.HasProTxRefs(regTx->GetHash()));
+
+    index.Clear();
+    BOOST_CHECK_EQUAL(index.Size(), 0U);
+    BOOST_CHECK(!index.HasProTxRefs(proTxHash));
+}
+
+BOOST_AUTO_TEST_CASE(assetunlock_and_mnhf)
+{
+    CSpecialTxMempoolIndex index;
+
+    const auto unlockTx = MakeSpecialTx(CAssetUnlockPayload(1, 101, 1000, 10, uint256::ONE, CBLSSignature()));
+    const auto unlockTx2 = MakeSpecialTx(CAssetUnlockPayload(1, 102, 1000, 100, uint256::ONE, CBLSSignature()));
+    index.Add(unlockTx->GetHash(), ParseSpecialTxPayload(*unlockTx));
+    index.Add(unlockTx2->GetHash(), ParseSpecialTxPayload(*unlockTx2));
+
+    BOOST_CHECK(index.GetAssetUnlockByIndex(101) == unlockTx->GetHash());
+    BOOST_CHECK(index.GetAssetUnlockByIndex(102) == unlockTx2->GetHash());
+    BOOST_CHECK(!index.GetAssetUnlockByIndex(103));
+
+    BOOST_CHECK(index.GetExpiredAssetUnlocks(10 + CAssetUnlockPayload::HEIGHT_DIFF_EXPIRING).empty());
+    BOOST_CHECK(index.GetExpiredAssetUnlocks(11 + CAssetUnlockPayload::HEIGHT_DIFF_EXPIRING) == std::vector<uint256>{unlockTx->GetHash()});
+
+    index.Remove(unlockTx->GetHash());
+    BOOST_CHECK(!index.GetAssetUnlockByIndex(101));
+    BOOST_CHECK(index.GetExpiredAssetUnlocks(11 + CAssetUnlockPayload::HEIGHT_DIFF_EXPIRING).empty());
+
+    MNHFTxPayload mnhfPayload;
+    mnhfPayload.signal.versionBit = 10;
+    const auto mnhfTx = MakeSpecialTx(mnhfPayload);
+    index.Add(mnhfTx->GetHash(), ParseSpecialTxPayload(*mnhfTx));
+    const auto payload = index.GetPayload(mnhfTx->GetHash());
+    BOOST_REQUIRE(payload != nullptr);
+    BOOST_REQUIRE(payload->Get<MNHFTxPayload>() != nullptr);
+    BOOST_CHECK_EQUAL(payload->Get<MNHFTxPayload>()->signal.versionBit, 10);
+    index.Remove(mnhfTx->GetHash());
+    BOOST_CHECK(index.GetPayload(mnhfTx->GetHash()) == nullptr);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
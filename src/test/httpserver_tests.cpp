@@ -0,0 +1,116 @@
+// Copyright (c) 2024 The Dash Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <httpserver.h>
+#include <test/util/setup_common.h>
+#include <util/system.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <vector>
+
+struct HTTPServerTestingSetup : public BasicTestingSetup {
+    ~HTTPServerTestingSetup() { StopHTTPServer(); }
+
+    /// Set up the work classes from the given command line
+    bool InitWorkClasses(const std::vector<std::string>& options)
+    {
+        ArgsManager args;
+        for (const std::string& name : {"-rpcmethodclass", "-rpcthreads", "-rpcworkclass", "-rpcworkqueue"}) {
+            args.AddArg(name + "=<v>", "", ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
+        }
+        std::vector<const char*> argv{"testdash"};
+        for (const std::string& option : options) {
+            argv.push_back(option.c_str());
+        }
+        std::string error;
+        BOOST_REQUIRE(args.ParseParameters(argv.size(), argv.data(), error));
+        return InitHTTPWorkClasses(args);
+    }
+
+    static std::string Request(const std::string& method)
+    {
+        return R"({"jsonrpc": "1.0", "id": "test", "method": ")" + method + R"(", "params": []})";
+    }
+};
+
+BOOST_FIXTURE_TEST_SUITE(httpserver_tests, HTTPServerTestingSetup)
+
+BOOST_AUTO_TEST_CASE(work_class_default)
+{
+    // without -rpcworkclass everything is served by a single queue, even the slow methods
+    BOOST_REQUIRE(InitWorkClasses({"-rpcthreads=3", "-rpcworkqueue=5"}));
+    const auto stats = GetHTTPWorkClassStats();
+    BOOST_REQUIRE_EQUAL(stats.size(), 1U);
+    BOOST_CHECK_EQUAL(stats[0].name, HTTP_WORK_CLASS_DEFAULT);
+    BOOST_CHECK_EQUAL(stats[0].threads, 3);
+    BOOST_CHECK_EQUAL(stats[0].max_depth, 5U);
+    for (const auto& method : DEFAULT_HTTP_HEAVY_METHODS) {
+        BOOST_CHECK_EQUAL(GetHTTPWorkClassName(Request(method)), HTTP_WORK_CLASS_DEFAULT);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(work_class_options)
+{
+    // creating the heavy class moves the known slow methods there, the mapping can be overridden
+    BOOST_REQUIRE(InitWorkClasses({"-rpcworkclass=heavy:2:8", "-rpcworkclass=wallet:1:4",
+                                   "-rpcmethodclass=sendtoaddress:wallet", "-rpcmethodclass=quorum:default"}));
+    const auto stats = GetHTTPWorkClassStats();
+    BOOST_REQUIRE_EQUAL(stats.size(), 3U);
+    BOOST_CHECK_EQUAL(stats[0].name, HTTP_WORK_CLASS_DEFAULT);
+    BOOST_CHECK_EQUAL(stats[0].threads, DEFAULT_HTTP_THREADS);
+    BOOST_CHECK_EQUAL(stats[0].max_depth, size_t(DEFAULT_HTTP_WORKQUEUE));
+    BOOST_CHECK_EQUAL(stats[1].name, HTTP_WORK_CLASS_HEAVY);
+    BOOST_CHECK_EQUAL(stats[1].threads, 2);
+    BOOST_CHECK_EQUAL(stats[1].max_depth, 8U);
+    BOOST_CHECK_EQUAL(stats[2].name, "wallet");
+    BOOST_CHECK_EQUAL(stats[2].threads, 1);
+    BOOST_CHECK_EQUAL(stats[2].max_depth, 4U);
+
+    BOOST_CHECK_EQUAL(GetHTTPWorkClassName(Request("protx")), HTTP_WORK_CLASS_HEAVY);
+    BOOST_CHECK_EQUAL(GetHTTPWorkClassName(Request("quorum")), HTTP_WORK_CLASS_DEFAULT);
+    BOOST_CHECK_EQUAL(GetHTTPWorkClassName(Request("sendtoaddress")), "wallet");
+    BOOST_CHECK_EQUAL(GetHTTPWorkClassName(Request("getblockcount")), HTTP_WORK_CLASS_DEFAULT);
+}
+
+BOOST_AUTO_TEST_CASE(work_class_invalid_options)
+{
+    BOOST_CHECK(!InitWorkClasses({"-rpcworkclass=heavy:2"}));
+    BOOST_CHECK(!InitWorkClasses({"-rpcworkclass=heavy:0:8"}));
+    BOOST_CHECK(!InitWorkClasses({"-rpcworkclass=heavy:2:-1"}));
+    BOOST_CHECK(!InitWorkClasses({"-rpcworkclass=heavy:two:8"}));
+    BOOST_CHECK(!InitWorkClasses({"-rpcworkclass=:2:8"}));
+    BOOST_CHECK(!InitWorkClasses({"-rpcworkclass=default:2:8"}));
+    BOOST_CHECK(!InitWorkClasses({"-rpcmethodclass=protx:heavy"}));
+    BOOST_CHECK(!InitWorkClasses({"-rpcworkclass=heavy:2:8", "-rpcmethodclass=protx"}));
+    BOOST_CHECK(!InitWorkClasses({"-rpcworkclass=heavy:2:8", "-rpcmethodclass=:heavy"}));
+    BOOST_CHECK(!InitWorkClasses({"-rpcworkclass=heavy:2:8", "-rpcmethodclass=protx:heavy:default"}));
+}
+
+BOOST_AUTO_TEST_CASE(work_class_method_scan)
+{
+    BOOST_REQUIRE(InitWorkClasses({"-rpcworkclass=heavy:2:8"}));
+
+    // whitespace and the position of the method member don't matter
+    BOOST_CHECK_EQUAL(GetHTTPWorkClassName(" \r\n{\"method\"\t:\n \"protx\"}"), HTTP_WORK_CLASS_HEAVY);
+    BOOST_CHECK_EQUAL(GetHTTPWorkClassName(R"({"params": [], "id": 1, "method": "quorum"})"), HTTP_WORK_CLASS_HEAVY);
+
+    // anything which isn't a plain request object goes to the default queue
+    BOOST_CHECK_EQUAL(GetHTTPWorkClassName(""), HTTP_WORK_CLASS_DEFAULT);
+    BOOST_CHECK_EQUAL(GetHTTPWorkClassName("protx"), HTTP_WORK_CLASS_DEFAULT);
+    BOOST_CHECK_EQUAL(GetHTTPWorkClassName(R"([{"method": "protx"}])"), HTTP_WORK_CLASS_DEFAULT);
+    BOOST_CHECK_EQUAL(GetHTTPWorkClassName(R"({"method": protx})"), HTTP_WORK_CLASS_DEFAULT);
+    BOOST_CHECK_EQUAL(GetHTTPWorkClassName(R"({"method" "protx"})"), HTTP_WORK_CLASS_DEFAULT);
+    BOOST_CHECK_EQUAL(GetHTTPWorkClassName(R"({"method": "protx)"), HTTP_WORK_CLASS_DEFAULT);
+    BOOST_CHECK_EQUAL(GetHTTPWorkClassName(R"({"method":)"), HTTP_WORK_CLASS_DEFAULT);
+    BOOST_CHECK_EQUAL(GetHTTPWorkClassName(R"({"method": "Protx"})"), HTTP_WORK_CLASS_DEFAULT);
+
+    // the method name has to be within the scanned part of the body
+    const std::string padding(HTTP_WORK_CLASS_SCAN_SIZE, ' ');
+    BOOST_CHECK_EQUAL(GetHTTPWorkClassName(R"({"params": [], )" + padding + R"("method": "protx"})"), HTTP_WORK_CLASS_DEFAULT);
+    BOOST_CHECK_EQUAL(GetHTTPWorkClassName(R"({"method": "protx"})" + padding), HTTP_WORK_CLASS_HEAVY);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
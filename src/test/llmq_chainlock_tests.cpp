@@ -0,0 +1,91 @@
+// Copyright (c) 2024 The Dash Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <test/util/setup_common.h>
+
+#include <bls/bls.h>
+#include <bls/bls_worker.h>
+#include <hash.h>
+#include <llmq/chainlocks.h>
+#include <llmq/context.h>
+#include <masternode/sync.h>
+#include <random.h>
+#include <spork.h>
+#include <util/time.h>
+#include <validation.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+#include <thread>
+
+using namespace std::chrono_literals;
+
+class TestChainLocksHandler : public llmq::CChainLocksHandler
+{
+public:
+    TestChainLocksHandler(NodeContext& node, CBLSWorker& bls_worker, PeerMisbehavingFunc peer_misbehaving) :
+        CChainLocksHandler(node.chainman->ActiveChainstate(), *node.connman, *::masternodeSync, *node.llmq_ctx->qman,
+                           *node.llmq_ctx->sigman, *node.llmq_ctx->shareman, *::sporkManager, *node.mempool, bls_worker,
+                           std::move(peer_misbehaving))
+    {
+    }
+
+    using CChainLocksHandler::VerifyChainLockAsync;
+};
+
+/** Wait for the verification which runs on the BLS worker and the scheduler thread of the handler */
+template <typename Pred>
+static bool WaitFor(Pred pred)
+{
+    for (int i = 0; i < 1000; ++i) {
+        if (pred()) return true;
+        std::this_thread::sleep_for(10ms);
+    }
+    return false;
+}
+
+BOOST_FIXTURE_TEST_SUITE(llmq_chainlock_tests, TestingSetup)
+
+BOOST_AUTO_TEST_CASE(verify_async)
+{
+    CBLSWorker bls_worker;
+    bls_worker.Start();
+
+    Mutex cs_misbehaving;
+    std::vector<std::pair<NodeId, int>> misbehaving;
+    TestChainLocksHandler handler(m_node, bls_worker, [&](NodeId from, int howmuch) {
+        LOCK(cs_misbehaving);
+        misbehaving.emplace_back(from, howmuch);
+    });
+    const auto misbehaving_count = [&]() { return WITH_LOCK(cs_misbehaving, return misbehaving.size()); };
+
+    CBLSSecretKey quorum_key;
+    quorum_key.MakeNewKey();
+    // the block isn't known, so an accepted CLSIG is only recorded and not enforced
+    const uint256 block_hash = GetRandHash();
+    const uint256 sign_hash = GetRandHash();
+
+    // a CLSIG which isn't signed by the quorum costs the peer which sent it
+    CBLSSecretKey other_key;
+    other_key.MakeNewKey();
+    const llmq::CChainLockSig invalid(100, block_hash, other_key.Sign(sign_hash));
+    handler.VerifyChainLockAsync(1, invalid, ::SerializeHash(invalid), quorum_key.GetPublicKey(), sign_hash);
+    BOOST_REQUIRE(WaitFor([&]() { return misbehaving_count() != 0; }));
+    BOOST_CHECK(WITH_LOCK(cs_misbehaving, return misbehaving.front()) == std::make_pair(NodeId{1}, 10));
+    BOOST_CHECK(handler.GetBestChainLock().IsNull());
+
+    // a valid one becomes the best CLSIG
+    const llmq::CChainLockSig valid(100, block_hash, quorum_key.Sign(sign_hash));
+    handler.VerifyChainLockAsync(2, valid, ::SerializeHash(valid), quorum_key.GetPublicKey(), sign_hash);
+    BOOST_REQUIRE(WaitFor([&]() { return !handler.GetBestChainLock().IsNull(); }));
+    const llmq::CChainLockSig best = handler.GetBestChainLock();
+    BOOST_CHECK_EQUAL(best.getHeight(), 100);
+    BOOST_CHECK(best.getBlockHash() == block_hash);
+    BOOST_CHECK_EQUAL(misbehaving_count(), 1U);
+
+    bls_worker.Stop();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,98 @@
+// Copyright (c) 2023 The Dash Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <test/util/setup_common.h>
+#include <util/metrics.h>
+
+#include <limits>
+#include <thread>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(metrics_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(metrics_registry)
+{
+    auto& counter = metrics::GetCounter("test.registry.counter");
+    BOOST_CHECK_EQUAL(&counter, &metrics::GetCounter("test.registry.counter"));
+    BOOST_CHECK(&counter != &metrics::GetCounter("test.registry.other"));
+
+    counter.Inc();
+    counter.Inc(4);
+    metrics::GetGauge("test.registry.gauge").Set(2.5);
+    metrics::GetHistogram("test.registry.histogram").Observe(10);
+
+    const auto snapshot = metrics::GetSnapshot();
+    BOOST_CHECK_EQUAL(snapshot.counters.at("test.registry.counter"), 5U);
+    BOOST_CHECK_EQUAL(snapshot.gauges.at("test.registry.gauge"), 2.5);
+    BOOST_CHECK_EQUAL(snapshot.histograms.at("test.registry.histogram").count, 1U);
+}
+
+BOOST_AUTO_TEST_CASE(metrics_counter_threads)
+{
+    auto& counter = metrics::GetCounter("test.threads.counter");
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i) {
+        threads.emplace_back([&counter] {
+            for (int j = 0; j < 1000; ++j) counter.Inc();
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    BOOST_CHECK_EQUAL(counter.Get(), 4000U);
+}
+
+BOOST_AUTO_TEST_CASE(metrics_histogram)
+{
+    metrics::Histogram hist;
+    BOOST_CHECK_EQUAL(hist.GetSnapshot().Quantile(0.5), 0U);
+
+    for (int i = 0; i < 90; ++i) hist.Observe(100);
+    for (int i = 0; i < 10; ++i) hist.Observe(5000);
+    // negative durations count as zero
+    hist.Observe(-1);
+
+    const auto snapshot = hist.GetSnapshot();
+    BOOST_CHECK_EQUAL(snapshot.count, 101U);
+    BOOST_CHECK_EQUAL(snapshot.sum, 90U * 100 + 10U * 5000);
+    BOOST_CHECK_EQUAL(snapshot.max, 5000U);
+    BOOST_CHECK_EQUAL(snapshot.buckets[0], 1U);
+    // 100 falls into [64, 128), 5000 into [4096, 8192)
+    BOOST_CHECK_EQUAL(snapshot.buckets[7], 90U);
+    BOOST_CHECK_EQUAL(snapshot.buckets[13], 10U);
+    BOOST_CHECK_EQUAL(snapshot.Quantile(0.5), 128U);
+    BOOST_CHECK_EQUAL(snapshot.Quantile(0.9), 128U);
+    // quantiles never exceed the largest observation
+    BOOST_CHECK_EQUAL(snapshot.Quantile(0.99), 5000U);
+
+    hist.Observe(std::numeric_limits<int64_t>::max());
+    BOOST_CHECK_EQUAL(hist.GetSnapshot().buckets[metrics::Histogram::BUCKETS - 1], 1U);
+}
+
+BOOST_AUTO_TEST_CASE(metrics_histogram_since)
+{
+    metrics::Histogram hist;
+    for (int i = 0; i < 10; ++i) hist.Observe(5000);
+    const auto first = hist.GetSnapshot();
+    BOOST_CHECK_EQUAL(first.Since(metrics::Histogram::Snapshot{}).count, 10U);
+    BOOST_CHECK_EQUAL(first.Since(metrics::Histogram::Snapshot{}).max, 5000U);
+
+    // only the observations of the second period count, the slow ones of the first period are gone
+    for (int i = 0; i < 4; ++i) hist.Observe(100);
+    const auto period = hist.GetSnapshot().Since(first);
+    BOOST_CHECK_EQUAL(period.count, 4U);
+    BOOST_CHECK_EQUAL(period.sum, 4U * 100);
+    BOOST_CHECK_EQUAL(period.buckets[7], 4U);
+    BOOST_CHECK_EQUAL(period.buckets[13], 0U);
+    BOOST_CHECK_EQUAL(period.max, 128U);
+    BOOST_CHECK_EQUAL(period.Quantile(0.99), 128U);
+
+    // nothing observed in a period
+    const auto idle = hist.GetSnapshot().Since(hist.GetSnapshot());
+    BOOST_CHECK_EQUAL(idle.count, 0U);
+    BOOST_CHECK_EQUAL(idle.max, 0U);
+    BOOST_CHECK_EQUAL(idle.Quantile(0.5), 0U);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -7,6 +7,7 @@
 #include <consensus/merkle.h>
 #include <consensus/tx_verify.h>
 #include <consensus/validation.h>
+#include <evo/deterministicmns.h>
 #include <evo/evodb.h>
 #include <governance/governance.h>
 #include <llmq/blockprocessor.h>
@@ -16,6 +17,7 @@
 #include <miner.h>
 #include <policy/policy.h>
 #include <pow.h>
+#include <script/interpreter.h>
 #include <script/standard.h>
 #include <spork.h>
 #include <uint256.h>
@@ -549,4 +551,131 @@ BOOST_AUTO_TEST_CASE(CreateNewBlock_validity)
     fCheckpointsEnabled = true;
 }
 
+BOOST_AUTO_TEST_CASE(cbtx_template_key)
+{
+    const CBlockIndex* tip = WITH_LOCK(cs_main, return ::ChainActive().Tip());
+    const CDeterministicMNList mnList;
+    const auto calc_key = [&](const std::vector<CMutableTransaction>& txs) {
+        CBlock block;
+        // the coinbase is not created yet when the key is calculated
+        block.vtx.emplace_back();
+        for (const auto& tx : txs) {
+            block.vtx.push_back(MakeTransactionRef(tx));
+        }
+        return CalcCbTxTemplateKey(block, tip, mnList, CCbTx::Version::CLSIG_AND_BALANCE, 0);
+    };
+    const auto spend = [](const CMutableTransaction& prev, CAmount nValue) {
+        CMutableTransaction tx;
+        tx.vin.emplace_back(COutPoint(prev.GetHash(), 0));
+        tx.vout.emplace_back(nValue, CScript() << OP_TRUE);
+        return tx;
+    };
+
+    CMutableTransaction special;
+    special.nVersion = 3;
+    special.nType = TRANSACTION_ASSET_LOCK;
+    special.vin.emplace_back(COutPoint(InsecureRand256(), 0));
+    special.vout.emplace_back(COIN, CScript() << OP_TRUE);
+    CMutableTransaction unrelated;
+    unrelated.vin.emplace_back(COutPoint(InsecureRand256(), 0));
+    unrelated.vout.emplace_back(COIN, CScript() << OP_TRUE);
+
+    const uint256 key = calc_key({special});
+    BOOST_CHECK(key != calc_key({}));
+    // normal transactions which don't depend on special ones don't matter
+    BOOST_CHECK(key == calc_key({special, unrelated}));
+    BOOST_CHECK(key == calc_key({special, spend(unrelated, 1)}));
+    // spends of outputs of special transactions in the block do, also through other transactions
+    const CMutableTransaction child = spend(special, 1);
+    BOOST_CHECK(key != calc_key({special, child}));
+    BOOST_CHECK(calc_key({special, child}) != calc_key({special, spend(special, 2)}));
+    BOOST_CHECK(calc_key({special, child, spend(child, 1)}) != calc_key({special, child, spend(child, 2)}));
+}
+
+static CMutableTransaction SpendCoinbase(const CTransactionRef& coinbase, const CKey& key, CAmount nFee)
+{
+    CMutableTransaction tx;
+    tx.vin.emplace_back(COutPoint(coinbase->GetHash(), 0));
+    // the mempool only accepts standard outputs
+    tx.vout.emplace_back(coinbase->vout[0].nValue - nFee, CScript() << ToByteVector(key.GetPubKey()) << OP_CHECKSIG);
+    std::vector<unsigned char> vchSig;
+    const uint256 hash = SignatureHash(coinbase->vout[0].scriptPubKey, tx, 0, SIGHASH_ALL, 0, SigVersion::BASE);
+    BOOST_CHECK(key.Sign(hash, vchSig));
+    vchSig.push_back((unsigned char)SIGHASH_ALL);
+    tx.vin[0].scriptSig << vchSig;
+    return tx;
+}
+
+/** Hashes of the transactions of a template which came from the mempool, in block order */
+static std::vector<uint256> MempoolTxids(const CBlockTemplate& block_template)
+{
+    std::vector<uint256> ret;
+    for (const auto& tx : block_template.block.vtx) {
+        if (tx->IsCoinBase() || tx->nType == TRANSACTION_QUORUM_COMMITMENT) continue;
+        ret.push_back(tx->GetHash());
+    }
+    return ret;
+}
+
+BOOST_FIXTURE_TEST_CASE(block_template_cache, TestChainDIP3Setup)
+{
+    const CScript scriptPubKey = CScript() << OP_TRUE;
+    BlockTemplateCache cache;
+    const auto create = [&](BlockTemplateCache* template_cache) {
+        return BlockAssembler(*sporkManager, *governance, *m_node.llmq_ctx, *m_node.evodb, ::ChainstateActive(), *m_node.mempool, Params(), template_cache).CreateNewBlock(scriptPubKey);
+    };
+    const auto to_mempool = [&](const CMutableTransaction& tx) {
+        LOCK(cs_main);
+        TxValidationState state;
+        return AcceptToMemoryPool(::ChainstateActive(), *m_node.mempool, state, MakeTransactionRef(tx), false /* bypass_limits */, 0 /* nAbsurdFee */);
+    };
+    const auto check_valid = [&](const CBlockTemplate& block_template) {
+        LOCK(cs_main);
+        BlockValidationState state;
+        BOOST_CHECK(TestBlockValidity(state, *m_node.llmq_ctx->clhandler, *m_node.evodb, Params(), ::ChainstateActive(), block_template.block, ::ChainActive().Tip(), false, false));
+        BOOST_CHECK(state.IsValid());
+    };
+
+    auto block_template = create(&cache);
+    BOOST_CHECK(MempoolTxids(*block_template).empty());
+
+    // transactions entering the mempool which pay less are added after the ones of the last template
+    const CMutableTransaction tx1 = SpendCoinbase(m_coinbase_txns[0], coinbaseKey, 20000);
+    const CMutableTransaction tx2 = SpendCoinbase(m_coinbase_txns[1], coinbaseKey, 10000);
+    const CMutableTransaction tx3 = SpendCoinbase(m_coinbase_txns[2], coinbaseKey, 30000);
+    BOOST_REQUIRE(to_mempool(tx1));
+    block_template = create(&cache);
+    BOOST_CHECK(MempoolTxids(*block_template) == std::vector<uint256>({tx1.GetHash()}));
+    BOOST_REQUIRE(to_mempool(tx2));
+    block_template = create(&cache);
+    BOOST_CHECK(MempoolTxids(*block_template) == std::vector<uint256>({tx1.GetHash(), tx2.GetHash()}));
+    check_valid(*block_template);
+
+    // one which pays more is selected before them
+    BOOST_REQUIRE(to_mempool(tx3));
+    block_template = create(&cache);
+    BOOST_CHECK(MempoolTxids(*block_template) == std::vector<uint256>({tx3.GetHash(), tx1.GetHash(), tx2.GetHash()}));
+    check_valid(*block_template);
+
+    // the template is the same as one built from scratch
+    const auto fresh_template = create(nullptr);
+    BOOST_CHECK(MempoolTxids(*fresh_template) == MempoolTxids(*block_template));
+    BOOST_CHECK(block_template->block.vtx[0]->GetHash() == fresh_template->block.vtx[0]->GetHash());
+    BOOST_CHECK_EQUAL(block_template->vTxFees[0], -60000);
+    BOOST_CHECK_EQUAL(fresh_template->vTxFees[0], -60000);
+
+    // a transaction leaving the mempool makes the next template start from scratch
+    WITH_LOCK(m_node.mempool->cs, m_node.mempool->removeRecursive(CTransaction(tx1), MemPoolRemovalReason::CONFLICT));
+    block_template = create(&cache);
+    BOOST_CHECK(MempoolTxids(*block_template) == std::vector<uint256>({tx3.GetHash(), tx2.GetHash()}));
+    check_valid(*block_template);
+
+    // and so does a new tip
+    CreateAndProcessBlock({}, coinbaseKey);
+    block_template = create(&cache);
+    BOOST_CHECK(block_template->block.hashPrevBlock == WITH_LOCK(cs_main, return ::ChainActive().Tip()->GetBlockHash()));
+    BOOST_CHECK(MempoolTxids(*block_template) == std::vector<uint256>({tx3.GetHash(), tx2.GetHash()}));
+    check_valid(*block_template);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -4,6 +4,7 @@
 
 #include <context.h>
 #include <core_io.h>
+#include <httpserver.h>
 #include <interfaces/chain.h>
 #include <node/context.h>
 #include <rpc/blockchain.h>
@@ -295,6 +296,48 @@ BOOST_AUTO_TEST_CASE(json_parse_errors)
     BOOST_CHECK_THROW(ParseNonRFCJSONValue("3J98t1WpEZ73CNmQviecrnyiWrnqRhWNL"), std::runtime_error);
 }
 
+BOOST_AUTO_TEST_CASE(rpc_reply_stream)
+{
+    UniValue result(UniValue::VOBJ);
+    result.pushKV("str", "quote \" and \\ backslash");
+    result.pushKV("num", 1.5);
+    result.pushKV("bool", true);
+    result.pushKV("null", NullUniValue);
+    result.pushKV("empty_obj", UniValue(UniValue::VOBJ));
+    UniValue arr(UniValue::VARR);
+    for (int i = 0; i < 100; ++i) {
+        UniValue entry(UniValue::VOBJ);
+        entry.pushKV("i", i);
+        entry.pushKV("hash", std::string(64, 'a' + i % 26));
+        arr.push_back(entry);
+    }
+    result.pushKV("arr", arr);
+    const UniValue id("stream-test");
+
+    for (const size_t chunk_size : {1, 7, 100, 100000}) {
+        std::string streamed;
+        size_t chunks{0};
+        BOOST_CHECK(JSONRPCReplyStream(result, NullUniValue, id, chunk_size, [&](const std::string& chunk) {
+            ++chunks;
+            streamed += chunk;
+            return true;
+        }));
+        BOOST_CHECK_EQUAL(streamed, JSONRPCReply(result, NullUniValue, id));
+        BOOST_CHECK(chunk_size >= streamed.size() ? chunks == 1 : chunks > 1);
+    }
+
+    // errors replace the result
+    const UniValue error = JSONRPCError(RPC_MISC_ERROR, "error");
+    std::string streamed;
+    BOOST_CHECK(JSONRPCReplyStream(result, error, id, 16, [&](const std::string& chunk) { streamed += chunk; return true; }));
+    BOOST_CHECK_EQUAL(streamed, JSONRPCReply(result, error, id));
+
+    // stops once the client is gone
+    size_t chunks{0};
+    BOOST_CHECK(!JSONRPCReplyStream(result, NullUniValue, id, 16, [&](const std::string& chunk) { return ++chunks < 3; }));
+    BOOST_CHECK_EQUAL(chunks, 3U);
+}
+
 BOOST_AUTO_TEST_CASE(rpc_ban)
 {
     BOOST_CHECK_NO_THROW(CallRPC(std::string("clearbanned")));
@@ -527,4 +570,26 @@ BOOST_AUTO_TEST_CASE(rpc_bls)
     BOOST_CHECK_EQUAL(find_value(r.get_obj(), "public").get_str(), "b379c28e0f50546906fe733f1222c8f7e39574d513790034f1fec1476286eb652a350c8c0e630cd2cc60d10c26d6f6ee");
 }
 
+BOOST_AUTO_TEST_CASE(rpc_getrpcinfo_work_queues)
+{
+    // no HTTP server, no work queues
+    UniValue r = CallRPC("getrpcinfo");
+    BOOST_CHECK(find_value(r.get_obj(), "work_queues").get_array().empty());
+
+    BOOST_REQUIRE(InitHTTPWorkClasses(*m_node.args));
+    r = CallRPC("getrpcinfo");
+    const UniValue& queues = find_value(r.get_obj(), "work_queues").get_array();
+    BOOST_REQUIRE_EQUAL(queues.size(), 1U);
+    const UniValue& queue = queues[0].get_obj();
+    BOOST_CHECK_EQUAL(find_value(queue, "class").get_str(), HTTP_WORK_CLASS_DEFAULT);
+    BOOST_CHECK_EQUAL(find_value(queue, "threads").get_int(), DEFAULT_HTTP_THREADS);
+    BOOST_CHECK_EQUAL(find_value(queue, "depth").get_int(), 0);
+    BOOST_CHECK_EQUAL(find_value(queue, "max_depth").get_int(), DEFAULT_HTTP_WORKQUEUE);
+    BOOST_CHECK_EQUAL(find_value(queue, "requests").get_int(), 0);
+    BOOST_CHECK_EQUAL(find_value(queue, "rejected").get_int(), 0);
+    BOOST_CHECK_EQUAL(find_value(queue, "avg_queue_time").get_int(), 0);
+    BOOST_CHECK_EQUAL(find_value(queue, "max_queue_time").get_int(), 0);
+    StopHTTPServer();
+}
+
 BOOST_AUTO_TEST_SUITE_END()
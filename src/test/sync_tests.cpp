@@ -7,7 +7,9 @@
 
 #include <boost/test/unit_test.hpp>
 
+#include <algorithm>
 #include <mutex>
+#include <thread>
 
 namespace {
 template <typename MutexType>
@@ -126,6 +128,59 @@ BOOST_AUTO_TEST_CASE(inconsistent_lock_order_detected)
 #endif // DEBUG_LOCKORDER
 }
 
+BOOST_AUTO_TEST_CASE(lock_profile)
+{
+    const uint32_t prev_rate = g_lock_profile_rate.exchange(1);
+    ResetLockProfile();
+
+    Mutex mutex;
+    int uncontended_line{0};
+    int contended_line{0};
+    // samples of other threads are flushed when they exit
+    std::thread([&] {
+        for (int i = 0; i < 3; ++i) {
+            uncontended_line = __LINE__ + 1;
+            LOCK(mutex);
+        }
+    }).join();
+    std::thread waiter;
+    {
+        LOCK(mutex);
+        waiter = std::thread([&] {
+            contended_line = __LINE__ + 1;
+            LOCK(mutex);
+        });
+        // only release the mutex once the waiter found it taken
+        while (g_lock_profile_waiters == 0) {
+            std::this_thread::yield();
+        }
+    }
+    waiter.join();
+
+    const auto profile = GetLockProfile();
+    const auto find_site = [&](int line) {
+        return std::find_if(profile.begin(), profile.end(), [&](const LockSiteStats& site) {
+            return site.line == line && site.file == __FILE__;
+        });
+    };
+    const auto uncontended = find_site(uncontended_line);
+    BOOST_REQUIRE(uncontended != profile.end());
+    BOOST_CHECK_EQUAL(uncontended->name, "mutex");
+    BOOST_CHECK_EQUAL(uncontended->samples, 3U);
+    BOOST_CHECK_EQUAL(uncontended->contended, 0U);
+    BOOST_CHECK_EQUAL(uncontended->wait_total_ns, 0);
+
+    const auto contended = find_site(contended_line);
+    BOOST_REQUIRE(contended != profile.end());
+    BOOST_CHECK_EQUAL(contended->samples, 1U);
+    BOOST_CHECK_EQUAL(contended->contended, 1U);
+    BOOST_CHECK(contended->wait_total_ns > 0);
+    BOOST_CHECK_EQUAL(contended->wait_max_ns, contended->wait_total_ns);
+
+    ResetLockProfile();
+    g_lock_profile_rate = prev_rate;
+}
+
 /* Double lock would produce an undefined behavior. Thus, we only do that if
  * DEBUG_LOCKORDER is activated to detect it. We don't want non-DEBUG_LOCKORDER
  * build to produce tests that exhibit known undefined behavior. */
@@ -12,6 +12,7 @@
 #include <consensus/validation.h>
 #include <deploymentstatus.h>
 #include <crypto/sha256.h>
+#include <crypto/x11.h>
 #include <flat-database.h>
 #include <governance/governance.h>
 #include <index/txindex.h>
@@ -64,6 +65,7 @@
 #include <coinjoin/context.h>
 #include <coinjoin/server.h>
 #include <evo/cbtx.h>
+#include <evo/cbtxindex.h>
 #include <evo/creditpool.h>
 #include <evo/deterministicmns.h>
 #include <evo/evodb.h>
@@ -113,7 +115,9 @@ void DashTestSetup(NodeContext& node)
     node.coinjoin_loader = interfaces::MakeCoinJoinLoader(*node.cj_ctx->walletman);
 #endif // ENABLE_WALLET
     ::deterministicMNManager = std::make_unique<CDeterministicMNManager>(chainstate, *node.connman, *node.evodb);
-    node.llmq_ctx = std::make_unique<LLMQContext>(chainstate, *node.connman, *node.evodb, *sporkManager, *node.mempool, node.peerman, true, false);
+    node.llmq_ctx = std::make_unique<LLMQContext>(chainstate, *node.connman, *node.evodb, *sporkManager, *node.mempool, node.peerman,
+                                                  [&node](NodeId from, int howmuch) { if (node.peerman) node.peerman->Misbehaving(from, howmuch); },
+                                                  true, false);
 }
 
 void DashTestSetupClose(NodeContext& node)
@@ -157,6 +161,7 @@ BasicTestingSetup::BasicTestingSetup(const std::string& chainName, const std::ve
     AppInitParameterInteraction(*m_node.args);
     LogInstance().StartLogging();
     SHA256AutoDetect();
+    X11AutoDetect();
     ECC_Start();
     BLSInit();
     SetupEnvironment();
@@ -176,6 +181,7 @@ BasicTestingSetup::BasicTestingSetup(const std::string& chainName, const std::ve
     llmq::quorumSnapshotManager.reset(new llmq::CQuorumSnapshotManager(*m_node.evodb));
     creditPoolManager = std::make_unique<CCreditPoolManager>(*m_node.evodb);
     m_node.creditPoolManager = creditPoolManager.get();
+    cbTxIndex = std::make_unique<CCbTxIndex>(*m_node.evodb);
     static bool noui_connected = false;
     if (!noui_connected) {
         noui_connect();
@@ -190,6 +196,7 @@ BasicTestingSetup::~BasicTestingSetup()
     llmq::quorumSnapshotManager.reset();
     creditPoolManager.reset();
     m_node.creditPoolManager = nullptr;
+    cbTxIndex.reset();
     m_node.mnhf_manager.reset();
     m_node.evodb.reset();
 
@@ -226,6 +233,7 @@ ChainTestingSetup::ChainTestingSetup(const std::string& chainName, const std::ve
 
     creditPoolManager = std::make_unique<CCreditPoolManager>(*m_node.evodb);
     m_node.creditPoolManager = creditPoolManager.get();
+    cbTxIndex = std::make_unique<CCbTxIndex>(*m_node.evodb);
 
 
     // Start script-checking threads. Set g_parallel_script_checks to true so they are used.
@@ -239,6 +247,7 @@ ChainTestingSetup::~ChainTestingSetup()
     m_node.scheduler->stop();
     creditPoolManager.reset();
     m_node.creditPoolManager = nullptr;
+    cbTxIndex.reset();
     StopScriptCheckWorkerThreads();
     GetMainSignals().FlushBackgroundCallbacks();
     GetMainSignals().UnregisterBackgroundSignalScheduler();
@@ -12,8 +12,11 @@
 #include <node/utxo_snapshot.h>
 #include <random.h>
 #include <rpc/blockchain.h>
+#include <rpc/server.h>
+#include <shutdown.h>
 #include <spork.h>
 #include <sync.h>
+#include <test/util/index.h>
 #include <test/util/setup_common.h>
 #include <uint256.h>
 #include <validation.h>
@@ -208,6 +211,7 @@ CreateAndActivateUTXOSnapshot(NodeContext& node, const fs::path root, F malleati
     CAutoFile auto_infile{infile, SER_DISK, CLIENT_VERSION};
     SnapshotMetadata metadata;
     auto_infile >> metadata;
+    BOOST_REQUIRE(CEvoDB::VerifySnapshot(auto_infile));
 
     malleation(auto_infile, metadata);
 
@@ -363,4 +367,175 @@ BOOST_FIXTURE_TEST_CASE(chainstatemanager_activate_snapshot, TestChain100Setup)
         loaded_snapshot_blockhash);
 }
 
+//! Test the EvoDB contents bundled with a snapshot.
+BOOST_FIXTURE_TEST_CASE(chainstatemanager_snapshot_evodb, TestChain100Setup)
+{
+    const uint256 tip_hash = WITH_LOCK(::cs_main, return m_node.chainman->ActiveTip()->GetBlockHash());
+    const auto dump = [&](const std::string& name) {
+        const fs::path path = m_path_root / name;
+        CAutoFile outfile{fsbridge::fopen(path, "wb"), SER_DISK, CLIENT_VERSION};
+        return std::make_pair(path, CreateUTXOSnapshot(m_node, m_node.chainman->ActiveChainstate(), outfile));
+    };
+    const auto [snapshot_path, result] = dump("test_snapshot_evodb.dat");
+
+    // data depending on the history of the node doesn't change the EvoDB section: node-local quorum data, entries
+    // of blocks which are not part of the chain and index entries of blocks connected before the index existed
+    const auto local_key = std::make_pair(std::string{"q_Qsk"}, uint256::ONE);
+    m_node.evodb->GetRawDB().Write(local_key, uint256::ONE);
+    m_node.evodb->GetRawDB().Write(std::make_pair(std::string{"dmn_D3"}, uint256::ONE), uint256::ONE);
+    m_node.evodb->GetRawDB().Write(std::make_pair(std::string{"cbi"}, uint256::ONE), uint256::ONE);
+    m_node.evodb->GetRawDB().Write(std::make_pair(std::string{"llmq_S"}, uint256::ONE), uint256::ONE);
+    m_node.evodb->GetRawDB().Erase(std::make_pair(std::string{"cbi"}, tip_hash));
+    const UniValue result2 = dump("test_snapshot_evodb2.dat").second;
+    BOOST_CHECK_EQUAL(find_value(result2, "evodb_entries").get_int64(), find_value(result, "evodb_entries").get_int64());
+    BOOST_CHECK_EQUAL(find_value(result2, "evodb_hash").get_str(), find_value(result, "evodb_hash").get_str());
+
+    std::vector<unsigned char> contents;
+    {
+        CAutoFile infile{fsbridge::fopen(snapshot_path, "rb"), SER_DISK, CLIENT_VERSION};
+        SnapshotMetadata metadata;
+        infile >> metadata;
+        const long evodb_pos = ftell(infile.Get());
+        const auto stats = CEvoDB::VerifySnapshot(infile);
+        BOOST_REQUIRE(stats);
+        BOOST_CHECK_EQUAL(stats->entries, find_value(result, "evodb_entries").get_int64());
+        BOOST_CHECK_EQUAL(stats->hash.ToString(), find_value(result, "evodb_hash").get_str());
+        // the index entries of all blocks but the genesis block, which are fewer than EVODB_SNAPSHOT_CHAIN_DEPTH
+        BOOST_CHECK_EQUAL(stats->store_entries[static_cast<size_t>(EvoDBStore::CBTX_INDEX)], 100U);
+
+        CEvoDB evodb(1 << 20, /* fMemory */ true);
+        evodb.GetRawDB().Write(local_key, uint256::ZERO);
+        evodb.Write(EVODB_BEST_BLOCK, uint256::ONE);
+        BOOST_REQUIRE(fseek(infile.Get(), evodb_pos, SEEK_SET) == 0);
+        BOOST_REQUIRE(evodb.LoadSnapshot(infile, *stats));
+        BOOST_CHECK(evodb.VerifyBestBlock(tip_hash));
+        BOOST_CHECK(evodb.Exists(std::make_pair(std::string{"cbi"}, tip_hash)));
+        // local data of the node loading the snapshot is kept
+        uint256 local_value;
+        BOOST_CHECK(evodb.Read(local_key, local_value));
+        BOOST_CHECK_EQUAL(local_value, uint256::ZERO);
+
+        BOOST_REQUIRE(fseek(infile.Get(), 0, SEEK_END) == 0);
+        contents.resize(ftell(infile.Get()));
+        BOOST_REQUIRE(fseek(infile.Get(), 0, SEEK_SET) == 0);
+        infile.read((char*)contents.data(), contents.size());
+    }
+
+    // flipping a byte in the EvoDB section, right behind the metadata and the number of entries, is detected
+    const size_t metadata_size = ::GetSerializeSize(SnapshotMetadata{}, CLIENT_VERSION);
+    contents.at(metadata_size + sizeof(uint64_t) + 1) ^= 0x01;
+    const fs::path bad_path = m_path_root / "test_snapshot_evodb_bad.dat";
+    {
+        CAutoFile badfile{fsbridge::fopen(bad_path, "wb"), SER_DISK, CLIENT_VERSION};
+        badfile.write((const char*)contents.data(), contents.size());
+    }
+    CAutoFile badfile{fsbridge::fopen(bad_path, "rb"), SER_DISK, CLIENT_VERSION};
+    SnapshotMetadata metadata;
+    badfile >> metadata;
+    BOOST_CHECK(!CEvoDB::VerifySnapshot(badfile));
+}
+
+//! Test that loadtxoutset only accepts the EvoDB contents committed in the assumeutxo data and that the node
+//! continues from the snapshot after a restart.
+BOOST_FIXTURE_TEST_CASE(chainstatemanager_loadtxoutset_evodb, TestChain100Setup)
+{
+    ChainstateManager& chainman = *Assert(m_node.chainman);
+    const auto dump = [&](const std::string& name) {
+        const fs::path path = m_path_root / name;
+        CAutoFile outfile{fsbridge::fopen(path, "wb"), SER_DISK, CLIENT_VERSION};
+        CreateUTXOSnapshot(m_node, chainman.ActiveChainstate(), outfile);
+        return path;
+    };
+    const auto load = [&](const fs::path& path) {
+        CoreContext context{m_node};
+        JSONRPCRequest request(context);
+        request.strMethod = "loadtxoutset";
+        request.params.setArray();
+        request.params.push_back(path.string());
+        if (RPCIsInWarmup(nullptr)) SetRPCWarmupFinished();
+        return tableRPC.execute(request);
+    };
+    const auto has_message = [](const std::string& message) {
+        return [message](const UniValue& error) { return find_value(error, "message").get_str().find(message) != std::string::npos; };
+    };
+
+    const fs::path path_100 = dump("test_snapshot.100.dat");
+    mineBlocks(10);
+    const AssumeutxoData* au_data = ExpectedAssumeutxo(110, ::Params());
+    BOOST_REQUIRE(au_data);
+    BOOST_REQUIRE(!au_data->evodb_hash.IsNull());
+    const uint256 base_hash = WITH_LOCK(::cs_main, return chainman.ActiveTip()->GetBlockHash());
+    const fs::path path = dump("test_snapshot_evodb.dat");
+
+    // a mined commitment which is not part of the chain makes for EvoDB contents which are consistent in themselves
+    // but don't match the committed hash
+    const auto extra_key = std::make_pair(std::string{"q_mc"}, std::make_pair(uint8_t{100}, uint256::ONE));
+    m_node.evodb->GetRawDB().Write(extra_key, uint256::ONE);
+    const fs::path extra_path = dump("test_snapshot_evodb_extra.dat");
+    m_node.evodb->GetRawDB().Erase(extra_key);
+
+    // the node has connected blocks already
+    BOOST_CHECK_EXCEPTION(load(path), UniValue, has_message("hasn't connected any block"));
+
+    // go back to the genesis block, without marking the blocks as invalid
+    {
+        CBlockIndex* first = WITH_LOCK(::cs_main, return chainman.ActiveChain()[1]);
+        BlockValidationState state;
+        BOOST_REQUIRE(chainman.ActiveChainstate().InvalidateBlock(state, first));
+        LOCK(::cs_main);
+        chainman.ActiveChainstate().ResetBlockFailureFlags(first);
+        BOOST_REQUIRE_EQUAL(chainman.ActiveHeight(), 0);
+    }
+
+    // there is no assumeutxo data for height 100
+    BOOST_CHECK_EXCEPTION(load(path_100), UniValue, has_message("No assumeutxo data"));
+    BOOST_CHECK_EXCEPTION(load(extra_path), UniValue, has_message("Bad EvoDB content hash"));
+    BOOST_CHECK(!chainman.SnapshotBlockhash());
+    BOOST_CHECK(!FindSnapshotChainstate(GetDataDir()));
+
+    // the shutdown requested by loadtxoutset is signalled through the pipe init sets up
+    BOOST_REQUIRE(InitShutdownState());
+    const UniValue result = load(path);
+    BOOST_CHECK_EQUAL(find_value(result, "evodb_hash").get_str(), au_data->evodb_hash.ToString());
+    BOOST_CHECK_EQUAL(find_value(result, "base_height").get_int(), 110);
+    BOOST_CHECK(chainman.SnapshotBlockhash() == base_hash);
+    // the node shuts down to continue from the snapshot chainstate
+    BOOST_CHECK(ShutdownRequested());
+    AbortShutdown();
+    BOOST_CHECK(FindSnapshotChainstate(GetDataDir()) == base_hash);
+
+    // restart like init does: the snapshot chainstate is the only one and the managers are bound to it
+    WITH_LOCK(::cs_main, chainman.ActiveChainstate().ForceFlushStateToDisk());
+    IndexWaitSynced(*g_txindex);
+    g_txindex->Stop();
+    SyncWithValidationInterfaceQueue();
+    g_txindex.reset();
+    DashTestSetupClose(m_node);
+    {
+        LOCK(::cs_main);
+        chainman.Reset();
+        chainman.InitializeChainstate(m_node.mempool.get(), *m_node.mnhf_manager, *m_node.evodb, llmq::chainLocksHandler, llmq::quorumInstantSendManager, llmq::quorumBlockProcessor,
+                                      FindSnapshotChainstate(GetDataDir()));
+        UnloadBlockIndex(m_node.mempool.get(), chainman);
+        BOOST_REQUIRE(chainman.LoadBlockIndex());
+        CChainState& chainstate = chainman.ActiveChainstate();
+        chainstate.InitCoinsDB(/* cache_size_bytes */ 1 << 23, /* in_memory */ false, /* should_wipe */ false);
+        chainstate.InitCoinsCache(1 << 23);
+        BOOST_REQUIRE(chainstate.LoadChainTip());
+    }
+    DashTestSetup(m_node);
+    g_txindex = std::make_unique<TxIndex>(1 << 20, true);
+    BOOST_REQUIRE(g_txindex->Start(chainman.ActiveChainstate()));
+
+    BOOST_CHECK(chainman.IsSnapshotActive());
+    BOOST_CHECK_EQUAL(WITH_LOCK(::cs_main, return chainman.GetAll().size()), 1U);
+    BOOST_CHECK_EQUAL(WITH_LOCK(::cs_main, return chainman.ActiveTip()->GetBlockHash()), base_hash);
+
+    // blocks are connected on top of the snapshot base with the loaded EvoDB contents
+    const CBlock block = CreateAndProcessBlock({}, GetScriptForRawPubKey(coinbaseKey.GetPubKey()));
+    BOOST_CHECK_EQUAL(WITH_LOCK(::cs_main, return chainman.ActiveTip()->GetBlockHash()), block.GetHash());
+    BOOST_CHECK_EQUAL(WITH_LOCK(::cs_main, return chainman.ActiveHeight()), 111);
+    BOOST_CHECK(m_node.evodb->VerifyBestBlock(block.GetHash()));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -5,16 +5,27 @@
 
 #include <txdb.h>
 
+#include <memusage.h>
 #include <node/ui_interface.h>
 #include <pow.h>
 #include <random.h>
 #include <shutdown.h>
 #include <uint256.h>
+#include <util/hasher.h>
+#include <util/metrics.h>
 #include <util/system.h>
+#include <util/thread.h>
+#include <util/threadnames.h>
 #include <util/translation.h>
 #include <util/vector.h>
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <stdint.h>
+#include <thread>
+#include <unordered_set>
 
 static const char DB_COIN = 'C';
 static const char DB_COINS = 'c';
@@ -150,6 +161,140 @@ size_t CCoinsViewDB::EstimateSize() const
     return m_db->EstimateSize(DB_COIN, (char)(DB_COIN+1));
 }
 
+CCoinsViewPrefetch::CCoinsViewPrefetch(CCoinsView* base, int threads) : CCoinsViewBacked(base), m_threads(threads) {}
+
+CCoinsViewPrefetch::~CCoinsViewPrefetch()
+{
+    Stop();
+}
+
+void CCoinsViewPrefetch::Prefetch(const CBlock& block, const CCoinsViewCache& cache)
+{
+    if (m_threads <= 0) return;
+
+    std::unordered_set<uint256, SaltedTxidHasher> txids;
+    for (const auto& tx : block.vtx) {
+        txids.insert(tx->GetHash());
+    }
+
+    {
+        LOCK(m_mutex);
+        for (const auto& tx : block.vtx) {
+            if (tx->IsCoinBase()) continue;
+            for (const auto& txin : tx->vin) {
+                if (m_queue.size() >= MAX_QUEUED_OUTPOINTS) break;
+                if (txids.count(txin.prevout.hash) || cache.HaveCoinInCache(txin.prevout)) continue;
+                m_queue.push_back(txin.prevout);
+            }
+        }
+    }
+
+    if (m_worker_threads.empty()) {
+        for (int n = 0; n < m_threads; ++n) {
+            m_worker_threads.emplace_back([this, n]() {
+                util::ThreadRename(strprintf("inputfetch.%i", n));
+                WorkerThread();
+            });
+        }
+    }
+    m_worker_cv.notify_all();
+}
+
+void CCoinsViewPrefetch::WorkerThread()
+{
+    WAIT_LOCK(m_mutex, lock);
+    while (true) {
+        m_worker_cv.wait(lock, [this]() EXCLUSIVE_LOCKS_REQUIRED(m_mutex) { return m_request_stop || !m_queue.empty(); });
+        if (m_request_stop) return;
+
+        const COutPoint outpoint = m_queue.front();
+        m_queue.pop_front();
+        if (m_coins.count(outpoint) || memusage::DynamicUsage(m_coins) + m_coins_usage >= m_max_usage) continue;
+
+        const uint64_t generation = m_generation;
+        Coin coin;
+        bool found;
+        {
+            REVERSE_LOCK(lock);
+            found = base->GetCoin(outpoint, coin);
+        }
+        if (found && generation == m_generation) {
+            const size_t usage = coin.DynamicMemoryUsage();
+            if (m_coins.emplace(outpoint, std::move(coin)).second) m_coins_usage += usage;
+        }
+    }
+}
+
+void CCoinsViewPrefetch::Stop()
+{
+    WITH_LOCK(m_mutex, m_request_stop = true);
+    m_worker_cv.notify_all();
+    for (std::thread& t : m_worker_threads) {
+        t.join();
+    }
+    m_worker_threads.clear();
+
+    LOCK(m_mutex);
+    m_request_stop = false;
+    m_queue.clear();
+    m_coins.clear();
+    m_coins_usage = 0;
+    ++m_generation;
+}
+
+size_t CCoinsViewPrefetch::GetPrefetchedCount() const
+{
+    return WITH_LOCK(m_mutex, return m_coins.size());
+}
+
+size_t CCoinsViewPrefetch::DynamicMemoryUsage() const
+{
+    LOCK(m_mutex);
+    return memusage::DynamicUsage(m_coins) + m_coins_usage;
+}
+
+void CCoinsViewPrefetch::SetMaxUsage(size_t max_usage)
+{
+    WITH_LOCK(m_mutex, m_max_usage = max_usage);
+}
+
+bool CCoinsViewPrefetch::GetCoin(const COutPoint& outpoint, Coin& coin) const
+{
+    static metrics::Counter& hits = metrics::GetCounter("coins.prefetch.hits");
+    static metrics::Counter& misses = metrics::GetCounter("coins.prefetch.misses");
+
+    {
+        LOCK(m_mutex);
+        if (const auto it = m_coins.find(outpoint); it != m_coins.end()) {
+            hits.Inc();
+            m_coins_usage -= it->second.DynamicMemoryUsage();
+            coin = std::move(it->second);
+            m_coins.erase(it);
+            return true;
+        }
+    }
+    misses.Inc();
+    return base->GetCoin(outpoint, coin);
+}
+
+bool CCoinsViewPrefetch::HaveCoin(const COutPoint& outpoint) const
+{
+    if (WITH_LOCK(m_mutex, return m_coins.count(outpoint) > 0)) return true;
+    return base->HaveCoin(outpoint);
+}
+
+bool CCoinsViewPrefetch::BatchWrite(CCoinsMap& mapCoins, const uint256& hashBlock)
+{
+    const bool ret = base->BatchWrite(mapCoins, hashBlock);
+    // Whatever was read up to now, including reads still in progress, may predate the write. Nobody asks for
+    // coins during the write itself, so it is enough to discard them afterwards.
+    LOCK(m_mutex);
+    m_coins.clear();
+    m_coins_usage = 0;
+    ++m_generation;
+    return ret;
+}
+
 CBlockTreeDB::CBlockTreeDB(size_t nCacheSize, bool fMemory, bool fWipe) : CDBWrapper(GetDataDir() / "blocks" / "index", nCacheSize, fMemory, fWipe) {
 }
 
@@ -409,42 +554,123 @@ bool CBlockTreeDB::ReadFlag(const std::string &name, bool &fValue) {
 
 bool CBlockTreeDB::LoadBlockIndexGuts(const Consensus::Params& consensusParams, std::function<CBlockIndex*(const uint256&)> insertBlockIndex)
 {
-    std::unique_ptr<CDBIterator> pcursor(NewIterator());
-
-    pcursor->Seek(std::make_pair(DB_BLOCK_INDEX, uint256()));
-
-    // Load m_block_index
-    while (pcursor->Valid()) {
-        if (ShutdownRequested()) return false;
-        std::pair<char, uint256> key;
-        if (pcursor->GetKey(key) && key.first == DB_BLOCK_INDEX) {
+    // Block index entries are keyed by block hash, so the key range can be split by the first byte of the hash and
+    // each part read, deserialized and checked by its own thread. The entries are handed over in batches to this
+    // thread which links them, a reader waits while too many batches are pending, so only a few are held in memory.
+    const int num_threads = std::clamp(GetNumCores(), 1, MAX_BLOCK_INDEX_LOAD_THREADS);
+    const size_t max_pending = 2 * num_threads;
+    Mutex cs_loaded;
+    std::condition_variable cv_loaded;
+    std::deque<std::vector<CDiskBlockIndex>> loaded; // guarded by cs_loaded
+    int running{num_threads};                        // guarded by cs_loaded
+    std::string err;                                 // guarded by cs_loaded
+    std::atomic<bool> failed{false};
+
+    const auto fail = [&](const std::string& reason) {
+        {
+            LOCK(cs_loaded);
+            if (err.empty()) err = reason;
+            failed = true;
+        }
+        cv_loaded.notify_all();
+    };
+    const auto hand_over = [&](std::vector<CDiskBlockIndex>& batch) {
+        {
+            WAIT_LOCK(cs_loaded, lock);
+            cv_loaded.wait(lock, [&] { return loaded.size() < max_pending || failed; });
+            loaded.emplace_back(std::move(batch));
+        }
+        cv_loaded.notify_all();
+        batch.clear();
+    };
+
+    auto load_range = [&](int part) {
+        const unsigned int begin = 256 * part / num_threads;
+        const unsigned int end = 256 * (part + 1) / num_threads;
+        uint256 start;
+        *start.begin() = static_cast<uint8_t>(begin);
+
+        std::unique_ptr<CDBIterator> pcursor(NewIterator());
+        pcursor->Seek(std::make_pair(DB_BLOCK_INDEX, start));
+
+        std::vector<CDiskBlockIndex> batch;
+        batch.reserve(BLOCK_INDEX_LOAD_BATCH_SIZE);
+        while (pcursor->Valid()) {
+            if (failed) return;
+            if (ShutdownRequested()) {
+                fail("");
+                return;
+            }
+            std::pair<char, uint256> key;
+            if (!pcursor->GetKey(key) || key.first != DB_BLOCK_INDEX || *key.second.begin() >= end) {
+                break;
+            }
             CDiskBlockIndex diskindex;
-            if (pcursor->GetValue(diskindex)) {
-                // Construct block index object
-                CBlockIndex* pindexNew = insertBlockIndex(diskindex.GetBlockHash());
-                pindexNew->pprev          = insertBlockIndex(diskindex.hashPrev);
-                pindexNew->nHeight        = diskindex.nHeight;
-                pindexNew->nFile          = diskindex.nFile;
-                pindexNew->nDataPos       = diskindex.nDataPos;
-                pindexNew->nUndoPos       = diskindex.nUndoPos;
-                pindexNew->nVersion       = diskindex.nVersion;
-                pindexNew->hashMerkleRoot = diskindex.hashMerkleRoot;
-                pindexNew->nTime          = diskindex.nTime;
-                pindexNew->nBits          = diskindex.nBits;
-                pindexNew->nNonce         = diskindex.nNonce;
-                pindexNew->nStatus        = diskindex.nStatus;
-                pindexNew->nTx            = diskindex.nTx;
-
-                if (!CheckProofOfWork(pindexNew->GetBlockHash(), pindexNew->nBits, consensusParams))
-                    return error("%s: CheckProofOfWork failed: %s", __func__, pindexNew->ToString());
-
-                pcursor->Next();
-            } else {
-                return error("%s: failed to read value", __func__);
+            if (!pcursor->GetValue(diskindex)) {
+                fail("failed to read value");
+                return;
             }
-        } else {
-            break;
+            // the hash is stored with the entry, this is a comparison and not a hash computation
+            if (!CheckProofOfWork(diskindex.GetBlockHash(), diskindex.nBits, consensusParams)) {
+                fail(strprintf("CheckProofOfWork failed: block %s at height %d", diskindex.GetBlockHash().ToString(), diskindex.nHeight));
+                return;
+            }
+            batch.emplace_back(std::move(diskindex));
+            if (batch.size() == BLOCK_INDEX_LOAD_BATCH_SIZE) {
+                hand_over(batch);
+            }
+            pcursor->Next();
         }
+        if (!batch.empty()) {
+            hand_over(batch);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int part = 0; part < num_threads; ++part) {
+        threads.emplace_back(util::TraceThread, "loadblkidx", [&load_range, &cs_loaded, &cv_loaded, &running, part] {
+            load_range(part);
+            WITH_LOCK(cs_loaded, --running);
+            cv_loaded.notify_all();
+        });
+    }
+
+    // Construct block index objects
+    while (true) {
+        std::vector<CDiskBlockIndex> batch;
+        {
+            WAIT_LOCK(cs_loaded, lock);
+            cv_loaded.wait(lock, [&] { return !loaded.empty() || running == 0 || failed; });
+            if (failed || loaded.empty()) break;
+            batch = std::move(loaded.front());
+            loaded.pop_front();
+        }
+        cv_loaded.notify_all();
+
+        for (const CDiskBlockIndex& diskindex : batch) {
+            CBlockIndex* pindexNew = insertBlockIndex(diskindex.GetBlockHash());
+            pindexNew->pprev          = insertBlockIndex(diskindex.hashPrev);
+            pindexNew->nHeight        = diskindex.nHeight;
+            pindexNew->nFile          = diskindex.nFile;
+            pindexNew->nDataPos       = diskindex.nDataPos;
+            pindexNew->nUndoPos       = diskindex.nUndoPos;
+            pindexNew->nVersion       = diskindex.nVersion;
+            pindexNew->hashMerkleRoot = diskindex.hashMerkleRoot;
+            pindexNew->nTime          = diskindex.nTime;
+            pindexNew->nBits          = diskindex.nBits;
+            pindexNew->nNonce         = diskindex.nNonce;
+            pindexNew->nStatus        = diskindex.nStatus;
+            pindexNew->nTx            = diskindex.nTx;
+        }
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    if (ShutdownRequested()) return false;
+    if (failed) {
+        return error("%s: %s", __func__, err);
     }
 
     return true;
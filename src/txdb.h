@@ -11,10 +11,15 @@
 #include <chain.h>
 #include <primitives/block.h>
 #include <spentindex.h>
+#include <sync.h>
 #include <timestampindex.h>
 
+#include <condition_variable>
+#include <deque>
 #include <memory>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -40,6 +45,16 @@ static const int64_t nMaxTxIndexCache = 1024;
 static const int64_t max_filter_index_cache = 1024;
 //! Max memory allocated to coin DB specific cache (MiB)
 static const int64_t nMaxCoinsDBCache = 8;
+//! Max number of threads reading the block index at startup
+static constexpr int MAX_BLOCK_INDEX_LOAD_THREADS{8};
+//! Number of block index entries the loader threads hand over at once
+static constexpr size_t BLOCK_INDEX_LOAD_BATCH_SIZE{256};
+//! -inputprefetch default
+static constexpr int DEFAULT_INPUT_PREFETCH_THREADS{4};
+//! Max number of threads prefetching block inputs
+static constexpr int MAX_INPUT_PREFETCH_THREADS{16};
+//! Percentage of the coins cache budget prefetched coins may use
+static constexpr size_t INPUT_PREFETCH_CACHE_PERCENT{10};
 
 // Actually declared in validation.cpp; can't include because of circular dependency.
 extern RecursiveMutex cs_main;
@@ -73,6 +88,62 @@ public:
     void ResizeCache(size_t new_cache_size) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 };
 
+/**
+ * CCoinsView reading the coins spent by blocks from its base, the coins database, with worker threads ahead of
+ * their validation. The coins cache of the chain tip on top of it then finds them in memory instead of waiting
+ * for random database reads one input at a time.
+ *
+ * Only what the database holds is prefetched, which is exactly what the coins cache would read itself for the
+ * coins it doesn't have. Everything prefetched is dropped whenever the database is written to.
+ *
+ * The memory used by prefetched coins is part of the coins cache budget: it is capped with SetMaxUsage() and
+ * counted together with the coins cache when deciding whether to flush.
+ */
+class CCoinsViewPrefetch final : public CCoinsViewBacked
+{
+public:
+    //! Max number of outpoints waiting to be read, more than the inputs of any block
+    static constexpr size_t MAX_QUEUED_OUTPOINTS{100000};
+
+    //! No coins are prefetched with 0 threads
+    CCoinsViewPrefetch(CCoinsView* base, int threads);
+    ~CCoinsViewPrefetch();
+
+    //! Queue the coins spent by block for reading, except the ones cache has and the ones created by block itself.
+    //! Starts the worker threads if needed.
+    void Prefetch(const CBlock& block, const CCoinsViewCache& cache);
+    //! Stop the worker threads and drop everything queued and prefetched, e.g. before the database is reopened.
+    void Stop();
+    //! Number of coins read and not asked for yet
+    size_t GetPrefetchedCount() const;
+    //! Memory used by the coins read and not asked for yet
+    size_t DynamicMemoryUsage() const;
+    //! Stop prefetching while the prefetched coins use this much memory or more
+    void SetMaxUsage(size_t max_usage);
+
+    bool GetCoin(const COutPoint& outpoint, Coin& coin) const override;
+    bool HaveCoin(const COutPoint& outpoint) const override;
+    bool BatchWrite(CCoinsMap& mapCoins, const uint256& hashBlock) override;
+
+private:
+    const int m_threads;
+
+    mutable Mutex m_mutex;
+    std::condition_variable m_worker_cv;
+    std::deque<COutPoint> m_queue GUARDED_BY(m_mutex);
+    //! Coins handed out to the coins cache are removed, it keeps them itself from then on
+    mutable std::unordered_map<COutPoint, Coin, SaltedOutpointHasher> m_coins GUARDED_BY(m_mutex);
+    //! Dynamic memory used by the coins in m_coins
+    mutable size_t m_coins_usage GUARDED_BY(m_mutex){0};
+    size_t m_max_usage GUARDED_BY(m_mutex){0};
+    //! Bumped whenever the database is written to, reads started before are discarded
+    uint64_t m_generation GUARDED_BY(m_mutex){0};
+    bool m_request_stop GUARDED_BY(m_mutex){false};
+    std::vector<std::thread> m_worker_threads;
+
+    void WorkerThread();
+};
+
 /** Access to the block database (blocks/index/) */
 class CBlockTreeDB : public CDBWrapper
 {
@@ -99,6 +170,10 @@ public:
     bool ReadTimestampIndex(const unsigned int &high, const unsigned int &low, std::vector<uint256> &vect);
     bool WriteFlag(const std::string &name, bool fValue);
     bool ReadFlag(const std::string &name, bool &fValue);
+    /**
+     * Read all block index entries, using up to MAX_BLOCK_INDEX_LOAD_THREADS threads. insertBlockIndex is only
+     * called by the calling thread.
+     */
     bool LoadBlockIndexGuts(const Consensus::Params& consensusParams, std::function<CBlockIndex*(const uint256&)> insertBlockIndex);
 };
 
@@ -22,6 +22,7 @@
 
 #include <evo/specialtx.h>
 #include <evo/assetlocktx.h>
+#include <evo/mempoolindex.h>
 #include <evo/providertx.h>
 #include <evo/deterministicmns.h>
 #include <llmq/instantsend.h>
@@ -33,7 +34,8 @@ CTxMemPoolEntry::CTxMemPoolEntry(const CTransactionRef& _tx, const CAmount& _nFe
                                  int64_t _nTime, unsigned int _entryHeight,
                                  bool _spendsCoinbase, unsigned int _sigOps, LockPoints lp)
     : tx(_tx), nFee(_nFee), nTxSize(tx->GetTotalSize()), nUsageSize(RecursiveDynamicUsage(tx)), nTime(_nTime), entryHeight(_entryHeight),
-    spendsCoinbase(_spendsCoinbase), sigOpCount(_sigOps), lockPoints(lp)
+    spendsCoinbase(_spendsCoinbase), sigOpCount(_sigOps), lockPoints(lp),
+    specialTxPayload(ParseSpecialTxPayload(*_tx))
 {
     nCountWithDescendants = 1;
     nSizeWithDescendants = GetTxSize();
@@ -337,11 +339,13 @@ void CTxMemPoolEntry::UpdateAncestorState(int64_t modifySize, CAmount modifyFee,
 }
 
 CTxMemPool::CTxMemPool(CBlockPolicyEstimator* estimator, int check_ratio)
-    : m_check_ratio(check_ratio), minerPolicyEstimator(estimator)
+    : m_check_ratio(check_ratio), minerPolicyEstimator(estimator), m_specialtx_index(std::make_unique<CSpecialTxMempoolIndex>())
 {
     _clear(); //lock free clear
 }
 
+CTxMemPool::~CTxMemPool() = default;
+
 bool CTxMemPool::isSpent(const COutPoint& outpoint) const
 {
     LOCK(cs);
@@ -408,49 +412,29 @@ void CTxMemPool::addUnchecked(const CTxMemPoolEntry &entry, setEntries &setAnces
     vTxHashes.emplace_back(entry.GetTx().GetHash(), newit);
     newit->vTxHashesIdx = vTxHashes.size() - 1;
 
-    // Invalid ProTxes should never get this far because transactions should be
+    // Invalid special txes should never get this far because transactions should be
     // fully checked by AcceptToMemoryPool() at this point, so we just assume that
     // everything is fine here.
-    if (tx.nType == TRANSACTION_PROVIDER_REGISTER) {
-        auto proTx = *Assert(GetTxPayload<CProRegTx>(tx));
-        if (!proTx.collateralOutpoint.hash.IsNull()) {
-            mapProTxRefs.emplace(tx.GetHash(), proTx.collateralOutpoint.hash);
-        }
-        mapProTxAddresses.emplace(proTx.addr, tx.GetHash());
-        mapProTxPubKeyIDs.emplace(proTx.keyIDOwner, tx.GetHash());
-        mapProTxBlsPubKeyHashes.emplace(proTx.pubKeyOperator.GetHash(), tx.GetHash());
-        if (!proTx.collateralOutpoint.hash.IsNull()) {
-            mapProTxCollaterals.emplace(proTx.collateralOutpoint, tx.GetHash());
-        } else {
-            mapProTxCollaterals.emplace(COutPoint(tx.GetHash(), proTx.collateralOutpoint.n), tx.GetHash());
-        }
-    } else if (tx.nType == TRANSACTION_PROVIDER_UPDATE_SERVICE) {
-        auto proTx = *Assert(GetTxPayload<CProUpServTx>(tx));
-        mapProTxRefs.emplace(proTx.proTxHash, tx.GetHash());
-        mapProTxAddresses.emplace(proTx.addr, tx.GetHash());
-    } else if (tx.nType == TRANSACTION_PROVIDER_UPDATE_REGISTRAR) {
-        auto proTx = *Assert(GetTxPayload<CProUpRegTx>(tx));
-        mapProTxRefs.emplace(proTx.proTxHash, tx.GetHash());
-        mapProTxBlsPubKeyHashes.emplace(proTx.pubKeyOperator.GetHash(), tx.GetHash());
-        auto dmn = Assert(deterministicMNManager->GetListAtChainTip().GetMN(proTx.proTxHash));
-        newit->validForProTxKey = ::SerializeHash(dmn->pdmnState->pubKeyOperator);
-        if (dmn->pdmnState->pubKeyOperator != proTx.pubKeyOperator) {
-            newit->isKeyChangeProTx = true;
-        }
-    } else if (tx.nType == TRANSACTION_PROVIDER_UPDATE_REVOKE) {
-        auto proTx = *Assert(GetTxPayload<CProUpRevTx>(tx));
-        mapProTxRefs.emplace(proTx.proTxHash, tx.GetHash());
-        auto dmn = deterministicMNManager->GetListAtChainTip().GetMN(proTx.proTxHash);
-        assert(dmn);
-        newit->validForProTxKey = ::SerializeHash(dmn->pdmnState->pubKeyOperator);
-        if (dmn->pdmnState->pubKeyOperator.Get() != CBLSPublicKey()) {
-            newit->isKeyChangeProTx = true;
+    if (IsMempoolIndexedSpecialTx(tx.nType)) {
+        const auto& payload = Assert(newit->GetSpecialTxPayload());
+        m_specialtx_index->Add(tx.GetHash(), payload);
+
+        if (const auto* proTx = payload->Get<CProUpRegTx>()) {
+            auto dmn = Assert(deterministicMNManager->GetListAtChainTip().GetMN(proTx->proTxHash));
+            newit->validForProTxKey = ::SerializeHash(dmn->pdmnState->pubKeyOperator);
+            if (dmn->pdmnState->pubKeyOperator != proTx->pubKeyOperator) {
+                newit->isKeyChangeProTx = true;
+            }
+        } else if (const auto* proTx = payload->Get<CProUpRevTx>()) {
+            auto dmn = deterministicMNManager->GetListAtChainTip().GetMN(proTx->proTxHash);
+            assert(dmn);
+            newit->validForProTxKey = ::SerializeHash(dmn->pdmnState->pubKeyOperator);
+            if (dmn->pdmnState->pubKeyOperator.Get() != CBLSPublicKey()) {
+                newit->isKeyChangeProTx = true;
+            }
+        } else if (payload->Get<MNHFTxPayload>()) {
+            PrioritiseTransaction(tx.GetHash(), 0.1 * COIN);
         }
-    } else if (tx.nType == TRANSACTION_ASSET_UNLOCK) {
-        auto assetUnlockTx = *Assert(GetTxPayload<CAssetUnlockPayload>(tx));
-        mapAssetUnlockExpiry.insert({tx.GetHash(), assetUnlockTx.getHeightToExpiry()});
-    } else if (tx.nType == TRANSACTION_MNHF_SIGNAL) {
-        PrioritiseTransaction(tx.GetHash(), 0.1 * COIN);
     }
 }
 
@@ -611,40 +595,8 @@ void CTxMemPool::removeUnchecked(txiter it, MemPoolRemovalReason reason)
     } else
         vTxHashes.clear();
 
-    auto eraseProTxRef = [&](const uint256& proTxHash, const uint256& txHash) {
-        auto its = mapProTxRefs.equal_range(proTxHash);
-        for (auto it = its.first; it != its.second;) {
-            if (it->second == txHash) {
-                it = mapProTxRefs.erase(it);
-            } else {
-                ++it;
-            }
-        }
-    };
-
-    if (it->GetTx().nType == TRANSACTION_PROVIDER_REGISTER) {
-        auto proTx = *Assert(GetTxPayload<CProRegTx>(it->GetTx()));
-        if (!proTx.collateralOutpoint.IsNull()) {
-            eraseProTxRef(it->GetTx().GetHash(), proTx.collateralOutpoint.hash);
-        }
-        mapProTxAddresses.erase(proTx.addr);
-        mapProTxPubKeyIDs.erase(proTx.keyIDOwner);
-        mapProTxBlsPubKeyHashes.erase(proTx.pubKeyOperator.GetHash());
-        mapProTxCollaterals.erase(proTx.collateralOutpoint);
-        mapProTxCollaterals.erase(COutPoint(it->GetTx().GetHash(), proTx.collateralOutpoint.n));
-    } else if (it->GetTx().nType == TRANSACTION_PROVIDER_UPDATE_SERVICE) {
-        auto proTx = *Assert(GetTxPayload<CProUpServTx>(it->GetTx()));
-        eraseProTxRef(proTx.proTxHash, it->GetTx().GetHash());
-        mapProTxAddresses.erase(proTx.addr);
-    } else if (it->GetTx().nType == TRANSACTION_PROVIDER_UPDATE_REGISTRAR) {
-        auto proTx = *Assert(GetTxPayload<CProUpRegTx>(it->GetTx()));
-        eraseProTxRef(proTx.proTxHash, it->GetTx().GetHash());
-        mapProTxBlsPubKeyHashes.erase(proTx.pubKeyOperator.GetHash());
-    } else if (it->GetTx().nType == TRANSACTION_PROVIDER_UPDATE_REVOKE) {
-        auto proTx = *Assert(GetTxPayload<CProUpRevTx>(it->GetTx()));
-        eraseProTxRef(proTx.proTxHash, it->GetTx().GetHash());
-    } else if (it->GetTx().nType == TRANSACTION_ASSET_UNLOCK) {
-        mapAssetUnlockExpiry.erase(it->GetTx().GetHash());
+    if (it->GetSpecialTxPayload()) {
+        m_specialtx_index->Remove(hash);
     }
 
     totalTxSize -= it->GetTxSize();
@@ -771,16 +723,16 @@ void CTxMemPool::removeConflicts(const CTransaction &tx)
                     // Remove all other protxes which refer to this protx
                     // NOTE: Can't use equal_range here as every call to removeRecursive might invalidate iterators
                     while (true) {
-                        auto itPro = mapProTxRefs.find(txConflict.GetHash());
-                        if (itPro == mapProTxRefs.end()) {
+                        auto refHash = m_specialtx_index->GetFirstProTxRef(txConflict.GetHash());
+                        if (!refHash) {
                             break;
                         }
-                        auto txit = mapTx.find(itPro->second);
+                        auto txit = mapTx.find(*refHash);
                         if (txit != mapTx.end()) {
                             ClearPrioritisation(txit->GetTx().GetHash());
                             removeRecursive(txit->GetTx(), MemPoolRemovalReason::CONFLICT);
                         } else {
-                            mapProTxRefs.erase(itPro);
+                            m_specialtx_index->EraseProTxRef(txConflict.GetHash(), *refHash);
                         }
                     }
                 }
@@ -793,30 +745,30 @@ void CTxMemPool::removeConflicts(const CTransaction &tx)
 
 void CTxMemPool::removeProTxPubKeyConflicts(const CTransaction &tx, const CKeyID &keyId)
 {
-    if (mapProTxPubKeyIDs.count(keyId)) {
-        uint256 conflictHash = mapProTxPubKeyIDs[keyId];
-        if (conflictHash != tx.GetHash() && mapTx.count(conflictHash)) {
-            removeRecursive(mapTx.find(conflictHash)->GetTx(), MemPoolRemovalReason::CONFLICT);
+    if (auto conflictHash = m_specialtx_index->GetTxByOwnerKey(keyId)) {
+        auto conflictIt = mapTx.find(*conflictHash);
+        if (*conflictHash != tx.GetHash() && conflictIt != mapTx.end()) {
+            removeRecursive(conflictIt->GetTx(), MemPoolRemovalReason::CONFLICT);
         }
     }
 }
 
 void CTxMemPool::removeProTxPubKeyConflicts(const CTransaction &tx, const CBLSLazyPublicKey &pubKey)
 {
-    if (mapProTxBlsPubKeyHashes.count(pubKey.GetHash())) {
-        uint256 conflictHash = mapProTxBlsPubKeyHashes[pubKey.GetHash()];
-        if (conflictHash != tx.GetHash() && mapTx.count(conflictHash)) {
-            removeRecursive(mapTx.find(conflictHash)->GetTx(), MemPoolRemovalReason::CONFLICT);
+    if (auto conflictHash = m_specialtx_index->GetTxByOperatorKey(pubKey.GetHash())) {
+        auto conflictIt = mapTx.find(*conflictHash);
+        if (*conflictHash != tx.GetHash() && conflictIt != mapTx.end()) {
+            removeRecursive(conflictIt->GetTx(), MemPoolRemovalReason::CONFLICT);
         }
     }
 }
 
 void CTxMemPool::removeProTxCollateralConflicts(const CTransaction &tx, const COutPoint &collateralOutpoint)
 {
-    if (mapProTxCollaterals.count(collateralOutpoint)) {
-        uint256 conflictHash = mapProTxCollaterals[collateralOutpoint];
-        if (conflictHash != tx.GetHash() && mapTx.count(conflictHash)) {
-            removeRecursive(mapTx.find(conflictHash)->GetTx(), MemPoolRemovalReason::CONFLICT);
+    if (auto conflictHash = m_specialtx_index->GetTxByCollateral(collateralOutpoint)) {
+        auto conflictIt = mapTx.find(*conflictHash);
+        if (*conflictHash != tx.GetHash() && conflictIt != mapTx.end()) {
+            removeRecursive(conflictIt->GetTx(), MemPoolRemovalReason::CONFLICT);
         }
     }
 }
@@ -828,27 +780,26 @@ void CTxMemPool::removeProTxSpentCollateralConflicts(const CTransaction &tx)
         // Can't use equal_range here as every call to removeRecursive might invalidate iterators
         AssertLockHeld(cs);
         while (true) {
-            auto it = mapProTxRefs.find(proTxHash);
-            if (it == mapProTxRefs.end()) {
+            auto refHash = m_specialtx_index->GetFirstProTxRef(proTxHash);
+            if (!refHash) {
                 break;
             }
-            auto conflictIt = mapTx.find(it->second);
+            auto conflictIt = mapTx.find(*refHash);
             if (conflictIt != mapTx.end()) {
                 removeRecursive(conflictIt->GetTx(), MemPoolRemovalReason::CONFLICT);
             } else {
                 // Should not happen as we track referencing TXs in addUnchecked/removeUnchecked.
                 // But lets be on the safe side and not run into an endless loop...
-                LogPrint(BCLog::MEMPOOL, "%s: ERROR: found invalid TX ref in mapProTxRefs, proTxHash=%s, txHash=%s\n", __func__, proTxHash.ToString(), it->second.ToString());
-                mapProTxRefs.erase(it);
+                LogPrint(BCLog::MEMPOOL, "%s: ERROR: found invalid TX ref in special tx index, proTxHash=%s, txHash=%s\n", __func__, proTxHash.ToString(), refHash->ToString());
+                m_specialtx_index->EraseProTxRef(proTxHash, *refHash);
             }
         }
     };
     auto mnList = deterministicMNManager->GetListAtChainTip();
     for (const auto& in : tx.vin) {
-        auto collateralIt = mapProTxCollaterals.find(in.prevout);
-        if (collateralIt != mapProTxCollaterals.end()) {
+        if (auto collateralTxHash = m_specialtx_index->GetTxByCollateral(in.prevout)) {
             // These are not yet mined ProRegTxs
-            removeSpentCollateralConflict(collateralIt->second);
+            removeSpentCollateralConflict(*collateralTxHash);
         }
         auto dmn = mnList.GetMNByCollateral(in.prevout);
         if (dmn) {
@@ -861,8 +812,8 @@ void CTxMemPool::removeProTxSpentCollateralConflicts(const CTransaction &tx)
 void CTxMemPool::removeProTxKeyChangedConflicts(const CTransaction &tx, const uint256& proTxHash, const uint256& newKeyHash)
 {
     std::set<uint256> conflictingTxs;
-    for (auto its = mapProTxRefs.equal_range(proTxHash); its.first != its.second; ++its.first) {
-        auto txit = mapTx.find(its.first->second);
+    for (const auto& refHash : m_specialtx_index->GetProTxRefs(proTxHash)) {
+        auto txit = mapTx.find(refHash);
         if (txit == mapTx.end()) {
             continue;
         }
@@ -876,61 +827,48 @@ void CTxMemPool::removeProTxKeyChangedConflicts(const CTransaction &tx, const ui
     }
 }
 
-void CTxMemPool::removeProTxConflicts(const CTransaction &tx)
+void CTxMemPool::removeProTxConflicts(const CTransaction &tx, CSpecialTxPayloadPtr payload)
 {
     removeProTxSpentCollateralConflicts(tx);
 
-    if (tx.nType == TRANSACTION_PROVIDER_REGISTER) {
-        const auto opt_proTx = GetTxPayload<CProRegTx>(tx);
-        if (!opt_proTx) {
-            LogPrint(BCLog::MEMPOOL, "%s: ERROR: Invalid transaction payload, tx: %s\n", __func__, tx.GetHash().ToString());
-            return;
-        }
-        auto& proTx = *opt_proTx;
-
-        if (mapProTxAddresses.count(proTx.addr)) {
-            uint256 conflictHash = mapProTxAddresses[proTx.addr];
-            if (conflictHash != tx.GetHash() && mapTx.count(conflictHash)) {
-                removeRecursive(mapTx.find(conflictHash)->GetTx(), MemPoolRemovalReason::CONFLICT);
-            }
-        }
-        removeProTxPubKeyConflicts(tx, proTx.keyIDOwner);
-        removeProTxPubKeyConflicts(tx, proTx.pubKeyOperator);
-        if (!proTx.collateralOutpoint.hash.IsNull()) {
-            removeProTxCollateralConflicts(tx, proTx.collateralOutpoint);
-        } else {
-            removeProTxCollateralConflicts(tx, COutPoint(tx.GetHash(), proTx.collateralOutpoint.n));
-        }
-    } else if (tx.nType == TRANSACTION_PROVIDER_UPDATE_SERVICE) {
-        const auto opt_proTx = GetTxPayload<CProUpServTx>(tx);
-        if (!opt_proTx) {
-            LogPrint(BCLog::MEMPOOL, "%s: ERROR: Invalid transaction payload, tx: %s\n", __func__, tx.GetHash().ToString());
-            return;
-        }
+    if (tx.nType != TRANSACTION_PROVIDER_REGISTER && tx.nType != TRANSACTION_PROVIDER_UPDATE_SERVICE &&
+        tx.nType != TRANSACTION_PROVIDER_UPDATE_REGISTRAR && tx.nType != TRANSACTION_PROVIDER_UPDATE_REVOKE) {
+        return;
+    }
+    if (!payload) {
+        payload = ParseSpecialTxPayload(tx);
+    }
+    if (!payload) {
+        LogPrint(BCLog::MEMPOOL, "%s: ERROR: Invalid transaction payload, tx: %s\n", __func__, tx.GetHash().ToString());
+        return;
+    }
 
-        if (mapProTxAddresses.count(opt_proTx->addr)) {
-            uint256 conflictHash = mapProTxAddresses[opt_proTx->addr];
-            if (conflictHash != tx.GetHash() && mapTx.count(conflictHash)) {
-                removeRecursive(mapTx.find(conflictHash)->GetTx(), MemPoolRemovalReason::CONFLICT);
+    auto removeAddressConflict = [&](const CService& addr) {
+        AssertLockHeld(cs);
+        if (auto conflictHash = m_specialtx_index->GetTxByAddress(addr)) {
+            auto conflictIt = mapTx.find(*conflictHash);
+            if (*conflictHash != tx.GetHash() && conflictIt != mapTx.end()) {
+                removeRecursive(conflictIt->GetTx(), MemPoolRemovalReason::CONFLICT);
             }
         }
-    } else if (tx.nType == TRANSACTION_PROVIDER_UPDATE_REGISTRAR) {
-        const auto opt_proTx = GetTxPayload<CProUpRegTx>(tx);
-        if (!opt_proTx) {
-            LogPrint(BCLog::MEMPOOL, "%s: ERROR: Invalid transaction payload, tx: %s\n", __func__, tx.GetHash().ToString());
-            return;
-        }
+    };
 
-        removeProTxPubKeyConflicts(tx, opt_proTx->pubKeyOperator);
-        removeProTxKeyChangedConflicts(tx, opt_proTx->proTxHash, ::SerializeHash(opt_proTx->pubKeyOperator));
-    } else if (tx.nType == TRANSACTION_PROVIDER_UPDATE_REVOKE) {
-        const auto opt_proTx = GetTxPayload<CProUpRevTx>(tx);
-        if (!opt_proTx) {
-            LogPrint(BCLog::MEMPOOL, "%s: ERROR: Invalid transaction payload, tx: %s\n", __func__, tx.GetHash().ToString());
-            return;
+    if (const auto* proTx = payload->Get<CProRegTx>()) {
+        removeAddressConflict(proTx->addr);
+        removeProTxPubKeyConflicts(tx, proTx->keyIDOwner);
+        removeProTxPubKeyConflicts(tx, proTx->pubKeyOperator);
+        if (!proTx->collateralOutpoint.hash.IsNull()) {
+            removeProTxCollateralConflicts(tx, proTx->collateralOutpoint);
+        } else {
+            removeProTxCollateralConflicts(tx, COutPoint(tx.GetHash(), proTx->collateralOutpoint.n));
         }
-
-        removeProTxKeyChangedConflicts(tx, opt_proTx->proTxHash, ::SerializeHash(CBLSPublicKey()));
+    } else if (const auto* proTx = payload->Get<CProUpServTx>()) {
+        removeAddressConflict(proTx->addr);
+    } else if (const auto* proTx = payload->Get<CProUpRegTx>()) {
+        removeProTxPubKeyConflicts(tx, proTx->pubKeyOperator);
+        removeProTxKeyChangedConflicts(tx, proTx->proTxHash, ::SerializeHash(proTx->pubKeyOperator));
+    } else if (const auto* proTx = payload->Get<CProUpRevTx>()) {
+        removeProTxKeyChangedConflicts(tx, proTx->proTxHash, ::SerializeHash(CBLSPublicKey()));
     }
 }
 
@@ -953,6 +891,8 @@ void CTxMemPool::removeForBlock(const std::vector<CTransactionRef>& vtx, unsigne
     if (minerPolicyEstimator) {minerPolicyEstimator->processBlock(nBlockHeight, entries);}
     for (const auto& tx : vtx)
     {
+        // Reuse the payload parsed on mempool accept, the entry is gone after RemoveStaged()
+        CSpecialTxPayloadPtr payload = m_specialtx_index->GetPayload(tx->GetHash());
         txiter it = mapTx.find(tx->GetHash());
         if (it != mapTx.end()) {
             setEntries stage;
@@ -960,7 +900,7 @@ void CTxMemPool::removeForBlock(const std::vector<CTransactionRef>& vtx, unsigne
             RemoveStaged(stage, true, MemPoolRemovalReason::BLOCK);
         }
         removeConflicts(*tx);
-        removeProTxConflicts(*tx);
+        removeProTxConflicts(*tx, std::move(payload));
         ClearPrioritisation(tx->GetHash());
     }
     lastRollingFeeUpdate = GetTime();
@@ -974,12 +914,10 @@ void CTxMemPool::removeExpiredAssetUnlock(int nBlockHeight)
 {
     AssertLockHeld(cs);
     // items to removed should be firstly collected to independed list,
-    // because removing items by `removeRecursive` changes the mapAssetUnlockExpiry
+    // because removing items by `removeRecursive` changes the special tx index
     std::vector<CTransactionRef> entries;
-    for (const auto& item: mapAssetUnlockExpiry) {
-        if (item.second < nBlockHeight) {
-            entries.push_back(get(item.first));
-        }
+    for (const auto& txHash : m_specialtx_index->GetExpiredAssetUnlocks(nBlockHeight)) {
+        entries.push_back(get(txHash));
     }
     for (const auto& tx : entries) {
         removeRecursive(*tx, MemPoolRemovalReason::EXPIRY);
@@ -991,8 +929,7 @@ void CTxMemPool::_clear()
     mapLinks.clear();
     mapTx.clear();
     mapNextTx.clear();
-    mapProTxAddresses.clear();
-    mapProTxPubKeyIDs.clear();
+    m_specialtx_index->Clear();
     totalTxSize = 0;
     m_total_fee = 0;
     cachedInnerUsage = 0;
@@ -1233,12 +1170,25 @@ TxMempoolInfo CTxMemPool::info(const uint256& hash) const
 }
 
 bool CTxMemPool::existsProviderTxConflict(const CTransaction &tx) const {
+    if (!IsMempoolIndexedSpecialTx(tx.nType)) return false;
+    const auto payload = ParseSpecialTxPayload(tx);
     LOCK(cs);
+    return existsProviderTxConflictInternal(tx, payload.get());
+}
+
+bool CTxMemPool::existsProviderTxConflict(const CTxMemPoolEntry &entry) const {
+    if (!IsMempoolIndexedSpecialTx(entry.GetTx().nType)) return false;
+    LOCK(cs);
+    return existsProviderTxConflictInternal(entry.GetTx(), entry.GetSpecialTxPayload().get());
+}
+
+bool CTxMemPool::existsProviderTxConflictInternal(const CTransaction &tx, const CSpecialTxPayload* payload) const {
+    AssertLockHeld(cs);
 
     auto hasKeyChangeInMempool = [&](const uint256& proTxHash) {
         AssertLockHeld(cs);
-        for (auto its = mapProTxRefs.equal_range(proTxHash); its.first != its.second; ++its.first) {
-            auto txit = mapTx.find(its.first->second);
+        for (const auto& refHash : m_specialtx_index->GetProTxRefs(proTxHash)) {
+            auto txit = mapTx.find(refHash);
             if (txit == mapTx.end()) {
                 continue;
             }
@@ -1249,73 +1199,60 @@ bool CTxMemPool::existsProviderTxConflict(const CTransaction &tx) const {
         return false;
     };
 
-    if (tx.nType == TRANSACTION_PROVIDER_REGISTER) {
-        const auto opt_proTx = GetTxPayload<CProRegTx>(tx);
-        if (!opt_proTx) {
-            LogPrint(BCLog::MEMPOOL, "%s: ERROR: Invalid transaction payload, tx: %s\n", __func__, tx.GetHash().ToString());
-            return true; // i.e. can't decode payload == conflict
-        }
-        auto& proTx = *opt_proTx;
-        if (mapProTxAddresses.count(proTx.addr) || mapProTxPubKeyIDs.count(proTx.keyIDOwner) || mapProTxBlsPubKeyHashes.count(proTx.pubKeyOperator.GetHash()))
+    if (tx.nType != TRANSACTION_PROVIDER_REGISTER && tx.nType != TRANSACTION_PROVIDER_UPDATE_SERVICE &&
+        tx.nType != TRANSACTION_PROVIDER_UPDATE_REGISTRAR && tx.nType != TRANSACTION_PROVIDER_UPDATE_REVOKE) {
+        return false;
+    }
+    if (!payload) {
+        LogPrint(BCLog::MEMPOOL, "%s: ERROR: Invalid transaction payload, tx: %s\n", __func__, tx.GetHash().ToString());
+        return true; // i.e. can't decode payload == conflict
+    }
+
+    if (const auto* proTx = payload->Get<CProRegTx>()) {
+        if (m_specialtx_index->GetTxByAddress(proTx->addr) || m_specialtx_index->GetTxByOwnerKey(proTx->keyIDOwner) ||
+            m_specialtx_index->GetTxByOperatorKey(proTx->pubKeyOperator.GetHash())) {
             return true;
-        if (!proTx.collateralOutpoint.hash.IsNull()) {
-            if (mapProTxCollaterals.count(proTx.collateralOutpoint)) {
+        }
+        if (!proTx->collateralOutpoint.hash.IsNull()) {
+            if (m_specialtx_index->GetTxByCollateral(proTx->collateralOutpoint)) {
                 // there is another ProRegTx that refers to the same collateral
                 return true;
             }
-            if (mapNextTx.count(proTx.collateralOutpoint)) {
+            if (mapNextTx.count(proTx->collateralOutpoint)) {
                 // there is another tx that spends the collateral
                 return true;
             }
         }
         return false;
-    } else if (tx.nType == TRANSACTION_PROVIDER_UPDATE_SERVICE) {
-        const auto opt_proTx = GetTxPayload<CProUpServTx>(tx);
-        if (!opt_proTx) {
-            LogPrint(BCLog::MEMPOOL, "%s: ERROR: Invalid transaction payload, tx: %s\n", __func__, tx.GetHash().ToString());
-            return true; // i.e. can't decode payload == conflict
-        }
-        auto it = mapProTxAddresses.find(opt_proTx->addr);
-        return it != mapProTxAddresses.end() && it->second != opt_proTx->proTxHash;
-    } else if (tx.nType == TRANSACTION_PROVIDER_UPDATE_REGISTRAR) {
-        const auto opt_proTx = GetTxPayload<CProUpRegTx>(tx);
-        if (!opt_proTx) {
-            LogPrint(BCLog::MEMPOOL, "%s: ERROR: Invalid transaction payload, tx: %s\n", __func__, tx.GetHash().ToString());
-            return true; // i.e. can't decode payload == conflict
-        }
-        auto& proTx = *opt_proTx;
-
+    } else if (const auto* proTx = payload->Get<CProUpServTx>()) {
+        auto conflictHash = m_specialtx_index->GetTxByAddress(proTx->addr);
+        return conflictHash && *conflictHash != proTx->proTxHash;
+    } else if (const auto* proTx = payload->Get<CProUpRegTx>()) {
         // this method should only be called with validated ProTxs
-        auto dmn = deterministicMNManager->GetListAtChainTip().GetMN(proTx.proTxHash);
+        auto dmn = deterministicMNManager->GetListAtChainTip().GetMN(proTx->proTxHash);
         if (!dmn) {
-            LogPrint(BCLog::MEMPOOL, "%s: ERROR: Masternode is not in the list, proTxHash: %s\n", __func__, proTx.proTxHash.ToString());
+            LogPrint(BCLog::MEMPOOL, "%s: ERROR: Masternode is not in the list, proTxHash: %s\n", __func__, proTx->proTxHash.ToString());
             return true; // i.e. failed to find validated ProTx == conflict
         }
         // only allow one operator key change in the mempool
-        if (dmn->pdmnState->pubKeyOperator != proTx.pubKeyOperator) {
-            if (hasKeyChangeInMempool(proTx.proTxHash)) {
+        if (dmn->pdmnState->pubKeyOperator != proTx->pubKeyOperator) {
+            if (hasKeyChangeInMempool(proTx->proTxHash)) {
                 return true;
             }
         }
 
-        auto it = mapProTxBlsPubKeyHashes.find(proTx.pubKeyOperator.GetHash());
-        return it != mapProTxBlsPubKeyHashes.end() && it->second != proTx.proTxHash;
-    } else if (tx.nType == TRANSACTION_PROVIDER_UPDATE_REVOKE) {
-        const auto opt_proTx = GetTxPayload<CProUpRevTx>(tx);
-        if (!opt_proTx) {
-            LogPrint(BCLog::MEMPOOL, "%s: ERROR: Invalid transaction payload, tx: %s\n", __func__, tx.GetHash().ToString());
-            return true; // i.e. can't decode payload == conflict
-        }
-        auto& proTx = *opt_proTx;
+        auto conflictHash = m_specialtx_index->GetTxByOperatorKey(proTx->pubKeyOperator.GetHash());
+        return conflictHash && *conflictHash != proTx->proTxHash;
+    } else if (const auto* proTx = payload->Get<CProUpRevTx>()) {
         // this method should only be called with validated ProTxs
-        auto dmn = deterministicMNManager->GetListAtChainTip().GetMN(proTx.proTxHash);
+        auto dmn = deterministicMNManager->GetListAtChainTip().GetMN(proTx->proTxHash);
         if (!dmn) {
-            LogPrint(BCLog::MEMPOOL, "%s: ERROR: Masternode is not in the list, proTxHash: %s\n", __func__, proTx.proTxHash.ToString());
+            LogPrint(BCLog::MEMPOOL, "%s: ERROR: Masternode is not in the list, proTxHash: %s\n", __func__, proTx->proTxHash.ToString());
             return true; // i.e. failed to find validated ProTx == conflict
         }
         // only allow one operator key change in the mempool
         if (dmn->pdmnState->pubKeyOperator.Get() != CBLSPublicKey()) {
-            if (hasKeyChangeInMempool(proTx.proTxHash)) {
+            if (hasKeyChangeInMempool(proTx->proTxHash)) {
                 return true;
             }
         }
@@ -1323,6 +1260,12 @@ bool CTxMemPool::existsProviderTxConflict(const CTransaction &tx) const {
     return false;
 }
 
+bool CTxMemPool::existsAssetUnlockIndex(uint64_t index) const
+{
+    LOCK(cs);
+    return m_specialtx_index->GetAssetUnlockByIndex(index).has_value();
+}
+
 void CTxMemPool::PrioritiseTransaction(const uint256& hash, const CAmount& nFeeDelta)
 {
     {
@@ -1421,7 +1364,7 @@ bool CCoinsViewMemPool::GetCoin(const COutPoint &outpoint, Coin &coin) const {
 size_t CTxMemPool::DynamicMemoryUsage() const {
     LOCK(cs);
     // Estimate the overhead of mapTx to be 12 pointers + an allocation, as no exact formula for boost::multi_index_contained is implemented.
-    return memusage::MallocUsage(sizeof(CTxMemPoolEntry) + 12 * sizeof(void*)) * mapTx.size() + memusage::DynamicUsage(mapNextTx) + memusage::DynamicUsage(mapDeltas) + memusage::DynamicUsage(mapLinks) + memusage::DynamicUsage(vTxHashes) + cachedInnerUsage;
+    return memusage::MallocUsage(sizeof(CTxMemPoolEntry) + 12 * sizeof(void*)) * mapTx.size() + memusage::DynamicUsage(mapNextTx) + memusage::DynamicUsage(mapDeltas) + memusage::DynamicUsage(mapLinks) + memusage::DynamicUsage(vTxHashes) + m_specialtx_index->DynamicMemoryUsage() + cachedInnerUsage;
 }
 
 void CTxMemPool::RemoveUnbroadcastTx(const uint256& txid, const bool unchecked) {
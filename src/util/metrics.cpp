@@ -0,0 +1,145 @@
+// Copyright (c) 2023 The Dash Core developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <util/metrics.h>
+
+#include <sync.h>
+
+#include <algorithm>
+#include <memory>
+
+namespace metrics {
+
+namespace {
+struct Registry {
+    Mutex cs;
+    std::map<std::string, std::unique_ptr<Counter>> counters GUARDED_BY(cs);
+    std::map<std::string, std::unique_ptr<Gauge>> gauges GUARDED_BY(cs);
+    std::map<std::string, std::unique_ptr<Histogram>> histograms GUARDED_BY(cs);
+};
+
+Registry& GetRegistry()
+{
+    // never destroyed, metrics may still be updated by threads which outlive static destruction
+    static Registry* registry = new Registry();
+    return *registry;
+}
+
+template <typename T>
+T& GetOrCreate(Mutex& cs, std::map<std::string, std::unique_ptr<T>>& map, const std::string& name)
+{
+    LOCK(cs);
+    auto& ptr = map[name];
+    if (!ptr) ptr = std::make_unique<T>();
+    return *ptr;
+}
+} // anonymous namespace
+
+size_t GetThreadStripe()
+{
+    static std::atomic<size_t> next_stripe{0};
+    thread_local const size_t stripe = next_stripe++ % COUNTER_STRIPES;
+    return stripe;
+}
+
+uint64_t Counter::Get() const
+{
+    uint64_t ret{0};
+    for (const auto& stripe : m_stripes) {
+        ret += stripe.value.load(std::memory_order_relaxed);
+    }
+    return ret;
+}
+
+void Histogram::Observe(int64_t value_us)
+{
+    // durations measured with a non-monotonic clock can come out negative
+    const uint64_t value = std::max<int64_t>(value_us, 0);
+    size_t bucket{0};
+    while (bucket < BUCKETS - 1 && value >= (uint64_t{1} << bucket)) {
+        ++bucket;
+    }
+    m_buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    m_sum.fetch_add(value, std::memory_order_relaxed);
+    uint64_t max = m_max.load(std::memory_order_relaxed);
+    while (value > max && !m_max.compare_exchange_weak(max, value, std::memory_order_relaxed)) {}
+}
+
+Histogram::Snapshot Histogram::GetSnapshot() const
+{
+    Snapshot ret;
+    for (size_t i = 0; i < BUCKETS; ++i) {
+        ret.buckets[i] = m_buckets[i].load(std::memory_order_relaxed);
+        ret.count += ret.buckets[i];
+    }
+    ret.sum = m_sum.load(std::memory_order_relaxed);
+    ret.max = m_max.load(std::memory_order_relaxed);
+    return ret;
+}
+
+uint64_t Histogram::Snapshot::Quantile(double q) const
+{
+    if (count == 0) return 0;
+    const uint64_t rank = std::max<uint64_t>(1, q * count);
+    uint64_t seen{0};
+    for (size_t i = 0; i < BUCKETS - 1; ++i) {
+        seen += buckets[i];
+        if (seen >= rank) return std::min(uint64_t{1} << i, max);
+    }
+    return max;
+}
+
+Histogram::Snapshot Histogram::Snapshot::Since(const Snapshot& prev) const
+{
+    Snapshot ret;
+    for (size_t i = 0; i < BUCKETS; ++i) {
+        ret.buckets[i] = buckets[i] - prev.buckets[i];
+        ret.count += ret.buckets[i];
+        if (ret.buckets[i] != 0) ret.max = i < BUCKETS - 1 ? std::min(uint64_t{1} << i, max) : max;
+    }
+    ret.sum = sum - prev.sum;
+    return ret;
+}
+
+ScopedTimer::~ScopedTimer()
+{
+    m_histogram.Observe(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_start).count());
+}
+
+Counter& GetCounter(const std::string& name)
+{
+    auto& registry = GetRegistry();
+    return GetOrCreate(registry.cs, registry.counters, name);
+}
+
+Gauge& GetGauge(const std::string& name)
+{
+    auto& registry = GetRegistry();
+    return GetOrCreate(registry.cs, registry.gauges, name);
+}
+
+Histogram& GetHistogram(const std::string& name)
+{
+    auto& registry = GetRegistry();
+    return GetOrCreate(registry.cs, registry.histograms, name);
+}
+
+Snapshot GetSnapshot()
+{
+    auto& registry = GetRegistry();
+    Snapshot ret;
+    LOCK(registry.cs);
+    for (const auto& [name, counter] : registry.counters) {
+        ret.counters.emplace(name, counter->Get());
+    }
+    for (const auto& [name, gauge] : registry.gauges) {
+        ret.gauges.emplace(name, gauge->Get());
+    }
+    for (const auto& [name, histogram] : registry.histograms) {
+        ret.histograms.emplace(name, histogram->GetSnapshot());
+    }
+    return ret;
+}
+
+} // namespace metrics
@@ -0,0 +1,118 @@
+// Copyright (c) 2023 The Dash Core developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_UTIL_METRICS_H
+#define BITCOIN_UTIL_METRICS_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <string>
+
+/**
+ * Registry of counters, gauges and latency histograms any subsystem can publish to.
+ *
+ * Metrics are looked up by name once, usually into a function-local static, and updating them
+ * afterwards is lock-free:
+ *
+ *     static auto& hist = metrics::GetHistogram("llmq.signing.recovery_us");
+ *     hist.Observe(duration_us);
+ *
+ * The registry is pulled by the getmetrics RPC and the /rest/metrics endpoint and pushed to statsd.
+ */
+namespace metrics {
+
+/** Number of slots counters are striped over, threads pick a slot to avoid sharing cache lines */
+static constexpr size_t COUNTER_STRIPES = 16;
+
+struct alignas(64) CounterStripe {
+    std::atomic<uint64_t> value{0};
+};
+
+size_t GetThreadStripe();
+
+/** Monotonically increasing count of events */
+class Counter
+{
+private:
+    std::array<CounterStripe, COUNTER_STRIPES> m_stripes;
+
+public:
+    void Inc(uint64_t n = 1) { m_stripes[GetThreadStripe()].value.fetch_add(n, std::memory_order_relaxed); }
+    uint64_t Get() const;
+};
+
+/** Value which can go up and down */
+class Gauge
+{
+private:
+    std::atomic<double> m_value{0};
+
+public:
+    void Set(double value) { m_value.store(value, std::memory_order_relaxed); }
+    double Get() const { return m_value.load(std::memory_order_relaxed); }
+};
+
+/** Distribution of durations in microseconds over buckets growing by powers of two */
+class Histogram
+{
+public:
+    /** Bucket i counts values below 2^i microseconds, the last one everything else (about 36 minutes and more) */
+    static constexpr size_t BUCKETS = 32;
+
+    struct Snapshot {
+        uint64_t count{0};
+        uint64_t sum{0};
+        uint64_t max{0};
+        std::array<uint64_t, BUCKETS> buckets{};
+
+        /** Upper bound of the bucket the given quantile falls into */
+        uint64_t Quantile(double q) const;
+        /** Observations made since the earlier snapshot prev. The exact maximum isn't known for a period, it's
+         *  the upper bound of the highest bucket which got observations, capped by the overall maximum. */
+        Snapshot Since(const Snapshot& prev) const;
+    };
+
+private:
+    std::array<std::atomic<uint64_t>, BUCKETS> m_buckets{};
+    std::atomic<uint64_t> m_sum{0};
+    std::atomic<uint64_t> m_max{0};
+
+public:
+    void Observe(int64_t value_us);
+    /** Total of all observed values */
+    uint64_t Sum() const { return m_sum.load(std::memory_order_relaxed); }
+    Snapshot GetSnapshot() const;
+};
+
+/** Records the time until it goes out of scope into a histogram */
+class ScopedTimer
+{
+private:
+    Histogram& m_histogram;
+    const std::chrono::steady_clock::time_point m_start;
+
+public:
+    explicit ScopedTimer(Histogram& histogram) : m_histogram(histogram), m_start(std::chrono::steady_clock::now()) {}
+    ~ScopedTimer();
+};
+
+/** Get or create the metric of the given name. The returned references stay valid until shutdown. */
+Counter& GetCounter(const std::string& name);
+Gauge& GetGauge(const std::string& name);
+Histogram& GetHistogram(const std::string& name);
+
+struct Snapshot {
+    std::map<std::string, uint64_t> counters;
+    std::map<std::string, double> gauges;
+    std::map<std::string, Histogram::Snapshot> histograms;
+};
+/** Current values of all registered metrics */
+Snapshot GetSnapshot();
+
+} // namespace metrics
+
+#endif // BITCOIN_UTIL_METRICS_H
@@ -43,6 +43,7 @@
 #include <uint256.h>
 #include <undo.h>
 #include <util/check.h> // For NDEBUG compile time check
+#include <util/metrics.h>
 #include <util/strencodings.h>
 #include <util/translation.h>
 #include <util/system.h>
@@ -52,6 +53,7 @@
 #include <masternode/payments.h>
 #include <masternode/sync.h>
 
+#include <evo/cbtx.h>
 #include <evo/deterministicmns.h>
 #include <evo/evodb.h>
 #include <evo/mnhftx.h>
@@ -160,6 +162,8 @@ int64_t nMaxTipAge = DEFAULT_MAX_TIP_AGE;
 std::atomic<bool> fDIP0001ActiveAtTip{false};
 
 uint256 hashAssumeValid;
+bool g_chainlock_fast_sync = DEFAULT_CHAINLOCK_FAST_SYNC;
+int g_input_prefetch_threads = DEFAULT_INPUT_PREFETCH_THREADS;
 arith_uint256 nMinimumChainWork;
 
 CFeeRate minRelayTxFee = CFeeRate(DEFAULT_MIN_RELAY_TX_FEE);
@@ -349,6 +353,9 @@ bool CheckSequenceLocks(CChainState& active_chainstate,
 
 bool GetUTXOCoin(const COutPoint& outpoint, Coin& coin)
 {
+    if (const auto read_cache = g_chainman.ActiveCoinsReadCache(); read_cache && read_cache->GetCoin(outpoint, coin)) {
+        return !coin.IsSpent();
+    }
     LOCK(cs_main);
     if (!::ChainstateActive().CoinsTip().GetCoin(outpoint, coin))
         return false;
@@ -836,7 +843,7 @@ bool MemPoolAccept::PreChecks(ATMPArgs& args, Workspace& ws)
     if (!CheckSpecialTx(tx, m_active_chainstate.m_chain.Tip(), m_active_chainstate.CoinsTip(), true, state))
         return false;
 
-    if (m_pool.existsProviderTxConflict(tx)) {
+    if (m_pool.existsProviderTxConflict(*entry)) {
         return state.Invalid(TxValidationResult::TX_CONFLICT, "protx-dup");
     }
 
@@ -944,7 +951,7 @@ bool MemPoolAccept::Finalize(ATMPArgs& args, Workspace& ws)
 
 bool MemPoolAccept::AcceptSingleTransaction(const CTransactionRef& ptx, ATMPArgs& args)
 {
-    auto start = Now<SteadyMilliseconds>();
+    auto start = Now<SteadyMicroseconds>();
     AssertLockHeld(cs_main);
     LOCK(m_pool.cs); // mempool "read lock" (held through GetMainSignals().TransactionAddedToMempool())
 
@@ -971,9 +978,10 @@ bool MemPoolAccept::AcceptSingleTransaction(const CTransactionRef& ptx, ATMPArgs
     GetMainSignals().TransactionAddedToMempool(ptx, nAcceptTime);
 
     const CTransaction& tx = *ptx;
-    auto finish = Now<SteadyMilliseconds>();
+    auto finish = Now<SteadyMicroseconds>();
     auto diff = finish - start;
-    statsClient.timing("AcceptToMemoryPool_ms", count_milliseconds(diff), 1.0f);
+    static metrics::Histogram& histAccept = metrics::GetHistogram("validation.accept_to_mempool_us");
+    histAccept.Observe(count_microseconds(diff));
     statsClient.inc("transactions.accepted", 1.0f);
     statsClient.count("transactions.inputs", tx.vin.size(), 1.0f);
     statsClient.count("transactions.outputs", tx.vout.size(), 1.0f);
@@ -1250,11 +1258,12 @@ CoinsViews::CoinsViews(
     bool in_memory,
     bool should_wipe) : m_dbview(
                             GetDataDir() / ldb_name, cache_size_bytes, in_memory, should_wipe),
-                        m_catcherview(&m_dbview) {}
+                        m_catcherview(&m_dbview),
+                        m_prefetchview(&m_catcherview, g_input_prefetch_threads) {}
 
 void CoinsViews::InitCache()
 {
-    m_cacheview = std::make_unique<CCoinsViewCache>(&m_catcherview);
+    m_cacheview = std::make_unique<CCoinsViewCache>(&m_prefetchview);
 }
 
 CChainState::CChainState(CTxMemPool* mempool,
@@ -1294,6 +1303,7 @@ void CChainState::InitCoinsCache(size_t cache_size_bytes)
     assert(m_coins_views != nullptr);
     m_coinstip_cache_size_bytes = cache_size_bytes;
     m_coins_views->InitCache();
+    m_coins_views->m_prefetchview.SetMaxUsage(cache_size_bytes / 100 * INPUT_PREFETCH_CACHE_PERCENT);
 }
 
 // Note that though this is marked const, we may end up modifying `m_cached_finished_ibd`, which
@@ -1492,7 +1502,7 @@ void InitScriptExecutionCache() {
  */
 bool CheckInputScripts(const CTransaction& tx, TxValidationState &state, const CCoinsViewCache &inputs, unsigned int flags, bool cacheSigStore, bool cacheFullScriptStore, PrecomputedTransactionData& txdata, std::vector<CScriptCheck> *pvChecks) EXCLUSIVE_LOCKS_REQUIRED(cs_main)
 {
-    auto start = Now<SteadyMilliseconds>();
+    auto start = Now<SteadyMicroseconds>();
     if (tx.IsCoinBase()) return true;
 
     if (pvChecks) {
@@ -1569,9 +1579,10 @@ bool CheckInputScripts(const CTransaction& tx, TxValidationState &state, const C
         g_scriptExecutionCache.insert(hashCacheEntry);
     }
 
-    auto finish = Now<SteadyMilliseconds>();
+    auto finish = Now<SteadyMicroseconds>();
     auto diff = finish - start;
-    statsClient.timing("CheckInputScripts_ms", count_milliseconds(diff), 1.0f);
+    static metrics::Histogram& histCheckInputs = metrics::GetHistogram("validation.check_input_scripts_us");
+    histCheckInputs.Observe(count_microseconds(diff));
     return true;
 }
 
@@ -1688,7 +1699,7 @@ DisconnectResult CChainState::DisconnectBlock(const CBlock& block, const CBlockI
         return DISCONNECT_FAILED;
     }
 
-    auto start = Now<SteadyMilliseconds>();
+    auto start = Now<SteadyMicroseconds>();
 
     bool fClean = true;
 
@@ -1830,9 +1841,10 @@ DisconnectResult CChainState::DisconnectBlock(const CBlock& block, const CBlockI
         uiInterface.NotifyMasternodeListChanged(mnlu.new_list, pindex->pprev);
     }
 
-    auto finish = Now<SteadyMilliseconds>();
+    auto finish = Now<SteadyMicroseconds>();
     auto diff = finish - start;
-    statsClient.timing("DisconnectBlock_ms", count_milliseconds(diff), 1.0f);
+    static metrics::Histogram& histDisconnect = metrics::GetHistogram("validation.disconnect_block_us");
+    histDisconnect.Observe(count_microseconds(diff));
 
     return fClean ? DISCONNECT_OK : DISCONNECT_UNCLEAN;
 }
@@ -1975,23 +1987,116 @@ static unsigned int GetBlockScriptFlags(const CBlockIndex* pindex, const Consens
 
 
 
-static int64_t nTimeCheck = 0;
-static int64_t nTimeForks = 0;
-static int64_t nTimeVerify = 0;
-static int64_t nTimeISFilter = 0;
-static int64_t nTimeSubsidy = 0;
-static int64_t nTimeCreditPool = 0;
-static int64_t nTimeValueValid = 0;
-static int64_t nTimePayeeValid = 0;
-static int64_t nTimeProcessSpecial = 0;
-static int64_t nTimeDashSpecific = 0;
-static int64_t nTimeConnect = 0;
-static int64_t nTimeIndexConnect = 0;
-static int64_t nTimeIndexWrite = 0;
-static int64_t nTimeCallbacks = 0;
-static int64_t nTimeTotal = 0;
+static metrics::Histogram& histCheck = metrics::GetHistogram("validation.connectblock.check_us");
+static metrics::Histogram& histForks = metrics::GetHistogram("validation.connectblock.forks_us");
+static metrics::Histogram& histVerify = metrics::GetHistogram("validation.connectblock.verify_us");
+static metrics::Histogram& histScriptWait = metrics::GetHistogram("validation.connectblock.script_wait_us");
+static metrics::Histogram& histISFilter = metrics::GetHistogram("validation.connectblock.is_filter_us");
+static metrics::Histogram& histSubsidy = metrics::GetHistogram("validation.connectblock.subsidy_us");
+static metrics::Histogram& histCreditPool = metrics::GetHistogram("validation.connectblock.credit_pool_us");
+static metrics::Histogram& histValueValid = metrics::GetHistogram("validation.connectblock.value_valid_us");
+static metrics::Histogram& histPayeeValid = metrics::GetHistogram("validation.connectblock.payee_valid_us");
+static metrics::Histogram& histProcessSpecial = metrics::GetHistogram("validation.connectblock.process_special_us");
+static metrics::Histogram& histDashSpecific = metrics::GetHistogram("validation.connectblock.dash_specific_us");
+static metrics::Histogram& histConnect = metrics::GetHistogram("validation.connectblock.connect_us");
+static metrics::Histogram& histIndexConnect = metrics::GetHistogram("validation.connectblock.index_connect_us");
+static metrics::Histogram& histIndexWrite = metrics::GetHistogram("validation.connectblock.index_write_us");
+static metrics::Histogram& histCallbacks = metrics::GetHistogram("validation.connectblock.callbacks_us");
+static metrics::Histogram& histTotal = metrics::GetHistogram("validation.connecttip.total_us");
 static int64_t nBlocksTotal = 0;
 
+/** Blocks connected without script checks under -chainlockfastsync are logged in ranges of at most this many blocks */
+static constexpr int CHAINLOCK_FAST_SYNC_LOG_BLOCKS{1000};
+
+namespace {
+/** The range of consecutive blocks most recently connected without script checks because of a ChainLock */
+struct ChainLockSkippedRange {
+    const CBlockIndex* first{nullptr};
+    const CBlockIndex* last{nullptr};
+    llmq::CChainLockSig clsig;
+};
+} // namespace
+static ChainLockSkippedRange g_chainlock_skipped_range GUARDED_BY(cs_main);
+
+static void LogChainLockSkippedRange() EXCLUSIVE_LOCKS_REQUIRED(cs_main)
+{
+    auto& range = g_chainlock_skipped_range;
+    if (range.first == nullptr) return;
+    LogPrintf("Skipped script verification of blocks %d (%s) to %d (%s) under ChainLock %s\n",
+              range.first->nHeight, range.first->GetBlockHash().ToString(), range.last->nHeight, range.last->GetBlockHash().ToString(),
+              range.clsig.ToString());
+    range = {};
+}
+
+static void AddChainLockSkippedBlock(const CBlockIndex* pindex, const llmq::CChainLockSig& clsig) EXCLUSIVE_LOCKS_REQUIRED(cs_main)
+{
+    auto& range = g_chainlock_skipped_range;
+    if (range.first != nullptr && (range.last != pindex->pprev || pindex->nHeight - range.first->nHeight >= CHAINLOCK_FAST_SYNC_LOG_BLOCKS)) {
+        LogChainLockSkippedRange();
+    }
+    if (range.first == nullptr) {
+        LogPrintf("Skipping script verification of blocks from %d (%s) on, buried under ChainLock %s\n",
+                  pindex->nHeight, pindex->GetBlockHash().ToString(), clsig.ToString());
+        range.first = pindex;
+    }
+    range.last = pindex;
+    range.clsig = clsig;
+}
+
+namespace {
+/** The best ChainLock found in the CbTx of a block which was downloaded but not connected yet */
+struct CbTxChainLock {
+    const CBlockIndex* pindex{nullptr}; //!< the ChainLocked block
+    llmq::CChainLockSig clsig;
+    const CBlockIndex* pindexScanned{nullptr}; //!< the highest block whose CbTx was looked at
+};
+} // namespace
+static CbTxChainLock g_cbtx_chainlock GUARDED_BY(cs_main);
+
+/**
+ * Find a verified ChainLock which buries pindex in the CbTx of the blocks above it on the best header chain.
+ * A ChainLock for height H is signed by a quorum selected at H - SIGN_HEIGHT_OFFSET, so only the ones for
+ * the next few blocks can be verified against the quorums known from the chain connected so far.
+ */
+static std::optional<llmq::CChainLockSig> FindCbTxChainLock(const CBlockIndex* pindex, const llmq::CChainLocksHandler& clhandler,
+                                                            const Consensus::Params& params) EXCLUSIVE_LOCKS_REQUIRED(cs_main)
+{
+    auto& found = g_cbtx_chainlock;
+    if (found.pindex != nullptr && found.pindex->GetAncestor(pindex->nHeight) == pindex) return found.clsig;
+    if (pindexBestHeader == nullptr || pindexBestHeader->GetAncestor(pindex->nHeight) != pindex) return std::nullopt;
+
+    // the chain is connected up to the parent of pindex
+    const int max_cl_height = std::min(pindex->nHeight - 1 + llmq::CSigningManager::SIGN_HEIGHT_OFFSET, pindexBestHeader->nHeight - 1);
+    int height = pindex->nHeight + 1;
+    if (found.pindexScanned != nullptr && pindexBestHeader->GetAncestor(found.pindexScanned->nHeight) == found.pindexScanned) {
+        // blocks which were looked at already had no ChainLock for this height or above which could be verified
+        height = std::max(height, found.pindexScanned->nHeight + 1);
+    }
+    for (; height <= max_cl_height + 1; ++height) {
+        const CBlockIndex* pindexCbTx = pindexBestHeader->GetAncestor(height);
+        if (!(pindexCbTx->nStatus & BLOCK_HAVE_DATA)) break;
+        found.pindexScanned = pindexCbTx;
+
+        // only the coinbase is needed, don't read whole blocks while holding cs_main
+        CTransactionRef coinbase;
+        if (!DeploymentActiveAt(*pindexCbTx, params, Consensus::DEPLOYMENT_V20) || !ReadCoinbaseFromDisk(coinbase, pindexCbTx)) continue;
+        const auto opt_cbTx = GetTxPayload<CCbTx>(*coinbase);
+        if (!opt_cbTx || opt_cbTx->nVersion < CCbTx::Version::CLSIG_AND_BALANCE || !opt_cbTx->bestCLSignature.IsValid()) continue;
+        // a block carries a ChainLock for its parent or one of its ancestors
+        const int64_t cl_height = int64_t{height} - 1 - opt_cbTx->bestCLHeightDiff;
+        if (cl_height < pindex->nHeight || (found.pindex != nullptr && cl_height <= found.pindex->nHeight)) continue;
+
+        const CBlockIndex* pindexCL = pindexBestHeader->GetAncestor(cl_height);
+        const llmq::CChainLockSig clsig(cl_height, pindexCL->GetBlockHash(), opt_cbTx->bestCLSignature);
+        if (clhandler.VerifyChainLock(clsig)) {
+            found.pindex = pindexCL;
+            found.clsig = clsig;
+        }
+    }
+    if (found.pindex != nullptr && found.pindex->GetAncestor(pindex->nHeight) == pindex) return found.clsig;
+    return std::nullopt;
+}
+
 /** Apply the effects of this block (with given index) on the UTXO set represented by coins.
  *  Validity checks that depend on the UTXO set are also done; ConnectBlock()
  *  can fail if those validity checks fail (among other reasons). */
@@ -2090,8 +2195,28 @@ bool CChainState::ConnectBlock(const CBlock& block, BlockValidationState& state,
         }
     }
 
-    int64_t nTime1 = GetTimeMicros(); nTimeCheck += nTime1 - nTimeStart;
-    LogPrint(BCLog::BENCHMARK, "    - Sanity checks: %.2fms [%.2fs (%.2fms/blk)]\n", MILLI * (nTime1 - nTimeStart), nTimeCheck * MICRO, nTimeCheck * MILLI / nBlocksTotal);
+    if (!fJustCheck) {
+        std::optional<llmq::CChainLockSig> clsig;
+        if (fScriptChecks && g_chainlock_fast_sync) {
+            if (m_clhandler->HasChainLock(pindex->nHeight, block_hash)) {
+                clsig = m_clhandler->GetBestChainLock();
+            } else if (this == &::ChainstateActive()) {
+                clsig = FindCbTxChainLock(pindex, *m_clhandler, m_params.GetConsensus());
+            }
+        }
+        if (clsig) {
+            // This block is buried under a ChainLock which was verified against the LLMQ responsible for its
+            // height and a quorum only signs blocks its members consider valid, so script verification is
+            // skipped like for assumevalid. Merkle roots, amounts and the evo state are still checked.
+            fScriptChecks = false;
+            AddChainLockSkippedBlock(pindex, *clsig);
+        } else {
+            LogChainLockSkippedRange();
+        }
+    }
+
+    int64_t nTime1 = GetTimeMicros(); histCheck.Observe(nTime1 - nTimeStart);
+    LogPrint(BCLog::BENCHMARK, "    - Sanity checks: %.2fms [%.2fs (%.2fms/blk)]\n", MILLI * (nTime1 - nTimeStart), histCheck.Sum() * MICRO, histCheck.Sum() * MILLI / nBlocksTotal);
 
     // Do not allow blocks that contain transactions which 'overwrite' older transactions,
     // unless those are already completely spent.
@@ -2150,8 +2275,8 @@ bool CChainState::ConnectBlock(const CBlock& block, BlockValidationState& state,
     // Get the script flags for this block
     unsigned int flags = GetBlockScriptFlags(pindex, m_params.GetConsensus());
 
-    int64_t nTime2 = GetTimeMicros(); nTimeForks += nTime2 - nTime1;
-    LogPrint(BCLog::BENCHMARK, "    - Fork checks: %.2fms [%.2fs (%.2fms/blk)]\n", MILLI * (nTime2 - nTime1), nTimeForks * MICRO, nTimeForks * MILLI / nBlocksTotal);
+    int64_t nTime2 = GetTimeMicros(); histForks.Observe(nTime2 - nTime1);
+    LogPrint(BCLog::BENCHMARK, "    - Fork checks: %.2fms [%.2fs (%.2fms/blk)]\n", MILLI * (nTime2 - nTime1), histForks.Sum() * MICRO, histForks.Sum() * MILLI / nBlocksTotal);
 
     CBlockUndo blockundo;
 
@@ -2181,8 +2306,8 @@ bool CChainState::ConnectBlock(const CBlock& block, BlockValidationState& state,
                      pindex->GetBlockHash().ToString(), state.ToString());
     }
 
-    int64_t nTime2_1 = GetTimeMicros(); nTimeProcessSpecial += nTime2_1 - nTime2;
-    LogPrint(BCLog::BENCHMARK, "      - ProcessSpecialTxsInBlock: %.2fms [%.2fs (%.2fms/blk)]\n", MILLI * (nTime2_1 - nTime2), nTimeProcessSpecial * MICRO, nTimeProcessSpecial * MILLI / nBlocksTotal);
+    int64_t nTime2_1 = GetTimeMicros(); histProcessSpecial.Observe(nTime2_1 - nTime2);
+    LogPrint(BCLog::BENCHMARK, "      - ProcessSpecialTxsInBlock: %.2fms [%.2fs (%.2fms/blk)]\n", MILLI * (nTime2_1 - nTime2), histProcessSpecial.Sum() * MICRO, histProcessSpecial.Sum() * MILLI / nBlocksTotal);
 
     int64_t nTime2_index = 0;
 
@@ -2308,21 +2433,62 @@ bool CChainState::ConnectBlock(const CBlock& block, BlockValidationState& state,
         UpdateCoins(tx, view, i == 0 ? undoDummy : blockundo.vtxundo.back(), pindex->nHeight);
     }
 
-    nTimeIndexConnect += nTime2_index;
-    LogPrint(BCLog::BENCHMARK, "        - Connect index: %.2fms [%.2fs (%.2fms/blk)]\n", MILLI * nTime2_index, nTimeIndexConnect * MICRO, nTimeIndexConnect * MILLI / nBlocksTotal);
-    int64_t nTime3 = GetTimeMicros(); nTimeConnect += nTime3 - nTime2;
-    LogPrint(BCLog::BENCHMARK, "      - Connect %u transactions: %.2fms (%.3fms/tx, %.3fms/txin) [%.2fs (%.2fms/blk)]\n", (unsigned)block.vtx.size(), MILLI * (nTime3 - nTime2), MILLI * (nTime3 - nTime2) / block.vtx.size(), nInputs <= 1 ? 0 : MILLI * (nTime3 - nTime2) / (nInputs-1), nTimeConnect * MICRO, nTimeConnect * MILLI / nBlocksTotal);
+    histIndexConnect.Observe(nTime2_index);
+    LogPrint(BCLog::BENCHMARK, "        - Connect index: %.2fms [%.2fs (%.2fms/blk)]\n", MILLI * nTime2_index, histIndexConnect.Sum() * MICRO, histIndexConnect.Sum() * MILLI / nBlocksTotal);
+    int64_t nTime3 = GetTimeMicros(); histConnect.Observe(nTime3 - nTime2);
+    LogPrint(BCLog::BENCHMARK, "      - Connect %u transactions: %.2fms (%.3fms/tx, %.3fms/txin) [%.2fs (%.2fms/blk)]\n", (unsigned)block.vtx.size(), MILLI * (nTime3 - nTime2), MILLI * (nTime3 - nTime2) / block.vtx.size(), nInputs <= 1 ? 0 : MILLI * (nTime3 - nTime2) / (nInputs-1), histConnect.Sum() * MICRO, histConnect.Sum() * MILLI / nBlocksTotal);
+
+
+    // DASH : MODIFIED TO CHECK MASTERNODE PAYMENTS AND SUPERBLOCKS
+
+    // These checks don't depend on the results of the script checks, run them while the script check
+    // threads are still busy and only act on their result once the script checks are done. A script
+    // failure and the IS filter below take precedence, like they did when these ran last.
+    BlockValidationState dash_state;
+
+    // TODO: resync data (both ways?) and try to reprocess this block later.
+    CAmount blockSubsidy = GetBlockSubsidy(pindex, m_params.GetConsensus());
+    CAmount feeReward = nFees;
+    std::string strError = "";
+
+    int64_t nTime3_1 = GetTimeMicros(); histSubsidy.Observe(nTime3_1 - nTime3);
+    LogPrint(BCLog::BENCHMARK, "      - GetBlockSubsidy: %.2fms [%.2fs (%.2fms/blk)]\n", MILLI * (nTime3_1 - nTime3), histSubsidy.Sum() * MICRO, histSubsidy.Sum() * MILLI / nBlocksTotal);
+
+    if (!CheckCreditPoolDiffForBlock(block, pindex, m_params.GetConsensus(), blockSubsidy, dash_state)) {
+        LogPrintf("ERROR: ConnectBlock(DASH): CheckCreditPoolDiffForBlock for block %s failed with %s\n",
+                  pindex->GetBlockHash().ToString(), dash_state.ToString());
+    }
+
+    int64_t nTime3_2 = GetTimeMicros(); histCreditPool.Observe(nTime3_2 - nTime3_1);
+    LogPrint(BCLog::BENCHMARK, "      - CheckCreditPoolDiffForBlock: %.2fms [%.2fs (%.2fms/blk)]\n", MILLI * (nTime3_2 - nTime3_1), histCreditPool.Sum() * MICRO, histCreditPool.Sum() * MILLI / nBlocksTotal);
+
+    if (dash_state.IsValid() && !MasternodePayments::IsBlockValueValid(*sporkManager, *governance, *::masternodeSync, block, pindex->nHeight, blockSubsidy + feeReward, strError)) {
+        // NOTE: Do not punish, the node might be missing governance data
+        LogPrintf("ERROR: ConnectBlock(DASH): %s\n", strError);
+        dash_state.Invalid(BlockValidationResult::BLOCK_RESULT_UNSET, "bad-cb-amount");
+    }
 
+    int64_t nTime3_3 = GetTimeMicros(); histValueValid.Observe(nTime3_3 - nTime3_2);
+    LogPrint(BCLog::BENCHMARK, "      - IsBlockValueValid: %.2fms [%.2fs (%.2fms/blk)]\n", MILLI * (nTime3_3 - nTime3_2), histValueValid.Sum() * MICRO, histValueValid.Sum() * MILLI / nBlocksTotal);
+
+    if (dash_state.IsValid() && !MasternodePayments::IsBlockPayeeValid(*sporkManager, *governance, *::masternodeSync, *block.vtx[0], pindex->pprev, blockSubsidy, feeReward)) {
+        // NOTE: Do not punish, the node might be missing governance data
+        LogPrintf("ERROR: ConnectBlock(DASH): couldn't find masternode or superblock payments\n");
+        dash_state.Invalid(BlockValidationResult::BLOCK_RESULT_UNSET, "bad-cb-payee");
+    }
+
+    int64_t nTime3_4 = GetTimeMicros(); histPayeeValid.Observe(nTime3_4 - nTime3_3);
+    LogPrint(BCLog::BENCHMARK, "      - IsBlockPayeeValid: %.2fms [%.2fs (%.2fms/blk)]\n", MILLI * (nTime3_4 - nTime3_3), histPayeeValid.Sum() * MICRO, histPayeeValid.Sum() * MILLI / nBlocksTotal);
 
     if (!control.Wait()) {
         LogPrintf("ERROR: %s: CheckQueue failed\n", __func__);
         return state.Invalid(BlockValidationResult::BLOCK_CONSENSUS, "block-validation-failed");
     }
-    int64_t nTime4 = GetTimeMicros(); nTimeVerify += nTime4 - nTime2;
-    LogPrint(BCLog::BENCHMARK, "    - Verify %u txins: %.2fms (%.3fms/txin) [%.2fs (%.2fms/blk)]\n", nInputs - 1, MILLI * (nTime4 - nTime2), nInputs <= 1 ? 0 : MILLI * (nTime4 - nTime2) / (nInputs-1), nTimeVerify * MICRO, nTimeVerify * MILLI / nBlocksTotal);
-
+    int64_t nTime4 = GetTimeMicros(); histVerify.Observe(nTime4 - nTime2);
+    LogPrint(BCLog::BENCHMARK, "    - Verify %u txins: %.2fms (%.3fms/txin) [%.2fs (%.2fms/blk)]\n", nInputs - 1, MILLI * (nTime4 - nTime2), nInputs <= 1 ? 0 : MILLI * (nTime4 - nTime2) / (nInputs-1), histVerify.Sum() * MICRO, histVerify.Sum() * MILLI / nBlocksTotal);
+    histScriptWait.Observe(nTime4 - nTime3_4);
+    LogPrint(BCLog::BENCHMARK, "      - Wait for script checks: %.2fms [%.2fs (%.2fms/blk)]\n", MILLI * (nTime4 - nTime3_4), histScriptWait.Sum() * MICRO, histScriptWait.Sum() * MILLI / nBlocksTotal);
 
-    // DASH
 
     // It's possible that we simply don't have enough data and this could fail
     // (i.e. block itself could be a correct one and we need to store it),
@@ -2332,6 +2498,7 @@ bool CChainState::ConnectBlock(const CBlock& block, BlockValidationState& state,
 
     // DASH : CHECK TRANSACTIONS FOR INSTANTSEND
 
+    // Not overlapped with the script checks: resolving conflicts removes islocks, which must not happen for invalid blocks
     if (m_isman->RejectConflictingBlocks()) {
         // Require other nodes to comply, send them some data in case they are missing it.
         for (const auto& tx : block.vtx) {
@@ -2352,47 +2519,16 @@ bool CChainState::ConnectBlock(const CBlock& block, BlockValidationState& state,
         }
     }
 
-    int64_t nTime5_1 = GetTimeMicros(); nTimeISFilter += nTime5_1 - nTime4;
-    LogPrint(BCLog::BENCHMARK, "      - IS filter: %.2fms [%.2fs (%.2fms/blk)]\n", MILLI * (nTime5_1 - nTime4), nTimeISFilter * MICRO, nTimeISFilter * MILLI / nBlocksTotal);
-
-    // DASH : MODIFIED TO CHECK MASTERNODE PAYMENTS AND SUPERBLOCKS
-
-    // TODO: resync data (both ways?) and try to reprocess this block later.
-    CAmount blockSubsidy = GetBlockSubsidy(pindex, m_params.GetConsensus());
-    CAmount feeReward = nFees;
-    std::string strError = "";
+    int64_t nTime5 = GetTimeMicros(); histISFilter.Observe(nTime5 - nTime4);
+    LogPrint(BCLog::BENCHMARK, "      - IS filter: %.2fms [%.2fs (%.2fms/blk)]\n", MILLI * (nTime5 - nTime4), histISFilter.Sum() * MICRO, histISFilter.Sum() * MILLI / nBlocksTotal);
 
-    int64_t nTime5_2 = GetTimeMicros(); nTimeSubsidy += nTime5_2 - nTime5_1;
-    LogPrint(BCLog::BENCHMARK, "      - GetBlockSubsidy: %.2fms [%.2fs (%.2fms/blk)]\n", MILLI * (nTime5_2 - nTime5_1), nTimeSubsidy * MICRO, nTimeSubsidy * MILLI / nBlocksTotal);
-
-    if (!CheckCreditPoolDiffForBlock(block, pindex, m_params.GetConsensus(), blockSubsidy, state)) {
-        return error("ConnectBlock(DASH): CheckCreditPoolDiffForBlock for block %s failed with %s",
-                     pindex->GetBlockHash().ToString(), state.ToString());
-    }
-
-    int64_t nTime5_3 = GetTimeMicros(); nTimeCreditPool += nTime5_3 - nTime5_2;
-    LogPrint(BCLog::BENCHMARK, "      - CheckCreditPoolDiffForBlock: %.2fms [%.2fs (%.2fms/blk)]\n", MILLI * (nTime5_3 - nTime5_2), nTimeCreditPool * MICRO, nTimeCreditPool * MILLI / nBlocksTotal);
-
-    if (!MasternodePayments::IsBlockValueValid(*sporkManager, *governance, *::masternodeSync, block, pindex->nHeight, blockSubsidy + feeReward, strError)) {
-        // NOTE: Do not punish, the node might be missing governance data
-        LogPrintf("ERROR: ConnectBlock(DASH): %s\n", strError);
-        return state.Invalid(BlockValidationResult::BLOCK_RESULT_UNSET, "bad-cb-amount");
-    }
-
-    int64_t nTime5_4 = GetTimeMicros(); nTimeValueValid += nTime5_4 - nTime5_3;
-    LogPrint(BCLog::BENCHMARK, "      - IsBlockValueValid: %.2fms [%.2fs (%.2fms/blk)]\n", MILLI * (nTime5_4 - nTime5_3), nTimeValueValid * MICRO, nTimeValueValid * MILLI / nBlocksTotal);
-
-    if (!MasternodePayments::IsBlockPayeeValid(*sporkManager, *governance, *::masternodeSync, *block.vtx[0], pindex->pprev, blockSubsidy, feeReward)) {
-        // NOTE: Do not punish, the node might be missing governance data
-        LogPrintf("ERROR: ConnectBlock(DASH): couldn't find masternode or superblock payments\n");
-        return state.Invalid(BlockValidationResult::BLOCK_RESULT_UNSET, "bad-cb-payee");
+    if (!dash_state.IsValid()) {
+        state = dash_state;
+        return false;
     }
 
-    int64_t nTime5_5 = GetTimeMicros(); nTimePayeeValid += nTime5_5 - nTime5_4;
-    LogPrint(BCLog::BENCHMARK, "      - IsBlockPayeeValid: %.2fms [%.2fs (%.2fms/blk)]\n", MILLI * (nTime5_5 - nTime5_4), nTimePayeeValid * MICRO, nTimePayeeValid * MILLI / nBlocksTotal);
-
-    int64_t nTime5 = GetTimeMicros(); nTimeDashSpecific += nTime5 - nTime4;
-    LogPrint(BCLog::BENCHMARK, "    - Dash specific: %.2fms [%.2fs (%.2fms/blk)]\n", MILLI * (nTime5 - nTime4), nTimeDashSpecific * MICRO, nTimeDashSpecific * MILLI / nBlocksTotal);
+    histDashSpecific.Observe((nTime3_4 - nTime3) + (nTime5 - nTime4));
+    LogPrint(BCLog::BENCHMARK, "    - Dash specific: %.2fms [%.2fs (%.2fms/blk)]\n", MILLI * ((nTime3_4 - nTime3) + (nTime5 - nTime4)), histDashSpecific.Sum() * MICRO, histDashSpecific.Sum() * MILLI / nBlocksTotal);
 
     // END DASH
 
@@ -2428,8 +2564,8 @@ bool CChainState::ConnectBlock(const CBlock& block, BlockValidationState& state,
         if (!pblocktree->WriteTimestampIndex(CTimestampIndexKey(pindex->nTime, pindex->GetBlockHash())))
             return AbortNode(state, "Failed to write timestamp index");
 
-    int64_t nTime7 = GetTimeMicros(); nTimeIndexWrite += nTime7 - nTime6;
-    LogPrint(BCLog::BENCHMARK, "      - Index writing: %.2fms [%.2fs (%.2fms/blk)]\n", MILLI * (nTime7 - nTime6), nTimeIndexWrite * MICRO, nTimeIndexWrite * MILLI / nBlocksTotal);
+    int64_t nTime7 = GetTimeMicros(); histIndexWrite.Observe(nTime7 - nTime6);
+    LogPrint(BCLog::BENCHMARK, "      - Index writing: %.2fms [%.2fs (%.2fms/blk)]\n", MILLI * (nTime7 - nTime6), histIndexWrite.Sum() * MICRO, histIndexWrite.Sum() * MILLI / nBlocksTotal);
 
     assert(pindex->phashBlock);
     // add this block to the view's block chain
@@ -2442,10 +2578,11 @@ bool CChainState::ConnectBlock(const CBlock& block, BlockValidationState& state,
         uiInterface.NotifyMasternodeListChanged(mnlu.new_list, pindex);
     }
 
-    int64_t nTime8 = GetTimeMicros(); nTimeCallbacks += nTime8 - nTime5;
-    LogPrint(BCLog::BENCHMARK, "    - Callbacks: %.2fms [%.2fs (%.2fms/blk)]\n", MILLI * (nTime8 - nTime5), nTimeCallbacks * MICRO, nTimeCallbacks * MILLI / nBlocksTotal);
+    int64_t nTime8 = GetTimeMicros(); histCallbacks.Observe(nTime8 - nTime5);
+    LogPrint(BCLog::BENCHMARK, "    - Callbacks: %.2fms [%.2fs (%.2fms/blk)]\n", MILLI * (nTime8 - nTime5), histCallbacks.Sum() * MICRO, histCallbacks.Sum() * MILLI / nBlocksTotal);
 
-    statsClient.timing("ConnectBlock_ms", (nTime8 - nTimeStart) / 1000, 1.0f);
+    static metrics::Histogram& histConnectBlock = metrics::GetHistogram("validation.connectblock.total_us");
+    histConnectBlock.Observe(nTime8 - nTimeStart);
     statsClient.gauge("blocks.tip.SizeBytes", ::GetSerializeSize(block, PROTOCOL_VERSION), 1.0f);
     statsClient.gauge("blocks.tip.Height", m_chain.Height(), 1.0f);
     statsClient.gauge("blocks.tip.Version", block.nVersion, 1.0f);
@@ -2467,7 +2604,10 @@ CoinsCacheSizeState CChainState::GetCoinsCacheSizeState(
     size_t max_mempool_size_bytes)
 {
     const int64_t nMempoolUsage = m_mempool ? m_mempool->DynamicMemoryUsage() : 0;
-    int64_t cacheSize = CoinsTip().DynamicMemoryUsage();
+    // prefetched coins are dropped by the next flush just like the coins cache is emptied, and so are the copies of
+    // the unflushed changes the coins read cache keeps
+    int64_t cacheSize = CoinsTip().DynamicMemoryUsage() + m_coins_views->m_prefetchview.DynamicMemoryUsage() +
+                        m_coins_read_cache->DynamicMemoryUsage();
     int64_t nTotalSpace =
         max_coins_cache_size_bytes + std::max<int64_t>(int64_t(max_mempool_size_bytes) - nMempoolUsage, 0);
 
@@ -2627,6 +2767,12 @@ bool CChainState::FlushStateToDisk(
             nLastFlush = nNow;
             full_flush_completed = true;
         }
+        // Start the coins read cache once we are synced, and drop the changes it mirrors once they are flushed.
+        if ((full_flush_completed || !m_coins_read_cache->IsReady()) && !IsInitialBlockDownload()) {
+            if (const CBlockIndex* pindex_coins = m_blockman.LookupBlockIndex(CoinsTip().GetBestBlock())) {
+                m_coins_read_cache->Reset(CoinsErrorCatcher(), CoinsTip(), pindex_coins->nHeight);
+            }
+        }
     }
     if (full_flush_completed) {
         // Update best block in wallet (so we can detect restored wallets).
@@ -2746,6 +2892,7 @@ bool CChainState::DisconnectTip(BlockValidationState& state, DisconnectedBlockTr
         assert(view.GetBestBlock() == pindexDelete->GetBlockHash());
         if (DisconnectBlock(block, pindexDelete, view) != DISCONNECT_OK)
             return error("DisconnectTip(): DisconnectBlock %s failed", pindexDelete->GetBlockHash().ToString());
+        m_coins_read_cache->ApplyChanges(view, pindexDelete->nHeight - 1);
         bool flushed = view.Flush();
         assert(flushed);
         dbTx->Commit();
@@ -2778,11 +2925,11 @@ bool CChainState::DisconnectTip(BlockValidationState& state, DisconnectedBlockTr
     return true;
 }
 
-static int64_t nTimeReadFromDisk = 0;
-static int64_t nTimeConnectTotal = 0;
-static int64_t nTimeFlush = 0;
-static int64_t nTimeChainState = 0;
-static int64_t nTimePostConnect = 0;
+static metrics::Histogram& histReadFromDisk = metrics::GetHistogram("validation.connecttip.read_from_disk_us");
+static metrics::Histogram& histConnectTotal = metrics::GetHistogram("validation.connecttip.connect_us");
+static metrics::Histogram& histFlush = metrics::GetHistogram("validation.connecttip.flush_us");
+static metrics::Histogram& histChainState = metrics::GetHistogram("validation.connecttip.chainstate_us");
+static metrics::Histogram& histPostConnect = metrics::GetHistogram("validation.connecttip.post_connect_us");
 
 struct PerBlockConnectTrace {
     CBlockIndex* pindex = nullptr;
@@ -2850,9 +2997,9 @@ bool CChainState::ConnectTip(BlockValidationState& state, CBlockIndex* pindexNew
     }
     const CBlock& blockConnecting = *pthisBlock;
     // Apply the block atomically to the chain state.
-    int64_t nTime2 = GetTimeMicros(); nTimeReadFromDisk += nTime2 - nTime1;
+    int64_t nTime2 = GetTimeMicros(); histReadFromDisk.Observe(nTime2 - nTime1);
     int64_t nTime3;
-    LogPrint(BCLog::BENCHMARK, "  - Load block from disk: %.2fms [%.2fs]\n", (nTime2 - nTime1) * MILLI, nTimeReadFromDisk * MICRO);
+    LogPrint(BCLog::BENCHMARK, "  - Load block from disk: %.2fms [%.2fs]\n", (nTime2 - nTime1) * MILLI, histReadFromDisk.Sum() * MICRO);
     {
         auto dbTx = m_evoDb.BeginTransaction();
 
@@ -2864,21 +3011,22 @@ bool CChainState::ConnectTip(BlockValidationState& state, CBlockIndex* pindexNew
                 InvalidBlockFound(pindexNew, state);
             return error("%s: ConnectBlock %s failed, %s", __func__, pindexNew->GetBlockHash().ToString(), state.ToString());
         }
-        nTime3 = GetTimeMicros(); nTimeConnectTotal += nTime3 - nTime2;
+        nTime3 = GetTimeMicros(); histConnectTotal.Observe(nTime3 - nTime2);
         assert(nBlocksTotal > 0);
-        LogPrint(BCLog::BENCHMARK, "  - Connect total: %.2fms [%.2fs (%.2fms/blk)]\n", (nTime3 - nTime2) * MILLI, nTimeConnectTotal * MICRO, nTimeConnectTotal * MILLI / nBlocksTotal);
+        LogPrint(BCLog::BENCHMARK, "  - Connect total: %.2fms [%.2fs (%.2fms/blk)]\n", (nTime3 - nTime2) * MILLI, histConnectTotal.Sum() * MICRO, histConnectTotal.Sum() * MILLI / nBlocksTotal);
+        m_coins_read_cache->ApplyChanges(view, pindexNew->nHeight);
         bool flushed = view.Flush();
         assert(flushed);
         dbTx->Commit();
     }
-    int64_t nTime4 = GetTimeMicros(); nTimeFlush += nTime4 - nTime3;
-    LogPrint(BCLog::BENCHMARK, "  - Flush: %.2fms [%.2fs (%.2fms/blk)]\n", (nTime4 - nTime3) * MILLI, nTimeFlush * MICRO, nTimeFlush * MILLI / nBlocksTotal);
+    int64_t nTime4 = GetTimeMicros(); histFlush.Observe(nTime4 - nTime3);
+    LogPrint(BCLog::BENCHMARK, "  - Flush: %.2fms [%.2fs (%.2fms/blk)]\n", (nTime4 - nTime3) * MILLI, histFlush.Sum() * MICRO, histFlush.Sum() * MILLI / nBlocksTotal);
     // Write the chain state to disk, if necessary.
     if (!FlushStateToDisk(state, FlushStateMode::IF_NEEDED)) {
         return false;
     }
-    int64_t nTime5 = GetTimeMicros(); nTimeChainState += nTime5 - nTime4;
-    LogPrint(BCLog::BENCHMARK, "  - Writing chainstate: %.2fms [%.2fs (%.2fms/blk)]\n", (nTime5 - nTime4) * MILLI, nTimeChainState * MICRO, nTimeChainState * MILLI / nBlocksTotal);
+    int64_t nTime5 = GetTimeMicros(); histChainState.Observe(nTime5 - nTime4);
+    LogPrint(BCLog::BENCHMARK, "  - Writing chainstate: %.2fms [%.2fs (%.2fms/blk)]\n", (nTime5 - nTime4) * MILLI, histChainState.Sum() * MICRO, histChainState.Sum() * MILLI / nBlocksTotal);
     // Remove conflicting transactions from the mempool.;
     if (m_mempool) {
         m_mempool->removeForBlock(blockConnecting.vtx, pindexNew->nHeight);
@@ -2889,9 +3037,9 @@ bool CChainState::ConnectTip(BlockValidationState& state, CBlockIndex* pindexNew
     m_chain.SetTip(pindexNew);
     UpdateTip(pindexNew);
 
-    int64_t nTime6 = GetTimeMicros(); nTimePostConnect += nTime6 - nTime5; nTimeTotal += nTime6 - nTime1;
-    LogPrint(BCLog::BENCHMARK, "  - Connect postprocess: %.2fms [%.2fs (%.2fms/blk)]\n", (nTime6 - nTime5) * MILLI, nTimePostConnect * MICRO, nTimePostConnect * MILLI / nBlocksTotal);
-    LogPrint(BCLog::BENCHMARK, "- Connect block: %.2fms [%.2fs (%.2fms/blk)]\n", (nTime6 - nTime1) * MILLI, nTimeTotal * MICRO, nTimeTotal * MILLI / nBlocksTotal);
+    int64_t nTime6 = GetTimeMicros(); histPostConnect.Observe(nTime6 - nTime5); histTotal.Observe(nTime6 - nTime1);
+    LogPrint(BCLog::BENCHMARK, "  - Connect postprocess: %.2fms [%.2fs (%.2fms/blk)]\n", (nTime6 - nTime5) * MILLI, histPostConnect.Sum() * MICRO, histPostConnect.Sum() * MILLI / nBlocksTotal);
+    LogPrint(BCLog::BENCHMARK, "- Connect block: %.2fms [%.2fs (%.2fms/blk)]\n", (nTime6 - nTime1) * MILLI, histTotal.Sum() * MICRO, histTotal.Sum() * MILLI / nBlocksTotal);
 
     statsClient.timing("ConnectTip_ms", (nTime6 - nTime1) / 1000, 1.0f);
 
@@ -3119,7 +3267,7 @@ bool CChainState::ActivateBestChain(BlockValidationState& state, std::shared_ptr
     // we use m_cs_chainstate to enforce mutual exclusion so that only one caller may execute this function at a time
     LOCK(m_cs_chainstate);
 
-    auto start = Now<SteadyMilliseconds>();
+    auto start = Now<SteadyMicroseconds>();
 
     CBlockIndex *pindexMostWork = nullptr;
     CBlockIndex *pindexNewTip = nullptr;
@@ -3200,9 +3348,10 @@ bool CChainState::ActivateBestChain(BlockValidationState& state, std::shared_ptr
     } while (pindexNewTip != pindexMostWork);
     CheckBlockIndex();
 
-    auto finish = Now<SteadyMilliseconds>();
+    auto finish = Now<SteadyMicroseconds>();
     auto diff = finish - start;
-    statsClient.timing("ActivateBestChain_ms", count_milliseconds(diff), 1.0f);
+    static metrics::Histogram& histActivate = metrics::GetHistogram("validation.activate_best_chain_us");
+    histActivate.Observe(count_microseconds(diff));
 
     // Write changes periodically to disk, after relay.
     if (!FlushStateToDisk(state, FlushStateMode::PERIODIC)) {
@@ -3974,11 +4123,10 @@ static bool ContextualCheckBlock(const CBlock& block, BlockValidationState& stat
     return true;
 }
 
-bool BlockManager::AcceptBlockHeader(const CBlockHeader& block, BlockValidationState& state, const CChainParams& chainparams, CBlockIndex** ppindex)
+bool BlockManager::AcceptBlockHeader(const CBlockHeader& block, const uint256& hash, BlockValidationState& state, const CChainParams& chainparams, CBlockIndex** ppindex)
 {
     AssertLockHeld(cs_main);
     // Check for duplicate
-    uint256 hash = block.GetHash();
     BlockMap::iterator miSelf = m_block_index.find(hash);
     CBlockIndex *pindex = nullptr;
 
@@ -4089,16 +4237,20 @@ bool BlockManager::AcceptBlockHeader(const CBlockHeader& block, BlockValidationS
 }
 
 // Exposed wrapper for AcceptBlockHeader
-bool ChainstateManager::ProcessNewBlockHeaders(const std::vector<CBlockHeader>& headers, BlockValidationState& state, const CChainParams& chainparams, const CBlockIndex** ppindex)
+bool ChainstateManager::ProcessNewBlockHeaders(const std::vector<CBlockHeader>& headers, BlockValidationState& state, const CChainParams& chainparams, const CBlockIndex** ppindex, const std::vector<uint256>& hashes)
 {
     assert(std::addressof(::ChainstateActive()) == std::addressof(ActiveChainstate()));
+    assert(hashes.empty() || hashes.size() == headers.size());
     AssertLockNotHeld(cs_main);
+    // Hash all headers at once and before taking cs_main
+    const std::vector<uint256> computed_hashes = hashes.empty() ? GetBlockHeaderHashes(headers) : std::vector<uint256>{};
+    const std::vector<uint256>& header_hashes = hashes.empty() ? computed_hashes : hashes;
     {
         LOCK(cs_main);
-        for (const CBlockHeader& header : headers) {
+        for (size_t i = 0; i < headers.size(); ++i) {
             CBlockIndex *pindex = nullptr; // Use a temp pindex instead of ppindex to avoid a const_cast
             bool accepted = m_blockman.AcceptBlockHeader(
-                header, state, chainparams, &pindex);
+                headers[i], header_hashes[i], state, chainparams, &pindex);
             ActiveChainstate().CheckBlockIndex();
 
             if (!accepted) {
@@ -4133,7 +4285,7 @@ bool CChainState::AcceptBlock(const std::shared_ptr<const CBlock>& pblock, Block
     CBlockIndex *pindexDummy = nullptr;
     CBlockIndex *&pindex = ppindex ? *ppindex : pindexDummy;
 
-    bool accepted_header = m_blockman.AcceptBlockHeader(block, state, m_params, &pindex);
+    bool accepted_header = m_blockman.AcceptBlockHeader(block, block.GetHash(), state, m_params, &pindex);
     CheckBlockIndex();
 
     if (!accepted_header)
@@ -4185,6 +4337,11 @@ bool CChainState::AcceptBlock(const std::shared_ptr<const CBlock>& pblock, Block
     if (!IsInitialBlockDownload() && m_chain.Tip() == pindex->pprev)
         GetMainSignals().NewPoWValidBlock(pindex, pblock);
 
+    // Start reading the coins spent by the block while it waits to be connected
+    if (CanFlushToDisk() && (m_chain.Tip() == nullptr || pindex->nChainWork > m_chain.Tip()->nChainWork)) {
+        m_coins_views->m_prefetchview.Prefetch(block, CoinsTip());
+    }
+
     // Write block to history file
     if (fNewBlock) *fNewBlock = true;
     assert(std::addressof(::ChainActive()) == std::addressof(m_chain));
@@ -4506,11 +4663,27 @@ CBlockIndex * BlockManager::InsertBlockIndex(const uint256& hash)
 bool BlockManager::LoadBlockIndex(
     const Consensus::Params& consensus_params,
     CBlockTreeDB& blocktree,
-    std::set<CBlockIndex*, CBlockIndexWorkComparator>& block_index_candidates)
+    std::set<CBlockIndex*, CBlockIndexWorkComparator>& block_index_candidates,
+    const std::optional<uint256>& snapshot_blockhash)
 {
     if (!blocktree.LoadBlockIndexGuts(consensus_params, [this](const uint256& hash) EXCLUSIVE_LOCKS_REQUIRED(cs_main) { return this->InsertBlockIndex(hash); }))
         return false;
 
+    // The blocks up to the base of a snapshot are never downloaded, link the ones after it to the
+    // base like ActivateSnapshot() did when the snapshot was loaded.
+    const CBlockIndex* snapshot_base{nullptr};
+    const AssumeutxoData* snapshot_au_data{nullptr};
+    if (snapshot_blockhash) {
+        snapshot_base = LookupBlockIndex(*snapshot_blockhash);
+        if (!snapshot_base) {
+            return error("%s: snapshot base block %s not found", __func__, snapshot_blockhash->ToString());
+        }
+        snapshot_au_data = ExpectedAssumeutxo(snapshot_base->nHeight, Params());
+        if (!snapshot_au_data) {
+            return error("%s: no assumeutxo data for the snapshot base block %s", __func__, snapshot_blockhash->ToString());
+        }
+    }
+
     // Calculate nChainWork
     std::vector<std::pair<int, CBlockIndex*> > vSortedByHeight;
     vSortedByHeight.reserve(m_block_index.size());
@@ -4544,12 +4717,15 @@ bool BlockManager::LoadBlockIndex(
             } else {
                 pindex->nChainTx = pindex->nTx;
             }
+        } else if (pindex == snapshot_base) {
+            pindex->nChainTx = snapshot_au_data->nChainTx;
         }
         if (!(pindex->nStatus & BLOCK_FAILED_MASK) && pindex->pprev && (pindex->pprev->nStatus & BLOCK_FAILED_MASK)) {
             pindex->nStatus |= BLOCK_FAILED_CHILD;
             setDirtyBlockIndex.insert(pindex);
         }
-        if (pindex->IsValid(BLOCK_VALID_TRANSACTIONS) && (pindex->HaveTxsDownloaded() || pindex->pprev == nullptr)) {
+        if ((pindex->IsValid(BLOCK_VALID_TRANSACTIONS) && (pindex->HaveTxsDownloaded() || pindex->pprev == nullptr)) ||
+            pindex == snapshot_base) {
             block_index_candidates.insert(pindex);
         }
         if (pindex->nStatus & BLOCK_FAILED_MASK && (!pindexBestInvalid || pindex->nChainWork > pindexBestInvalid->nChainWork))
@@ -4580,7 +4756,7 @@ bool CChainState::LoadBlockIndexDB()
     assert(std::addressof(::ChainstateActive()) == std::addressof(*this));
     if (!m_blockman.LoadBlockIndex(
             m_params.GetConsensus(), *pblocktree,
-            setBlockIndexCandidates)) {
+            setBlockIndexCandidates, m_from_snapshot_blockhash)) {
         return false;
     }
 
@@ -4720,7 +4896,7 @@ bool CVerifyDB::VerifyDB(
     int reportDone = 0;
     LogPrintf("[0%%]..."); /* Continued */
 
-    const bool is_snapshot_cs{!chainstate.m_from_snapshot_blockhash};
+    const bool is_snapshot_cs{chainstate.m_from_snapshot_blockhash.has_value()};
 
     for (pindex = chainstate.m_chain.Tip(); pindex && pindex->pprev; pindex = pindex->pprev) {
         const int percentageDone = std::max(1, std::min(99, (int)(((double)(chainstate.m_chain.Height() - pindex->nHeight)) / (double)nCheckDepth * (nCheckLevel >= 4 ? 50 : 100))));
@@ -5001,6 +5177,8 @@ void UnloadBlockIndex(CTxMemPool* mempool, ChainstateManager& chainman)
     chainman.Unload();
     pindexBestInvalid = nullptr;
     pindexBestHeader = nullptr;
+    g_chainlock_skipped_range = {};
+    g_cbtx_chainlock = {};
     if (mempool) mempool->clear();
     vinfoBlockFile.clear();
     nLastBlockFile = 0;
@@ -5224,6 +5402,12 @@ void CChainState::CheckBlockIndex()
         return;
     }
 
+    // The blocks a snapshot chainstate assumes to be valid have neither data nor a validity level,
+    // which breaks most of the relations checked below.
+    if (m_from_snapshot_blockhash) {
+        return;
+    }
+
     LOCK(cs_main);
 
     // During a reindex, we read the genesis block and call CheckBlockIndex before ActivateBestChain,
@@ -5427,6 +5611,10 @@ bool CChainState::ResizeCoinsCaches(size_t coinstip_size, size_t coinsdb_size)
     size_t old_coinstip_size = m_coinstip_cache_size_bytes;
     m_coinstip_cache_size_bytes = coinstip_size;
     m_coinsdb_cache_size_bytes = coinsdb_size;
+    // resizing reopens the coins database, the read cache is started again by the flush below
+    m_coins_read_cache->Reset();
+    m_coins_views->m_prefetchview.Stop();
+    m_coins_views->m_prefetchview.SetMaxUsage(coinstip_size / 100 * INPUT_PREFETCH_CACHE_PERCENT);
     CoinsDB().ResizeCache(coinsdb_size);
 
     LogPrintf("[%s] resized coinsdb cache to %.1f MiB\n",
@@ -5684,6 +5872,7 @@ CChainState& ChainstateManager::InitializeChainstate(CTxMemPool* mempool,
     if (is_snapshot || (!is_snapshot && !m_active_chainstate)) {
         LogPrintf("Switching active chainstate to %s\n", to_modify->ToString());
         m_active_chainstate = to_modify.get();
+        std::atomic_store(&m_active_coins_read_cache, m_active_chainstate->m_coins_read_cache);
     } else {
         throw std::logic_error("unexpected chainstate activation");
     }
@@ -5703,6 +5892,20 @@ const AssumeutxoData* ExpectedAssumeutxo(
     return nullptr;
 }
 
+std::optional<uint256> FindSnapshotChainstate(const fs::path& datadir)
+{
+    // CChainState::InitCoinsDB() names the coins database of a snapshot chainstate after its base
+    const std::string prefix{"chainstate_"};
+    for (fs::directory_iterator it(datadir); it != fs::directory_iterator(); it++) {
+        const std::string name = it->path().filename().string();
+        if (fs::is_directory(*it) && name.size() == prefix.size() + 64 && name.compare(0, prefix.size(), prefix) == 0 &&
+            IsHex(name.substr(prefix.size()))) {
+            return uint256S(name.substr(prefix.size()));
+        }
+    }
+    return std::nullopt;
+}
+
 bool ChainstateManager::ActivateSnapshot(
         CAutoFile& coins_file,
         const SnapshotMetadata& metadata,
@@ -5783,6 +5986,7 @@ bool ChainstateManager::ActivateSnapshot(
         assert(chaintip_loaded);
 
         m_active_chainstate = m_snapshot_chainstate.get();
+        std::atomic_store(&m_active_coins_read_cache, m_active_chainstate->m_coins_read_cache);
 
         LogPrintf("[snapshot] successfully activated snapshot %s\n", base_blockhash.ToString());
         LogPrintf("[snapshot] (%.2f MB)\n",
@@ -6007,6 +6211,11 @@ void ChainstateManager::Unload()
 void ChainstateManager::Reset()
 {
     LOCK(::cs_main);
+    std::atomic_store(&m_active_coins_read_cache, std::shared_ptr<CCoinsReadCache>());
+    // readers may still hold a cache, don't let them read from the coins views destroyed with the chainstate
+    for (const auto* chainstate : {m_ibd_chainstate.get(), m_snapshot_chainstate.get()}) {
+        if (chainstate) chainstate->m_coins_read_cache->Reset();
+    }
     m_ibd_chainstate.reset();
     m_snapshot_chainstate.reset();
     m_active_chainstate = nullptr;
@@ -98,6 +98,7 @@ static const unsigned int MAX_HEADERS_RESULTS = 2000;
 static const int64_t DEFAULT_MAX_TIP_AGE = 6 * 60 * 60; // ~144 blocks behind -> 2 x fork detection time, was 24 * 60 * 60 in bitcoin
 
 static const bool DEFAULT_CHECKPOINTS_ENABLED = true;
+static constexpr bool DEFAULT_CHAINLOCK_FAST_SYNC{false};
 static const bool DEFAULT_TXINDEX = true;
 static constexpr bool DEFAULT_COINSTATSINDEX{false};
 static const bool DEFAULT_ADDRESSINDEX = false;
@@ -165,6 +166,12 @@ extern std::atomic<bool> fDIP0001ActiveAtTip;
 /** Block hash whose ancestors we will assume to have valid scripts without checking them. */
 extern uint256 hashAssumeValid;
 
+/** Whether to skip script verification of blocks buried under a verified ChainLock (-chainlockfastsync). */
+extern bool g_chainlock_fast_sync;
+
+/** Number of threads reading the inputs of blocks ahead of their validation (-inputprefetch). */
+extern int g_input_prefetch_threads;
+
 /** Minimum work we will assume exists on some valid chain. */
 extern arith_uint256 nMinimumChainWork;
 
@@ -433,11 +440,15 @@ public:
      *
      * @param[out] block_index_candidates  Fill this set with any valid blocks for
      *                                     which we've downloaded all transactions.
+     * @param[in]  snapshot_blockhash      The base of the snapshot the chainstate
+     *                                     being loaded is based on, if any. Its
+     *                                     transactions are assumed to be downloaded.
      */
     bool LoadBlockIndex(
         const Consensus::Params& consensus_params,
         CBlockTreeDB& blocktree,
-        std::set<CBlockIndex*, CBlockIndexWorkComparator>& block_index_candidates)
+        std::set<CBlockIndex*, CBlockIndexWorkComparator>& block_index_candidates,
+        const std::optional<uint256>& snapshot_blockhash)
         EXCLUSIVE_LOCKS_REQUIRED(cs_main);
     /** Clear all data members. */
     void Unload() EXCLUSIVE_LOCKS_REQUIRED(cs_main);
@@ -455,6 +466,7 @@ public:
      */
     bool AcceptBlockHeader(
         const CBlockHeader& block,
+        const uint256& hash,
         BlockValidationState& state,
         const CChainParams& chainparams,
         CBlockIndex** ppindex) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
@@ -498,11 +510,14 @@ public:
     //! This view wraps access to the leveldb instance and handles read errors gracefully.
     CCoinsViewErrorCatcher m_catcherview GUARDED_BY(cs_main);
 
+    //! This view reads the inputs of blocks from the database ahead of their validation.
+    CCoinsViewPrefetch m_prefetchview GUARDED_BY(cs_main);
+
     //! This is the top layer of the cache hierarchy - it keeps as many coins in memory as
     //! can fit per the dbcache setting.
     std::unique_ptr<CCoinsViewCache> m_cacheview GUARDED_BY(cs_main);
 
-    //! This constructor initializes CCoinsViewDB and CCoinsViewErrorCatcher instances, but it
+    //! This constructor initializes CCoinsViewDB, CCoinsViewErrorCatcher and CCoinsViewPrefetch instances, but it
     //! *does not* create a CCoinsViewCache instance by default. This is done separately because the
     //! presence of the cache has implications on whether or not we're allowed to flush the cache's
     //! state to disk, which should not be done until the health of the database is verified.
@@ -658,7 +673,15 @@ public:
     }
 
     //! Destructs all objects related to accessing the UTXO set.
-    void ResetCoinsViews() { m_coins_views.reset(); }
+    void ResetCoinsViews()
+    {
+        m_coins_read_cache->Reset();
+        m_coins_views.reset();
+    }
+
+    //! View of the UTXO set as of m_chain's tip which can be read without cs_main.
+    //! Shared with ChainstateManager, which publishes the one of the active chainstate.
+    const std::shared_ptr<CCoinsReadCache> m_coins_read_cache{std::make_shared<CCoinsReadCache>()};
 
     //! The cache size of the on-disk coins view.
     size_t m_coinsdb_cache_size_bytes{0};
@@ -904,6 +927,10 @@ private:
     //! that call.
     CChainState* m_active_chainstate GUARDED_BY(::cs_main) {nullptr};
 
+    //! The coins read cache of m_active_chainstate, accessed with std::atomic_load/store so that it can be
+    //! fetched without cs_main.
+    std::shared_ptr<CCoinsReadCache> m_active_coins_read_cache;
+
     //! If true, the assumed-valid chainstate has been fully validated
     //! by the background validation chainstate.
     bool m_snapshot_validated{false};
@@ -972,6 +999,12 @@ public:
     CChain& ActiveChain() const { return ActiveChainstate().m_chain; }
     int ActiveHeight() const { return ActiveChain().Height(); }
     CBlockIndex* ActiveTip() const { return ActiveChain().Tip(); }
+    //! The coins read cache of the active chainstate, for reading the UTXO set without cs_main. It is null
+    //! until a chainstate is initialized, and may not be usable (see CCoinsReadCache).
+    std::shared_ptr<const CCoinsReadCache> ActiveCoinsReadCache() const
+    {
+        return std::atomic_load(&m_active_coins_read_cache);
+    }
 
     BlockMap& BlockIndex() EXCLUSIVE_LOCKS_REQUIRED(::cs_main)
     {
@@ -1038,8 +1071,9 @@ public:
      * @param[in]  chainparams The params for the chain we want to connect to
      * @param[out] ppindex If set, the pointer will be set to point to the last new block index object for the given headers
      * @param[out] first_invalid First header that fails validation, if one exists
+     * @param[in]  hashes The hashes of the headers if the caller already computed them, see GetBlockHeaderHashes()
      */
-    bool ProcessNewBlockHeaders(const std::vector<CBlockHeader>& block, BlockValidationState& state, const CChainParams& chainparams, const CBlockIndex** ppindex = nullptr) LOCKS_EXCLUDED(cs_main);
+    bool ProcessNewBlockHeaders(const std::vector<CBlockHeader>& block, BlockValidationState& state, const CChainParams& chainparams, const CBlockIndex** ppindex = nullptr, const std::vector<uint256>& hashes = {}) LOCKS_EXCLUDED(cs_main);
 
     //! Load the block tree and coins database from disk, initializing state if we're running with -reindex
     bool LoadBlockIndex() EXCLUSIVE_LOCKS_REQUIRED(cs_main);
@@ -1100,4 +1134,11 @@ inline bool IsBlockPruned(const CBlockIndex* pblockindex)
  */
 const AssumeutxoData* ExpectedAssumeutxo(const int height, const CChainParams& params);
 
+/**
+ * Find the coins database of a chainstate created by loading a UTXO snapshot in the data directory.
+ *
+ * @returns the base blockhash of the snapshot, empty if there is no snapshot chainstate.
+ */
+std::optional<uint256> FindSnapshotChainstate(const fs::path& datadir);
+
 #endif // BITCOIN_VALIDATION_H
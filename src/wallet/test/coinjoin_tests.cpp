@@ -218,6 +218,54 @@ BOOST_FIXTURE_TEST_CASE(coinjoin_manager_start_stop_tests, CTransactionBuilderTe
     BOOST_CHECK_EQUAL(cj_man->IsMixing(), false);
 }
 
+BOOST_FIXTURE_TEST_CASE(coinjoin_rounds_cache_tests, CTransactionBuilderTestSetup)
+{
+    // a denominated output next to a non-denominated change output starts a new chain
+    CompactTallyItem tallyItem = GetTallyItem({CoinJoin::GetSmallestDenomination()});
+    BOOST_CHECK_EQUAL(wallet->GetRealOutpointCoinJoinRounds(tallyItem.vecInputCoins[0].outpoint), 0);
+
+    LOCK(wallet->cs_wallet);
+    const int nRoundsMax = MAX_COINJOIN_ROUNDS + CCoinJoinClientOptions::GetRandomRounds();
+    // stored rounds are used as they are, unless they were calculated with a different cap
+    const COutPoint outpoint1(GetRandHash(), 0);
+    wallet->LoadCoinJoinRounds(outpoint1, 2, nRoundsMax);
+    BOOST_CHECK_EQUAL(wallet->GetRealOutpointCoinJoinRounds(outpoint1), 2);
+    const COutPoint outpoint2(GetRandHash(), 0);
+    wallet->LoadCoinJoinRounds(outpoint2, 2, nRoundsMax + 1);
+    BOOST_CHECK_EQUAL(wallet->GetRealOutpointCoinJoinRounds(outpoint2), -1);
+}
+
+BOOST_FIXTURE_TEST_CASE(coinjoin_utxo_buckets_tests, CTransactionBuilderTestSetup)
+{
+    const CAmount nDenomAmount = CoinJoin::GetSmallestDenomination();
+    GetTallyItem({nDenomAmount, nDenomAmount, CoinJoin::GetCollateralAmount()});
+
+    BOOST_CHECK_EQUAL(wallet->CountInputsWithAmount(nDenomAmount), 2);
+    BOOST_CHECK_EQUAL(wallet->CountInputsWithAmount(CoinJoin::GetCollateralAmount()), 1);
+    BOOST_CHECK_EQUAL(wallet->CountInputsWithAmount(CoinJoin::vecStandardDenominations.front()), 0);
+    BOOST_CHECK(wallet->HasCollateralInputs());
+
+    std::vector<CTxDSIn> vecTxDSIn;
+    BOOST_CHECK(wallet->SelectTxDSInsByDenomination(CoinJoin::AmountToDenomination(nDenomAmount), CoinJoin::GetMaxPoolAmount(), vecTxDSIn));
+    BOOST_CHECK_EQUAL(vecTxDSIn.size(), 2U);
+    BOOST_CHECK(!wallet->SelectTxDSInsByDenomination(CoinJoin::AmountToDenomination(CoinJoin::vecStandardDenominations.front()), CoinJoin::GetMaxPoolAmount(), vecTxDSIn));
+
+    // spending an output removes it from its bucket
+    CTransactionRef tx;
+    CAmount nFeeRet;
+    int nChangePosRet = -1;
+    bilingual_str strError;
+    CCoinControl coinControl;
+    coinControl.m_feerate = CFeeRate(1000);
+    coinControl.fAllowOtherInputs = true;
+    coinControl.Select(vecTxDSIn[0].prevout);
+    BOOST_CHECK(wallet->CreateTransaction({{GetScriptForRawPubKey(coinbaseKey.GetPubKey()), nDenomAmount * 2, false}}, tx, nFeeRet, nChangePosRet, strError, coinControl));
+    {
+        LOCK2(wallet->cs_wallet, cs_main);
+        wallet->CommitTransaction(tx, {}, {});
+    }
+    BOOST_CHECK_EQUAL(wallet->CountInputsWithAmount(nDenomAmount), 1);
+}
 
 BOOST_FIXTURE_TEST_CASE(CTransactionBuilderTest, CTransactionBuilderTestSetup)
 {
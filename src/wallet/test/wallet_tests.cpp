@@ -11,7 +11,9 @@
 #include <vector>
 
 #include <coinjoin/client.h>
+#include <coinjoin/common.h>
 #include <coinjoin/context.h>
+#include <coinjoin/options.h>
 #include <interfaces/chain.h>
 #include <interfaces/coinjoin.h>
 #include <key_io.h>
@@ -25,6 +27,7 @@
 #include <validation.h>
 #include <wallet/coincontrol.h>
 #include <wallet/test/wallet_test_fixture.h>
+#include <wallet/walletdb.h>
 
 #include <boost/test/unit_test.hpp>
 #include <univalue.h>
@@ -1313,6 +1316,75 @@ BOOST_FIXTURE_TEST_CASE(CreateWalletFromFile, TestChain100Setup)
     TestUnloadWallet(std::move(wallet));
 }
 
+BOOST_FIXTURE_TEST_CASE(coinjoin_rounds_reload, TestChain100Setup)
+{
+    gArgs.ForceSetArg("-unsafesqlitesync", "1");
+    auto wallet = TestLoadWallet(m_node);
+    CKey key;
+    key.MakeNewKey(true);
+    AddKey(*wallet, key);
+
+    const auto spend = [&](const CTransaction& from, const CKey& from_key, const std::vector<CTxOut>& outputs) {
+        CMutableTransaction mtx;
+        mtx.vin.emplace_back(from.GetHash(), 0);
+        mtx.vout = outputs;
+        FillableSigningProvider keystore;
+        keystore.AddKey(from_key);
+        std::map<COutPoint, Coin> coins;
+        coins[mtx.vin[0].prevout].out = from.vout[0];
+        std::map<int, std::string> input_errors;
+        BOOST_CHECK(SignTransaction(mtx, &keystore, coins, SIGHASH_ALL, input_errors));
+        CreateAndProcessBlock({mtx}, GetScriptForRawPubKey(coinbaseKey.GetPubKey()));
+        SyncWithValidationInterfaceQueue();
+        return CTransaction(mtx);
+    };
+    const auto has_record = [](CWallet& wallet, const COutPoint& outpoint) {
+        return wallet.GetDatabase().MakeBatch()->Exists(std::make_pair(DBKeys::COINJOIN_ROUNDS, outpoint));
+    };
+
+    // a denominated output next to a non-denominated one starts a new chain, its rounds are stored right away
+    const CAmount denom = CoinJoin::GetSmallestDenomination();
+    const CTransaction& coinbase = *m_coinbase_txns[0];
+    const CTransaction denom_tx = spend(coinbase, coinbaseKey, {
+        CTxOut(denom, GetScriptForRawPubKey(key.GetPubKey())),
+        CTxOut(coinbase.vout[0].nValue - denom - DEFAULT_TRANSACTION_MAXFEE, GetScriptForRawPubKey(coinbaseKey.GetPubKey())),
+    });
+    const COutPoint denom_outpoint(denom_tx.GetHash(), 0);
+    BOOST_CHECK_EQUAL(wallet->GetRealOutpointCoinJoinRounds(denom_outpoint), 0);
+    BOOST_CHECK(has_record(*wallet, denom_outpoint));
+
+    // replace the record to tell it apart from recalculated rounds, and add one calculated with another cap
+    const int nRoundsMax = MAX_COINJOIN_ROUNDS + CCoinJoinClientOptions::GetRandomRounds();
+    const COutPoint outdated_outpoint(GetRandHash(), 0);
+    {
+        WalletBatch batch(wallet->GetDatabase());
+        BOOST_CHECK(batch.WriteCoinJoinRounds(denom_outpoint, 3, nRoundsMax));
+        BOOST_CHECK(batch.WriteCoinJoinRounds(outdated_outpoint, 3, nRoundsMax + 1));
+    }
+    TestUnloadWallet(std::move(wallet));
+
+    wallet = TestLoadWallet(m_node);
+    BOOST_CHECK_EQUAL(wallet->GetRealOutpointCoinJoinRounds(denom_outpoint), 3);
+    BOOST_CHECK_EQUAL(wallet->GetRealOutpointCoinJoinRounds(outdated_outpoint), -1);
+    BOOST_CHECK(!has_record(*wallet, outdated_outpoint));
+
+    // the record of a spent output is dropped, the new output has its own one
+    CKey next_key;
+    next_key.MakeNewKey(true);
+    AddKey(*wallet, next_key);
+    const CTransaction next_tx = spend(denom_tx, key, {CTxOut(denom, GetScriptForRawPubKey(next_key.GetPubKey()))});
+    const COutPoint next_outpoint(next_tx.GetHash(), 0);
+    BOOST_CHECK_EQUAL(wallet->GetRealOutpointCoinJoinRounds(next_outpoint), 4);
+    BOOST_CHECK(has_record(*wallet, next_outpoint));
+    BOOST_CHECK(!has_record(*wallet, denom_outpoint));
+    TestUnloadWallet(std::move(wallet));
+
+    // without the record of the spent output the stored rounds are the only way to get 4 rounds again
+    wallet = TestLoadWallet(m_node);
+    BOOST_CHECK_EQUAL(wallet->GetRealOutpointCoinJoinRounds(next_outpoint), 4);
+    TestUnloadWallet(std::move(wallet));
+}
+
 // Explicit calculation which is used to test the wallet constant
 // We get the same virtual size due to rounding(weight/4) for both use_max_sig values
 static size_t CalculateNestedKeyhashInputSize(bool use_max_sig)
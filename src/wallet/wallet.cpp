@@ -574,10 +574,34 @@ bool CWallet::IsSpent(const uint256& hash, unsigned int n) const
     return false;
 }
 
+bool CWallet::AddWalletUTXO(const COutPoint& outpoint, CAmount nValue)
+{
+    AssertLockHeld(cs_wallet);
+    if (!setWalletUTXO.insert(outpoint).second) return false;
+    if (CoinJoin::IsDenominatedAmount(nValue) || CoinJoin::IsCollateralAmount(nValue)) {
+        mapCoinJoinUTXOs[nValue].insert(outpoint);
+    }
+    return true;
+}
+
+void CWallet::EraseWalletUTXO(const COutPoint& outpoint)
+{
+    AssertLockHeld(cs_wallet);
+    if (setWalletUTXO.erase(outpoint) == 0) return;
+    const auto it = mapWallet.find(outpoint.hash);
+    if (it == mapWallet.end()) return;
+    const auto jt = mapCoinJoinUTXOs.find(it->second.tx->vout[outpoint.n].nValue);
+    if (jt == mapCoinJoinUTXOs.end()) return;
+    jt->second.erase(outpoint);
+    if (jt->second.empty()) {
+        mapCoinJoinUTXOs.erase(jt);
+    }
+}
+
 void CWallet::AddToSpends(const COutPoint& outpoint, const uint256& wtxid)
 {
     mapTxSpends.insert(std::make_pair(outpoint, wtxid));
-    setWalletUTXO.erase(outpoint);
+    EraseWalletUTXO(outpoint);
 
     setLockedCoins.erase(outpoint);
 
@@ -880,15 +904,27 @@ CWalletTx* CWallet::AddToWallet(CTransactionRef tx, const CWalletTx::Confirmatio
         AddToSpends(hash);
 
         std::vector<std::pair<const CTransactionRef&, unsigned int>> outputs;
+        std::vector<COutPoint> new_utxos;
         for(unsigned int i = 0; i < wtx.tx->vout.size(); ++i) {
+            // drop whatever was cached while the tx wasn't known yet
+            mapOutpointRoundsCache.erase(COutPoint(hash, i));
             if (IsMine(wtx.tx->vout[i]) && !IsSpent(hash, i)) {
-                setWalletUTXO.insert(COutPoint(hash, i));
+                AddWalletUTXO(COutPoint(hash, i), wtx.tx->vout[i].nValue);
                 outputs.emplace_back(wtx.tx, i);
+                new_utxos.emplace_back(hash, i);
             }
         }
         for (const auto& outPoint : m_chain->listMNCollaterials(outputs)) {
             LockCoin(outPoint);
         }
+        // inputs are usually cached already, so this only has to look at the new tx itself
+        WriteCoinJoinRounds(batch, new_utxos);
+        // the rounds of the spent outputs are only needed until the ones of the new outputs are known
+        for (const CTxIn& txin : wtx.tx->vin) {
+            if (setCoinJoinRoundsStored.erase(txin.prevout)) {
+                batch.EraseCoinJoinRounds(txin.prevout);
+            }
+        }
     }
 
     if (!fInsertedNew)
@@ -908,7 +944,7 @@ CWalletTx* CWallet::AddToWallet(CTransactionRef tx, const CWalletTx::Confirmatio
         std::vector<std::pair<const CTransactionRef&, unsigned int>> outputs;
         for(unsigned int i = 0; i < wtx.tx->vout.size(); ++i) {
             if (IsMine(wtx.tx->vout[i]) && !IsSpent(hash, i)) {
-                bool new_utxo = setWalletUTXO.insert(COutPoint(hash, i)).second;
+                bool new_utxo = AddWalletUTXO(COutPoint(hash, i), wtx.tx->vout[i].nValue);
                 if (new_utxo) {
                     outputs.emplace_back(wtx.tx, i);
                     fUpdated = true;
@@ -1438,6 +1474,32 @@ int CWallet::GetRealOutpointCoinJoinRounds(const COutPoint& outpoint, int nRound
     return *nRoundsRef;
 }
 
+void CWallet::LoadCoinJoinRounds(const COutPoint& outpoint, int nRounds, int nRoundsMax)
+{
+    AssertLockHeld(cs_wallet);
+    // rounds calculated with a different cap may be wrong now, recalculate them
+    if (nRoundsMax != MAX_COINJOIN_ROUNDS + CCoinJoinClientOptions::GetRandomRounds()) {
+        setCoinJoinRoundsOutdated.insert(outpoint);
+        return;
+    }
+    mapOutpointRoundsCache[outpoint] = nRounds;
+    setCoinJoinRoundsStored.insert(outpoint);
+}
+
+void CWallet::WriteCoinJoinRounds(WalletBatch& batch, const std::vector<COutPoint>& outpoints)
+{
+    AssertLockHeld(cs_wallet);
+    const int nRoundsMax = MAX_COINJOIN_ROUNDS + CCoinJoinClientOptions::GetRandomRounds();
+    for (const auto& outpoint : outpoints) {
+        if (setCoinJoinRoundsStored.count(outpoint)) continue;
+        // only denominated outputs need the history lookup, everything else is resolved from the output itself
+        if (GetRealOutpointCoinJoinRounds(outpoint) < 0) continue;
+        if (batch.WriteCoinJoinRounds(outpoint, mapOutpointRoundsCache.at(outpoint), nRoundsMax)) {
+            setCoinJoinRoundsStored.insert(outpoint);
+        }
+    }
+}
+
 // respect current settings
 int CWallet::GetCappedOutpointCoinJoinRounds(const COutPoint& outpoint) const
 {
@@ -2427,11 +2489,26 @@ void MaybeResendWalletTxs()
  */
 
 
-std::unordered_set<const CWalletTx*, WalletTxHasher> CWallet::GetSpendableTXs() const
+std::unordered_set<const CWalletTx*, WalletTxHasher> CWallet::GetSpendableTXs(CoinType nCoinType, CAmount nMinimumAmount, CAmount nMaximumAmount) const
 {
     AssertLockHeld(cs_wallet);
 
     std::unordered_set<const CWalletTx*, WalletTxHasher> ret;
+    if (nCoinType == CoinType::ONLY_FULLY_MIXED || nCoinType == CoinType::ONLY_READY_TO_MIX || nCoinType == CoinType::ONLY_COINJOIN_COLLATERAL) {
+        // only the matching amount buckets can contain such outputs
+        const bool fCollateral = nCoinType == CoinType::ONLY_COINJOIN_COLLATERAL;
+        for (auto it = mapCoinJoinUTXOs.lower_bound(nMinimumAmount); it != mapCoinJoinUTXOs.end() && it->first <= nMaximumAmount; ++it) {
+            if (fCollateral ? !CoinJoin::IsCollateralAmount(it->first) : !CoinJoin::IsDenominatedAmount(it->first)) continue;
+            for (const auto& outpoint : it->second) {
+                const auto jt = mapWallet.find(outpoint.hash);
+                if (jt != mapWallet.end()) {
+                    ret.emplace(&jt->second);
+                }
+            }
+        }
+        return ret;
+    }
+
     for (auto it = setWalletUTXO.begin(); it != setWalletUTXO.end(); ) {
         const auto& outpoint = *it;
         const auto jt = mapWallet.find(outpoint.hash);
@@ -2512,11 +2589,12 @@ float CWallet::GetAverageAnonymizedRounds() const
     int nCount = 0;
 
     LOCK(cs_wallet);
-    for (const auto& outpoint : setWalletUTXO) {
-        if(!IsDenominated(outpoint)) continue;
-
-        nTotal += GetCappedOutpointCoinJoinRounds(outpoint);
-        nCount++;
+    for (const auto& [nValue, outpoints] : mapCoinJoinUTXOs) {
+        if (!CoinJoin::IsDenominatedAmount(nValue)) continue;
+        for (const auto& outpoint : outpoints) {
+            nTotal += GetCappedOutpointCoinJoinRounds(outpoint);
+            nCount++;
+        }
     }
 
     if(nCount == 0) return 0;
@@ -2533,16 +2611,16 @@ CAmount CWallet::GetNormalizedAnonymizedBalance() const
     CAmount nTotal = 0;
 
     LOCK(cs_wallet);
-    for (const auto& outpoint : setWalletUTXO) {
-        const auto it = mapWallet.find(outpoint.hash);
-        if (it == mapWallet.end()) continue;
-
-        CAmount nValue = it->second.tx->vout[outpoint.n].nValue;
+    for (const auto& [nValue, outpoints] : mapCoinJoinUTXOs) {
         if (!CoinJoin::IsDenominatedAmount(nValue)) continue;
-        if (it->second.GetDepthInMainChain() < 0) continue;
+        for (const auto& outpoint : outpoints) {
+            const auto it = mapWallet.find(outpoint.hash);
+            if (it == mapWallet.end()) continue;
+            if (it->second.GetDepthInMainChain() < 0) continue;
 
-        int nRounds = GetCappedOutpointCoinJoinRounds(outpoint);
-        nTotal += nValue * nRounds / CCoinJoinClientOptions::GetRounds();
+            int nRounds = GetCappedOutpointCoinJoinRounds(outpoint);
+            nTotal += nValue * nRounds / CCoinJoinClientOptions::GetRounds();
+        }
     }
 
     return nTotal;
@@ -2578,7 +2656,7 @@ void CWallet::AvailableCoins(std::vector<COutput> &vCoins, bool fOnlySafe, const
     const int max_depth = {coinControl ? coinControl->m_max_depth : DEFAULT_MAX_DEPTH};
 
     std::set<uint256> trusted_parents;
-    for (auto pcoin : GetSpendableTXs()) {
+    for (auto pcoin : GetSpendableTXs(nCoinType, nMinimumAmount, nMaximumAmount)) {
         const uint256& wtxid = pcoin->GetHash();
 
         if (!chain().checkFinalTx(*pcoin->tx))
@@ -3170,7 +3248,7 @@ bool CWallet::SelectTxDSInsByDenomination(int nDenom, CAmount nValueMax, std::ve
 
     CCoinControl coin_control;
     coin_control.nCoinType = CoinType::ONLY_READY_TO_MIX;
-    AvailableCoins(vCoins, true, &coin_control);
+    AvailableCoins(vCoins, true, &coin_control, nDenomAmount, nDenomAmount);
     WalletCJLogPrint((*this), "CWallet::%s -- vCoins.size(): %d\n", __func__, vCoins.size());
 
     Shuffle(vCoins.rbegin(), vCoins.rend(), FastRandomContext());
@@ -3391,7 +3469,12 @@ int CWallet::CountInputsWithAmount(CAmount nInputAmount) const
 
     LOCK(cs_wallet);
 
-    for (const auto& outpoint : setWalletUTXO) {
+    // CoinJoin amounts are bucketed, anything else requires looking at all outputs
+    const bool fIndexed = CoinJoin::IsDenominatedAmount(nInputAmount) || CoinJoin::IsCollateralAmount(nInputAmount);
+    const auto bucket = mapCoinJoinUTXOs.find(nInputAmount);
+    if (fIndexed && bucket == mapCoinJoinUTXOs.end()) return 0;
+
+    for (const auto& outpoint : fIndexed ? bucket->second : setWalletUTXO) {
         const auto it = mapWallet.find(outpoint.hash);
         if (it == mapWallet.end()) continue;
         if (it->second.tx->vout[outpoint.n].nValue != nInputAmount) continue;
@@ -3882,7 +3965,7 @@ DBErrors CWallet::LoadWallet(bool& fFirstRunRet)
             for (auto& pair : mapWallet) {
                 for(unsigned int i = 0; i < pair.second.tx->vout.size(); ++i) {
                     if (IsMine(pair.second.tx->vout[i]) && !IsSpent(pair.first, i)) {
-                        setWalletUTXO.insert(COutPoint(pair.first, i));
+                        AddWalletUTXO(COutPoint(pair.first, i), pair.second.tx->vout[i].nValue);
                     }
                 }
             }
@@ -3894,6 +3977,27 @@ DBErrors CWallet::LoadWallet(bool& fFirstRunRet)
     if (nLoadWalletRet != DBErrors::LOAD_OK)
         return nLoadWalletRet;
 
+    // Store the rounds of outputs which are missing in the database, e.g. after an upgrade,
+    // so later restarts don't have to walk the transaction history again, and drop the ones of spent outputs
+    {
+        WalletBatch batch(GetDatabase());
+        batch.TxnBegin();
+        for (const auto& outpoint : setCoinJoinRoundsOutdated) {
+            batch.EraseCoinJoinRounds(outpoint);
+        }
+        setCoinJoinRoundsOutdated.clear();
+        WriteCoinJoinRounds(batch, {setWalletUTXO.begin(), setWalletUTXO.end()});
+        for (auto it = setCoinJoinRoundsStored.begin(); it != setCoinJoinRoundsStored.end();) {
+            if (setWalletUTXO.count(*it)) {
+                ++it;
+                continue;
+            }
+            batch.EraseCoinJoinRounds(*it);
+            it = setCoinJoinRoundsStored.erase(it);
+        }
+        batch.TxnCommit();
+    }
+
     return DBErrors::LOAD_OK;
 }
 
@@ -3928,6 +4032,14 @@ DBErrors CWallet::ZapSelectTx(std::vector<uint256>& vHashIn, std::vector<uint256
         wtxOrdered.erase(it->second.m_it_wtxOrdered);
         for (const auto& txin : it->second.tx->vin)
             mapTxSpends.erase(txin.prevout);
+        for (unsigned int i = 0; i < it->second.tx->vout.size(); ++i) {
+            const COutPoint outpoint(hash, i);
+            EraseWalletUTXO(outpoint);
+            mapOutpointRoundsCache.erase(outpoint);
+            if (setCoinJoinRoundsStored.erase(outpoint)) {
+                WalletBatch(GetDatabase()).EraseCoinJoinRounds(outpoint);
+            }
+        }
         mapWallet.erase(it);
         NotifyTransactionChanged(this, hash, CT_DELETED);
     }
@@ -711,7 +711,23 @@ private:
     void AddToSpends(const uint256& wtxid) EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
 
     std::set<COutPoint> setWalletUTXO;
+    /** Subset of setWalletUTXO with denominated and CoinJoin collateral amounts, bucketed by amount */
+    std::map<CAmount, std::set<COutPoint>> mapCoinJoinUTXOs GUARDED_BY(cs_wallet);
+    /** Add an output to setWalletUTXO and, if it has a CoinJoin amount, to mapCoinJoinUTXOs. Returns false if it was known already */
+    bool AddWalletUTXO(const COutPoint& outpoint, CAmount nValue) EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
+    void EraseWalletUTXO(const COutPoint& outpoint) EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
     mutable std::map<COutPoint, int> mapOutpointRoundsCache;
+    /** Outpoints whose CoinJoin rounds are stored in the wallet database ("cj_rounds"), only unspent ones are kept */
+    std::set<COutPoint> setCoinJoinRoundsStored GUARDED_BY(cs_wallet);
+    /** Outpoints whose stored CoinJoin rounds were calculated with another cap, they are dropped once the wallet is loaded */
+    std::set<COutPoint> setCoinJoinRoundsOutdated GUARDED_BY(cs_wallet);
+
+    /**
+     * Calculate the CoinJoin rounds of the given outputs and store the ones of
+     * denominated outputs which aren't in the wallet database yet, so they don't
+     * need to be recalculated from the transaction history after a restart.
+     */
+    void WriteCoinJoinRounds(WalletBatch& batch, const std::vector<COutPoint>& outpoints) EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
 
     /**
      * Add a transaction to the wallet, or update it.  pIndex and posInBlock should
@@ -768,8 +784,8 @@ private:
     /** Internal database handle. */
     std::unique_ptr<WalletDatabase> const m_database;
 
-    // A helper function which loops through wallet UTXOs
-    std::unordered_set<const CWalletTx*, WalletTxHasher> GetSpendableTXs() const EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
+    // A helper function which loops through wallet UTXOs, CoinJoin specific coin types only look at the matching amount buckets
+    std::unordered_set<const CWalletTx*, WalletTxHasher> GetSpendableTXs(CoinType nCoinType = CoinType::ALL_COINS, CAmount nMinimumAmount = 0, CAmount nMaximumAmount = MAX_MONEY) const EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
 
     /**
      * The following is used to keep track of how far behind the wallet is
@@ -924,6 +940,8 @@ public:
 
     // get the CoinJoin chain depth for a given input
     int GetRealOutpointCoinJoinRounds(const COutPoint& outpoint, int nRounds = 0) const;
+    /** Load the CoinJoin rounds of an output from the wallet database, nRoundsMax is the cap they were calculated with */
+    void LoadCoinJoinRounds(const COutPoint& outpoint, int nRounds, int nRoundsMax) EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
     // respect current settings
     int GetCappedOutpointCoinJoinRounds(const COutPoint& outpoint) const;
 
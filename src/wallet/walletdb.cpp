@@ -35,6 +35,7 @@ const std::string BESTBLOCK_NOMERKLE{"bestblock_nomerkle"};
 const std::string BESTBLOCK{"bestblock"};
 const std::string CRYPTED_KEY{"ckey"};
 const std::string CRYPTED_HDCHAIN{"chdchain"};
+const std::string COINJOIN_ROUNDS{"cj_rounds"};
 const std::string COINJOIN_SALT{"cj_salt"};
 const std::string CSCRIPT{"cscript"};
 const std::string DEFAULTKEY{"defaultkey"};
@@ -216,6 +217,16 @@ bool WalletBatch::WriteCoinJoinSalt(const uint256& salt)
     return WriteIC(DBKeys::COINJOIN_SALT, salt);
 }
 
+bool WalletBatch::WriteCoinJoinRounds(const COutPoint& outpoint, int nRounds, int nRoundsMax)
+{
+    return WriteIC(std::make_pair(DBKeys::COINJOIN_ROUNDS, outpoint), std::make_pair(nRounds, nRoundsMax));
+}
+
+bool WalletBatch::EraseCoinJoinRounds(const COutPoint& outpoint)
+{
+    return EraseIC(std::make_pair(DBKeys::COINJOIN_ROUNDS, outpoint));
+}
+
 bool WalletBatch::WriteGovernanceObject(const Governance::Object& obj)
 {
     return WriteIC(std::make_pair(DBKeys::G_OBJECT, obj.GetHash()), obj, false);
@@ -506,6 +517,12 @@ ReadKeyValue(CWallet* pwallet, CDataStream& ssKey, CDataStream& ssValue,
                 strErr = "Invalid governance object: LoadGovernanceObject";
                 return false;
             }
+        } else if (strType == DBKeys::COINJOIN_ROUNDS) {
+            COutPoint outpoint;
+            int nRounds, nRoundsMax;
+            ssKey >> outpoint;
+            ssValue >> nRounds >> nRoundsMax;
+            pwallet->LoadCoinJoinRounds(outpoint, nRounds, nRoundsMax);
         } else if (strType == DBKeys::FLAGS) {
             uint64_t flags;
             ssValue >> flags;
@@ -34,6 +34,7 @@ class CHDChain;
 class CHDPubKey;
 class CKeyPool;
 class CMasterKey;
+class COutPoint;
 class CScript;
 class CWallet;
 class CWalletTx;
@@ -62,6 +63,7 @@ extern const std::string BESTBLOCK;
 extern const std::string BESTBLOCK_NOMERKLE;
 extern const std::string CRYPTED_HDCHAIN;
 extern const std::string CRYPTED_KEY;
+extern const std::string COINJOIN_ROUNDS;
 extern const std::string COINJOIN_SALT;
 extern const std::string CSCRIPT;
 extern const std::string DEFAULTKEY;
@@ -203,6 +205,9 @@ public:
     bool ReadCoinJoinSalt(uint256& salt, bool fLegacy = false);
     bool WriteCoinJoinSalt(const uint256& salt);
 
+    bool WriteCoinJoinRounds(const COutPoint& outpoint, int nRounds, int nRoundsMax);
+    bool EraseCoinJoinRounds(const COutPoint& outpoint);
+
     /** Write a CGovernanceObject to the database */
     bool WriteGovernanceObject(const Governance::Object& obj);
 
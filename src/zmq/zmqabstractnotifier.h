@@ -6,6 +6,8 @@
 #define BITCOIN_ZMQ_ZMQABSTRACTNOTIFIER_H
 
 
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <string>
 
@@ -54,6 +56,10 @@ public:
         }
     }
 
+    uint64_t GetPublishedCount() const { return published_count; }
+    uint64_t GetDroppedCount() const { return dropped_count; }
+    void IncrementDroppedCount() { ++dropped_count; }
+
     virtual bool Initialize(void *pcontext) = 0;
     virtual void Shutdown() = 0;
 
@@ -71,6 +77,8 @@ protected:
     std::string type;
     std::string address;
     int outbound_message_high_water_mark; // aka SNDHWM
+    std::atomic<uint64_t> published_count{0}; //!< messages sent to the socket
+    std::atomic<uint64_t> dropped_count{0}; //!< notifications dropped because the publishing queue was full
 };
 
 #endif // BITCOIN_ZMQ_ZMQABSTRACTNOTIFIER_H
@@ -10,6 +10,9 @@
 
 #include <validation.h>
 #include <util/system.h>
+#include <util/thread.h>
+
+#include <algorithm>
 
 CZMQNotificationInterface::CZMQNotificationInterface() : pcontext(nullptr)
 {
@@ -20,13 +23,18 @@ CZMQNotificationInterface::~CZMQNotificationInterface()
     Shutdown();
 }
 
-std::list<const CZMQAbstractNotifier*> CZMQNotificationInterface::GetActiveNotifiers() const
+void CZMQNotificationInterface::ForEachNotifier(const std::function<void(const CZMQAbstractNotifier&)>& func) const
 {
-    std::list<const CZMQAbstractNotifier*> result;
+    LOCK(cs_notifiers);
     for (const auto& n : notifiers) {
-        result.push_back(n.get());
+        func(*n);
     }
-    return result;
+}
+
+size_t CZMQNotificationInterface::GetQueueSize() const
+{
+    LOCK(cs_queue);
+    return queue.size();
 }
 
 CZMQNotificationInterface* CZMQNotificationInterface::Create()
@@ -68,7 +76,7 @@ CZMQNotificationInterface* CZMQNotificationInterface::Create()
     if (!notifiers.empty())
     {
         std::unique_ptr<CZMQNotificationInterface> notificationInterface(new CZMQNotificationInterface());
-        notificationInterface->notifiers = std::move(notifiers);
+        WITH_LOCK(notificationInterface->cs_notifiers, notificationInterface->notifiers = std::move(notifiers));
 
         if (notificationInterface->Initialize()) {
             return notificationInterface.release();
@@ -96,15 +104,20 @@ bool CZMQNotificationInterface::Initialize()
         return false;
     }
 
-    for (auto& notifier : notifiers) {
-        if (notifier->Initialize(pcontext)) {
-            LogPrint(BCLog::ZMQ, "zmq: Notifier %s ready (address = %s)\n", notifier->GetType(), notifier->GetAddress());
-        } else {
-            LogPrint(BCLog::ZMQ, "zmq: Notifier %s failed (address = %s)\n", notifier->GetType(), notifier->GetAddress());
-            return false;
+    {
+        LOCK(cs_notifiers);
+        for (auto& notifier : notifiers) {
+            if (notifier->Initialize(pcontext)) {
+                LogPrint(BCLog::ZMQ, "zmq: Notifier %s ready (address = %s)\n", notifier->GetType(), notifier->GetAddress());
+            } else {
+                LogPrint(BCLog::ZMQ, "zmq: Notifier %s failed (address = %s)\n", notifier->GetType(), notifier->GetAddress());
+                return false;
+            }
         }
     }
 
+    publishThread = std::thread(&util::TraceThread, "zmqpub", [this] { ThreadPublish(); });
+
     return true;
 }
 
@@ -112,8 +125,15 @@ bool CZMQNotificationInterface::Initialize()
 void CZMQNotificationInterface::Shutdown()
 {
     LogPrint(BCLog::ZMQ, "zmq: Shutdown notification interface\n");
+    if (publishThread.joinable()) {
+        // publish whatever is still queued before the sockets get closed
+        WITH_LOCK(cs_queue, fStopPublishing = true);
+        cvQueue.notify_all();
+        publishThread.join();
+    }
     if (pcontext)
     {
+        LOCK(cs_notifiers);
         for (auto& notifier : notifiers) {
             LogPrint(BCLog::ZMQ, "zmq: Shutdown notifier %s at %s\n", notifier->GetType(), notifier->GetAddress());
             notifier->Shutdown();
@@ -124,7 +144,55 @@ void CZMQNotificationInterface::Shutdown()
     }
 }
 
+void CZMQNotificationInterface::Enqueue(const std::vector<std::string>& types, std::function<void()>&& func)
+{
+    {
+        LOCK(cs_queue);
+        if (queue.size() < MAX_QUEUE_SIZE) {
+            queue.emplace_back(std::move(func));
+            cvQueue.notify_one();
+            return;
+        }
+    }
+
+    LogPrint(BCLog::ZMQ, "zmq: Publishing queue is full, dropping notification\n");
+    LOCK(cs_notifiers);
+    for (auto& notifier : notifiers) {
+        if (std::find(types.begin(), types.end(), notifier->GetType()) != types.end()) {
+            notifier->IncrementDroppedCount();
+        }
+    }
+}
+
+void CZMQNotificationInterface::ThreadPublish()
+{
+    while (true) {
+        std::function<void()> func;
+        {
+            WAIT_LOCK(cs_queue, lock);
+            while (!fStopPublishing && queue.empty()) {
+                cvQueue.wait(lock);
+            }
+            // only reached with an empty queue when shutting down
+            if (queue.empty()) return;
+            func = std::move(queue.front());
+            queue.pop_front();
+        }
+        func();
+    }
+}
+
 namespace {
+// Notifier types publishing each kind of notification, see CZMQNotificationInterface::Create()
+const std::vector<std::string> BLOCK_NOTIFIERS{"pubhashblock", "pubrawblock"};
+const std::vector<std::string> CHAINLOCK_NOTIFIERS{"pubhashchainlock", "pubrawchainlock", "pubrawchainlocksig"};
+const std::vector<std::string> TX_NOTIFIERS{"pubhashtx", "pubrawtx"};
+const std::vector<std::string> TXLOCK_NOTIFIERS{"pubhashtxlock", "pubrawtxlock", "pubrawtxlocksig"};
+const std::vector<std::string> GOVERNANCE_VOTE_NOTIFIERS{"pubhashgovernancevote", "pubrawgovernancevote"};
+const std::vector<std::string> GOVERNANCE_OBJECT_NOTIFIERS{"pubhashgovernanceobject", "pubrawgovernanceobject"};
+const std::vector<std::string> DOUBLESPEND_NOTIFIERS{"pubhashinstantsenddoublespend", "pubrawinstantsenddoublespend"};
+const std::vector<std::string> RECOVERED_SIG_NOTIFIERS{"pubhashrecoveredsig", "pubrawrecoveredsig"};
+
 template <typename Function>
 void TryForEachAndRemoveFailed(std::list<std::unique_ptr<CZMQAbstractNotifier>>& notifiers, const Function& func)
 {
@@ -145,15 +213,21 @@ void CZMQNotificationInterface::UpdatedBlockTip(const CBlockIndex *pindexNew, co
     if (fInitialDownload || pindexNew == pindexFork) // In IBD or blocks were disconnected without any new ones
         return;
 
-    TryForEachAndRemoveFailed(notifiers, [pindexNew](CZMQAbstractNotifier* notifier) {
-        return notifier->NotifyBlock(pindexNew);
+    Enqueue(BLOCK_NOTIFIERS, [this, pindexNew] {
+        LOCK(cs_notifiers);
+        TryForEachAndRemoveFailed(notifiers, [pindexNew](CZMQAbstractNotifier* notifier) {
+            return notifier->NotifyBlock(pindexNew);
+        });
     });
 }
 
 void CZMQNotificationInterface::NotifyChainLock(const CBlockIndex *pindex, const std::shared_ptr<const llmq::CChainLockSig>& clsig)
 {
-    TryForEachAndRemoveFailed(notifiers, [pindex, &clsig](CZMQAbstractNotifier* notifier) {
-        return notifier->NotifyChainLock(pindex, clsig);
+    Enqueue(CHAINLOCK_NOTIFIERS, [this, pindex, clsig] {
+        LOCK(cs_notifiers);
+        TryForEachAndRemoveFailed(notifiers, [pindex, &clsig](CZMQAbstractNotifier* notifier) {
+            return notifier->NotifyChainLock(pindex, clsig);
+        });
     });
 }
 
@@ -161,15 +235,17 @@ void CZMQNotificationInterface::TransactionAddedToMempool(const CTransactionRef&
 {
     // Used by BlockConnected and BlockDisconnected as well, because they're
     // all the same external callback.
-    const CTransaction& tx = *ptx;
-
-    TryForEachAndRemoveFailed(notifiers, [&tx](CZMQAbstractNotifier* notifier) {
-        return notifier->NotifyTransaction(tx);
+    Enqueue(TX_NOTIFIERS, [this, ptx] {
+        LOCK(cs_notifiers);
+        TryForEachAndRemoveFailed(notifiers, [&ptx](CZMQAbstractNotifier* notifier) {
+            return notifier->NotifyTransaction(*ptx);
+        });
     });
 }
 
 void CZMQNotificationInterface::BlockConnected(const std::shared_ptr<const CBlock>& pblock, const CBlockIndex* pindexConnected)
 {
+    CZMQAbstractPublishNotifier::CacheBlock(pblock);
     for (const CTransactionRef& ptx : pblock->vtx) {
         // Do a normal notify for each transaction added in the block
         TransactionAddedToMempool(ptx, 0);
@@ -186,36 +262,51 @@ void CZMQNotificationInterface::BlockDisconnected(const std::shared_ptr<const CB
 
 void CZMQNotificationInterface::NotifyTransactionLock(const CTransactionRef& tx, const std::shared_ptr<const llmq::CInstantSendLock>& islock)
 {
-    TryForEachAndRemoveFailed(notifiers, [&tx, &islock](CZMQAbstractNotifier* notifier) {
-        return notifier->NotifyTransactionLock(tx, islock);
+    Enqueue(TXLOCK_NOTIFIERS, [this, tx, islock] {
+        LOCK(cs_notifiers);
+        TryForEachAndRemoveFailed(notifiers, [&tx, &islock](CZMQAbstractNotifier* notifier) {
+            return notifier->NotifyTransactionLock(tx, islock);
+        });
     });
 }
 
 void CZMQNotificationInterface::NotifyGovernanceVote(const std::shared_ptr<const CGovernanceVote> &vote)
 {
-    TryForEachAndRemoveFailed(notifiers, [&vote](CZMQAbstractNotifier* notifier) {
-        return notifier->NotifyGovernanceVote(vote);
+    Enqueue(GOVERNANCE_VOTE_NOTIFIERS, [this, vote] {
+        LOCK(cs_notifiers);
+        TryForEachAndRemoveFailed(notifiers, [&vote](CZMQAbstractNotifier* notifier) {
+            return notifier->NotifyGovernanceVote(vote);
+        });
     });
 }
 
 void CZMQNotificationInterface::NotifyGovernanceObject(const std::shared_ptr<const Governance::Object> &object)
 {
-    TryForEachAndRemoveFailed(notifiers, [&object](CZMQAbstractNotifier* notifier) {
-        return notifier->NotifyGovernanceObject(object);
+    Enqueue(GOVERNANCE_OBJECT_NOTIFIERS, [this, object] {
+        LOCK(cs_notifiers);
+        TryForEachAndRemoveFailed(notifiers, [&object](CZMQAbstractNotifier* notifier) {
+            return notifier->NotifyGovernanceObject(object);
+        });
     });
 }
 
 void CZMQNotificationInterface::NotifyInstantSendDoubleSpendAttempt(const CTransactionRef& currentTx, const CTransactionRef& previousTx)
 {
-    TryForEachAndRemoveFailed(notifiers, [&currentTx, &previousTx](CZMQAbstractNotifier* notifier) {
-        return notifier->NotifyInstantSendDoubleSpendAttempt(currentTx, previousTx);
+    Enqueue(DOUBLESPEND_NOTIFIERS, [this, currentTx, previousTx] {
+        LOCK(cs_notifiers);
+        TryForEachAndRemoveFailed(notifiers, [&currentTx, &previousTx](CZMQAbstractNotifier* notifier) {
+            return notifier->NotifyInstantSendDoubleSpendAttempt(currentTx, previousTx);
+        });
     });
 }
 
 void CZMQNotificationInterface::NotifyRecoveredSig(const std::shared_ptr<const llmq::CRecoveredSig>& sig)
 {
-    TryForEachAndRemoveFailed(notifiers, [&sig](CZMQAbstractNotifier* notifier) {
-        return notifier->NotifyRecoveredSig(sig);
+    Enqueue(RECOVERED_SIG_NOTIFIERS, [this, sig] {
+        LOCK(cs_notifiers);
+        TryForEachAndRemoveFailed(notifiers, [&sig](CZMQAbstractNotifier* notifier) {
+            return notifier->NotifyRecoveredSig(sig);
+        });
     });
 }
 
@@ -5,9 +5,17 @@
 #ifndef BITCOIN_ZMQ_ZMQNOTIFICATIONINTERFACE_H
 #define BITCOIN_ZMQ_ZMQNOTIFICATIONINTERFACE_H
 
+#include <sync.h>
 #include <validationinterface.h>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
 #include <list>
 #include <memory>
+#include <string>
+#include <thread>
+#include <vector>
 
 class CBlockIndex;
 class CZMQAbstractNotifier;
@@ -17,7 +25,10 @@ class CZMQNotificationInterface final : public CValidationInterface
 public:
     virtual ~CZMQNotificationInterface();
 
-    std::list<const CZMQAbstractNotifier*> GetActiveNotifiers() const;
+    /** Call func for every active notifier, the notifiers can't be removed while it runs */
+    void ForEachNotifier(const std::function<void(const CZMQAbstractNotifier&)>& func) const;
+    /** Number of notifications waiting to be published */
+    size_t GetQueueSize() const;
 
     static CZMQNotificationInterface* Create();
 
@@ -38,10 +49,27 @@ protected:
     void NotifyRecoveredSig(const std::shared_ptr<const llmq::CRecoveredSig>& sig) override;
 
 private:
+    /** Maximum number of pending notifications, new ones are dropped when it's reached */
+    static constexpr size_t MAX_QUEUE_SIZE{10000};
+
     CZMQNotificationInterface();
 
+    /**
+     * Hand a notification over to the publishing thread, so validation never waits for disk reads or sockets.
+     * types are the notifiers publishing it, their dropped count is increased if the queue is full.
+     */
+    void Enqueue(const std::vector<std::string>& types, std::function<void()>&& func);
+    void ThreadPublish();
+
     void *pcontext;
-    std::list<std::unique_ptr<CZMQAbstractNotifier>> notifiers;
+    mutable Mutex cs_notifiers;
+    std::list<std::unique_ptr<CZMQAbstractNotifier>> notifiers GUARDED_BY(cs_notifiers);
+
+    mutable Mutex cs_queue;
+    std::condition_variable cvQueue;
+    std::deque<std::function<void()>> queue GUARDED_BY(cs_queue);
+    bool fStopPublishing GUARDED_BY(cs_queue){false};
+    std::thread publishThread;
 };
 
 extern CZMQNotificationInterface* g_zmq_notification_interface;
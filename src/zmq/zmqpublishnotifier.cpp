@@ -7,7 +7,10 @@
 #include <chain.h>
 #include <chainparams.h>
 #include <node/blockstorage.h>
+#include <saltedhasher.h>
 #include <streams.h>
+#include <sync.h>
+#include <unordered_lru_cache.h>
 #include <validation.h>
 #include <zmq/zmqutil.h>
 
@@ -28,6 +31,14 @@
 
 static std::multimap<std::string, CZMQAbstractPublishNotifier*> mapPublishNotifiers;
 
+// Blocks and transactions usually get published by several notifiers (raw, lock, lock + sig), and
+// connected blocks are in memory anyway. Keep a few of them around so every object is serialized
+// only once and ChainLocked blocks don't have to be read back from disk.
+static Mutex cs_serialized_cache;
+static unordered_lru_cache<uint256, std::shared_ptr<const CBlock>, StaticSaltedHasher> recentBlocks GUARDED_BY(cs_serialized_cache){8};
+static unordered_lru_cache<uint256, std::shared_ptr<const std::vector<unsigned char>>, StaticSaltedHasher> serializedBlocks GUARDED_BY(cs_serialized_cache){8};
+static unordered_lru_cache<uint256, std::shared_ptr<const std::vector<unsigned char>>, StaticSaltedHasher> serializedTxes GUARDED_BY(cs_serialized_cache){1000};
+
 static const char *MSG_HASHBLOCK     = "hashblock";
 static const char *MSG_HASHCHAINLOCK = "hashchainlock";
 static const char *MSG_HASHTX        = "hashtx";
@@ -191,10 +202,69 @@ bool CZMQAbstractPublishNotifier::SendZmqMessage(const char *command, const void
 
     /* increment memory only sequence number after sending */
     nSequence++;
+    published_count++;
 
     return true;
 }
 
+void CZMQAbstractPublishNotifier::CacheBlock(const std::shared_ptr<const CBlock>& pblock)
+{
+    LOCK(cs_serialized_cache);
+    recentBlocks.insert(pblock->GetHash(), pblock);
+}
+
+CZMQAbstractPublishNotifier::SerializedData CZMQAbstractPublishNotifier::GetSerializedBlock(const CBlockIndex* pindex)
+{
+    const uint256 hash = pindex->GetBlockHash();
+    std::shared_ptr<const CBlock> pblock;
+    {
+        LOCK(cs_serialized_cache);
+        SerializedData data;
+        if (serializedBlocks.get(hash, data)) {
+            return data;
+        }
+        recentBlocks.get(hash, pblock);
+    }
+
+    SerializedData data;
+    if (pblock) {
+        auto vec = std::make_shared<std::vector<unsigned char>>();
+        CVectorWriter{SER_NETWORK, PROTOCOL_VERSION, *vec, 0, *pblock};
+        data = std::move(vec);
+    } else {
+        // not connected recently, the bytes on disk are what we would serialize
+        data = GetRawBlock(pindex, Params().MessageStart());
+        if (!data) {
+            zmqError("Can't read block from disk");
+            return nullptr;
+        }
+    }
+
+    LOCK(cs_serialized_cache);
+    serializedBlocks.insert(hash, data);
+    return data;
+}
+
+CZMQAbstractPublishNotifier::SerializedData CZMQAbstractPublishNotifier::GetSerializedTransaction(const CTransaction& transaction)
+{
+    const uint256& hash = transaction.GetHash();
+    {
+        LOCK(cs_serialized_cache);
+        SerializedData data;
+        if (serializedTxes.get(hash, data)) {
+            return data;
+        }
+    }
+
+    auto vec = std::make_shared<std::vector<unsigned char>>();
+    CVectorWriter{SER_NETWORK, PROTOCOL_VERSION, *vec, 0, transaction};
+    SerializedData data = std::move(vec);
+
+    LOCK(cs_serialized_cache);
+    serializedTxes.insert(hash, data);
+    return data;
+}
+
 bool CZMQPublishHashBlockNotifier::NotifyBlock(const CBlockIndex *pindex)
 {
     uint256 hash = pindex->GetBlockHash();
@@ -281,92 +351,64 @@ bool CZMQPublishRawBlockNotifier::NotifyBlock(const CBlockIndex *pindex)
 {
     LogPrint(BCLog::ZMQ, "zmq: Publish rawblock %s to %s\n", pindex->GetBlockHash().GetHex(), this->address);
 
-    const Consensus::Params& consensusParams = Params().GetConsensus();
-    CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
-    {
-        LOCK(cs_main);
-        CBlock block;
-        if(!ReadBlockFromDisk(block, pindex, consensusParams))
-        {
-            zmqError("Can't read block from disk");
-            return false;
-        }
-
-        ss << block;
+    const auto data = GetSerializedBlock(pindex);
+    if (!data) {
+        return false;
     }
 
-    return SendZmqMessage(MSG_RAWBLOCK, &(*ss.begin()), ss.size());
+    return SendZmqMessage(MSG_RAWBLOCK, data->data(), data->size());
 }
 
 bool CZMQPublishRawChainLockNotifier::NotifyChainLock(const CBlockIndex *pindex, const std::shared_ptr<const llmq::CChainLockSig>& clsig)
 {
     LogPrint(BCLog::ZMQ, "zmq: Publish rawchainlock %s\n", pindex->GetBlockHash().GetHex());
 
-    const Consensus::Params& consensusParams = Params().GetConsensus();
-    CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
-    {
-        LOCK(cs_main);
-        CBlock block;
-        if(!ReadBlockFromDisk(block, pindex, consensusParams))
-        {
-            zmqError("Can't read block from disk");
-            return false;
-        }
-
-        ss << block;
+    const auto data = GetSerializedBlock(pindex);
+    if (!data) {
+        return false;
     }
 
-    return SendZmqMessage(MSG_RAWCHAINLOCK, &(*ss.begin()), ss.size());
+    return SendZmqMessage(MSG_RAWCHAINLOCK, data->data(), data->size());
 }
 
 bool CZMQPublishRawChainLockSigNotifier::NotifyChainLock(const CBlockIndex *pindex, const std::shared_ptr<const llmq::CChainLockSig>& clsig)
 {
     LogPrint(BCLog::ZMQ, "zmq: Publish rawchainlocksig %s\n", pindex->GetBlockHash().GetHex());
 
-    const Consensus::Params& consensusParams = Params().GetConsensus();
-    CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
-    {
-        LOCK(cs_main);
-        CBlock block;
-        if(!ReadBlockFromDisk(block, pindex, consensusParams))
-        {
-            zmqError("Can't read block from disk");
-            return false;
-        }
-
-        ss << block;
-        ss << *clsig;
+    const auto data = GetSerializedBlock(pindex);
+    if (!data) {
+        return false;
     }
 
-    return SendZmqMessage(MSG_RAWCLSIG, &(*ss.begin()), ss.size());
+    std::vector<unsigned char> msg(*data);
+    CVectorWriter{SER_NETWORK, PROTOCOL_VERSION, msg, msg.size(), *clsig};
+
+    return SendZmqMessage(MSG_RAWCLSIG, msg.data(), msg.size());
 }
 
 bool CZMQPublishRawTransactionNotifier::NotifyTransaction(const CTransaction &transaction)
 {
     uint256 hash = transaction.GetHash();
     LogPrint(BCLog::ZMQ, "zmq: Publish rawtx %s to %s\n", hash.GetHex(), this->address);
-    CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
-    ss << transaction;
-    return SendZmqMessage(MSG_RAWTX, &(*ss.begin()), ss.size());
+    const auto data = GetSerializedTransaction(transaction);
+    return SendZmqMessage(MSG_RAWTX, data->data(), data->size());
 }
 
 bool CZMQPublishRawTransactionLockNotifier::NotifyTransactionLock(const CTransactionRef& transaction, const std::shared_ptr<const llmq::CInstantSendLock>& islock)
 {
     uint256 hash = transaction->GetHash();
     LogPrint(BCLog::ZMQ, "zmq: Publish rawtxlock %s to %s\n", hash.GetHex(), this->address);
-    CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
-    ss << *transaction;
-    return SendZmqMessage(MSG_RAWTXLOCK, &(*ss.begin()), ss.size());
+    const auto data = GetSerializedTransaction(*transaction);
+    return SendZmqMessage(MSG_RAWTXLOCK, data->data(), data->size());
 }
 
 bool CZMQPublishRawTransactionLockSigNotifier::NotifyTransactionLock(const CTransactionRef& transaction, const std::shared_ptr<const llmq::CInstantSendLock>& islock)
 {
     uint256 hash = transaction->GetHash();
     LogPrint(BCLog::ZMQ, "zmq: Publish rawtxlocksig %s to %s\n", hash.GetHex(), this->address);
-    CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
-    ss << *transaction;
-    ss << *islock;
-    return SendZmqMessage(MSG_RAWTXLOCKSIG, &(*ss.begin()), ss.size());
+    std::vector<unsigned char> msg(*GetSerializedTransaction(*transaction));
+    CVectorWriter{SER_NETWORK, PROTOCOL_VERSION, msg, msg.size(), *islock};
+    return SendZmqMessage(MSG_RAWTXLOCKSIG, msg.data(), msg.size());
 }
 
 bool CZMQPublishRawGovernanceVoteNotifier::NotifyGovernanceVote(const std::shared_ptr<const CGovernanceVote>& vote)
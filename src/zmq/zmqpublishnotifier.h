@@ -7,6 +7,9 @@
 
 #include <zmq/zmqabstractnotifier.h>
 
+#include <vector>
+
+class CBlock;
 class CBlockIndex;
 class CGovernanceVote;
 
@@ -33,6 +36,16 @@ public:
 
     bool Initialize(void *pcontext) override;
     void Shutdown() override;
+
+    /** Remember a connected block, so the raw block publishers don't have to read it back from disk */
+    static void CacheBlock(const std::shared_ptr<const CBlock>& pblock);
+
+protected:
+    using SerializedData = std::shared_ptr<const std::vector<unsigned char>>;
+
+    /** Network serialization of a block/transaction, shared between all publishers */
+    static SerializedData GetSerializedBlock(const CBlockIndex* pindex);
+    static SerializedData GetSerializedTransaction(const CTransaction& transaction);
 };
 
 class CZMQPublishHashBlockNotifier : public CZMQAbstractPublishNotifier
@@ -26,6 +26,9 @@ UniValue getzmqnotifications(const JSONRPCRequest& request)
                     {RPCResult::Type::STR, "type", "Type of notification"},
                     {RPCResult::Type::STR, "address", "Address of the publisher"},
                     {RPCResult::Type::NUM, "hwm", "Outbound message high water mark"},
+                    {RPCResult::Type::NUM, "published", "Number of messages published by this notifier"},
+                    {RPCResult::Type::NUM, "dropped", "Number of notifications dropped because the publishing queue was full"},
+                    {RPCResult::Type::NUM, "queued", "Number of notifications currently waiting in the publishing queue (shared by all notifiers)"},
                 }},
             }
         },
@@ -37,13 +40,17 @@ UniValue getzmqnotifications(const JSONRPCRequest& request)
 
     UniValue result(UniValue::VARR);
     if (g_zmq_notification_interface != nullptr) {
-        for (const auto* n : g_zmq_notification_interface->GetActiveNotifiers()) {
+        const size_t queued = g_zmq_notification_interface->GetQueueSize();
+        g_zmq_notification_interface->ForEachNotifier([&](const CZMQAbstractNotifier& n) {
             UniValue obj(UniValue::VOBJ);
-            obj.pushKV("type", n->GetType());
-            obj.pushKV("address", n->GetAddress());
-            obj.pushKV("hwm", n->GetOutboundMessageHighWaterMark());
+            obj.pushKV("type", n.GetType());
+            obj.pushKV("address", n.GetAddress());
+            obj.pushKV("hwm", n.GetOutboundMessageHighWaterMark());
+            obj.pushKV("published", n.GetPublishedCount());
+            obj.pushKV("dropped", n.GetDroppedCount());
+            obj.pushKV("queued", (uint64_t)queued);
             result.push_back(obj);
-        }
+        });
     }
 
     return result;
@@ -0,0 +1,108 @@
+#!/usr/bin/env python3
+# Copyright (c) 2024 The Dash Core developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+'''
+feature_llmq_chainlock_fast_sync.py
+
+Checks that -chainlockfastsync skips script verification of blocks which are buried under a ChainLock
+embedded in the CbTx of a downloaded block, and only of those.
+
+'''
+
+import os
+import re
+
+from test_framework.test_framework import DashTestFramework
+from test_framework.util import assert_equal, get_chain_folder
+
+SIGN_HEIGHT_OFFSET = 8
+
+
+class LLMQChainLockFastSyncTest(DashTestFramework):
+    def set_test_params(self):
+        self.set_dash_test_params(5, 4, fast_dip3_enforcement=True)
+
+    def run_test(self):
+        # Connect all nodes to node1 so that we always have the whole network connected
+        for i in range(len(self.nodes)):
+            if i != 1:
+                self.connect_nodes(i, 1)
+
+        self.activate_dip8()
+        self.activate_v20(expected_activation_height=1200)
+
+        self.nodes[0].sporkupdate("SPORK_17_QUORUM_DKG_ENABLED", 0)
+        self.wait_for_sporks_same()
+        self.move_to_next_cycle()
+        self.move_to_next_cycle()
+        self.move_to_next_cycle()
+        self.mine_cycle_quorum(llmq_type_name="llmq_test_dip0024", llmq_type=103)
+
+        self.log.info("Mine ChainLocked blocks, each one carries the ChainLock of its parent")
+        for _ in range(12):
+            block_hash = self.nodes[0].generate(1)[0]
+            self.wait_for_chainlocked_block_all_nodes(block_hash)
+
+        self.log.info("Mine blocks without new ChainLocks")
+        self.nodes[0].sporkupdate("SPORK_19_CHAINLOCKS_ENABLED", 1)
+        self.wait_for_sporks_same()
+        for _ in range(3):
+            block_hash = self.nodes[0].generate(1)[0]
+            self.wait_for_chainlocked_block_all_nodes(block_hash, expected=False)
+        self.sync_blocks()
+
+        node = self.nodes[0]
+        tip_height = node.getblockcount()
+        cl_heights = self.get_cbtx_chainlock_heights(node)
+        first_cl_height = min(cl_heights.values())
+        last_cl_height = max(cl_heights.values())
+        assert last_cl_height < tip_height
+
+        self.log.info("Reconnect all blocks without -chainlockfastsync, all of them are verified")
+        assert_equal(self.reconnect_blocks(node, []), set())
+
+        self.log.info("Reconnect all blocks with -chainlockfastsync")
+        skipped = self.reconnect_blocks(node, ["-chainlockfastsync"])
+
+        # script verification was skipped for every block covered by a ChainLock from the CbTx of the blocks above it...
+        assert set(range(first_cl_height, last_cl_height + 1)).issubset(skipped)
+        # ...and only for those, blocks before v20, before the first ChainLock and the ones mined while
+        # ChainLocks were disabled were fully verified
+        for height in skipped:
+            assert any(height < cbtx_height <= height + SIGN_HEIGHT_OFFSET and cl_height >= height
+                       for cbtx_height, cl_height in cl_heights.items()), height
+        assert max(skipped) <= last_cl_height
+
+    def get_cbtx_chainlock_heights(self, node):
+        """Map the height of each block with a ChainLock in its CbTx to the height of the ChainLocked block"""
+        cl_heights = {}
+        for height in range(1, node.getblockcount() + 1):
+            cbtx = node.getblock(node.getblockhash(height), 2).get("cbTx")
+            if cbtx is None or int(cbtx["version"]) < 3 or int(cbtx["bestCLSignature"], 16) == 0:
+                continue
+            cl_heights[height] = height - 1 - int(cbtx["bestCLHeightDiff"])
+        return cl_heights
+
+    def reconnect_blocks(self, node, extra_args):
+        """Rebuild the chainstate from the blocks on disk, returns the heights of the blocks connected without script checks"""
+        debug_log = os.path.join(node.datadir, get_chain_folder(node.datadir, node.chain), "debug.log")
+        log_start = os.path.getsize(debug_log)
+        tip = node.getbestblockhash()
+        # the other nodes aren't connected, all blocks come from disk and the ChainLocks from their CbTx
+        self.restart_node(0, extra_args=self.extra_args[0] + extra_args + ["-reindex-chainstate"])
+        self.wait_until(lambda: node.getbestblockhash() == tip)
+        self.connect_nodes(0, 1)
+
+        with open(debug_log, encoding="utf-8") as dl:
+            dl.seek(log_start)
+            log = dl.read()
+        skipped = set()
+        for first, last in re.findall(r"Skipped script verification of blocks (\d+) \(\w+\) to (\d+) \(\w+\)", log):
+            skipped.update(range(int(first), int(last) + 1))
+        return skipped
+
+
+if __name__ == '__main__':
+    LLMQChainLockFastSyncTest().main()
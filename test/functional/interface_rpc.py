@@ -48,6 +48,33 @@ class RPCInterfaceTest(BitcoinTestFramework):
         assert_greater_than_or_equal(command['duration'], 0)
         assert_equal(info['logpath'], os.path.join(self.nodes[0].datadir, self.chain, 'debug.log'))
 
+        # all calls are served by a single queue unless other classes are configured
+        assert_equal(len(info['work_queues']), 1)
+        queue = info['work_queues'][0]
+        assert_equal(queue['class'], 'default')
+        assert_equal(queue['threads'], 4)
+        assert_equal(queue['max_depth'], 16)
+        assert_greater_than_or_equal(queue['requests'], 1)
+        assert_equal(queue['rejected'], 0)
+        assert_greater_than_or_equal(queue['avg_queue_time'], 0)
+        assert_greater_than_or_equal(queue['max_queue_time'], queue['avg_queue_time'])
+
+    def test_work_classes(self):
+        self.log.info("Testing work classes...")
+        self.restart_node(0, ['-rpcworkclass=heavy:1:4', '-rpcmethodclass=getblockcount:heavy', '-rpcmethodclass=protx:default'])
+        node = self.nodes[0]
+        node.quorum('list')
+        node.getblockcount()
+        node.protx('list')
+
+        queues = {queue['class']: queue for queue in node.getrpcinfo()['work_queues']}
+        assert_equal(sorted(queues.keys()), ['default', 'heavy'])
+        assert_equal(queues['heavy']['threads'], 1)
+        assert_equal(queues['heavy']['max_depth'], 4)
+        assert_equal(queues['heavy']['requests'], 2)
+        assert_equal(queues['heavy']['depth'], 0)
+        assert_greater_than_or_equal(queues['default']['requests'], 2)
+
     def test_batch_request(self):
         self.log.info("Testing basic JSON-RPC batch request...")
 
@@ -96,6 +123,7 @@ class RPCInterfaceTest(BitcoinTestFramework):
         self.test_getrpcinfo()
         self.test_batch_request()
         self.test_http_status_codes()
+        self.test_work_classes()
         self.test_work_queue_exceeded()
 
 
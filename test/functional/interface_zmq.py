@@ -123,7 +123,11 @@ class ZMQTest (BitcoinTestFramework):
 
 
         self.log.info("Test the getzmqnotifications RPC")
-        assert_equal(self.nodes[0].getzmqnotifications(), [
+        notifications = self.nodes[0].getzmqnotifications()
+        for n in notifications:
+            assert n["published"] > 0
+            assert_equal(n["dropped"], 0)
+        assert_equal([{k: n[k] for k in ("type", "address", "hwm")} for n in notifications], [
             {"type": "pubhashblock", "address": ADDRESS, "hwm": 1000},
             {"type": "pubhashtx", "address": ADDRESS, "hwm": 1000},
             {"type": "pubrawblock", "address": ADDRESS, "hwm": 1000},
@@ -427,7 +427,10 @@ class DashZMQTest (DashTestFramework):
 
     def test_getzmqnotifications(self):
         # Test getzmqnotifications RPC
-        assert_equal(self.nodes[0].getzmqnotifications(), [
+        notifications = self.nodes[0].getzmqnotifications()
+        for n in notifications:
+            assert_equal(n["dropped"], 0)
+        assert_equal([{k: n[k] for k in ("type", "address", "hwm")} for n in notifications], [
             {"type": "pubhashchainlock", "address": self.address, "hwm": 1000},
             {"type": "pubhashgovernanceobject", "address": self.address, "hwm": 1000},
             {"type": "pubhashgovernancevote", "address": self.address, "hwm": 1000},
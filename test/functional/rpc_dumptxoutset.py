@@ -33,6 +33,13 @@ class DumptxoutsetTest(BitcoinTestFramework):
 
         assert_equal(out['coins_written'], 100)
         assert_equal(out['base_height'], 100)
+        assert_equal(out['evodb_entries'], 101)
+        assert_equal(
+            out['evodb_hash'],
+            '9140fc6d4c527b93f1fa04b01b3ee9ad9bbb918f9f0003c971f868f35e699608')
+        # one coinbase index entry per block and the best block
+        assert_equal(out['evodb_stores']['cbtx_index'], 100)
+        assert_equal(sum(out['evodb_stores'].values()), out['evodb_entries'])
         assert_equal(out['path'], str(expected_path))
         # Blockhash should be deterministic based on mocked time.
         assert_equal(
@@ -43,7 +50,7 @@ class DumptxoutsetTest(BitcoinTestFramework):
             digest = hashlib.sha256(f.read()).hexdigest()
             # UTXO snapshot hash should be deterministic based on mocked time.
             assert_equal(
-                digest, '83ec62f0b9d9f2cdfe4514e8996d5ba0a6aa4cf74517988670d912db83bc0318')
+                digest, '4d4bedd2d8f776bdb20ac682d4d9acdd4bb8e88de17221da307dde2a73370dca')
 
         # Specifying a path to an existing file will fail.
         assert_raises_rpc_error(
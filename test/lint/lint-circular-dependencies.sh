@@ -81,6 +81,8 @@ EXPECTED_CIRCULAR_DEPENDENCIES=(
     "consensus/tx_verify -> evo/assetlocktx -> validation -> consensus/tx_verify"
     "consensus/tx_verify -> evo/assetlocktx -> llmq/signing -> net_processing -> txmempool -> consensus/tx_verify"
     "evo/assetlocktx -> llmq/signing -> net_processing -> txmempool -> evo/assetlocktx"
+    "evo/assetlocktx -> llmq/signing -> net_processing -> txmempool -> evo/mempoolindex -> evo/assetlocktx"
+    "evo/mempoolindex -> evo/mnhftx -> llmq/signing -> net_processing -> txmempool -> evo/mempoolindex"
 
     "evo/simplifiedmns -> llmq/blockprocessor -> llmq/utils -> llmq/snapshot -> evo/simplifiedmns"
     "llmq/blockprocessor -> llmq/utils -> llmq/snapshot -> llmq/blockprocessor"
@@ -94,6 +96,7 @@ EXPECTED_CIRCULAR_DEPENDENCIES=(
     "llmq/signing -> masternode/node -> validationinterface -> llmq/signing"
     "evo/mnhftx -> validation -> evo/mnhftx"
     "evo/deterministicmns -> validation -> evo/deterministicmns"
+    "evo/cbtx -> validation -> evo/cbtx"
 )
 
 EXIT_CODE=0